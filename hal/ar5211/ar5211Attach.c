@@ -19,6 +19,7 @@
 #include "ui.h"
 #include "halUtil.h"
 #include "halDevId.h"
+#include "halWriteList.h"
 
 /* Headers for HW private items */
 #include "ar5211/ar5211Reg.h"
@@ -79,6 +80,8 @@ static const HW_FUNCS ar5211Funcs = {
     ar5211PhyDisable,
     ar5211Disable,
     ar5211PerCalibration,
+    NULL,                       /* hwStartCalibration */
+    NULL,                       /* hwCalibrationStatus */
     ar5211GetRfgain,
     ar5211SetTxPowerLimit,
 
@@ -160,6 +163,7 @@ static const HW_FUNCS ar5211Funcs = {
     ar5211ReserveHalKeyCacheEntries,
     ar5211ResetKeyCacheEntry,
     ar5211SetKeyCacheEntry,
+    NULL,                       /* hwSetKeyCacheEntries */
     ar5211KeyCacheAlloc,
     ar5211KeyCacheFree,
 
@@ -383,6 +387,18 @@ ar5211Attach(WLAN_DEV_INFO *pDev, A_UINT16 deviceID)
     /* Initialize gain ladder thermal calibration structure */
     ar5211InitializeGainValues(pGainValues);
 
+    /*
+     * Compile the init tables.  The AR5211 always paced its table
+     * writes every 64 registers (bug 6773), not by writeBlockSize.
+     */
+    halWriteListInitPacing(pDev, MAC_RXDP);
+    pDev->pHalInfo->writePacing.blockSize = 64;
+    if (ar5211AllocateIniWriteLists(pDev, pDev->pHalInfo) != A_OK) {
+        uiPrintf("ar5211Attach: Could not allocate memory for init write lists\n");
+        ar5211Detach(pDev);
+        return A_NO_MEMORY;
+    }
+
     /*
      * It's okay for the address to be assigned by software, so we ignore the
      * following error value if returned.
@@ -454,6 +470,8 @@ ar5211Detach(WLAN_DEV_INFO *pDev)
         pInfo->pGainValues = NULL;
     }
 
+    ar5211FreeIniWriteLists(pDev, pInfo);
+
     return A_OK;
 }
 
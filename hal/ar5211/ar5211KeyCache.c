@@ -17,6 +17,7 @@
 #include "hal.h"
 #include "ui.h"
 #include "halUtil.h"
+#include "halKeyCache.h"
 
 /* Headers for HW private items */
 #include "ar5211Reg.h"
@@ -226,12 +227,10 @@ ar5211KeyCacheAlloc(WLAN_DEV_INFO *pdevInfo, A_UINT16 hwIndex,
                     A_BOOL *pHwEncrypt)
 {
     SIB_ENTRY        *pVictimSib = NULL;
-    SIB_ENTRY        *pAssocSib  = NULL;
-    SIB_ENTRY        *pFreeSib   = NULL;
-    A_UINT32         tsAssoc     = 0xffffffff;
-    A_UINT32         tsFree      = 0xffffffff;
     SIB_ENTRY        *pSibtmp;
     SIB_ENTRY        **keyCacheSib;
+    A_UINT16         idx;
+    A_UINT32         list;
 
     if (pHwEncrypt) {
        *pHwEncrypt = TRUE;
@@ -247,29 +246,31 @@ ar5211KeyCacheAlloc(WLAN_DEV_INFO *pdevInfo, A_UINT16 hwIndex,
             ar5211ResetKeyCacheEntry(pdevInfo, hwIndex);
         }
 
-        keyCacheSib[hwIndex] = pSib;
+        halKeySlotSet(pdevInfo, hwIndex, pSib);
+        halKeySlotTouch(pdevInfo, hwIndex);
         return (hwIndex);
     }
 
-    for (hwIndex = MAX_SHARED_KEYS; hwIndex < pdevInfo->keyCacheSize;
-         hwIndex++)
-    {
-        pSibtmp = keyCacheSib[hwIndex];
-        if (pSibtmp == NULL) {
-            break;
-        } else if (pSibtmp->numTxPending <= 0 &&
-                   pSibtmp != pdevInfo->localSta)
-        {
-            /* Is there a race condition here?  The sib may wake up? */
-            if (pSibtmp->staState & (STATE_AUTH|STATE_ASSOC)) {
-                if (pSibtmp->staLastActivityTime < tsAssoc) {
-                    tsAssoc   = pSibtmp->staLastActivityTime;
-                    pAssocSib = pSibtmp;
-                }
-            } else {
-                if (pSibtmp->staLastActivityTime < tsFree) {
-                    tsFree   = pSibtmp->staLastActivityTime;
-                    pFreeSib = pSibtmp;
+    hwIndex = halKeySlotFindFree(pdevInfo, (A_UINT16)pdevInfo->keyCacheSize,
+                                 FALSE, FALSE);
+    if (hwIndex == HWINDEX_INVALID) {
+        /*
+         * Nothing free.  Take the least recently active station without
+         * pending tx frames, with preference to stations that are not
+         * associated.  The LRU lists hold them in that order.
+         */
+        for (list = 0; list < 2 && pVictimSib == NULL; list++) {
+            for (idx = halKeySlotLruFirst(pdevInfo, list); idx != HWINDEX_INVALID;
+                 idx = halKeySlotLruNext(pdevInfo, idx))
+            {
+                pSibtmp = keyCacheSib[idx];
+                if (idx >= MAX_SHARED_KEYS &&
+                    pSibtmp->numTxPending <= 0 &&
+                    pSibtmp != pdevInfo->localSta)
+                {
+                    /* Is there a race condition here?  The sib may wake up? */
+                    pVictimSib = pSibtmp;
+                    break;
                 }
             }
         }
@@ -281,15 +282,14 @@ ar5211KeyCacheAlloc(WLAN_DEV_INFO *pdevInfo, A_UINT16 hwIndex,
          * Update entry to reflect new owner and return
          * found entry.
          */
-        keyCacheSib[hwIndex] = pSib;
+        halKeySlotSet(pdevInfo, hwIndex, pSib);
+        halKeySlotTouch(pdevInfo, hwIndex);
         return (hwIndex);
     }
 
     /*
      * No easy key cache entry was found. We will steal an entry
      */
-    pVictimSib = pFreeSib ? pFreeSib : pAssocSib;
-
     if (pVictimSib == NULL) {
 #ifdef DEBUG
         if (keyDebugLevel > 0) {
@@ -334,7 +334,8 @@ ar5211KeyCacheAlloc(WLAN_DEV_INFO *pdevInfo, A_UINT16 hwIndex,
     /*
      * Mark the stolen entry as belonging to the new Sib
      */
-    keyCacheSib[hwIndex] = pSib;
+    halKeySlotSet(pdevInfo, hwIndex, pSib);
+    halKeySlotTouch(pdevInfo, hwIndex);
 
     return hwIndex;
 }
@@ -348,7 +349,7 @@ ar5211KeyCacheFree(WLAN_DEV_INFO *pdevInfo, A_UINT16 hwIndex)
     ASSERT(pSib != NULL);
 
     ar5211ResetKeyCacheEntry(pdevInfo, hwIndex);
-    pdevInfo->keyCacheSib[hwIndex] = NULL;
+    halKeySlotSet(pdevInfo, hwIndex, NULL);
 
     /*
      * shouldn't be freeing hwIndex if frames are pending! swretry
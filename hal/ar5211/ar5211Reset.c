@@ -17,8 +17,11 @@
 #include "hal.h"
 #include "ui.h"
 #include "halUtil.h"
+#include "halCalInterp.h"
 #include "halDevId.h"
 #include "vport.h"
+#include "halWriteList.h"
+#include "halResetProfile.h"
 
 /* Headers for HW private items */
 #include "ar5211Reg.h"
@@ -150,14 +153,6 @@ ar5211GetScaledPower(A_UINT16 channel, A_UINT16 pcdacValue, PCDACS_EEPROM *pSrcS
 static A_BOOL
 ar5211FindValueInList(A_UINT16 channel, A_UINT16 pcdacValue, PCDACS_EEPROM *pSrcStruct, A_UINT16 *powerValue);
 
-static A_UINT16
-ar5211GetInterpolatedValue(A_UINT16 target, A_UINT16 srcLeft, A_UINT16 srcRight,
-                           A_UINT16 targetLeft, A_UINT16 targetRight, A_BOOL scaleUp);
-
-static void
-ar5211GetLowerUpperValues(A_UINT16 value, A_UINT16 *pList, A_UINT16 listSize,
-                          A_UINT16 *pLowerValue, A_UINT16 *pUpperValue);
-
 static void
 ar5211GetLowerUpperPcdacs(A_UINT16 pcdac, A_UINT16 channel, PCDACS_EEPROM *pSrcStruct,
                     A_UINT16 *pLowerPcdac, A_UINT16 *pUpperPcdac);
@@ -182,13 +177,18 @@ ar5211AdjustGain(GAIN_VALUES *pGainValues);
 #define PLL_SETTLE_DELAY       300 //300 usec
 
 /*
- * WAR for bug 6773.  udelay() does a PIO READ on the PCI bus which allows
- * other cards' DMA reads to complete in the middle of our reset.
+ * Init tables in the order the reset used to write them.  Folded into
+ * one address sorted write list per modesIndex at attach and written
+ * with the bug 6773 pacing by the write list engine.
  */
-#define WAR_6773(x)          \
-    if ((++(x) % 64) == 0) { \
-        udelay(1);           \
-    }
+static const HAL_WL_SOURCE ar5211IniSources[] = {
+    HAL_WL_SOURCE_INIT(ar5211Modes,     HAL_WL_COL_MODE,   0),
+    HAL_WL_SOURCE_INIT(ar5211BB_RfGain, HAL_WL_COL_FREQ,   0),
+    HAL_WL_SOURCE_INIT(ar5211Common,    HAL_WL_COL_COMMON, HAL_WL_KEEP_PCU),
+};
+
+/* 5211 modesIndex runs 1 - 4 */
+#define AR5211_NUM_MODES    5
 
 /**************************************************************
  * ar5211Reset
@@ -205,7 +205,7 @@ ar5211Reset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval,
 {
     A_UINT32        ulAddressLow, ulAddressHigh;
     A_UINT32        macStaId1;
-    A_UINT32        reg, data, synthDelay, i;
+    A_UINT32        data, synthDelay, i;
     A_STATUS        status;
     A_BOOL          is11b = IS_CHAN_CCK(pChval->channelFlags);
     A_UINT16        arrayEntries;
@@ -216,7 +216,6 @@ ar5211Reset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval,
     WLAN_STA_CONFIG *pCfg = &pDev->staConfig;
     VPORT_BSS       *pVportBaseBss = GET_BASE_BSS(pDev);
     A_UINT32        saveDefAntenna;
-    int             regWrites = 0;
 
     ASSERT(IS_CHAN_2GHZ(pChval->channelFlags) ^
            IS_CHAN_5GHZ(pChval->channelFlags));
@@ -271,7 +270,9 @@ ar5211Reset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval,
     /* Adjust gain parameters before reset if there's an outstanding gain update */
     ar5211GetRfgain(pDev);
 
+    HAL_RESET_PHASE_START(pDev, HAL_RESET_PHASE_CHIP_RESET);
     status = ar5211ChipReset(pDev, pChval->channelFlags);
+    HAL_RESET_PHASE_END(pDev, HAL_RESET_PHASE_CHIP_RESET);
     if (status != A_OK) {
         return status;
     }
@@ -341,33 +342,18 @@ ar5211Reset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval,
     }
 
     /* Write the analog registers 6 and 7 before other config */
+    HAL_RESET_PHASE_START(pDev, HAL_RESET_PHASE_RF_BANKS);
     ar5211SetRf6and7(pDev, pEepData->pEepHeader, pChval);
+    HAL_RESET_PHASE_END(pDev, HAL_RESET_PHASE_RF_BANKS);
 
-    /* Write registers that vary across all modes */
-    arrayEntries = sizeof(ar5211Modes) / (sizeof(A_UINT32) * 5);
-    for (i = 0; i < arrayEntries; i++) {
-        writePlatformReg(pDev, ar5211Modes[i][0], ar5211Modes[i][modesIndex]);
-        WAR_6773(regWrites);
-    }
-
-    arrayEntries = sizeof(ar5211BB_RfGain) / (sizeof(A_UINT32) * 3);
-    /* Write RFGain Parameters that differ between 2.4 and 5 GHz */
-    for (i = 0; i < arrayEntries; i++) {
-        writePlatformReg(pDev, ar5211BB_RfGain[i][0], ar5211BB_RfGain[i][freqIndex]);
-        WAR_6773(regWrites);
-    }
-
-    arrayEntries = sizeof(ar5211Common) / (sizeof(A_UINT32) * 2);
-    /* Write Common Array Parameters */
-    for (i = 0; i < arrayEntries; i++) {
-        reg = ar5211Common[i][0];
-
-        /* On channel change, don't reset the PCU registers */
-        if ( !(bChannelChange && (reg >= 0x8000 && reg < 0x9000)) ) {
-            writePlatformReg(pDev, reg, ar5211Common[i][1]);
-            WAR_6773(regWrites);
-        }
-    }
+    /*
+     * Write registers that vary across all modes, the RFGain parameters that
+     * differ between 2.4 and 5 GHz and the common parameters - on channel
+     * change, don't reset the PCU registers
+     */
+    HAL_RESET_PHASE_START(pDev, HAL_RESET_PHASE_INI_WRITES);
+    halWriteListApply(pDev, pDev->pHalInfo->pIniWriteList[modesIndex], bChannelChange);
+    HAL_RESET_PHASE_END(pDev, HAL_RESET_PHASE_INI_WRITES);
 
     /* Fix pre-AR5211 register values, this includes AR531Xs. */
     if (pDev->macVersion < MAC_SREV_VERSION_OAHU) {
@@ -462,9 +448,11 @@ ar5211Reset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval,
     writePlatformReg(pDev, MAC_RSSI_THR, INIT_RSSI_THR);
 
     /* Setup the transmit power values. */
+    HAL_RESET_PHASE_START(pDev, HAL_RESET_PHASE_TX_POWER);
     if (ar5211SetTransmitPower(pDev, pChval) != A_OK) {
         return A_ERROR;
     }
+    HAL_RESET_PHASE_END(pDev, HAL_RESET_PHASE_TX_POWER);
 
     /* Setup board specific options for EEPROM version 3 */
     ar5211SetBoardValues(pDev, pEepData->pEepHeader, pChval);
@@ -510,10 +498,12 @@ ar5211Reset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval,
      * Added an extra delay, BASE_ACTIVATE_DELAY, to ensure that this
      * condition will not happen.
      */
+    HAL_RESET_PHASE_START(pDev, HAL_RESET_PHASE_SYNTH_SETTLE);
     udelay(synthDelay + BASE_ACTIVATE_DELAY);
-
+    HAL_RESET_PHASE_END(pDev, HAL_RESET_PHASE_SYNTH_SETTLE);
 
     /* Calibrate the AGC and poll the bit going to 0 for completion. */
+    HAL_RESET_PHASE_START(pDev, HAL_RESET_PHASE_NF_CAL);
     writePlatformReg(pDev, PHY_AGC_CONTROL,
                      readPlatformReg(pDev, PHY_AGC_CONTROL) | PHY_AGC_CONTROL_CAL);
 
@@ -527,6 +517,7 @@ ar5211Reset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval,
 
     /* Perform noise floor and set status */
     status = ar5211CalNoiseFloor(pDev, pChval);
+    HAL_RESET_PHASE_END(pDev, HAL_RESET_PHASE_NF_CAL);
     if (status != A_OK) {
         pChval->channelFlags |= (is11b ? 0 : CHANNEL_CW_INT);
         return status;
@@ -537,6 +528,7 @@ ar5211Reset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval,
      * -Cal is not necessary for CCK-only operation
      * -Don't run cal if previous results exist (and no current request)
      */
+    HAL_RESET_PHASE_START(pDev, HAL_RESET_PHASE_IQ_CAL);
     if ( (pCfg->calibrationTime != 0) && !IS_CHAN_B(pChval->channelFlags) && 
          !(pDev->pHalInfo->iqCalState == IQ_CAL_DONE) )
     {
@@ -548,6 +540,7 @@ ar5211Reset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval,
     } else {
         pDev->pHalInfo->iqCalState = IQ_CAL_INACTIVE;
     }
+    HAL_RESET_PHASE_END(pDev, HAL_RESET_PHASE_IQ_CAL);
 
     /* Set 1:1 QCU to DCU mapping for all queues */
     for (i = 0; i < MAC_NUM_DCU; i++) {
@@ -1599,7 +1592,7 @@ ar5211SetPowerTable(WLAN_DEV_INFO *pDev, PCDACS_EEPROM *pSrcStruct, A_UINT16 cha
             i++;
         }
         /* scale by 2 and add 1 to enable round up or down as needed */
-        scaledPcdac = (A_UINT16)(ar5211GetInterpolatedValue(pwr, pScaledUpDbm[i],
+        scaledPcdac = (A_UINT16)(halCalInterpolate(pwr, pScaledUpDbm[i],
                                  pScaledUpDbm[i + 1], (A_UINT16)(pPcdacValues[i] * 2),
                                  (A_UINT16)(pPcdacValues[i + 1] * 2), 0 ) + 1);
 
@@ -1676,7 +1669,7 @@ ar5211SetRateTable(WLAN_DEV_INFO *pDev, RD_EDGES_POWER *pRdEdgesPower,
         }
         numEdges = i;
 
-        ar5211GetLowerUpperValues(pChval->channel, tempChannelList, numEdges,
+        halCalGetLowerUpperValues(pChval->channel, tempChannelList, numEdges,
                                   &lowerChannel, &upperChannel);
         /* Get the index for the lower channel */
         for (i = 0; i < numEdges; i++) {
@@ -1704,7 +1697,7 @@ ar5211SetRateTable(WLAN_DEV_INFO *pDev, RD_EDGES_POWER *pRdEdgesPower,
         tempChannelList[i] = pPowerInfo[i].testChannel;
     }
 
-    ar5211GetLowerUpperValues(pChval->channel, tempChannelList, numChannels,
+    halCalGetLowerUpperValues(pChval->channel, tempChannelList, numChannels,
                               &lowerChannel, &upperChannel);
 
     /* get the index for the channel */
@@ -1760,7 +1753,7 @@ ar5211SetRateTable(WLAN_DEV_INFO *pDev, RD_EDGES_POWER *pRdEdgesPower,
             }
         }
 
-        twicePower = (A_UINT16)ar5211GetInterpolatedValue(pChval->channel, lowerChannel,
+        twicePower = (A_UINT16)halCalInterpolate(pChval->channel, lowerChannel,
                      upperChannel, lowerPower, upperPower, 0);
 
         /* Reduce power by band edge restrictions */
@@ -1850,7 +1843,7 @@ ar5211GetScaledPower(A_UINT16 channel, A_UINT16 pcdacValue, PCDACS_EEPROM *pSrcS
         return powerValue;
     }
 
-    ar5211GetLowerUpperValues(channel, pSrcStruct->pChannelList,
+    halCalGetLowerUpperValues(channel, pSrcStruct->pChannelList,
                               pSrcStruct->numChannels, &lFreq, &rFreq);
     ar5211GetLowerUpperPcdacs(pcdacValue, lFreq, pSrcStruct, &llPcdac, &ulPcdac);
     ar5211GetLowerUpperPcdacs(pcdacValue, rFreq, pSrcStruct, &lrPcdac, &urPcdac);
@@ -1858,161 +1851,49 @@ ar5211GetScaledPower(A_UINT16 channel, A_UINT16 pcdacValue, PCDACS_EEPROM *pSrcS
     /* get the power index for the pcdac value */
     ar5211FindValueInList(lFreq, llPcdac, pSrcStruct, &lPwr);
     ar5211FindValueInList(lFreq, ulPcdac, pSrcStruct, &uPwr);
-    lScaledPwr = ar5211GetInterpolatedValue(pcdacValue, llPcdac, ulPcdac,
-                                            lPwr, uPwr, 0);
+    lScaledPwr = halCalInterpolate(pcdacValue, llPcdac, ulPcdac,
+                                   lPwr, uPwr, 0);
 
     ar5211FindValueInList(rFreq, lrPcdac, pSrcStruct, &lPwr);
     ar5211FindValueInList(rFreq, urPcdac, pSrcStruct, &uPwr);
-    rScaledPwr = ar5211GetInterpolatedValue(pcdacValue, lrPcdac, urPcdac,
-                                            lPwr, uPwr, 0);
+    rScaledPwr = halCalInterpolate(pcdacValue, lrPcdac, urPcdac,
+                                   lPwr, uPwr, 0);
 
-    return ar5211GetInterpolatedValue(channel, lFreq, rFreq,
-                                      (A_UINT16)lScaledPwr,
-                                      (A_UINT16)rScaledPwr, 0);
+    return halCalInterpolate(channel, lFreq, rFreq,
+                             (A_UINT16)lScaledPwr,
+                             (A_UINT16)rScaledPwr, 0);
 }
 
 /**************************************************************
  * ar5211FindValueInList
  *
- * Find the value from the calibrated source data struct
+ * Find the value from the calibrated source data struct.  The
+ * channel and PCDAC lists are ascending, as
+ * halCalGetLowerUpperValues also requires of them, and
+ * pDataPerChannel[i] holds the data for pChannelList[i]: the
+ * EEPROM reader (ar5211Attach.c) fills both from the same list.
  */
 A_BOOL
 ar5211FindValueInList(A_UINT16 channel, A_UINT16 pcdacValue, PCDACS_EEPROM *pSrcStruct, A_UINT16 *powerValue)
 {
     DATA_PER_CHANNEL    *pChannelData;
-    A_UINT16            *pPcdac;
     A_UINT16            i, j;
 
-    pChannelData = pSrcStruct->pDataPerChannel;
-
-    for (i = 0; i < pSrcStruct->numChannels; i++ ) {
-        if (pChannelData->channelValue == channel) {
-            pPcdac = pChannelData->PcdacValues;
-
-            for (j = 0; j < pChannelData->numPcdacValues; j++ ) {
-                if (*pPcdac == pcdacValue) {
-                    *powerValue = pChannelData->PwrValues[j];
-                    return TRUE;
-                }
-                pPcdac++;
-            }
-        }
-        pChannelData++;
-    }
-
-    return FALSE;
-}
-
-/**************************************************************
- * ar5211GetInterpolatedValue
- *
- * Returns interpolated or the scaled up interpolated value
- */
-A_UINT16
-ar5211GetInterpolatedValue(A_UINT16 target, A_UINT16 srcLeft, A_UINT16 srcRight,
-                           A_UINT16 targetLeft, A_UINT16 targetRight, A_BOOL scaleUp)
-{
-    A_UINT16 returnValue;
-    A_INT16 lRatio;
-    A_UINT16 scaleValue = EEP_SCALE;
-
-    /*
-     * To get an accurate ratio, always scale, If we want to scale, then
-     * don't scale back down.
-     */
-    if ((targetLeft * targetRight) == 0) {
-        return 0;
-    }
-
-    if (scaleUp) {
-        scaleValue = 1;
-    }
-
-    if (srcRight != srcLeft) {
-        /* note the ratio always need to be scaled, since it will be a fraction */
-        lRatio = ((target - srcLeft) * EEP_SCALE / (srcRight - srcLeft));
-        if (lRatio < 0) {
-            /* Return as Left target if value would be negative */
-            returnValue = targetLeft * (scaleUp ? EEP_SCALE : 1);
-        } else if (lRatio > EEP_SCALE) {
-            /* Return as Right target if Ratio is greater than 100% (SCALE) */
-            returnValue = targetRight * (scaleUp ? EEP_SCALE : 1);
-        } else {
-            returnValue = ((lRatio * targetRight + (EEP_SCALE - lRatio) *
-                                  targetLeft) / scaleValue);
-        }
-    } else {
-        returnValue = targetLeft * (scaleUp ? EEP_SCALE : 1);
-    }
-
-    return returnValue;
-}
-
-/**************************************************************
- * ar5211GetLowerUpperValues
- *
- *  Look for value being within 0.1 of the search values
- *  however, NDIS can't do float calculations, so multiply everything
- *  up by EEP_SCALE so can do integer arithmatic
- *
- * INPUT  value       -value to search for
- * INPUT  pList       -ptr to the list to search
- * INPUT  listSize    -number of entries in list
- * OUTPUT pLowerValue -return the lower value
- * OUTPUT pUpperValue -return the upper value
- *
- * WARNING: This input list should be filled and in ascending order
- */
-void
-ar5211GetLowerUpperValues(A_UINT16 value, A_UINT16 *pList, A_UINT16 listSize,
-                          A_UINT16 *pLowerValue, A_UINT16 *pUpperValue)
-{
-    A_UINT16    i;
-    A_UINT16    listEndValue = *(pList + listSize - 1);
-    A_UINT32    target       = value * EEP_SCALE;
-
-    /*
-     * See if value is lower than the first value in the list
-     * if so return first value
-     */
-    if (target < (A_UINT32)(*pList * EEP_SCALE - EEP_DELTA)) {
-        *pLowerValue = *pList;
-        *pUpperValue = *pList;
-        return;
-    }
-
-    /*
-     * See if value is greater than last value in list
-     * if so return last value
-     */
-    if (target > (A_UINT32)(listEndValue * EEP_SCALE + EEP_DELTA)) {
-        *pLowerValue = listEndValue;
-        *pUpperValue = listEndValue;
-        return;
-    }
-
-    /* look for value being near or between 2 values in list */
-    for (i = 0; i < listSize; i++) {
-        /*
-         * If value is close to the current value of the list
-         * then target is not between values, it is one of the values
-         */
-        if (A_ABS(pList[i] * EEP_SCALE - (A_INT32)target) < EEP_DELTA) {
-            *pLowerValue = pList[i];
-            *pUpperValue = pList[i];
-            return;
+    i = halCalFindIndex(channel, pSrcStruct->pChannelList, pSrcStruct->numChannels);
+    ASSERT(i == pSrcStruct->numChannels ||
+           pSrcStruct->pDataPerChannel[i].channelValue == channel);
+    for (; i < pSrcStruct->numChannels; i++) {
+        pChannelData = &pSrcStruct->pDataPerChannel[i];
+        if (pChannelData->channelValue != channel) {
+            break;
         }
-
-        /*
-         * Look for value being between current value and next value
-         * if so return these 2 values
-         */
-        if (target < (A_UINT32)(pList[i + 1] * EEP_SCALE - EEP_DELTA)) {
-            *pLowerValue = pList[i];
-            *pUpperValue = pList[i + 1];
-            return;
+        j = halCalFindIndex(pcdacValue, pChannelData->PcdacValues, pChannelData->numPcdacValues);
+        if (j < pChannelData->numPcdacValues) {
+            *powerValue = pChannelData->PwrValues[j];
+            return TRUE;
         }
     }
+    return FALSE;
 }
 
 /**************************************************************
@@ -2038,7 +1919,7 @@ ar5211GetLowerUpperPcdacs(A_UINT16 pcdac, A_UINT16 channel,
         pChannelData++;
     }
 
-    ar5211GetLowerUpperValues(pcdac, pChannelData->PcdacValues,
+    halCalGetLowerUpperValues(pcdac, pChannelData->PcdacValues,
                               pChannelData->numPcdacValues,
                               pLowerPcdac, pUpperPcdac);
 }
@@ -2274,4 +2155,41 @@ ar5211SetRfgain(WLAN_DEV_INFO *pDev)
     pHeaderInfo->cornerCal.gSel = pGainValues->currStep->paramVal[3]; // rf_rfgainsel
 }
 
+/**************************************************************
+ * ar5211AllocateIniWriteLists
+ *
+ * Compile the init tables into one write list per modesIndex
+ */
+A_STATUS
+ar5211AllocateIniWriteLists(WLAN_DEV_INFO *pDev, HAL_INFO *pHalInfo)
+{
+    A_UINT16 modesIndex;
+    A_STATUS status;
+
+    /* modesIndex 1, 2 are 5 GHz (freqIndex 1), 3, 4 are 2.4 GHz (freqIndex 2) */
+    for (modesIndex = 1; modesIndex < AR5211_NUM_MODES; modesIndex++) {
+        status = halWriteListCompile(&pHalInfo->pIniWriteList[modesIndex], ar5211IniSources,
+                                     sizeof(ar5211IniSources) / sizeof(ar5211IniSources[0]),
+                                     modesIndex, (modesIndex <= 2) ? 1 : 2);
+        if (status != A_OK) {
+            ar5211FreeIniWriteLists(pDev, pHalInfo);
+            return status;
+        }
+    }
+    return A_OK;
+}
+
+/**************************************************************
+ * ar5211FreeIniWriteLists
+ */
+void
+ar5211FreeIniWriteLists(WLAN_DEV_INFO *pDev, HAL_INFO *pHalInfo)
+{
+    int i;
+
+    for (i = 0; i < HAL_WL_NUM_MODES; i++) {
+        halWriteListFree(&pHalInfo->pIniWriteList[i]);
+    }
+}
+
 #endif // #ifdef BUILD_AR5211
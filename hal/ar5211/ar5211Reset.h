@@ -40,6 +40,12 @@ ar5211InitializeGainValues(struct gainValues *pGainValues);
 void
 ar5211SetTxPowerLimit(WLAN_DEV_INFO *pDev, A_UINT32 limit);
 
+A_STATUS
+ar5211AllocateIniWriteLists(WLAN_DEV_INFO *pDev, HAL_INFO *pHalInfo);
+
+void
+ar5211FreeIniWriteLists(WLAN_DEV_INFO *pDev, HAL_INFO *pHalInfo);
+
 #ifdef _cplusplus
 }
 #endif
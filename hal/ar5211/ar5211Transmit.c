@@ -21,6 +21,7 @@
 #include "hal.h"
 #include "halDevId.h"
 #include "ui.h"
+#include "halResetProfile.h"
 #include "display.h"
 #include "ratectrl.h"
 
@@ -234,7 +235,9 @@ ar5211SetupTxQueue(WLAN_DEV_INFO *pDev, HAL_TX_QUEUE_INFO *queueInfo)
         pDev->pHalInfo->txDescIntMask |= queueMask;
     }
 
+    HAL_RESET_PHASE_START(pDev, HAL_RESET_PHASE_TX_QUEUES);
     ar5211ResetTxQueue(pDev, queueNum, queueInfo);
+    HAL_RESET_PHASE_END(pDev, HAL_RESET_PHASE_TX_QUEUES);
 
     return queueNum;
 }
@@ -19,6 +19,7 @@
 #include "ui.h"
 #include "halUtil.h"
 #include "halDevId.h"
+#include "halWriteList.h"
 
 /* Headers for HW private items */
 #include "ar5212/ar5212Reg.h"
@@ -127,6 +128,8 @@ static const HW_FUNCS ar5212Funcs = {
     ar5212PhyDisable,
     ar5212Disable,
     ar5212PerCalibration,
+    NULL,                       /* hwStartCalibration */
+    NULL,                       /* hwCalibrationStatus */
     ar5212GetRfgain,
     ar5212SetTxPowerLimit,
 
@@ -208,6 +211,7 @@ static const HW_FUNCS ar5212Funcs = {
     ar5212ReserveHalKeyCacheEntries,
     ar5212ResetKeyCacheEntry,
     ar5212SetKeyCacheEntry,
+    NULL,                       /* hwSetKeyCacheEntries */
     ar5212KeyCacheAlloc,
     ar5212KeyCacheFree,
 
@@ -523,6 +527,13 @@ ar5212Attach(WLAN_DEV_INFO *pDev, A_UINT16 deviceID)
         goto attachError;
     }
 
+    /* Compile the init tables - the table set depends on the radio revision */
+    halWriteListInitPacing(pDev, MAC_RXDP);
+    if (ar5212AllocateIniWriteLists(pDev, pDev->pHalInfo) != A_OK) {
+        uiPrintf("ar5212Attach: Could not allocate memory for init write lists\n");
+        goto attachError;
+    }
+
     /*
      * It's okay for the address to be assigned by software, so we ignore the
      * following error value if returned.
@@ -682,6 +693,7 @@ ar5212Detach(WLAN_DEV_INFO *pDev)
     }
 
     ar5212FreeRfBanks(pDev, pInfo);
+    ar5212FreeIniWriteLists(pDev, pInfo);
 
     if (pInfo->pEarHead) {
         if (pInfo->pEarHead->numRHs) {
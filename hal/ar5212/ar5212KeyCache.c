@@ -17,6 +17,7 @@
 #include "hal.h"
 #include "ui.h"
 #include "halUtil.h"
+#include "halKeyCache.h"
 
 /* Headers for HW private items */
 #include "ar5212Reg.h"
@@ -583,13 +584,11 @@ ar5212KeyCacheAlloc(WLAN_DEV_INFO *pdevInfo, A_UINT16 hwIndex,
                     A_BOOL *pHwEncrypt)
 {
     SIB_ENTRY        *pVictimSib = NULL;
-    SIB_ENTRY        *pAssocSib  = NULL;
-    SIB_ENTRY        *pFreeSib   = NULL;
-    A_UINT32         tsAssoc     = 0xffffffff;
-    A_UINT32         tsFree      = 0xffffffff;
     SIB_ENTRY        *pSibtmp;
     SIB_ENTRY        **keyCacheSib;
-    A_UINT16         indexLimit, singleEntry = 0;
+    A_UINT16         indexLimit, idx;
+    A_UINT32         list;
+    A_BOOL           skipShared;
 
     if (pHwEncrypt) {
        *pHwEncrypt = TRUE;
@@ -634,14 +633,15 @@ ar5212KeyCacheAlloc(WLAN_DEV_INFO *pdevInfo, A_UINT16 hwIndex,
                 (!keyCacheSib[hwIndex + 32 + 64] ||
                 keyCacheSib[hwIndex + 32 + 64] == pSib) )
             {
-                keyCacheSib[hwIndex + 32] = pSib;
-                keyCacheSib[hwIndex + 64] = pSib;
-                keyCacheSib[hwIndex + 32 + 64] = pSib;
+                halKeySlotSet(pdevInfo, hwIndex + 32, pSib);
+                halKeySlotSet(pdevInfo, hwIndex + 64, pSib);
+                halKeySlotSet(pdevInfo, hwIndex + 32 + 64, pSib);
             } else if (pHwEncrypt) {
                *pHwEncrypt = FALSE;
             }
         }
-        keyCacheSib[hwIndex] = pSib;
+        halKeySlotSet(pdevInfo, hwIndex, pSib);
+        halKeySlotTouch(pdevInfo, hwIndex);
         return (hwIndex);
     }
     if (pdevInfo->staConfig.encryptionAlg == ENCRYPTION_TKIP ||
@@ -658,44 +658,33 @@ ar5212KeyCacheAlloc(WLAN_DEV_INFO *pdevInfo, A_UINT16 hwIndex,
     }
 
 
-    for (hwIndex = MAX_SHARED_KEYS; hwIndex < indexLimit; hwIndex++)
-    {
-        if (((hwIndex & 0x1F) < MAX_SHARED_KEYS) &&
-            pdevInfo->localSta->serviceType == WLAN_STA_SERVICE)
-        {
-            /*
-             * Do not allocate an index which would be required by a
-             * broadcast key using TKIP
-             */
-            continue;
-        }
-        pSibtmp = keyCacheSib[hwIndex];
-        if (pSibtmp == NULL) {
-            if (keyType != PRIV_KEY_TYPE_TKIP) {
-                break;
-            } else {
-                singleEntry = hwIndex;
-                if (hwIndex < (pdevInfo->keyCacheSize >> 2) &&
-                    keyCacheSib[hwIndex + 32] == NULL &&
-                    keyCacheSib[hwIndex + 64] == NULL &&
-                    keyCacheSib[hwIndex + 32 + 64] == NULL)
+    /*
+     * Do not allocate an index which would be required by a
+     * broadcast key using TKIP
+     */
+    skipShared = (A_BOOL)(pdevInfo->localSta->serviceType == WLAN_STA_SERVICE);
+
+    hwIndex = halKeySlotFindFree(pdevInfo, indexLimit, skipShared,
+                                 (A_BOOL)(keyType == PRIV_KEY_TYPE_TKIP));
+    if (hwIndex == HWINDEX_INVALID) {
+        /*
+         * Nothing free.  Take the least recently active station without
+         * pending tx frames, with preference to stations that are not
+         * associated.  The LRU lists hold them in that order.
+         */
+        for (list = 0; list < 2 && pVictimSib == NULL; list++) {
+            for (idx = halKeySlotLruFirst(pdevInfo, list); idx != HWINDEX_INVALID;
+                 idx = halKeySlotLruNext(pdevInfo, idx))
+            {
+                pSibtmp = keyCacheSib[idx];
+                if (idx >= MAX_SHARED_KEYS && idx < indexLimit &&
+                    !(skipShared && (idx & 0x1F) < MAX_SHARED_KEYS) &&
+                    pSibtmp->numTxPending <= 0 &&
+                    pSibtmp != pdevInfo->localSta)
                 {
-                     break;
-                }
-            }
-        } else if (pSibtmp->numTxPending <= 0 &&
-                   pSibtmp != pdevInfo->localSta)
-        {
-            /* Is there a race condition here?  The sib may wake up? */
-            if (pSibtmp->staState & (STATE_AUTH|STATE_ASSOC)) {
-                if (pSibtmp->staLastActivityTime < tsAssoc) {
-                    tsAssoc   = pSibtmp->staLastActivityTime;
-                    pAssocSib = pSibtmp;
-                }
-            } else {
-                if (pSibtmp->staLastActivityTime < tsFree) {
-                    tsFree   = pSibtmp->staLastActivityTime;
-                    pFreeSib = pSibtmp;
+                    /* Is there a race condition here?  The sib may wake up? */
+                    pVictimSib = pSibtmp;
+                    break;
                 }
             }
         }
@@ -709,19 +698,18 @@ ar5212KeyCacheAlloc(WLAN_DEV_INFO *pdevInfo, A_UINT16 hwIndex,
          */
         if (keyType == PRIV_KEY_TYPE_TKIP) {
                 ASSERT(hwIndex < (pdevInfo->keyCacheSize >> 2));
-                keyCacheSib[hwIndex + 32] = pSib;
-                keyCacheSib[hwIndex + 64] = pSib;
-                keyCacheSib[hwIndex + 32 + 64] = pSib;
+                halKeySlotSet(pdevInfo, hwIndex + 32, pSib);
+                halKeySlotSet(pdevInfo, hwIndex + 64, pSib);
+                halKeySlotSet(pdevInfo, hwIndex + 32 + 64, pSib);
         }
-        keyCacheSib[hwIndex] = pSib;
+        halKeySlotSet(pdevInfo, hwIndex, pSib);
+        halKeySlotTouch(pdevInfo, hwIndex);
         return (hwIndex);
     }
 
     /*
      * No easy key cache entry was found. We will steal an entry
      */
-    pVictimSib = pFreeSib ? pFreeSib : pAssocSib;
-
     if (pVictimSib == NULL) {
 #ifdef DEBUG
         if (keyDebugLevel > 0) {
@@ -771,11 +759,12 @@ ar5212KeyCacheAlloc(WLAN_DEV_INFO *pdevInfo, A_UINT16 hwIndex,
         ASSERT(keyCacheSib[hwIndex + 32] == NULL);
         ASSERT(keyCacheSib[hwIndex + 64] == NULL);
         ASSERT(keyCacheSib[hwIndex + 32 + 64] == NULL);
-        keyCacheSib[hwIndex + 32] = pSib;
-        keyCacheSib[hwIndex + 64] = pSib;
-        keyCacheSib[hwIndex + 32 + 64] = pSib;
+        halKeySlotSet(pdevInfo, hwIndex + 32, pSib);
+        halKeySlotSet(pdevInfo, hwIndex + 64, pSib);
+        halKeySlotSet(pdevInfo, hwIndex + 32 + 64, pSib);
     }
-    keyCacheSib[hwIndex] = pSib;
+    halKeySlotSet(pdevInfo, hwIndex, pSib);
+    halKeySlotTouch(pdevInfo, hwIndex);
 
     return hwIndex;
 }
@@ -788,7 +777,7 @@ ar5212KeyCacheFree(WLAN_DEV_INFO *pdevInfo, A_UINT16 hwIndex)
     ar5212KeyCacheInvalidate(pdevInfo, hwIndex);
     pSib = pdevInfo->keyCacheSib[hwIndex];
     ASSERT(pSib != NULL);
-    pdevInfo->keyCacheSib[hwIndex] = NULL;
+    halKeySlotSet(pdevInfo, hwIndex, NULL);
     if (pSib && pSib->decompMaskIndex == hwIndex) {
         pSib->decompMaskIndex = ar5212SetDecompMask(pdevInfo, hwIndex,
                                                     pdevInfo->keyCache[hwIndex],
@@ -831,17 +820,17 @@ ar5212KeyCacheInvalidate(WLAN_DEV_INFO *pdevInfo, A_UINT16 hwIndex)
      */
     if (hwIndex < (pdevInfo->keyCacheSize >> 2)) {
         if (pdevInfo->keyCacheSib[hwIndex + 32] == pSib) {
-            pdevInfo->keyCacheSib[hwIndex + 32] = NULL;
+            halKeySlotSet(pdevInfo, hwIndex + 32, NULL);
             pdevInfo->keyCache[hwIndex + 32]    = NULL;
             ar5212ResetKeyCacheEntry(pdevInfo, hwIndex + 32);
         }
         if (pdevInfo->keyCacheSib[hwIndex + 64] == pSib) {
-            pdevInfo->keyCacheSib[hwIndex + 64] = NULL;
+            halKeySlotSet(pdevInfo, hwIndex + 64, NULL);
             pdevInfo->keyCache[hwIndex + 64]    = NULL;
             ar5212ResetKeyCacheEntry(pdevInfo, hwIndex + 64);
         }
         if (pdevInfo->keyCacheSib[hwIndex + 32 + 64] == pSib) {
-            pdevInfo->keyCacheSib[hwIndex + 32 + 64] = NULL;
+            halKeySlotSet(pdevInfo, hwIndex + 32 + 64, NULL);
             pdevInfo->keyCache[hwIndex + 32 + 64]    = NULL;
             ar5212ResetKeyCacheEntry(pdevInfo, hwIndex + 32 + 64);
         }
@@ -17,8 +17,11 @@
 #include "hal.h"
 #include "ui.h"
 #include "halUtil.h"
+#include "halCalInterp.h"
 #include "halDevId.h"
 #include "vport.h"
+#include "halWriteList.h"
+#include "halResetProfile.h"
 
 /* Headers for HW private items */
 #include "ar5212Reg.h"
@@ -132,14 +135,6 @@ ar5212GetScaledPower(A_UINT16 channel, A_UINT16 pcdacValue, PCDACS_EEPROM *pSrcS
 static A_BOOL
 ar5212FindValueInList(A_UINT16 channel, A_UINT16 pcdacValue, PCDACS_EEPROM *pSrcStruct, A_UINT16 *powerValue);
 
-static A_UINT16
-ar5212GetInterpolatedValue(A_UINT16 target, A_UINT16 srcLeft, A_UINT16 srcRight,
-                           A_UINT16 targetLeft, A_UINT16 targetRight, A_BOOL scaleUp);
-
-static void
-ar5212GetLowerUpperValues(A_UINT16 value, A_UINT16 *pList, A_UINT16 listSize,
-                          A_UINT16 *pLowerValue, A_UINT16 *pUpperValue);
-
 static void
 ar5212GetLowerUpperPcdacs(A_UINT16 pcdac, A_UINT16 channel, PCDACS_EEPROM *pSrcStruct,
                     A_UINT16 *pLowerPcdac, A_UINT16 *pUpperPcdac);
@@ -232,49 +227,34 @@ const struct RfHalFuncs ar2413Funcs = {
 #define PLL_SETTLE_DELAY       300 //300 usec
 
 /*
- * Bug 10685, need to provide a registry based control for
- * the maximum number of registers that can be written to by
- * REG_WRITE_ARRAY and REG_WRITE_RF_ARRAY, without a 1 us delay
- * This is to provide some level of flexibility for only the ndis
- * drivers to better interoperate with out drivers, namely the
- * sound drivers.
- * Provided a new Registry entry writeBlockSize, defaults to 64
- * note, for the BUILD_AP this will always be 64.
- * Also this was only implemented for the AR5212 hal and not the
- * AR5211 hal.
+ * Init tables in the order the reset used to write them: the base
+ * tables followed by the radio specific set.  Folded into one address
+ * sorted write list per modesIndex at attach.  Pacing (bug 10685
+ * writeBlockSize, bug 6773) is applied by the write list engine.
  */
-#define REG_WRITE_ARRAY(regArray, column, regWar, writeBlockSize)           \
-{   int entries, r;                                                         \
-    udelay(1);                                                              \
-    entries = sizeof(regArray) / sizeof(*(regArray));                       \
-    for (r = 0; r < entries; r++) {                                         \
-        A_REG_WR(pDev, (regArray)[r][0], (regArray)[r][(column)]);          \
-        if ((++(regWar) % writeBlockSize) == 0) {                           \
-            udelay(1);                                                      \
-        }                                                                   \
-    }                                                                       \
-}
+static const HAL_WL_SOURCE ar5212IniSources2413[] = {
+    HAL_WL_SOURCE_INIT(ar5212Modes,          HAL_WL_COL_MODE,   0),
+    HAL_WL_SOURCE_INIT(ar5212Common,         HAL_WL_COL_COMMON, HAL_WL_KEEP_PCU),
+    HAL_WL_SOURCE_INIT(ar5212Modes_2413,     HAL_WL_COL_MODE,   0),
+    HAL_WL_SOURCE_INIT(ar5212Common_2413,    HAL_WL_COL_COMMON, 0),
+    HAL_WL_SOURCE_INIT(ar5212BB_RfGain_2413, HAL_WL_COL_FREQ,   0),
+};
 
-#define REG_WRITE_RF_ARRAY(regAddress, regData, regWar, writeBlockSize)     \
-{   int entries, r;                                                         \
-    udelay(1);                                                              \
-    entries = sizeof(regAddress) / sizeof(*(regAddress));                   \
-    for (r = 0; r < entries; r++) {                                         \
-        A_REG_WR(pDev, (regAddress)[r][0], (regData)[r]);                   \
-        if ((++(regWar) % writeBlockSize) == 0) {                           \
-            udelay(1);                                                      \
-        }                                                                   \
-    }                                                                       \
-}
+static const HAL_WL_SOURCE ar5212IniSources5112[] = {
+    HAL_WL_SOURCE_INIT(ar5212Modes,          HAL_WL_COL_MODE,   0),
+    HAL_WL_SOURCE_INIT(ar5212Common,         HAL_WL_COL_COMMON, HAL_WL_KEEP_PCU),
+    HAL_WL_SOURCE_INIT(ar5212Modes_5112,     HAL_WL_COL_MODE,   0),
+    HAL_WL_SOURCE_INIT(ar5212Common_5112,    HAL_WL_COL_COMMON, 0),
+    HAL_WL_SOURCE_INIT(ar5212BB_RfGain_5112, HAL_WL_COL_FREQ,   0),
+};
 
-/*
- * WAR for bug 6773.  udelay() does a PIO READ on the PCI bus which allows
- * other cards' DMA reads to complete in the middle of our reset.
- */
-#define WAR_6773(x)          \
-    if ((++(x) % 64) == 0) { \
-        udelay(1);           \
-    }
+static const HAL_WL_SOURCE ar5212IniSources5111[] = {
+    HAL_WL_SOURCE_INIT(ar5212Modes,          HAL_WL_COL_MODE,   0),
+    HAL_WL_SOURCE_INIT(ar5212Common,         HAL_WL_COL_COMMON, HAL_WL_KEEP_PCU),
+    HAL_WL_SOURCE_INIT(ar5212Modes_5111,     HAL_WL_COL_MODE,   0),
+    HAL_WL_SOURCE_INIT(ar5212Common_5111,    HAL_WL_COL_COMMON, 0),
+    HAL_WL_SOURCE_INIT(ar5212BB_RfGain_5111, HAL_WL_COL_FREQ,   0),
+};
 
 /**************************************************************
  * ar5212Reset
@@ -295,7 +275,6 @@ ar5212Reset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval,
     A_UINT32           reg, data, synthDelay;
     A_UINT16           rfXpdGain[4];
     A_STATUS           status;
-    A_UINT16           arrayEntries;
     A_INT16            powerLimit = MAX_RATE_POWER;
     A_INT16            cckOfdmPwrDelta = 0;
     A_UINT16           modesIndex = 0, freqIndex = 0;
@@ -304,13 +283,11 @@ ar5212Reset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval,
     A_BOOL             earHere;
     struct eepMap      *pEepData = pDev->pHalInfo->pEepData;
     WLAN_STA_CONFIG    *pCfg = &pDev->staConfig;
-    int                regWrites = 0;
     const RF_HAL_FUNCS *pRfHal = pDev->pHalInfo->pRfHal;
     A_UINT32           useMic;
     VPORT_BSS          *pVportBaseBss = GET_BASE_BSS(pDev);
     A_UINT32           testReg;
     A_STATUS           ret;
-    A_UINT32           writeBlockSize;
 
     ASSERT(((pChval->channelFlags & CHANNEL_2GHZ) || 0) ^
            ((pChval->channelFlags & CHANNEL_5GHZ) || 0));
@@ -372,7 +349,9 @@ ar5212Reset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval,
     /* Adjust gain parameters before reset if there's an outstanding gain update */
     ar5212GetRfgain(pDev);
 
+    HAL_RESET_PHASE_START(pDev, HAL_RESET_PHASE_CHIP_RESET);
     status = ar5212ChipReset(pDev, pChval);
+    HAL_RESET_PHASE_END(pDev, HAL_RESET_PHASE_CHIP_RESET);
     if (status != A_OK) {
         return status;
     }
@@ -417,38 +396,10 @@ ar5212Reset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval,
     /* Set correct Baseband to analog shift setting to access analog chips. */
     writePlatformReg(pDev, PHY_BASE, 0x00000007);
 
-#ifdef BUILD_AP
-    writeBlockSize = MAX_WRITEBLOCKSIZE;
-#else
-    writeBlockSize = pDev->staConfig.writeBlockSize;
-#endif
-
-    REG_WRITE_ARRAY(ar5212Modes, modesIndex, regWrites, writeBlockSize);
-    /* Write Common Array Parameters */
-    arrayEntries = sizeof(ar5212Common) / sizeof(*ar5212Common);
-    for (i = 0; i < arrayEntries; i++) {
-        reg = ar5212Common[i][0];
-
-        /* On channel change, don't reset the PCU registers */
-        if ( !(bChannelChange && (reg >= 0x8000 && reg < 0x9000)) ) {
-            /* TODO: Is this still needed here for 5212? */
-            A_REG_WR(pDev, reg, ar5212Common[i][1]);
-            WAR_6773(regWrites);
-        }
-    }
-    if (IS_2413(pDev)) {
-        REG_WRITE_ARRAY(ar5212Modes_2413, modesIndex, regWrites, writeBlockSize);
-        REG_WRITE_ARRAY(ar5212Common_2413, 1, regWrites, writeBlockSize);
-        REG_WRITE_ARRAY(ar5212BB_RfGain_2413, freqIndex, regWrites, writeBlockSize);
-    } else if (IS_5112(pDev)) {
-        REG_WRITE_ARRAY(ar5212Modes_5112, modesIndex, regWrites, writeBlockSize);
-        REG_WRITE_ARRAY(ar5212Common_5112, 1, regWrites, writeBlockSize);
-        REG_WRITE_ARRAY(ar5212BB_RfGain_5112, freqIndex, regWrites, writeBlockSize);
-    } else {
-        REG_WRITE_ARRAY(ar5212Modes_5111, modesIndex, regWrites, writeBlockSize);
-        REG_WRITE_ARRAY(ar5212Common_5111, 1, regWrites, writeBlockSize);
-        REG_WRITE_ARRAY(ar5212BB_RfGain_5111, freqIndex, regWrites, writeBlockSize);
-    }
+    /* Write the Modes, Common and RfGain init tables - on channel change, don't reset the PCU registers */
+    HAL_RESET_PHASE_START(pDev, HAL_RESET_PHASE_INI_WRITES);
+    halWriteListApply(pDev, pDev->pHalInfo->pIniWriteList[modesIndex], bChannelChange);
+    HAL_RESET_PHASE_END(pDev, HAL_RESET_PHASE_INI_WRITES);
 
     ar5212SetRateDurationTable(pDev, pChval);
 
@@ -513,12 +464,16 @@ ar5212Reset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval,
         powerLimit = A_MIN(pDev->bssDescr->tpcIe.pwrLimit, powerLimit);
     }
 
+    HAL_RESET_PHASE_START(pDev, HAL_RESET_PHASE_TX_POWER);
     if (ar5212SetTransmitPower(pDev, pChval, rfXpdGain, powerLimit, TRUE) != A_OK) {
         return A_ERROR;
     }
+    HAL_RESET_PHASE_END(pDev, HAL_RESET_PHASE_TX_POWER);
 
     /* Write the analog registers */
+    HAL_RESET_PHASE_START(pDev, HAL_RESET_PHASE_RF_BANKS);
     pRfHal->ar5212SetRfRegs(pDev, pEepData->pEepHeader, pChval, modesIndex, rfXpdGain);
+    HAL_RESET_PHASE_END(pDev, HAL_RESET_PHASE_RF_BANKS);
 
     /* Write delta slope for OFDM enabled modes (A, G, Turbo) */
     if (IS_CHAN_OFDM(pChval->channelFlags)) {
@@ -675,6 +630,7 @@ ar5212Reset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval,
 
     /* Activate the PHY (includes baseband activate and synthesizer on) */
     writePlatformReg(pDev, PHY_ACTIVE, PHY_ACTIVE_EN);
+    HAL_RESET_PHASE_START(pDev, HAL_RESET_PHASE_SYNTH_SETTLE);
 
     /*
      * There is an issue if the AP starts the calibration before the base
@@ -704,6 +660,7 @@ ar5212Reset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval,
     ASSERT(i < 20);                         /* ASSERT i limit is reached */
 
     A_REG_WR(pDev, PHY_TESTCTRL, testReg);
+    HAL_RESET_PHASE_END(pDev, HAL_RESET_PHASE_SYNTH_SETTLE);
 
     /* Should the Ear disable offset cal? */
     if (!(earHere && ar5212EarModify(pDev, EAR_LC_RESET_OFFSET, pChval, &modifier))) {
@@ -720,6 +677,7 @@ ar5212Reset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval,
      * -Cal is not necessary for CCK-only operation or scan-only channels
      * -Don't run cal if previous results exist (and no current request)
      */
+    HAL_RESET_PHASE_START(pDev, HAL_RESET_PHASE_IQ_CAL);
     if ((pCfg->calibrationTime != 0) && !IS_CHAN_B(pChval->channelFlags) &&
         !(pDev->pHalInfo->iqCalState == IQ_CAL_DONE) &&
         !(earHere && ar5212EarModify(pDev, EAR_LC_RESET_IQ, pChval, &modifier)))
@@ -731,6 +689,7 @@ ar5212Reset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval,
     } else {
         pDev->pHalInfo->iqCalState = IQ_CAL_INACTIVE;
     }
+    HAL_RESET_PHASE_END(pDev, HAL_RESET_PHASE_IQ_CAL);
 
     /* set up compression registers */
     ar5212SetCompRegs(pDev);
@@ -777,12 +736,14 @@ ar5212Reset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval,
     /* Should the Ear disable offset cal? */
     if (!(earHere && ar5212EarModify(pDev, EAR_LC_RESET_OFFSET, pChval, &modifier))) {
         /* At the end of reset - poll for a completed offset calibration */
+        HAL_RESET_PHASE_START(pDev, HAL_RESET_PHASE_NF_CAL);
         for (i = 0; i < 100; i++) {
             if ( (A_REG_RD(pDev, PHY_AGC_CONTROL) & PHY_AGC_CONTROL_CAL) == 0 ) {
                 break;
             }
             udelay(10);
         }
+        HAL_RESET_PHASE_END(pDev, HAL_RESET_PHASE_NF_CAL);
         if (i == 100) {
             uiPrintf("WARNING: ar5212Reset: offset calibration failed to complete in 1 ms - noisy environment?\n");
         }
@@ -1875,11 +1836,10 @@ ar5212SetRfRegs5111(WLAN_DEV_INFO *pDev, EEP_HEADER_INFO *pHeaderInfo,
     A_UINT16              tempDB    = 0;
     A_UINT32              modifier;
     HEADER_WMODE          arrayMode = 0;
-    int                   arrayEntries, i, regWrites = 0;
+    int                   arrayEntries, i;
     A_UINT32              ob2GHz = 0, db2GHz = 0;
     AR5212_RF_BANKS_5111  *pRfBanks = pDev->pHalInfo->pAnalogBanks;
     GAIN_VALUES           *pGainValues = pDev->pHalInfo->pGainValues;
-    A_UINT32              writeBlockSize;
 
     ASSERT(pRfBanks);
 
@@ -2005,19 +1965,13 @@ ar5212SetRfRegs5111(WLAN_DEV_INFO *pDev, EEP_HEADER_INFO *pHeaderInfo,
         ar5212EarModify(pDev, EAR_LC_RF_WRITE, pChval, &modifier);
     }
 
-#ifdef BUILD_AP
-    writeBlockSize = MAX_WRITEBLOCKSIZE;
-#else
-    writeBlockSize = pDev->staConfig.writeBlockSize;
-#endif
-
     /* Write Analog registers */
-    REG_WRITE_RF_ARRAY(ar5212Bank0_5111, pRfBanks->Bank0Data, regWrites, writeBlockSize);
-    REG_WRITE_RF_ARRAY(ar5212Bank1_5111, pRfBanks->Bank1Data, regWrites, writeBlockSize);
-    REG_WRITE_RF_ARRAY(ar5212Bank2_5111, pRfBanks->Bank2Data, regWrites, writeBlockSize);
-    REG_WRITE_RF_ARRAY(ar5212Bank3_5111, pRfBanks->Bank3Data, regWrites, writeBlockSize);
-    REG_WRITE_RF_ARRAY(ar5212Bank6_5111, pRfBanks->Bank6Data, regWrites, writeBlockSize);
-    REG_WRITE_RF_ARRAY(ar5212Bank7_5111, pRfBanks->Bank7Data, regWrites, writeBlockSize);
+    HAL_WL_WRITE_RF_ARRAY(pDev, ar5212Bank0_5111, pRfBanks->Bank0Data);
+    HAL_WL_WRITE_RF_ARRAY(pDev, ar5212Bank1_5111, pRfBanks->Bank1Data);
+    HAL_WL_WRITE_RF_ARRAY(pDev, ar5212Bank2_5111, pRfBanks->Bank2Data);
+    HAL_WL_WRITE_RF_ARRAY(pDev, ar5212Bank3_5111, pRfBanks->Bank3Data);
+    HAL_WL_WRITE_RF_ARRAY(pDev, ar5212Bank6_5111, pRfBanks->Bank6Data);
+    HAL_WL_WRITE_RF_ARRAY(pDev, ar5212Bank7_5111, pRfBanks->Bank7Data);
 
     /* Now that we have reprogrammed rfgain value, clear the flag. */
     pDev->pHalInfo->rfgainState = RFGAIN_INACTIVE;
@@ -2035,7 +1989,7 @@ static void
 ar5212SetRfRegs5112(WLAN_DEV_INFO *pDev, EEP_HEADER_INFO *pHeaderInfo,
                     CHAN_VALUES *pChval, A_UINT16 modesIndex, A_UINT16 *rfXpdGain)
 {
-    int                   arrayEntries, i, regWrites = 0;
+    int                   arrayEntries, i;
     A_UINT16              rfXpdSel, gainI;
     A_UINT16              ob5GHz = 0, db5GHz = 0;
     A_UINT16              ob2GHz = 0, db2GHz = 0;
@@ -2043,7 +1997,6 @@ ar5212SetRfRegs5112(WLAN_DEV_INFO *pDev, EEP_HEADER_INFO *pHeaderInfo,
     A_UINT32              modifier;
     AR5212_RF_BANKS_5112  *pRfBanks = pDev->pHalInfo->pAnalogBanks;
     GAIN_VALUES           *pGainValues = pDev->pHalInfo->pGainValues;
-    A_UINT32              writeBlockSize;
 
     ASSERT(pRfBanks);
 
@@ -2169,18 +2122,12 @@ ar5212SetRfRegs5112(WLAN_DEV_INFO *pDev, EEP_HEADER_INFO *pHeaderInfo,
         ar5212EarModify(pDev, EAR_LC_RF_WRITE, pChval, &modifier);
     }
 
-#ifdef BUILD_AP
-    writeBlockSize = MAX_WRITEBLOCKSIZE;
-#else
-    writeBlockSize = pDev->staConfig.writeBlockSize;
-#endif
-
     /* Write Analog registers */
-    REG_WRITE_RF_ARRAY(ar5212Bank1_5112, pRfBanks->Bank1Data, regWrites, writeBlockSize);
-    REG_WRITE_RF_ARRAY(ar5212Bank2_5112, pRfBanks->Bank2Data, regWrites, writeBlockSize);
-    REG_WRITE_RF_ARRAY(ar5212Bank3_5112, pRfBanks->Bank3Data, regWrites, writeBlockSize);
-    REG_WRITE_RF_ARRAY(ar5212Bank6_5112, pRfBanks->Bank6Data, regWrites, writeBlockSize);
-    REG_WRITE_RF_ARRAY(ar5212Bank7_5112, pRfBanks->Bank7Data, regWrites, writeBlockSize);
+    HAL_WL_WRITE_RF_ARRAY(pDev, ar5212Bank1_5112, pRfBanks->Bank1Data);
+    HAL_WL_WRITE_RF_ARRAY(pDev, ar5212Bank2_5112, pRfBanks->Bank2Data);
+    HAL_WL_WRITE_RF_ARRAY(pDev, ar5212Bank3_5112, pRfBanks->Bank3Data);
+    HAL_WL_WRITE_RF_ARRAY(pDev, ar5212Bank6_5112, pRfBanks->Bank6Data);
+    HAL_WL_WRITE_RF_ARRAY(pDev, ar5212Bank7_5112, pRfBanks->Bank7Data);
 
     /* Now that we have reprogrammed rfgain value, clear the flag. */
     pDev->pHalInfo->rfgainState = RFGAIN_INACTIVE;
@@ -2197,11 +2144,10 @@ static void
 ar5212SetRfRegs2413(WLAN_DEV_INFO *pDev, EEP_HEADER_INFO *pHeaderInfo,
                     CHAN_VALUES *pChval, A_UINT16 modesIndex, A_UINT16 *rfXpdGain)
 {
-    int                   arrayEntries, i, regWrites = 0;
+    int                   arrayEntries, i;
     HEADER_WMODE          arrayMode = 0;
     A_UINT32              modifier;
     AR5212_RF_BANKS_2413  *pRfBanks = pDev->pHalInfo->pAnalogBanks;
-    A_UINT32              writeBlockSize;
     A_UINT16              ob2GHz = 0, db2GHz = 0;
 
     ASSERT(pRfBanks);
@@ -2263,18 +2209,12 @@ ar5212SetRfRegs2413(WLAN_DEV_INFO *pDev, EEP_HEADER_INFO *pHeaderInfo,
         ar5212EarModify(pDev, EAR_LC_RF_WRITE, pChval, &modifier);
     }
 
-#ifdef BUILD_AP
-    writeBlockSize = MAX_WRITEBLOCKSIZE;
-#else
-    writeBlockSize = pDev->staConfig.writeBlockSize;
-#endif
-
     /* Write Analog registers */
-    REG_WRITE_RF_ARRAY(ar5212Bank1_2413, pRfBanks->Bank1Data, regWrites, writeBlockSize);
-    REG_WRITE_RF_ARRAY(ar5212Bank2_2413, pRfBanks->Bank2Data, regWrites, writeBlockSize);
-    REG_WRITE_RF_ARRAY(ar5212Bank3_2413, pRfBanks->Bank3Data, regWrites, writeBlockSize);
-    REG_WRITE_RF_ARRAY(ar5212Bank6_2413, pRfBanks->Bank6Data, regWrites, writeBlockSize);
-    REG_WRITE_RF_ARRAY(ar5212Bank7_2413, pRfBanks->Bank7Data, regWrites, writeBlockSize);
+    HAL_WL_WRITE_RF_ARRAY(pDev, ar5212Bank1_2413, pRfBanks->Bank1Data);
+    HAL_WL_WRITE_RF_ARRAY(pDev, ar5212Bank2_2413, pRfBanks->Bank2Data);
+    HAL_WL_WRITE_RF_ARRAY(pDev, ar5212Bank3_2413, pRfBanks->Bank3Data);
+    HAL_WL_WRITE_RF_ARRAY(pDev, ar5212Bank6_2413, pRfBanks->Bank6Data);
+    HAL_WL_WRITE_RF_ARRAY(pDev, ar5212Bank7_2413, pRfBanks->Bank7Data);
 
     /* Now that we have reprogrammed rfgain value, clear the flag. */
     pDev->pHalInfo->rfgainState = RFGAIN_INACTIVE;
@@ -2396,6 +2336,53 @@ ar5212FreeRfBanks(WLAN_DEV_INFO *pDev, HAL_INFO *pHalInfo)
     }
 }
 
+/**************************************************************
+ * ar5212AllocateIniWriteLists
+ *
+ * Compile the init tables into one write list per modesIndex.
+ * Needs the mac and analog revisions to pick the radio table set.
+ */
+A_STATUS
+ar5212AllocateIniWriteLists(WLAN_DEV_INFO *pDev, HAL_INFO *pHalInfo)
+{
+    const HAL_WL_SOURCE *pSrc;
+    A_UINT16            modesIndex;
+    A_STATUS            status;
+
+    if (IS_2413(pDev)) {
+        pSrc = ar5212IniSources2413;
+    } else if (IS_5112(pDev)) {
+        pSrc = ar5212IniSources5112;
+    } else {
+        pSrc = ar5212IniSources5111;
+    }
+
+    /* modesIndex 1, 2 are 5 GHz (freqIndex 1), 3 - 5 are 2.4 GHz (freqIndex 2) */
+    for (modesIndex = 1; modesIndex < HAL_WL_NUM_MODES; modesIndex++) {
+        status = halWriteListCompile(&pHalInfo->pIniWriteList[modesIndex], pSrc,
+                                     sizeof(ar5212IniSources5111) / sizeof(ar5212IniSources5111[0]),
+                                     modesIndex, (modesIndex <= 2) ? 1 : 2);
+        if (status != A_OK) {
+            ar5212FreeIniWriteLists(pDev, pHalInfo);
+            return status;
+        }
+    }
+    return A_OK;
+}
+
+/**************************************************************
+ * ar5212FreeIniWriteLists
+ */
+void
+ar5212FreeIniWriteLists(WLAN_DEV_INFO *pDev, HAL_INFO *pHalInfo)
+{
+    int i;
+
+    for (i = 0; i < HAL_WL_NUM_MODES; i++) {
+        halWriteListFree(&pHalInfo->pIniWriteList[i]);
+    }
+}
+
 #define NO_FALSE_DETECT_BACKOFF   2
 #define CB22_FALSE_DETECT_BACKOFF 6
 /**************************************************************
@@ -2923,7 +2910,7 @@ ar5212SetPowerTable5111(WLAN_DEV_INFO *pDev, A_UINT16 *pPcdacTable, A_INT16 *pPo
             i++;
         }
         /* scale by 2 and add 1 to enable round up or down as needed */
-        scaledPcdac = (A_UINT16)(ar5212GetInterpolatedValue(pwr, pScaledUpDbm[i],
+        scaledPcdac = (A_UINT16)(halCalInterpolate(pwr, pScaledUpDbm[i],
                                  pScaledUpDbm[i + 1], (A_UINT16)(pPcdacValues[i] * 2),
                                  (A_UINT16)(pPcdacValues[i + 1] * 2), 0 ) + 1);
 
@@ -2949,66 +2936,6 @@ ar5212SetPowerTable5111(WLAN_DEV_INFO *pDev, A_UINT16 *pPcdacTable, A_INT16 *pPo
  * direct from DK code below to better merge with current similar functions
  * and stylize the Atheros SW way
  */
-A_INT16
-GetInterpolatedValue_Signed16(A_UINT16 target, A_UINT16 srcLeft, A_UINT16 srcRight,
-                             A_INT16 targetLeft, A_INT16 targetRight)
-{
-  A_INT16 returnValue;
-
-  if (srcRight != srcLeft) {
-        returnValue = (A_INT16)( ( (target - srcLeft)*targetRight + (srcRight - target)*targetLeft)/(srcRight - srcLeft));
-  }
-  else {
-        returnValue = targetLeft;
-  }
-  return (returnValue);
-}
-
-/* returns indices surrounding the value in sorted integer lists. used for channel and pcdac lists */
-static void
-GetLowerUpperIndex(A_INT16 value, A_UINT16 *pList, A_UINT16 listSize, A_UINT32 *pLowerValue,
-                    A_UINT32 *pUpperValue)
-{
-	A_UINT16	i;
-	A_INT16	listEndValue = *(pList + listSize - 1);
-	A_INT16	target = value ;
-
-	//see if value is lower than the first value in the list
-	//if so return first value
-	if (target <= (*pList)) {
-		*pLowerValue = 0;
-		*pUpperValue = 0;
-		return;
-	}
-  
-	//see if value is greater than last value in list
-	//if so return last value
-	if (target >= listEndValue) {
-		*pLowerValue = listSize - 1;
-		*pUpperValue = listSize - 1;
-		return;
-	}
-
-	//look for value being near or between 2 values in list
-	for(i = 0; i < listSize; i++) {
-		//if value is close to the current value of the list 
-		//then target is not between values, it is one of the values
-		if (pList[i] == target) {
-			*pLowerValue = i;
-			*pUpperValue = i;
-			return;
-		}
-
-		//look for value being between current value and next value
-		//if so return these 2 values
-		if (target < pList[i + 1]) {
-			*pLowerValue = i;
-			*pUpperValue = i + 1;
-			return;
-		}
-	}
-} 
-
 A_BOOL
 getFullPwrTable(A_UINT16 numPcdacs, A_UINT16 *pcdacs, A_INT16 *power, A_INT16 maxPower, A_INT16 *retVals)
 {
@@ -3026,7 +2953,7 @@ getFullPwrTable(A_UINT16 numPcdacs, A_UINT16 *pcdacs, A_INT16 *power, A_INT16 ma
             idxL++;
             idxR++;
         }
-        retVals[ii] = GetInterpolatedValue_Signed16(ii, pcdacs[idxL], pcdacs[idxR], power[idxL], power[idxR]);
+        retVals[ii] = halCalInterpolateSigned16(ii, pcdacs[idxL], pcdacs[idxR], power[idxL], power[idxR]);
         if (retVals[ii] >= maxPower) {
             while (ii<64) {
                 retVals[ii++] = maxPower;
@@ -3227,7 +3154,7 @@ ar5212SetPowerTable5112(WLAN_DEV_INFO *pDev, A_UINT16 *pPcdacTable, A_INT16 *pPo
         }
     }
 
-    GetLowerUpperIndex(pChval->channel, &(pPowerExpn->pChannels[0]), pPowerExpn->numChannels, &(chan_idx_L), &(chan_idx_R));
+    halCalGetLowerUpperIndex(pChval->channel, &(pPowerExpn->pChannels[0]), pPowerExpn->numChannels, &(chan_idx_L), &(chan_idx_R));
 
     kk = 0;
     for (ii=chan_idx_L; ii<=chan_idx_R; ii++) {
@@ -3275,9 +3202,7 @@ ar5212SetPowerTable5112(WLAN_DEV_INFO *pDev, A_UINT16 *pPcdacTable, A_INT16 *pPo
     kk = chan_idx_R - chan_idx_L;
 
     if (xgainList[1] == 0xDEAD) {
-        for (jj = 0; jj < 64; jj++) {
-            pwr_table0[jj] = GetInterpolatedValue_Signed16(pChval->channel, chan_L, chan_R, powTableLXPD[0][jj], powTableLXPD[kk][jj]);
-        }
+        halCalInterpolateVector(pChval->channel, chan_L, chan_R, powTableLXPD[0], powTableLXPD[kk], pwr_table0, 64);
         Pmin = getPminAndPcdacTableFromPowerTable(&(pwr_table0[0]), pPcdacTable);
         *pPowerMin = (A_INT16) (Pmin / 2);
         *pPowerMid = (A_INT16) (pwr_table0[63] / 2);
@@ -3285,10 +3210,8 @@ ar5212SetPowerTable5112(WLAN_DEV_INFO *pDev, A_UINT16 *pPcdacTable, A_INT16 *pPo
         rfXpdGain[0] = xgainList[0];
         rfXpdGain[1] = rfXpdGain[0];
     } else {
-        for (jj = 0; jj < 64; jj++) {
-            pwr_table0[jj] = GetInterpolatedValue_Signed16(pChval->channel, chan_L, chan_R, powTableLXPD[0][jj], powTableLXPD[kk][jj]);
-            pwr_table1[jj] = GetInterpolatedValue_Signed16(pChval->channel, chan_L, chan_R, powTableHXPD[0][jj], powTableHXPD[kk][jj]);
-        }
+        halCalInterpolateVector(pChval->channel, chan_L, chan_R, powTableLXPD[0], powTableLXPD[kk], pwr_table0, 64);
+        halCalInterpolateVector(pChval->channel, chan_L, chan_R, powTableHXPD[0], powTableHXPD[kk], pwr_table1, 64);
         if (numXpdGain == 2) {
             Pmin = getPminAndPcdacTableFromTwoPowerTables(&(pwr_table0[0]), &(pwr_table1[0]), pPcdacTable, &Pmid);
             *pPowerMin = (A_INT16) (Pmin / 2);
@@ -3343,7 +3266,7 @@ ar2413FillVpdTable(A_UINT32 pdGainIdx, A_INT16 Pmin, A_INT16  Pmax, A_INT16 *pwr
     }
 
     while (ii <= (A_UINT16)(Pmax - Pmin)) {
-        GetLowerUpperIndex(currPwr, pwrList, numIntercepts, &(idxL), &(idxR));
+        halCalGetLowerUpperIndex(currPwr, pwrList, numIntercepts, &(idxL), &(idxR));
         if (idxR < 1) {
             idxR = 1; // extrapolate below
         }
@@ -3390,7 +3313,7 @@ ar2413getGainBoundariesAndPdadcsForPowers(WLAN_DEV_INFO *pDev, A_UINT16 channel,
     A_UINT32  sizeCurrVpdTable, maxIndex, tgtIndex;
     
     /* Get upper lower index */
-    GetLowerUpperIndex(channel, pRawDataset->pChannels, pRawDataset->numChannels, &(idxL), &(idxR));
+    halCalGetLowerUpperIndex(channel, pRawDataset->pChannels, pRawDataset->numChannels, &(idxL), &(idxR));
 
     for (ii = 0; ii < MAX_NUM_PDGAINS_PER_CHANNEL; ii++) {
         jj = MAX_NUM_PDGAINS_PER_CHANNEL - ii - 1; // work backwards 'cause highest pdGain for lowest power
@@ -3414,7 +3337,7 @@ ar2413getGainBoundariesAndPdadcsForPowers(WLAN_DEV_INFO *pDev, A_UINT16 channel,
             ar2413FillVpdTable(numPdGainsUsed, Pmin_t2[numPdGainsUsed], Pmax_t2[numPdGainsUsed], &(pRawDataset->pDataPerChannel[idxR].pDataPerPDGain[jj].pwr_t4[0]),
                            &(pRawDataset->pDataPerChannel[idxR].pDataPerPDGain[jj].Vpd[0]), numVpd, VpdTable_R);
             for (kk = 0; kk < (A_UINT16)(Pmax_t2[numPdGainsUsed] - Pmin_t2[numPdGainsUsed]); kk++) {
-                VpdTable_I[numPdGainsUsed][kk] = GetInterpolatedValue_Signed16(channel, pRawDataset->pChannels[idxL], pRawDataset->pChannels[idxR],
+                VpdTable_I[numPdGainsUsed][kk] = halCalInterpolateSigned16(channel, pRawDataset->pChannels[idxL], pRawDataset->pChannels[idxR],
                                                             (A_INT16)VpdTable_L[numPdGainsUsed][kk], (A_INT16)VpdTable_R[numPdGainsUsed][kk]);
             } // fill VpdTable_I for this pdGain
             numPdGainsUsed++;
@@ -3884,7 +3807,7 @@ ar5212GetMaxEdgePower(A_UINT16 channel, RD_EDGES_POWER *pRdEdgesPower)
     }
     numEdges = i;
 
-    ar5212GetLowerUpperValues(channel, tempChannelList, numEdges, &lowerChannel, &upperChannel);
+    halCalGetLowerUpperValues(channel, tempChannelList, numEdges, &lowerChannel, &upperChannel);
     /* Get the index for the lower channel */
     for (i = 0; i < numEdges; i++) {
         if (lowerChannel == tempChannelList[i]) {
@@ -3927,7 +3850,7 @@ ar5212GetTargetPowers(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval, TRGT_POWER_INFO
         tempChannelList[i] = pPowerInfo[i].testChannel;
     }
 
-    ar5212GetLowerUpperValues(pChval->channel, tempChannelList, numChannels, &lowerChannel, &upperChannel);
+    halCalGetLowerUpperValues(pChval->channel, tempChannelList, numChannels, &lowerChannel, &upperChannel);
 
     /* Get the index for the channel */
     for (i = 0; i < numChannels; i++) {
@@ -3943,19 +3866,19 @@ ar5212GetTargetPowers(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval, TRGT_POWER_INFO
     /* Get the lower and upper channels target powers and interpolate between them */
     lowerPower = pPowerInfo[lowerIndex].twicePwr6_24;
     upperPower = pPowerInfo[upperIndex].twicePwr6_24;
-    pNewPower->twicePwr6_24 = ar5212GetInterpolatedValue(pChval->channel, lowerChannel,
+    pNewPower->twicePwr6_24 = halCalInterpolate(pChval->channel, lowerChannel,
         upperChannel, lowerPower, upperPower, 0);
     lowerPower = pPowerInfo[lowerIndex].twicePwr36;
     upperPower = pPowerInfo[upperIndex].twicePwr36;
-    pNewPower->twicePwr36 = ar5212GetInterpolatedValue(pChval->channel, lowerChannel,
+    pNewPower->twicePwr36 = halCalInterpolate(pChval->channel, lowerChannel,
         upperChannel, lowerPower, upperPower, 0);
     lowerPower = pPowerInfo[lowerIndex].twicePwr48;
     upperPower = pPowerInfo[upperIndex].twicePwr48;
-    pNewPower->twicePwr48 = ar5212GetInterpolatedValue(pChval->channel, lowerChannel,
+    pNewPower->twicePwr48 = halCalInterpolate(pChval->channel, lowerChannel,
         upperChannel, lowerPower, upperPower, 0);
     lowerPower = pPowerInfo[lowerIndex].twicePwr54;
     upperPower = pPowerInfo[upperIndex].twicePwr54;
-    pNewPower->twicePwr54 = ar5212GetInterpolatedValue(pChval->channel, lowerChannel,
+    pNewPower->twicePwr54 = halCalInterpolate(pChval->channel, lowerChannel,
         upperChannel, lowerPower, upperPower, 0);
 }
 
@@ -3979,7 +3902,7 @@ ar5212GetScaledPower(A_UINT16 channel, A_UINT16 pcdacValue, PCDACS_EEPROM *pSrcS
         return powerValue;
     }
 
-    ar5212GetLowerUpperValues(channel, pSrcStruct->pChannelList,
+    halCalGetLowerUpperValues(channel, pSrcStruct->pChannelList,
                               pSrcStruct->numChannels, &lFreq, &rFreq);
     ar5212GetLowerUpperPcdacs(pcdacValue, lFreq, pSrcStruct, &llPcdac, &ulPcdac);
     ar5212GetLowerUpperPcdacs(pcdacValue, rFreq, pSrcStruct, &lrPcdac, &urPcdac);
@@ -3987,158 +3910,49 @@ ar5212GetScaledPower(A_UINT16 channel, A_UINT16 pcdacValue, PCDACS_EEPROM *pSrcS
     /* get the power index for the pcdac value */
     ar5212FindValueInList(lFreq, llPcdac, pSrcStruct, &lPwr);
     ar5212FindValueInList(lFreq, ulPcdac, pSrcStruct, &uPwr);
-    lScaledPwr = ar5212GetInterpolatedValue(pcdacValue, llPcdac, ulPcdac,
-                                            lPwr, uPwr, 0);
+    lScaledPwr = halCalInterpolate(pcdacValue, llPcdac, ulPcdac,
+                                   lPwr, uPwr, 0);
 
     ar5212FindValueInList(rFreq, lrPcdac, pSrcStruct, &lPwr);
     ar5212FindValueInList(rFreq, urPcdac, pSrcStruct, &uPwr);
-    rScaledPwr = ar5212GetInterpolatedValue(pcdacValue, lrPcdac, urPcdac,
-                                            lPwr, uPwr, 0);
+    rScaledPwr = halCalInterpolate(pcdacValue, lrPcdac, urPcdac,
+                                   lPwr, uPwr, 0);
 
-    return ar5212GetInterpolatedValue(channel, lFreq, rFreq,
-                                      (A_UINT16)lScaledPwr,
-                                      (A_UINT16)rScaledPwr, 0);
+    return halCalInterpolate(channel, lFreq, rFreq,
+                             (A_UINT16)lScaledPwr,
+                             (A_UINT16)rScaledPwr, 0);
 }
 
 /**************************************************************
  * ar5212FindValueInList
  *
- * Find the value from the calibrated source data struct
+ * Find the value from the calibrated source data struct.  The
+ * channel and PCDAC lists are ascending, as
+ * halCalGetLowerUpperValues also requires of them, and
+ * pDataPerChannel[i] holds the data for pChannelList[i]: the
+ * EEPROM reader (ar5212Attach.c) fills both from the same list.
  */
 A_BOOL
 ar5212FindValueInList(A_UINT16 channel, A_UINT16 pcdacValue, PCDACS_EEPROM *pSrcStruct, A_UINT16 *powerValue)
 {
     DATA_PER_CHANNEL    *pChannelData;
-    A_UINT16            *pPcdac;
     A_UINT16            i, j;
 
-    pChannelData = pSrcStruct->pDataPerChannel;
-    for (i = 0; i < pSrcStruct->numChannels; i++ ) {
-        if (pChannelData->channelValue == channel) {
-            pPcdac = pChannelData->PcdacValues;
-            for (j = 0; j < pChannelData->numPcdacValues; j++ ) {
-                if (*pPcdac == pcdacValue) {
-                    *powerValue = pChannelData->PwrValues[j];
-                    return TRUE;
-                }
-                pPcdac++;
-            }
-        }
-        pChannelData++;
-    }
-    return FALSE;
-}
-
-/**************************************************************
- * ar5212GetInterpolatedValue
- *
- * Returns interpolated or the scaled up interpolated value
- */
-A_UINT16
-ar5212GetInterpolatedValue(A_UINT16 target, A_UINT16 srcLeft, A_UINT16 srcRight,
-                           A_UINT16 targetLeft, A_UINT16 targetRight, A_BOOL scaleUp)
-{
-    A_UINT16 returnValue;
-    A_INT16 lRatio;
-    A_UINT16 scaleValue = EEP_SCALE;
-
-    /*
-     * To get an accurate ratio, always scale, If we want to scale, then
-     * don't scale back down.
-     */
-    if ((targetLeft * targetRight) == 0) {
-        return 0;
-    }
-
-    if (scaleUp) {
-        scaleValue = 1;
-    }
-
-    if (srcRight != srcLeft) {
-        /* note the ratio always need to be scaled, since it will be a fraction */
-        lRatio = ((target - srcLeft) * EEP_SCALE / (srcRight - srcLeft));
-        if (lRatio < 0) {
-            /* Return as Left target if value would be negative */
-            returnValue = targetLeft * (scaleUp ? EEP_SCALE : 1);
-        } else if (lRatio > EEP_SCALE) {
-            /* Return as Right target if Ratio is greater than 100% (SCALE) */
-            returnValue = targetRight * (scaleUp ? EEP_SCALE : 1);
-        } else {
-            returnValue = ((lRatio * targetRight + (EEP_SCALE - lRatio) *
-                           targetLeft) / scaleValue);
-        }
-    } else {
-        returnValue = targetLeft * (scaleUp ? EEP_SCALE : 1);
-    }
-
-    return returnValue;
-}
-
-/**************************************************************
- * ar5212GetLowerUpperValues
- *
- *  Look for value being within 0.1 of the search values
- *  however, NDIS can't do float calculations, so multiply everything
- *  up by EEP_SCALE so can do integer arithmatic
- *
- * INPUT  value       -value to search for
- * INPUT  pList       -ptr to the list to search
- * INPUT  listSize    -number of entries in list
- * OUTPUT pLowerValue -return the lower value
- * OUTPUT pUpperValue -return the upper value
- *
- * WARNING: This input list should be filled and in ascending order
- */
-void
-ar5212GetLowerUpperValues(A_UINT16 value, A_UINT16 *pList, A_UINT16 listSize,
-                          A_UINT16 *pLowerValue, A_UINT16 *pUpperValue)
-{
-    A_UINT16    i;
-    A_UINT16    listEndValue = *(pList + listSize - 1);
-    A_UINT32    target       = value * EEP_SCALE;
-
-    /*
-     * See if value is lower than the first value in the list
-     * if so return first value
-     */
-    if (target < (A_UINT32)(*pList * EEP_SCALE - EEP_DELTA)) {
-        *pLowerValue = *pList;
-        *pUpperValue = *pList;
-        return;
-    }
-
-    /*
-     * See if value is greater than last value in list
-     * if so return last value
-     */
-    if (target > (A_UINT32)(listEndValue * EEP_SCALE + EEP_DELTA)) {
-        *pLowerValue = listEndValue;
-        *pUpperValue = listEndValue;
-        return;
-    }
-
-    /* look for value being near or between 2 values in list */
-    for (i = 0; i < listSize; i++) {
-        /*
-         * If value is close to the current value of the list
-         * then target is not between values, it is one of the values
-         */
-        if (A_ABS(pList[i] * EEP_SCALE - (A_INT32)target) < EEP_DELTA) {
-            *pLowerValue = pList[i];
-            *pUpperValue = pList[i];
-            return;
+    i = halCalFindIndex(channel, pSrcStruct->pChannelList, pSrcStruct->numChannels);
+    ASSERT(i == pSrcStruct->numChannels ||
+           pSrcStruct->pDataPerChannel[i].channelValue == channel);
+    for (; i < pSrcStruct->numChannels; i++) {
+        pChannelData = &pSrcStruct->pDataPerChannel[i];
+        if (pChannelData->channelValue != channel) {
+            break;
         }
-
-        /*
-         * Look for value being between current value and next value
-         * if so return these 2 values
-         */
-        if (target < (A_UINT32)(pList[i + 1] * EEP_SCALE - EEP_DELTA)) {
-            *pLowerValue = pList[i];
-            *pUpperValue = pList[i + 1];
-            return;
+        j = halCalFindIndex(pcdacValue, pChannelData->PcdacValues, pChannelData->numPcdacValues);
+        if (j < pChannelData->numPcdacValues) {
+            *powerValue = pChannelData->PwrValues[j];
+            return TRUE;
         }
     }
+    return FALSE;
 }
 
 /**************************************************************
@@ -4163,7 +3977,7 @@ ar5212GetLowerUpperPcdacs(A_UINT16 pcdac, A_UINT16 channel, PCDACS_EEPROM *pSrcS
         pChannelData++;
     }
 
-    ar5212GetLowerUpperValues(pcdac, pChannelData->PcdacValues,
+    halCalGetLowerUpperValues(pcdac, pChannelData->PcdacValues,
                               pChannelData->numPcdacValues,
                               pLowerPcdac, pUpperPcdac);
 }
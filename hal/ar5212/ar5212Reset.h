@@ -43,6 +43,12 @@ ar5212AllocateRfBanks(WLAN_DEV_INFO *pDev, HAL_INFO *pHalInfo);
 void
 ar5212FreeRfBanks(WLAN_DEV_INFO *pDev, HAL_INFO *pHalInfo);
 
+A_STATUS
+ar5212AllocateIniWriteLists(WLAN_DEV_INFO *pDev, HAL_INFO *pHalInfo);
+
+void
+ar5212FreeIniWriteLists(WLAN_DEV_INFO *pDev, HAL_INFO *pHalInfo);
+
 void
 ar5212SetTxPowerLimit(WLAN_DEV_INFO *pDev, A_UINT32 limit);
 
@@ -19,6 +19,16 @@
 #include "ui.h"
 #include "halUtil.h"
 #include "halDevId.h"
+#include "halWriteList.h"
+#ifdef HAL_REG_CACHE
+#include "halRegCache.h"
+#endif
+#ifdef HAL_RESET_RECIPE
+#include "halResetRecipe.h"
+#endif
+#ifdef HAL_TXPOWER_CACHE
+#include "halTxPowerCache.h"
+#endif
 
 /* Headers for HW private items */
 #include "ar5513/ar5513MacReg.h"
@@ -54,13 +64,20 @@ static A_STATUS
 ar5513VerifyEepromChecksum(A_UINT16 *pRawEeprom, A_UINT32 eepEndLoc);
 
 static A_STATUS
-ar5513AllocateProm(EEP_MAP *pEepMap, A_UINT8 chainCnt);
+ar5513AllocateEepArena(HAL_INFO *pInfo, A_UINT8 chainCnt, A_UINT8 expnModes, A_UINT32 earSize);
+
+static void
+ar5513FreeEepArena(HAL_INFO *pInfo);
+
+static A_STATUS
+ar5513AllocateProm(HAL_INFO *pInfo, EEP_MAP *pEepMap, A_UINT8 chainCnt);
 
 static A_STATUS
-ar5513ReadEepromIntoDataset(WLAN_DEV_INFO *pDev, A_UINT16 *pRawEeprom, A_UINT8 chnIdx);
+ar5513ReadEepromIntoDataset(WLAN_DEV_INFO *pDev, A_UINT16 *pRawEeprom, A_UINT8 chnIdx, A_UINT8 expnModes);
 
 static void
-ar5513ReadHeaderInfo(WLAN_DEV_INFO *pDev, EEP_HEADER_INFO *pHeaderInfo, A_UINT16 *pRawEeprom);
+ar5513ReadHeaderInfo(WLAN_DEV_INFO *pDev, A_UINT16 version, EEP_HEADER_INFO *pHeaderInfo,
+                     A_UINT16 *pRawEeprom);
 
 static void
 getPcdacInterceptsFromPcdacMinMax(A_UINT16 version, A_UINT16 pcdacMin,
@@ -72,15 +89,35 @@ fbin2freq(A_UINT16 version, A_UINT16 fbin, A_BOOL is2GHz);
 static int
 ar5513EarPreParse(A_UINT16 *in, int numLocs, EAR_ALLOC *earAlloc);
 
+static A_UINT32
+ar5513EarSize(EAR_ALLOC *earAlloc);
+
 static A_BOOL
-ar5513EarAllocate(EAR_ALLOC *earAlloc, EAR_HEADER **ppEarHead);
+ar5513EarAllocate(HAL_INFO *pInfo, EAR_ALLOC *earAlloc, EAR_HEADER **ppEarHead);
 
 static A_BOOL
 ar5513EarCheckAndFill(EAR_HEADER *earHead, A_UINT16 *in, int totalLocs, EAR_ALLOC *pEarAlloc);
 
+static A_STATUS
+ar5513EarCompile(HAL_INFO *pInfo);
+
+static A_BOOL
+ar5513IsChannelInEarRegHead(A_UINT16 earChannel, A_UINT16 channelMhz);
+
 static A_UINT16
 ar5513ReadRadioChipRev(WLAN_DEV_INFO *pDev, A_UINT16 chain_base);
 
+#ifdef HAL_CAL_IMAGE
+static A_STATUS
+ar5513CheckCalImage(WLAN_DEV_INFO *pDev, A_UINT16 eepVersion, A_UINT32 eepEndLoc, A_UINT8 chainCnt);
+
+static A_STATUS
+ar5513LoadCalImage(WLAN_DEV_INFO *pDev, A_UINT16 eepVersion, A_UINT8 chainCnt);
+
+static A_STATUS
+ar5513BuildCalImage(WLAN_DEV_INFO *pDev, A_UINT32 eepEndLoc, A_UINT8 chainCnt);
+#endif
+
 #ifdef DEBUG
 static void
 printEar(EAR_HEADER *earHead, EAR_ALLOC *earAlloc);
@@ -102,6 +139,8 @@ static const HW_FUNCS ar5513Funcs = {
     ar5513PhyDisable,
     ar5513Disable,
     ar5513PerCalibration,
+    ar5513StartCalibration,
+    ar5513CalibrationStatus,
     ar5513GetRfgain,
     ar5513SetTxPowerLimit,
 
@@ -191,6 +230,7 @@ static const HW_FUNCS ar5513Funcs = {
     ar5513ReserveHalKeyCacheEntries,
     ar5513ResetKeyCacheEntry,
     ar5513SetKeyCacheEntry,
+    ar5513SetKeyCacheEntries,
     ar5513KeyCacheAlloc,
     ar5513KeyCacheFree,
 
@@ -218,6 +258,60 @@ static const HW_FUNCS ar5513Funcs = {
 static const A_UINT16 channels11b[] = {2412, 2447, 2484};
 static const A_UINT16 channels11g[] = {2312, 2412, 2484};
 
+#ifdef HAL_REG_CACHE
+/*
+ * Shadow register cache attributes.  Only registers that hold what
+ * was last written to them are cacheable; status, counters, TSF,
+ * the key cache, self-clearing command bits (AGC_CONTROL, TIMING_CTRL4)
+ * and the analog shift registers are left volatile.  The chain 1
+ * baseband block mirrors chain 0 and writes to CHN_ALL_BASE land in both.
+ */
+static const HAL_REG_CACHE_ATTR ar5513RegCacheAttr[] = {
+    /* startReg  endReg   flags */
+    { 0x0030,   0x0034,  HAL_REG_CACHEABLE },                         /* TXCFG, RXCFG */
+    { 0x00a0,   0x00b4,  HAL_REG_CACHEABLE },                         /* IMR_P, IMR_S0-4 */
+    { 0x08c0,   0x08e4,  HAL_REG_CACHEABLE },                         /* Q_CBRCFG */
+    { 0x0900,   0x0924,  HAL_REG_CACHEABLE },                         /* Q_RDYTIMECFG */
+    { 0x09c0,   0x09e4,  HAL_REG_CACHEABLE | HAL_REG_WRITE_EFFECT },  /* Q_MISC - RESET_CBR_EXP_CTR */
+    { 0x1000,   0x1034,  HAL_REG_CACHEABLE },                         /* D_QCUMASK, D_GBL_IFS_SIFS */
+    { 0x1040,   0x1134,  HAL_REG_CACHEABLE },                         /* D_LCL_IFS .. D_MISC */
+    { 0x8000,   0x801c,  HAL_REG_CACHEABLE },                         /* STA_ID, BSS_ID */
+    { 0x8020,   0x8020,  HAL_REG_CACHEABLE | HAL_REG_WRITE_EFFECT },  /* MAC_BEACON */
+    { 0x803c,   0x8048,  HAL_REG_CACHEABLE },                         /* RX_FILTER, MCAST, DIAG_SW */
+    { 0x8060,   0x8060,  HAL_REG_CACHEABLE },                         /* SEQ_MASK */
+    { 0x80c0,   0x80e8,  HAL_REG_CACHEABLE },                         /* XR, SLEEP, BSSMASK, TPC */
+    { 0x80fc,   0x8104,  HAL_REG_CACHEABLE },                         /* QUIET, TSF_PARM */
+    { 0x810c,   0x810c,  HAL_REG_CACHEABLE },                         /* PHY_ERR */
+    { 0x8120,   0x8120,  HAL_REG_CACHEABLE },                         /* PCU_MISC */
+    { 0x81c4,   0x81c4,  HAL_REG_CACHEABLE },                         /* KC_MASK */
+    { 0x81ec,   0x81fc,  HAL_REG_CACHEABLE },                         /* TXOP */
+    { 0x8500,   0x85fc,  HAL_REG_CACHEABLE },                         /* FRM_TYPE_CAP_TBL */
+    { 0x8700,   0x87fc,  HAL_REG_CACHEABLE },                         /* RATE_DURATION */
+    { 0x9800,   0x9804,  HAL_REG_CACHEABLE },                         /* Chain 0 baseband */
+    { 0x980c,   0x9818,  HAL_REG_CACHEABLE },
+    { 0x981c,   0x981c,  HAL_REG_CACHEABLE | HAL_REG_WRITE_EFFECT },  /* PHY_ACTIVE */
+    { 0x9820,   0x985c,  HAL_REG_CACHEABLE },
+    { 0x9868,   0x987c,  HAL_REG_CACHEABLE },
+    { 0x9900,   0x991c,  HAL_REG_CACHEABLE },
+    { 0x9924,   0x992c,  HAL_REG_CACHEABLE },
+    { 0x9934,   0x996c,  HAL_REG_CACHEABLE },
+    { 0x9970,   0x9970,  HAL_REG_CACHEABLE | HAL_REG_WRITE_EFFECT },  /* PHY_RESTART */
+    { 0x9974,   0x9bfc,  HAL_REG_CACHEABLE },
+    { 0xa000,   0xa3fc,  HAL_REG_CACHEABLE },                         /* PHY_MODE */
+    { 0xa800,   0xa804,  HAL_REG_CACHEABLE },                         /* Chain 1 baseband */
+    { 0xa80c,   0xa818,  HAL_REG_CACHEABLE },
+    { 0xa81c,   0xa81c,  HAL_REG_CACHEABLE | HAL_REG_WRITE_EFFECT },
+    { 0xa820,   0xa85c,  HAL_REG_CACHEABLE },
+    { 0xa868,   0xa87c,  HAL_REG_CACHEABLE },
+    { 0xa900,   0xa91c,  HAL_REG_CACHEABLE },
+    { 0xa924,   0xa92c,  HAL_REG_CACHEABLE },
+    { 0xa934,   0xa96c,  HAL_REG_CACHEABLE },
+    { 0xa970,   0xa970,  HAL_REG_CACHEABLE | HAL_REG_WRITE_EFFECT },
+    { 0xa974,   0xabfc,  HAL_REG_CACHEABLE },
+    { 0xb800,   0xbffc,  HAL_REG_BROADCAST, { CHN_ALL_BASE - CHN_0_BASE, CHN_ALL_BASE - CHN_1_BASE } },
+};
+#endif /* HAL_REG_CACHE */
+
 
 #if defined (LOG_ANT_DIVERSITY)
 /* TODO: For AR5513 BRINGUP and Diversity  */
@@ -622,16 +716,19 @@ ar5513Attach(WLAN_DEV_INFO *pDev, A_UINT16 deviceID)
     A_STATUS  status;
     A_UINT16  eepVersion;
     A_UINT16  artBuildNo = 0;
-    A_UINT16  *pRawEeprom = NULL, *pData16, data;
+    A_UINT16  *pRawEeprom = NULL, data;
     A_UINT32  macRev;
-    A_UINT32  addr, loop, wrData, rdData, pattern, eepEndLoc;
+    A_UINT32  addr, loop, wrData, rdData, pattern, eepEndLoc, eepWords;
     A_UINT32  regAddr[2] = {MAC_STA_ID0, PHY_BASE+(8 << 2)};
     A_UINT32  regHold[2];
     A_UINT32  patternData[4] = {0x55555555, 0xaaaaaaaa, 0x66666666, 0x99999999};
+    EEP_HEADER_INFO eepHeader;
     EAR_ALLOC earAlloc;
+    A_UINT32  earSize = 0;
     int       earLocs = 0, parsedLocs;
     A_UINT16  *earBuffer = NULL;
-    A_UINT8   chainCnt = 0;
+    A_UINT8   chainCnt = 0, expnModes = 0, calModes[2];
+    A_BOOL    calImageLoaded = FALSE;
     A_UINT8   chain;
 #if defined(PCI_INTERFACE)
     A_UINT32  chipRev;
@@ -754,6 +851,15 @@ ar5513Attach(WLAN_DEV_INFO *pDev, A_UINT16 deviceID)
     }
     udelay(100);
 
+#ifdef HAL_REG_CACHE
+    /* Not before the self test - cached reads would defeat it */
+    status = halRegCacheAttach(pDev, ar5513RegCacheAttr,
+                               sizeof(ar5513RegCacheAttr) / sizeof(ar5513RegCacheAttr[0]));
+    if (status != A_OK) {
+        return status;
+    }
+#endif
+
     /* Set correct Baseband to analog shift setting to access analog chips. */
     writePlatformReg(pDev, PHY_BASE, 0x00000007);
 
@@ -867,22 +973,7 @@ ar5513Attach(WLAN_DEV_INFO *pDev, A_UINT16 deviceID)
         eepEndLoc |= data;
     }
     ASSERT(eepEndLoc > ATHEROS_EEPROM_OFFSET);
-
-    /* Cache EEPROM for checksum verification and multiple parse passes */
-    pRawEeprom = (A_UINT16 *)A_DRIVER_MALLOC(sizeof(A_UINT16) * (eepEndLoc - ATHEROS_EEPROM_OFFSET));
-    if (!pRawEeprom) {
-        uiPrintf("ar5513Attach: Could not allocate space to cache the EEPROM\n");
-        return A_NO_MEMORY;
-    }
-
-    /* Allocate EEPROM Map */
-    pEMap = (struct eepMap *)A_DRIVER_MALLOC(sizeof(struct eepMap));
-    if (!pEMap) {
-        uiPrintf("ar5513Attach: Could not allocate memory for version 3 EEPROM\n");
-        goto attachError;
-    }
-    A_MEM_ZERO(pEMap, sizeof(struct eepMap));
-    pDev->pHalInfo->pEepData = pEMap;
+    eepWords = eepEndLoc - ATHEROS_EEPROM_OFFSET;
 
     /* TODO AR5513: look at 1 vs 2 chain initialization w.r.t. A, B, D */
     if (pDev->staConfig.txChainCtrl == DUAL_CHAIN || 
@@ -922,53 +1013,142 @@ ar5513Attach(WLAN_DEV_INFO *pDev, A_UINT16 deviceID)
 
     ar5513SetDefAntenna(pDev, rdData);
 
-    status = ar5513AllocateProm(pEMap, chainCnt);
+    status = ar5513RecordSerialNumber(pDev, pDev->pHalInfo->serialNumber);
     if (status != A_OK) {
         goto attachError;
     }
 
-    /* Set Version so EEPROM Header can be correctly interpreted */
-    pEMap->version = eepVersion;
+#ifdef HAL_CAL_IMAGE
+    /* A matching image from an earlier attach stands in for the EEPROM */
+    status = ar5513CheckCalImage(pDev, eepVersion, eepEndLoc, chainCnt);
+    if (status != A_OK && status != A_EINVAL) {
+        goto attachError;
+    }
+    if (status == A_OK) {
+        /* One that will not load is passed over and the EEPROM parsed */
+        calImageLoaded = (ar5513LoadCalImage(pDev, eepVersion, chainCnt) == A_OK);
+    }
+#endif
+
+    /*
+     * Cache every configured chain's EEPROM for checksum verification
+     * and the parse, which each reset does for the chain and mode it
+     * needs - the arena must be sized before anything is parsed
+     */
+    if (!calImageLoaded) {
+        pRawEeprom = (A_UINT16 *)A_DRIVER_MALLOC(sizeof(A_UINT16) * eepWords * chainCnt);
+        if (!pRawEeprom) {
+            uiPrintf("ar5513Attach: Could not allocate space to cache the EEPROM\n");
+            goto attachError;
+        }
+    }
 
     /*
     **  When AR5513 is configured with Dual Radio chains,
     **  2 16Kbit EEPROM images must be processed in order
     **  to load the calibration data for each Radio chain.
     */
-/* TODO: this needs fixing to properly initialize for single chain B */
-    for (chain = 0; chain < chainCnt; chain++) {
-	
-        A_MEM_ZERO(pRawEeprom, sizeof(A_UINT16) * (eepEndLoc - ATHEROS_EEPROM_OFFSET));
-        pData16 = pRawEeprom;
-	
-        for (addr = ((chain * eepEndLoc) + ATHEROS_EEPROM_OFFSET); addr < ((chain * eepEndLoc) + eepEndLoc); addr++) {
-            status = ar5513EepromRead(pDev, addr, &data);
-            if (status != A_OK) {
-                goto attachError;
-            }
-            *(pData16++) = data;
+    for (chain = 0; chain < chainCnt && !calImageLoaded; chain++) {
+        status = ar5513EepromReadBlock(pDev, (chain * eepEndLoc) + ATHEROS_EEPROM_OFFSET,
+                                       &pRawEeprom[chain * eepWords], eepWords);
+        if (status != A_OK) {
+            goto attachError;
         }
 
     	/* Checksum validation */
-    	status = ar5513VerifyEepromChecksum(pRawEeprom, eepEndLoc);
-    	if (status != A_OK) {
-    	    goto attachError;
-    	}
-    
-    
-    	/* Parse the calibration portion of EEPROM into driver structures */
-    	status = ar5513ReadEepromIntoDataset(pDev, pRawEeprom, chain);
+    	status = ar5513VerifyEepromChecksum(&pRawEeprom[chain * eepWords], eepEndLoc);
     	if (status != A_OK) {
     	    goto attachError;
     	}
     }
 
-    status = ar5513EepromRead(pDev, EEPROM_PROTECT_OFFSET, &pEMap->protect);
-    if (status != A_OK) {
-        goto attachError;
+    /*
+    **  Each chain has its own header.  The 5112 power calibration is
+    **  expanded per mode, so the arena only needs room for the modes
+    **  some chain calibrates.
+    **  NOTE - EAR SUPPORT in Dual Chain Configuration
+    **  The EAR is taken from the last chain's EEPROM image.
+    */
+    for (chain = 0; chain < chainCnt && !calImageLoaded; chain++) {
+        ar5513ReadHeaderInfo(pDev, eepVersion, &eepHeader, &pRawEeprom[chain * eepWords]);
+
+        /* Require 5112 devices to have EEPROM 4.0 EEP_MAP set */
+        if (IS_5112(pDev) && !eepHeader.eepMap) {
+            uiPrintf("ar5513Attach: ERROR - 5112 devices must have an EEPROM 4.0 with the EEP_MAP set\n");
+            goto attachError;
+        }
+
+        calModes[chain] = 0;
+        if (eepVersion >= EEPROM_VER4_0 && eepHeader.eepMap) {
+            calModes[chain] = (eepHeader.Amode ? (1 << headerInfo11A) : 0) |
+                              (eepHeader.Bmode ? (1 << headerInfo11B) : 0) |
+                              (eepHeader.Gmode ? (1 << headerInfo11G) : 0);
+        }
+        expnModes |= calModes[chain];
     }
+    if (!calImageLoaded && eepHeader.earStart) {
+        ASSERT(eepHeader.earStart > ATHEROS_EEPROM_OFFSET);
+        ASSERT(eepHeader.earStart < eepEndLoc);
+        earBuffer = &pRawEeprom[(chainCnt - 1) * eepWords + eepHeader.earStart - ATHEROS_EEPROM_OFFSET];
+        earLocs = eepEndLoc - eepHeader.earStart;
+        ASSERT(earBuffer);
+        ASSERT(earLocs);
+    }
+#ifdef DEBUG
+    /* Debug EAR overrides normal EAR */
+    if (pDev->earDebugLength > 0) {
+        earBuffer = pDev->pEarDebug;
+        earLocs = pDev->earDebugLength / sizeof(A_UINT16);
+    }
+#endif
 
-    status = ar5513RecordSerialNumber(pDev, pDev->pHalInfo->serialNumber);
+    if (earBuffer) {
+        parsedLocs = ar5513EarPreParse(earBuffer, earLocs, &earAlloc);
+
+#ifdef DEBUG
+        if (EarDebugLevel >= EAR_DEBUG_VERBOSE) {
+            showEarAlloc(&earAlloc);
+        }
+#endif
+        earSize = ar5513EarSize(&earAlloc);
+    }
+
+    /* Everything parsed below is carved from one arena, sized from here on */
+    if (!calImageLoaded) {
+        status = ar5513AllocateEepArena(pDev->pHalInfo, chainCnt, expnModes, earSize);
+        if (status != A_OK) {
+            goto attachError;
+        }
+
+        status = ar5513AllocateProm(pDev->pHalInfo, pDev->pHalInfo->pEepData, chainCnt);
+        if (status != A_OK) {
+            goto attachError;
+        }
+
+        /* Set Version so EEPROM Header can be correctly interpreted */
+        pDev->pHalInfo->pEepData->version     = eepVersion;
+        *pDev->pHalInfo->pEepData->pEepHeader = eepHeader;
+        pDev->pHalInfo->pEepData->expnModes   = expnModes;
+    }
+    pEMap = pDev->pHalInfo->pEepData;
+
+    /*
+     * Each chain's calibration is parsed out of the cached EEPROM, with
+     * the chain's own header, by the first reset that needs it; see
+     * ar5513ExpandEepromDataset.  The header left in the EEP_MAP is the
+     * last chain's.
+     */
+    if (!calImageLoaded) {
+        for (chain = 0; chain < chainCnt; chain++) {
+            pEMap->chain[chain].calModes = calModes[chain];
+        }
+        pEMap->rawWords   = eepWords;
+        pEMap->numChains  = chainCnt;
+        pEMap->pRawEeprom = pRawEeprom;
+        pRawEeprom = NULL;
+    }
+
+    status = ar5513EepromRead(pDev, EEPROM_PROTECT_OFFSET, &pEMap->protect);
     if (status != A_OK) {
         goto attachError;
     }
@@ -989,12 +1169,34 @@ ar5513Attach(WLAN_DEV_INFO *pDev, A_UINT16 deviceID)
     /* Initialize gain ladder thermal calibration structure */
     ar5513InitializeGainValues(pDev, pGainValues);
 
+    if (ar5513KeyShadowAttach(pDev) != A_OK) {
+        goto attachError;
+    }
+
     /* Allocate analog bank scratch buffer */
     if (ar5513AllocateRfBanks(pDev, pDev->pHalInfo) == FALSE) {
         uiPrintf("ar5513Attach: Could not allocate memory for RF Banks\n");
         goto attachError;
     }
 
+    /* Compile the init tables - the 5112 table set depends on the radio revision */
+    halWriteListInitPacing(pDev, MAC_RXDP);
+    if (ar5513AllocateIniWriteLists(pDev, pDev->pHalInfo) != A_OK) {
+        uiPrintf("ar5513Attach: Could not allocate memory for init write lists\n");
+        goto attachError;
+    }
+
+#ifdef HAL_RESET_RECIPE
+    /* Resets just recompute the channel programming without it */
+    (void)ar5513AllocateResetRecipes(pDev);
+#endif
+#ifdef HAL_TXPOWER_CACHE
+    /* Transmit power is just recomputed every time without it */
+    (void)ar5513AllocateTxPowerCache(pDev);
+#endif
+    /* Tx power limit changes redo the full computation without them */
+    (void)ar5513AllocateRateTargets(pDev, pDev->pHalInfo);
+
     /*
      * It's okay for the address to be assigned by software, so we ignore the
      * following error value if returned.
@@ -1020,40 +1222,10 @@ ar5513Attach(WLAN_DEV_INFO *pDev, A_UINT16 deviceID)
         pDev->pHalInfo->pRfHal = &ar5112Funcs;
     } 
 
-    /*
-    **  NOTE - EAR SUPPORT in Dual Chain Configuration
-    **  The following EAR code uses pRawEeprom buffer,
-    **  which contains the 2nd EEPROM image.
-    */
-
-    if (pEMap->pEepHeader->earStart) {
-        ASSERT(pEMap->pEepHeader->earStart > ATHEROS_EEPROM_OFFSET);
-        ASSERT(pEMap->pEepHeader->earStart < eepEndLoc);
-        earBuffer = &pRawEeprom[pEMap->pEepHeader->earStart - ATHEROS_EEPROM_OFFSET];
-        earLocs = eepEndLoc - pEMap->pEepHeader->earStart;
-        ASSERT(earBuffer);
-        ASSERT(earLocs);
-    }
-#ifdef DEBUG
-    /* Debug EAR overrides normal EAR */
-    if (pDev->earDebugLength > 0) {
-        earBuffer = pDev->pEarDebug;
-        earLocs = pDev->earDebugLength / sizeof(A_UINT16);
-    }
-#endif
-
     if (earBuffer) {
-        parsedLocs = ar5513EarPreParse(earBuffer, earLocs, &earAlloc);
-
-#ifdef DEBUG
-        if (EarDebugLevel >= EAR_DEBUG_VERBOSE) {
-            showEarAlloc(&earAlloc);
-        }
-#endif
-
         /* Do not allocate EAR if no registers exist */
         if (earAlloc.numRHs) {
-            if (ar5513EarAllocate(&earAlloc, &(pDev->pHalInfo->pEarHead)) == FALSE) {
+            if (ar5513EarAllocate(pDev->pHalInfo, &earAlloc, &(pDev->pHalInfo->pEarHead)) == FALSE) {
                 uiPrintf("ar5513Attach: Could not allocate memory for EAR structures\n");
                 goto attachError;
             }
@@ -1071,8 +1243,28 @@ ar5513Attach(WLAN_DEV_INFO *pDev, A_UINT16 deviceID)
         }
     }
 
-    /* Cleanup cached EEPROM */
-    A_DRIVER_FREE(pRawEeprom, sizeof(A_UINT16) * (eepEndLoc - ATHEROS_EEPROM_OFFSET));
+    /* Reset runs the EAR, read here or loaded with the image, compiled */
+    if (pDev->pHalInfo->pEarHead && pDev->pHalInfo->pEarHead->numRHs) {
+        if (ar5513EarCompile(pDev->pHalInfo) != A_OK) {
+            goto attachError;
+        }
+    }
+
+#ifdef HAL_CAL_IMAGE
+    /* Keep what was parsed for the OS layer to save; attach is fine without */
+    if (!calImageLoaded) {
+        /* The image holds every chain and mode - the EAR is copied out of the cache by now */
+        for (chain = 0; chain < chainCnt; chain++) {
+            for (i = headerInfo11A; i <= headerInfo11G; i++) {
+                status = ar5513ExpandEepromDataset(pDev, chain, (HEADER_WMODE)i);
+                if (status != A_OK) {
+                    goto attachError;
+                }
+            }
+        }
+        (void)ar5513BuildCalImage(pDev, eepEndLoc, chainCnt);
+    }
+#endif
 
 #if defined(PCI_INTERFACE)
     writePlatformReg(pDev, RST_CIMR, WMAC_INTERRUPT_MASK);
@@ -1087,7 +1279,7 @@ ar5513Attach(WLAN_DEV_INFO *pDev, A_UINT16 deviceID)
 attachError:
     uiPrintf("ar5513Attach: EEPROM-related failure\n");
     if (pRawEeprom != NULL) {
-        A_DRIVER_FREE(pRawEeprom, sizeof(A_UINT16) * (eepEndLoc - ATHEROS_EEPROM_OFFSET));
+        A_DRIVER_FREE(pRawEeprom, sizeof(A_UINT16) * eepWords * chainCnt);
     }
     ar5513Detach(pDev);
     return A_HARDWARE;
@@ -1103,11 +1295,6 @@ A_STATUS
 ar5513Detach(WLAN_DEV_INFO *pDev)
 {
     HAL_INFO       *pInfo;
-    struct eepMap  *pData;
-    HEADER_WMODE   headerMode;
-    int            numChannels;
-    int i;
-    A_UINT8 chainCnt = 0;
 
     ASSERT(pDev && pDev->pHalInfo);
 
@@ -1116,52 +1303,20 @@ ar5513Detach(WLAN_DEV_INFO *pDev)
 #endif
 
     pInfo = pDev->pHalInfo;
-    pData = pInfo->pEepData;
-
-    if (pData) {
-        ASSERT(pData->version >= EEPROM_VER3);
-
-        if (pData->pEepHeader) {
-            A_DRIVER_FREE(pData->pEepHeader, sizeof(EEP_HEADER_INFO));
-        }
-
-        if (pDev->staConfig.txChainCtrl == DUAL_CHAIN ||
-            pDev->staConfig.rxChainCtrl == DUAL_CHAIN)
-        {
-            chainCnt = 2;
-        } else {
-            chainCnt = 1;
-        }
-
-	for (i = 0; i < chainCnt; i++) {
-	    if (pData->chain[i].pPcdacInfo) {
-		A_DRIVER_FREE(pData->chain[i].pPcdacInfo, sizeof(PCDACS_ALL_MODES));
-	    }
-
-	    if (pData->chain[i].pTrgtPowerInfo) {
-		A_DRIVER_FREE(pData->chain[i].pTrgtPowerInfo, sizeof(TRGT_POWER_ALL_MODES));
-	    }
 
-	    if (pData->chain[i].pRdEdgesPower) {
-		A_DRIVER_FREE(pData->chain[i].pRdEdgesPower,
-			      sizeof(RD_EDGES_POWER) * NUM_EDGES * NUM_CTLS_3_3);
-	    }
+    /* The EEPROM cache if some calibration was never parsed out of it */
+    if (pInfo->pEepData && pInfo->pEepData->pRawEeprom) {
+        A_DRIVER_FREE(pInfo->pEepData->pRawEeprom,
+                      sizeof(A_UINT16) * pInfo->pEepData->rawWords * pInfo->pEepData->numChains);
+        pInfo->pEepData->pRawEeprom = NULL;
+    }
 
-	    for (headerMode = headerInfo11A; headerMode <= headerInfo11G; headerMode++) {
-		numChannels = pData->chain[i].modePowerArray5112[headerMode].numChannels;
-		if (pData->chain[i].modePowerArray5112[headerMode].pChannels) {
-		    A_DRIVER_FREE(pData->chain[i].modePowerArray5112[headerMode].pChannels,
-				  sizeof(A_UINT16) * numChannels);
-		}
-		if (pData->chain[i].modePowerArray5112[headerMode].pDataPerChannel) {
-		    A_DRIVER_FREE(pData->chain[i].modePowerArray5112[headerMode].pDataPerChannel,
-				  sizeof(EXPN_DATA_PER_CHANNEL_5112) * numChannels);
-		}
-	    }
-	}
+    ar5513FreeEepArena(pInfo);
 
-        A_DRIVER_FREE(pData, sizeof(struct eepMap));
-        pInfo->pEepData = NULL;
+    if (pInfo->pEarProg) {
+        A_DRIVER_FREE(pInfo->pEarProg->pSegs, pInfo->pEarProg->indexSize);
+        A_DRIVER_FREE(pInfo->pEarProg, pInfo->pEarProg->allocSize);
+        pInfo->pEarProg = NULL;
     }
 
     if (pInfo->pGainValues) {
@@ -1169,17 +1324,27 @@ ar5513Detach(WLAN_DEV_INFO *pDev)
         pInfo->pGainValues = NULL;
     }
 
+    ar5513KeyShadowDetach(pDev);
     ar5513FreeRfBanks(pDev, pInfo);
+    ar5513FreeRateTargets(pDev, pInfo);
+    ar5513FreeIniWriteLists(pDev, pInfo);
+#ifdef HAL_RESET_RECIPE
+    halResetRecipeDetach(pDev);
+#endif
+#ifdef HAL_TXPOWER_CACHE
+    halTxPowerCacheDetach(pDev);
+#endif
 
-    if (pInfo->pEarHead) {
-        if (pInfo->pEarHead->numRHs) {
-            A_DRIVER_FREE(pInfo->pEarHead->pRH, pInfo->pEarHead->earSize);
-            pInfo->pEarHead->pRH = NULL;
-        }
-
-        A_DRIVER_FREE(pInfo->pEarHead, sizeof(EAR_HEADER));
-        pInfo->pEarHead = NULL;
+#ifdef HAL_CAL_IMAGE
+    if (pInfo->pCalImage) {
+        A_DRIVER_FREE(pInfo->pCalImage, pInfo->calImageSize);
+        pInfo->pCalImage = NULL;
     }
+#endif
+
+#ifdef HAL_REG_CACHE
+    halRegCacheDetach(pDev);
+#endif
 
     return A_OK;
 }
@@ -1347,20 +1512,110 @@ ar5513VerifyEepromChecksum(A_UINT16 *pRawEeprom, A_UINT32 eepEndLoc)
     return status;
 }
 
+/* Arena carving keeps every structure pointer aligned */
+#define EEP_ARENA_ALIGN(x)      (((x) + sizeof(void *) - 1) & ~(sizeof(void *) - 1))
+#define EEP_ARENA_EXPN_SIZE(n)  (EEP_ARENA_ALIGN(sizeof(A_UINT16) * (n)) + \
+                                 EEP_ARENA_ALIGN(sizeof(EXPN_DATA_PER_CHANNEL_5112) * (n)))
+
+/**************************************************************
+ * ar5513EepAlloc
+ *
+ * Carves size bytes from the EEPROM arena; NULL once it is used up
+ */
+static void *
+ar5513EepAlloc(HAL_INFO *pInfo, A_UINT32 size)
+{
+    void *p;
+
+    size = EEP_ARENA_ALIGN(size);
+    if (size > pInfo->eepArenaSize - pInfo->eepArenaUsed) {
+        return NULL;
+    }
+    p = (A_UINT8 *)pInfo->pEepArena + pInfo->eepArenaUsed;
+    pInfo->eepArenaUsed += size;
+    return p;
+}
+
+/**************************************************************
+ * ar5513AllocateEepArena
+ *
+ * Allocates the arena all calibration structures come from and
+ * places the EEP_MAP at its start.  The 5112 expansions of the
+ * expnModes modes are sized for the most piers a mode can
+ * calibrate and the EAR for earSize bytes of register headers
+ * and data.
+ */
+static A_STATUS
+ar5513AllocateEepArena(HAL_INFO *pInfo, A_UINT8 chainCnt, A_UINT8 expnModes, A_UINT32 earSize)
+{
+    A_UINT32 size, expnSize = 0;
+
+    ASSERT(pInfo->pEepArena == NULL);
+
+    if (expnModes & (1 << headerInfo11A)) {
+        expnSize += EEP_ARENA_EXPN_SIZE(NUM_11A_EEPROM_CHANNELS);
+    }
+    if (expnModes & (1 << headerInfo11B)) {
+        expnSize += EEP_ARENA_EXPN_SIZE(NUM_2_4_EEPROM_CHANNELS);
+    }
+    if (expnModes & (1 << headerInfo11G)) {
+        expnSize += EEP_ARENA_EXPN_SIZE(NUM_2_4_EEPROM_CHANNELS);
+    }
+
+    size = EEP_ARENA_ALIGN(sizeof(EEP_MAP)) + EEP_ARENA_ALIGN(sizeof(EEP_HEADER_INFO)) +
+           chainCnt * (EEP_ARENA_ALIGN(sizeof(PCDACS_ALL_MODES)) +
+                       EEP_ARENA_ALIGN(sizeof(TRGT_POWER_ALL_MODES)) +
+                       EEP_ARENA_ALIGN(sizeof(RD_EDGES_POWER) * NUM_EDGES * NUM_CTLS_3_3) +
+                       expnSize);
+    if (earSize) {
+        size += EEP_ARENA_ALIGN(sizeof(EAR_HEADER)) + EEP_ARENA_ALIGN(earSize);
+    }
+
+    pInfo->pEepArena = A_DRIVER_MALLOC(size);
+    if (pInfo->pEepArena == NULL) {
+        uiPrintf("ar5513AllocateEepArena: Could not allocate memory for version 3 EEPROM\n");
+        return A_NO_MEMORY;
+    }
+    A_MEM_ZERO(pInfo->pEepArena, size);
+    pInfo->eepArenaSize = size;
+    pInfo->eepArenaUsed = 0;
+
+    pInfo->pEepData = (EEP_MAP *)ar5513EepAlloc(pInfo, sizeof(EEP_MAP));
+    return A_OK;
+}
+
+/**************************************************************
+ * ar5513FreeEepArena
+ *
+ * Frees the EEP_MAP, everything it points to and the EAR
+ */
+static void
+ar5513FreeEepArena(HAL_INFO *pInfo)
+{
+    if (pInfo->pEepArena) {
+        A_DRIVER_FREE(pInfo->pEepArena, pInfo->eepArenaSize);
+        pInfo->pEepArena = NULL;
+    }
+    pInfo->eepArenaSize = 0;
+    pInfo->eepArenaUsed = 0;
+    pInfo->pEepData     = NULL;
+    pInfo->pEarHead     = NULL;
+}
+
 /**************************************************************
  * ar5513AllocateProm
  *
  * Allocates memory for the EEPROM structures
  */
 A_STATUS
-ar5513AllocateProm(EEP_MAP *pEepMap, A_UINT8 chainCnt)
+ar5513AllocateProm(HAL_INFO *pInfo, EEP_MAP *pEepMap, A_UINT8 chainCnt)
 {
     /* TODO: only allocate 2.4 info if configured */
     int i;
     int j;
 
     /* allocate the struct to hold the header info */
-    pEepMap->pEepHeader = (EEP_HEADER_INFO *)A_DRIVER_MALLOC(sizeof(EEP_HEADER_INFO));
+    pEepMap->pEepHeader = (EEP_HEADER_INFO *)ar5513EepAlloc(pInfo, sizeof(EEP_HEADER_INFO));
     if (!pEepMap->pEepHeader) {
         uiPrintf("Unable to allocate eeprom structure for header info\n");
         return A_NO_MEMORY;
@@ -1369,7 +1624,7 @@ ar5513AllocateProm(EEP_MAP *pEepMap, A_UINT8 chainCnt)
 
     for (j = 0; j < chainCnt; j++) {
 	/* allocate the struct to hold the pcdac/power info */
-	pEepMap->chain[j].pPcdacInfo = (PCDACS_ALL_MODES *)A_DRIVER_MALLOC(sizeof(PCDACS_ALL_MODES));
+	pEepMap->chain[j].pPcdacInfo = (PCDACS_ALL_MODES *)ar5513EepAlloc(pInfo, sizeof(PCDACS_ALL_MODES));
 	if (!pEepMap->chain[j].pPcdacInfo) {
 	    uiPrintf("Unable to allocate eeprom structure for pcdac/power info\n");
 	    return A_NO_MEMORY;
@@ -1392,7 +1647,7 @@ ar5513AllocateProm(EEP_MAP *pEepMap, A_UINT8 chainCnt)
 	}
 
 	/* allocate the structure to hold target power info */
-	pEepMap->chain[j].pTrgtPowerInfo = (TRGT_POWER_ALL_MODES *)A_DRIVER_MALLOC(sizeof(TRGT_POWER_ALL_MODES));
+	pEepMap->chain[j].pTrgtPowerInfo = (TRGT_POWER_ALL_MODES *)ar5513EepAlloc(pInfo, sizeof(TRGT_POWER_ALL_MODES));
 	if (!pEepMap->chain[j].pTrgtPowerInfo) {
 	    uiPrintf("Unable to allocate eeprom structure for target power info\n");
 	    return A_NO_MEMORY;
@@ -1400,7 +1655,7 @@ ar5513AllocateProm(EEP_MAP *pEepMap, A_UINT8 chainCnt)
 	A_MEM_ZERO(pEepMap->chain[j].pTrgtPowerInfo, sizeof(TRGT_POWER_ALL_MODES));
 
 	/* allocate structure for RD edges */
-	pEepMap->chain[j].pRdEdgesPower = (RD_EDGES_POWER *)A_DRIVER_MALLOC(sizeof(RD_EDGES_POWER) *
+	pEepMap->chain[j].pRdEdgesPower = (RD_EDGES_POWER *)ar5513EepAlloc(pInfo, sizeof(RD_EDGES_POWER) *
 								   NUM_EDGES * NUM_CTLS_3_3);
 	if (!pEepMap->chain[j].pRdEdgesPower) {
 	    uiPrintf("Unable to allocate eeprom structure for RD edges info\n");
@@ -1475,7 +1730,8 @@ ar5513ReadEepromFreqPierInfo(WLAN_DEV_INFO *pDev, A_UINT16 *pRawEeprom, A_UINT16
  * into the allocated space
  */
 INLINE void
-ar5513ReadEepromRawPowerCalInfo(WLAN_DEV_INFO *pDev, A_UINT16 *pRawEeprom, A_UINT16 offSetIn, A_UINT8 chnIdx)
+ar5513ReadEepromRawPowerCalInfo(WLAN_DEV_INFO *pDev, EEP_HEADER_INFO *pHeader, A_UINT16 *pRawEeprom,
+                                A_UINT16 offSetIn, A_UINT8 chnIdx)
 {
     A_UINT16             tempValue;
     A_UINT32             i, j;
@@ -1492,7 +1748,7 @@ ar5513ReadEepromRawPowerCalInfo(WLAN_DEV_INFO *pDev, A_UINT16 *pRawEeprom, A_UIN
     pMap            = pDev->pHalInfo->pEepData;
     pEepromData     = pMap->chain[chnIdx].pPcdacInfo;
 
-    enable24        = pMap->pEepHeader->Bmode;
+    enable24        = pHeader->Bmode;
     /*
      * Group 2:  read raw power data for all frequency piers
      *
@@ -1585,7 +1841,7 @@ ar5513ReadEepromRawPowerCalInfo(WLAN_DEV_INFO *pDev, A_UINT16 *pRawEeprom, A_UIN
  * that records only the EEPROM calibraiton
  */
 static void
-ar5513readPowerDataFromEeprom5112(WLAN_DEV_INFO *pDev, EEPROM_POWER_5112 *pPowerSet,
+ar5513readPowerDataFromEeprom5112(WLAN_DEV_INFO *pDev, EEP_HEADER_INFO *pHeader, EEPROM_POWER_5112 *pPowerSet,
                                   A_UINT16 startOffset, A_UINT16 maxPiers, A_UINT16 *pRawEeprom,
                                   HEADER_WMODE headerMode)
 {
@@ -1598,7 +1854,6 @@ ar5513readPowerDataFromEeprom5112(WLAN_DEV_INFO *pDev, EEPROM_POWER_5112 *pPower
     A_UINT16    freq[NUM_11A_EEPROM_CHANNELS];
     A_UINT16    *pCalPiers;
     A_UINT16    version = pDev->pHalInfo->pEepData->version;
-    EEP_HEADER_INFO *pHeader = pDev->pHalInfo->pEepData->pEepHeader;
 
     offset = startOffset;
     if (headerMode == headerInfo11A) {
@@ -1672,23 +1927,22 @@ ar5513readPowerDataFromEeprom5112(WLAN_DEV_INFO *pDev, EEPROM_POWER_5112 *pPower
  * recorded by the calibration.  These values are then initialized.
  */
 static A_STATUS
-ar5513AllocExpnPower5112(EEPROM_POWER_EXPN_5112 *pPowerExpn, A_UINT16 numChannels,
+ar5513AllocExpnPower5112(HAL_INFO *pInfo, EEPROM_POWER_EXPN_5112 *pPowerExpn, A_UINT16 numChannels,
                                A_UINT16 *pChanList)
 {
     A_UINT16    i, j, channelValue;
 
     /* Allocate the channel array */
-    pPowerExpn->pChannels = (A_UINT16 *)A_DRIVER_MALLOC(sizeof(A_UINT16) * numChannels);
+    pPowerExpn->pChannels = (A_UINT16 *)ar5513EepAlloc(pInfo, sizeof(A_UINT16) * numChannels);
     if (NULL == pPowerExpn->pChannels) {
         uiPrintf("unable to allocate raw data struct (gen3)\n");
         return(A_NO_MEMORY);
     }
 
     /* Allocate the Power Data for each channel */
-    pPowerExpn->pDataPerChannel = (EXPN_DATA_PER_CHANNEL_5112 *)A_DRIVER_MALLOC(sizeof(EXPN_DATA_PER_CHANNEL_5112) * numChannels);
+    pPowerExpn->pDataPerChannel = (EXPN_DATA_PER_CHANNEL_5112 *)ar5513EepAlloc(pInfo, sizeof(EXPN_DATA_PER_CHANNEL_5112) * numChannels);
     if (NULL == pPowerExpn->pDataPerChannel) {
         uiPrintf("unable to allocate raw data struct data per channel(gen3)\n");
-        A_DRIVER_FREE(pPowerExpn->pChannels, sizeof(A_UINT16) * numChannels);
         return(A_NO_MEMORY);
     }
 
@@ -1807,20 +2061,18 @@ ar5513ExpandPower5112(EEPROM_POWER_5112 *pCalDataset, EEPROM_POWER_EXPN_5112 *pP
  * ar5513ReadEepromPowerCal5112
  *
  * Allocate, expand and fill expanded power structure for 5112
- * cal'ed EEPROM across all modes.
+ * cal'ed EEPROM for the modes in expnModes.  The modes before
+ * them are still read to find where theirs start.
  */
 static A_STATUS
-ar5513ReadEepromPowerCal5112(WLAN_DEV_INFO *pDev, A_UINT16 *pRawEeprom,
-                             A_UINT16 offSetIn, EEPROM_POWER_EXPN_5112 *pPowerExpn)
+ar5513ReadEepromPowerCal5112(WLAN_DEV_INFO *pDev, EEP_HEADER_INFO *pHeaderInfo, A_UINT16 *pRawEeprom,
+                             A_UINT16 offSetIn, EEPROM_POWER_EXPN_5112 *pPowerExpn, A_UINT8 expnModes)
 {
     A_STATUS          status = A_OK;
     A_UINT16          offset= offSetIn;
     A_UINT16          maxPiers = 0;
     EEPROM_POWER_5112 eepPower;
     HEADER_WMODE      headerMode;
-    EEP_HEADER_INFO   *pHeaderInfo;
-
-    pHeaderInfo = pDev->pHalInfo->pEepData->pEepHeader;
 
     for (headerMode = headerInfo11A; headerMode <= headerInfo11G; headerMode++) {
         switch (headerMode) {
@@ -1848,18 +2100,20 @@ ar5513ReadEepromPowerCal5112(WLAN_DEV_INFO *pDev, A_UINT16 *pRawEeprom,
         A_MEM_ZERO(&eepPower, sizeof(EEPROM_POWER_5112));
 
         /* Copy from the EEPROM locations to the basic power structure */
-        ar5513readPowerDataFromEeprom5112(pDev, &eepPower, offset, maxPiers, pRawEeprom, headerMode);
+        ar5513readPowerDataFromEeprom5112(pDev, pHeaderInfo, &eepPower, offset, maxPiers, pRawEeprom, headerMode);
 
-        /* Allocate the expanded Power structure for easier use by reset */
-        status = ar5513AllocExpnPower5112(&pPowerExpn[headerMode], eepPower.numChannels, eepPower.pChannels);
-        if (status != A_OK) {
-            uiPrintf("ar5513ReadEepromPowerCal5112: Failed to allocate power structs\n");
-            return status;
-        }
+        if (expnModes & (1 << headerMode)) {
+            /* Allocate the expanded Power structure for easier use by reset */
+            status = ar5513AllocExpnPower5112(pDev->pHalInfo, &pPowerExpn[headerMode], eepPower.numChannels, eepPower.pChannels);
+            if (status != A_OK) {
+                uiPrintf("ar5513ReadEepromPowerCal5112: Failed to allocate power structs\n");
+                return status;
+            }
 
-        /* Copy and expand the basic power structure into the expanded structure */
-        if(ar5513ExpandPower5112(&eepPower, &pPowerExpn[headerMode]) == FALSE) {
-            return A_ERROR;
+            /* Copy and expand the basic power structure into the expanded structure */
+            if(ar5513ExpandPower5112(&eepPower, &pPowerExpn[headerMode]) == FALSE) {
+                return A_ERROR;
+            }
         }
         offset += (eepPower.numChannels * 5);
         if (headerMode == headerInfo11A) {
@@ -1879,7 +2133,8 @@ ar5513ReadEepromPowerCal5112(WLAN_DEV_INFO *pDev, A_UINT16 *pRawEeprom,
  * into the allocated space
  */
 INLINE void
-ar5513ReadEepromTargetPowerCalInfo(WLAN_DEV_INFO *pDev, A_UINT16 *pRawEeprom, A_UINT16 offsetIn, A_UINT16 *endOffset, A_UINT8 chnIdx)
+ar5513ReadEepromTargetPowerCalInfo(WLAN_DEV_INFO *pDev, EEP_HEADER_INFO *pHeader, A_UINT16 *pRawEeprom,
+                                   A_UINT16 offsetIn, A_UINT16 *endOffset, A_UINT8 chnIdx)
 {
     A_UINT16             tempValue;
     A_UINT32             i;
@@ -1892,7 +2147,7 @@ ar5513ReadEepromTargetPowerCalInfo(WLAN_DEV_INFO *pDev, A_UINT16 *pRawEeprom, A_
     ASSERT(pDev->pHalInfo && pDev->pHalInfo->pEepData);
 
     pMap            = pDev->pHalInfo->pEepData;
-    enable24        = pMap->pEepHeader->Bmode;
+    enable24        = pHeader->Bmode;
 
     for (mode = headerInfo11A; mode <= headerInfo11G; mode++) {
         TRGT_POWER_INFO *pPowerInfo = NULL;
@@ -1991,7 +2246,8 @@ ar5513ReadEepromTargetPowerCalInfo(WLAN_DEV_INFO *pDev, A_UINT16 *pRawEeprom, A_
  * into the allocated space
  */
 INLINE void
-ar5513ReadEepromCTLInfo(WLAN_DEV_INFO *pDev, A_UINT16 *pRawEeprom, A_UINT16 offsetIn, A_UINT8 chnIdx)
+ar5513ReadEepromCTLInfo(WLAN_DEV_INFO *pDev, EEP_HEADER_INFO *pHeader, A_UINT16 *pRawEeprom,
+                        A_UINT16 offsetIn, A_UINT8 chnIdx)
 {
     A_UINT16             tempValue;
     A_UINT32             i, j;
@@ -2006,8 +2262,8 @@ ar5513ReadEepromCTLInfo(WLAN_DEV_INFO *pDev, A_UINT16 *pRawEeprom, A_UINT16 offs
     pEepromData    = pMap->chain[chnIdx].pPcdacInfo;
     pRdEdgePwrInfo = pMap->chain[chnIdx].pRdEdgesPower;
 
-    for (i = 0; i < pMap->pEepHeader->numCtls; i++) {
-        if (pMap->pEepHeader->ctl[i] == 0) {
+    for (i = 0; i < pHeader->numCtls; i++) {
+        if (pHeader->ctl[i] == 0) {
             /* Move offset and edges */
             offset += ((pMap->version >= EEPROM_VER3_3) ? 8 : 7);
             pRdEdgePwrInfo += NUM_EDGES;
@@ -2069,8 +2325,8 @@ ar5513ReadEepromCTLInfo(WLAN_DEV_INFO *pDev, A_UINT16 *pRawEeprom, A_UINT16 offs
 
         for (j = 0; j < NUM_EDGES; j++ ) {
             if (pRdEdgePwrInfo[j].rdEdge != 0 || pRdEdgePwrInfo[j].twice_rdEdgePower != 0) {
-                if (((pMap->pEepHeader->ctl[i] & CTL_MODE_M) == CTL_11A) ||
-                    ((pMap->pEepHeader->ctl[i] & CTL_MODE_M) == CTL_TURBO))
+                if (((pHeader->ctl[i] & CTL_MODE_M) == CTL_11A) ||
+                    ((pHeader->ctl[i] & CTL_MODE_M) == CTL_TURBO))
                 {
                     pRdEdgePwrInfo[j].rdEdge = fbin2freq(pMap->version, pRdEdgePwrInfo[j].rdEdge, FALSE);
                 } else {
@@ -2085,27 +2341,28 @@ ar5513ReadEepromCTLInfo(WLAN_DEV_INFO *pDev, A_UINT16 *pRawEeprom, A_UINT16 offs
 /**************************************************************
  * ar5513ReadEepromIntoDataset
  *
- * Now verify and copy EEPROM contents into the allocated space
+ * Now copy EEPROM contents into the allocated space: the chain's
+ * pier, target power and CTL info if not yet done, and the 5112
+ * power calibration of the expnModes modes.  Everything is read
+ * with the chain's own header; the checksum and the 5112 EEP_MAP
+ * were checked at attach.
  */
 static A_STATUS
-ar5513ReadEepromIntoDataset(WLAN_DEV_INFO *pDev, A_UINT16 *pRawEeprom, A_UINT8 chnIdx)
+ar5513ReadEepromIntoDataset(WLAN_DEV_INFO *pDev, A_UINT16 *pRawEeprom, A_UINT8 chnIdx, A_UINT8 expnModes)
 {
-    A_STATUS      status = A_OK;
-    struct eepMap *pMap;
-    A_UINT16      offset, endOffset;
+    A_STATUS        status = A_OK;
+    struct eepMap   *pMap;
+    A_UINT16        offset, endOffset;
+    A_BOOL          chainDone;
+    EEP_HEADER_INFO header;
 
     ASSERT(pDev->pHalInfo && pDev->pHalInfo->pEepData);
     pMap = pDev->pHalInfo->pEepData;
+    chainDone = pMap->chain[chnIdx].expanded;
 
     /* Read the header information here */
-    ar5513ReadHeaderInfo(pDev, pMap->pEepHeader, pRawEeprom);
-
-    /* Require 5112 devices to have EEPROM 4.0 EEP_MAP set */
-    if (IS_5112(pDev) && !pMap->pEepHeader->eepMap) {
-        uiPrintf("ar5513ReadEepromIntoDataset: ERROR - 5112 devices must have an EEPROM 4.0 with the EEP_MAP set\n");
-        status = A_HARDWARE;
-        return status;
-    }
+    A_MEM_ZERO(&header, sizeof(header));
+    ar5513ReadHeaderInfo(pDev, pMap->version, &header, pRawEeprom);
 
     /*
      * Group 1: frequency pier locations readback
@@ -2115,25 +2372,35 @@ ar5513ReadEepromIntoDataset(WLAN_DEV_INFO *pDev, A_UINT16 *pRawEeprom, A_UINT8 c
      *
      * NOTE: Group 1 contains the 5 GHz channel numbers that have dBm->pcdac calibrated information
      */
-    offset = (A_UINT16)(((pMap->version >= EEPROM_VER3_3) ? EEPROM_GROUPS_OFFSET3_3 : EEPROM_GROUPS_OFFSET3_2) +
-        GROUP1_OFFSET - ATHEROS_EEPROM_OFFSET);
-    ar5513ReadEepromFreqPierInfo(pDev, pRawEeprom, offset, chnIdx);
+    if (!chainDone) {
+        offset = (A_UINT16)(((pMap->version >= EEPROM_VER3_3) ? EEPROM_GROUPS_OFFSET3_3 : EEPROM_GROUPS_OFFSET3_2) +
+            GROUP1_OFFSET - ATHEROS_EEPROM_OFFSET);
+        ar5513ReadEepromFreqPierInfo(pDev, pRawEeprom, offset, chnIdx);
+    }
 
     /*
      * Group 2:  readback data for all frequency piers
      *
      * NOTE: Group 2 contains the raw power calibration information for each of the channels
-     * that we recorded above
+     * that we recorded above.  The 5112 form is expanded a mode at a time.
      */
     offset = (A_UINT16)(((pMap->version >= EEPROM_VER3_3) ?
              EEPROM_GROUPS_OFFSET3_3 : EEPROM_GROUPS_OFFSET3_2) - ATHEROS_EEPROM_OFFSET);
-    if ((pMap->version >= EEPROM_VER4_0) && pMap->pEepHeader->eepMap) {
-        status = ar5513ReadEepromPowerCal5112(pDev, pRawEeprom, offset, pMap->chain[chnIdx].modePowerArray5112);
-        if (status != A_OK) {
-            return status;
+    if ((pMap->version >= EEPROM_VER4_0) && header.eepMap) {
+        if (expnModes) {
+            status = ar5513ReadEepromPowerCal5112(pDev, &header, pRawEeprom, offset,
+                                                  pMap->chain[chnIdx].modePowerArray5112, expnModes);
+            if (status != A_OK) {
+                return status;
+            }
+            pMap->chain[chnIdx].expnModes |= expnModes;
         }
-    } else {
-        ar5513ReadEepromRawPowerCalInfo(pDev, pRawEeprom, offset, chnIdx);
+    } else if (!chainDone) {
+        ar5513ReadEepromRawPowerCalInfo(pDev, &header, pRawEeprom, offset, chnIdx);
+    }
+
+    if (chainDone) {
+        return status;
     }
 
     /*
@@ -2144,13 +2411,13 @@ ar5513ReadEepromIntoDataset(WLAN_DEV_INFO *pDev, A_UINT16 *pRawEeprom, A_UINT8 c
      */
     /* Read the power per rate info for test channels */
     if (pMap->version >= EEPROM_VER4_0) {
-        offset = (A_UINT16)(pMap->pEepHeader->targetPowersStart - ATHEROS_EEPROM_OFFSET - GROUP5_OFFSET);
+        offset = (A_UINT16)(header.targetPowersStart - ATHEROS_EEPROM_OFFSET - GROUP5_OFFSET);
     } else if (pMap->version >= EEPROM_VER3_3) {
         offset = EEPROM_GROUPS_OFFSET3_3 - ATHEROS_EEPROM_OFFSET;
     } else {
         offset = EEPROM_GROUPS_OFFSET3_2 - ATHEROS_EEPROM_OFFSET;
     }
-    ar5513ReadEepromTargetPowerCalInfo(pDev, pRawEeprom, offset, &endOffset, chnIdx);
+    ar5513ReadEepromTargetPowerCalInfo(pDev, &header, pRawEeprom, offset, &endOffset, chnIdx);
 
     /*
      * Group 8: Conformance Test Limits information
@@ -2159,24 +2426,69 @@ ar5513ReadEepromIntoDataset(WLAN_DEV_INFO *pDev, A_UINT16 *pRawEeprom, A_UINT8 c
      * value based on any band edge violations.
      */
     /* Read the RD edge power limits */
-    ar5513ReadEepromCTLInfo(pDev, pRawEeprom, endOffset, chnIdx);
+    ar5513ReadEepromCTLInfo(pDev, &header, pRawEeprom, endOffset, chnIdx);
+
+    pMap->chain[chnIdx].expanded = TRUE;
 
     return status;
 }
 
+/**************************************************************
+ * ar5513ExpandEepromDataset
+ *
+ * Parses the chain's calibration, and its 5112 power calibration
+ * for headerMode, out of the EEPROM cached at attach the first
+ * time a reset needs them.  The cache is dropped once every
+ * configured chain has all the modes its header calibrates.
+ */
+A_STATUS
+ar5513ExpandEepromDataset(WLAN_DEV_INFO *pDev, A_UINT8 chnIdx, HEADER_WMODE headerMode)
+{
+    struct eepMap *pMap = pDev->pHalInfo->pEepData;
+    A_UINT8       modes, chain;
+    A_STATUS      status;
+
+    ASSERT(pMap);
+
+    /* Loaded from a calibration image, or everything already parsed */
+    if (pMap->pRawEeprom == NULL || chnIdx >= pMap->numChains) {
+        return A_OK;
+    }
+    modes = pMap->chain[chnIdx].calModes & (1 << headerMode) & ~pMap->chain[chnIdx].expnModes;
+    if (pMap->chain[chnIdx].expanded && !modes) {
+        return A_OK;
+    }
+
+    status = ar5513ReadEepromIntoDataset(pDev, &pMap->pRawEeprom[chnIdx * pMap->rawWords], chnIdx, modes);
+    if (status != A_OK) {
+        return status;
+    }
+
+    for (chain = 0; chain < pMap->numChains; chain++) {
+        if (!pMap->chain[chain].expanded || pMap->chain[chain].expnModes != pMap->chain[chain].calModes) {
+            return A_OK;
+        }
+    }
+    A_DRIVER_FREE(pMap->pRawEeprom, sizeof(A_UINT16) * pMap->rawWords * pMap->numChains);
+    pMap->pRawEeprom = NULL;
+    return A_OK;
+}
+
 /**************************************************************
  * ar5513ReadHeaderInfo
  *
- * Read the individual header fields for a Rev 3 EEPROM
+ * Read the individual header fields for a Rev 3 EEPROM.  Fields
+ * the version does not hold, such as earStart before 4.0, are
+ * left zero.
  */
 static void
-ar5513ReadHeaderInfo(WLAN_DEV_INFO *pDev, EEP_HEADER_INFO *pHeaderInfo, A_UINT16* pRawEeprom)
+ar5513ReadHeaderInfo(WLAN_DEV_INFO *pDev, A_UINT16 version, EEP_HEADER_INFO *pHeaderInfo,
+                     A_UINT16* pRawEeprom)
 {
     A_UINT16 tempValue;
     A_UINT32 offset;
     A_UINT16 i;
     A_UINT32 *pHeadOff;
-    A_UINT16 version = pDev->pHalInfo->pEepData->version;
 
     static A_UINT32 headerOffset3_0[] = {
         0x00C2, /* 0 - Mode bits, device type, max turbo power */
@@ -2195,6 +2507,8 @@ ar5513ReadHeaderInfo(WLAN_DEV_INFO *pDev, EEP_HEADER_INFO *pHeaderInfo, A_UINT16
         0x0128  /* 5 - Begin CTL section */
     };
 
+    A_MEM_ZERO(pHeaderInfo, sizeof(EEP_HEADER_INFO));
+
     /* Initialize cckOfdmGainDelta for < 4.2 EEPROM's */
     pHeaderInfo->cckOfdmGainDelta = CCK_OFDM_GAIN_DELTA;
     pHeaderInfo->scaledCh14FilterCckDelta = TENX_CH14_FILTER_CCK_DELTA_INIT;
@@ -2546,25 +2860,409 @@ fbin2freq(A_UINT16 version, A_UINT16 fbin, A_BOOL is2GHz)
     return returnValue;
 }
 
-/************** EEPROM REV 3/4 DEBUG PRINT FUNCTIONS *****************/
-#if defined(DEBUG)
-static void
-printHeaderInfo(WLAN_DEV_INFO *pDev, EEP_MAP *pEepMap, HEADER_WMODE modeArray)
-{
-    A_UINT16 j;
-    EEP_HEADER_INFO *pHeaderInfo = pEepMap->pEepHeader;
-    A_UINT16 version = pEepMap->version;
-    A_UINT32 regDmn = pDev->pHalInfo->halCapabilities.halRegDmn;
-
-    uiPrintf("\n");
-    uiPrintf(" =======================Header Information======================\n");
+#ifdef HAL_CAL_IMAGE
+/************** CALIBRATION IMAGE FUNCTIONS *****************/
 
-    uiPrintf(" |  Major Version           %2d  ", version >> 12);
-    uiPrintf("|  Minor Version           %2d  |\n", version & 0xFFF);
-    uiPrintf(" |-------------------------------------------------------------|\n");
+/*
+ * The calibration image holds the parsed EEP_MAP and EAR in one flat
+ * buffer so a later attach can skip reading and parsing the EEPROM.
+ * Structures are stored as this build lays them out, each padded to
+ * 4 bytes; pointers are replaced by the counts needed to rebuild them.
+ */
+#define CAL_IMAGE_MAGIC         0x35353133  /* "5513" */
+#define CAL_IMAGE_VERSION       3
+#define CAL_IMAGE_ALIGN(x)      (((x) + 3) & ~3)
+#define CAL_IMAGE_SUM_START     (sizeof(CAL_IMAGE_HDR) - sizeof(A_UINT32))  /* earSize on */
+
+typedef struct calImageHdr {
+    A_UINT32    magic;
+    A_UINT32    layout;                 /* Format version and structure sizes */
+    A_UINT32    size;                   /* Of the whole image */
+    A_UINT32    sum;                    /* Of the image after the header */
+    A_CHAR      serialNumber[16];
+    A_UINT16    eepChecksum[2];         /* Checksum word of each chain's EEPROM */
+    A_UINT16    eepVersion;
+    A_UINT16    eepEndLoc;
+    A_UINT8     chainCnt;
+    A_UINT8     turboGCfg;              /* Header parse of EEPROMs before 4.0 */
+    A_UINT8     expnModes;              /* These two size the EEPROM arena before the load */
+    A_UINT8     reserved;
+    A_UINT32    earSize;
+} CAL_IMAGE_HDR;
+
+typedef struct calImageCursor {
+    A_UINT8     *pImage;                /* NULL while sizing */
+    A_UINT32    size;
+    A_UINT32    pos;
+    A_BOOL      load;                   /* Image to structures */
+} CAL_IMAGE_CURSOR;
 
-    uiPrintf(" |  A Mode         %1d  ", pHeaderInfo->Amode);
-    uiPrintf("|  B Mode         %1d  ", pHeaderInfo->Bmode);
+/**************************************************************
+ * ar5513CalImageLayout
+ */
+static A_UINT32
+ar5513CalImageLayout(void)
+{
+    static const A_UINT32 sizes[] = {
+        sizeof(CAL_IMAGE_HDR), sizeof(EEP_HEADER_INFO), sizeof(PCDACS_ALL_MODES),
+        sizeof(TRGT_POWER_ALL_MODES), sizeof(RD_EDGES_POWER), sizeof(EXPN_DATA_PER_CHANNEL_5112),
+        sizeof(REGISTER_HEADER)
+    };
+    A_UINT32 layout = CAL_IMAGE_VERSION;
+    int      i;
+
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        layout = layout * 31 + sizes[i];
+    }
+    return layout;
+}
+
+/**************************************************************
+ * ar5513CalImageSum
+ */
+static A_UINT32
+ar5513CalImageSum(const A_UINT32 *pWords, A_UINT32 numWords)
+{
+    A_UINT32 sum = 0;
+
+    while (numWords--) {
+        sum = ((sum << 1) | (sum >> 31)) + *pWords++;
+    }
+    return sum;
+}
+
+/**************************************************************
+ * ar5513CalImageKey
+ *
+ * The image is keyed on the serial number and on the checksum
+ * word of each chain's EEPROM, read here, along with the inputs
+ * to the parse that do not come from the EEPROM.
+ */
+static A_STATUS
+ar5513CalImageKey(WLAN_DEV_INFO *pDev, A_UINT16 eepVersion, A_UINT32 eepEndLoc, A_UINT8 chainCnt,
+                  CAL_IMAGE_HDR *pKey)
+{
+    A_UINT8 chain;
+    int     i;
+
+    A_MEM_ZERO(pKey, sizeof(*pKey));
+    for (i = 0; i < sizeof(pDev->pHalInfo->serialNumber); i++) {
+        pKey->serialNumber[i] = pDev->pHalInfo->serialNumber[i];
+    }
+    for (chain = 0; chain < chainCnt; chain++) {
+        if (ar5513EepromRead(pDev, (chain * eepEndLoc) + ATHEROS_EEPROM_OFFSET,
+                             &pKey->eepChecksum[chain]) != A_OK)
+        {
+            return A_HARDWARE;
+        }
+    }
+    pKey->magic      = CAL_IMAGE_MAGIC;
+    pKey->layout     = ar5513CalImageLayout();
+    pKey->eepVersion = eepVersion;
+    pKey->eepEndLoc  = (A_UINT16)eepEndLoc;
+    pKey->chainCnt   = chainCnt;
+    pKey->turboGCfg  = (pDev->staConfig.disableTurboG == USE_ABOLT);
+    return A_OK;
+}
+
+/**************************************************************
+ * ar5513CalImageMove
+ *
+ * Copies len bytes between pData and the image, in the direction
+ * of the walk.  FALSE if the image ends first.
+ */
+static A_BOOL
+ar5513CalImageMove(CAL_IMAGE_CURSOR *pCur, void *pData, A_UINT32 len)
+{
+    if (pCur->pImage) {
+        if (CAL_IMAGE_ALIGN(len) > pCur->size - pCur->pos) {
+            return FALSE;
+        }
+        if (pCur->load) {
+            A_BCOPY(pCur->pImage + pCur->pos, pData, len);
+        } else {
+            A_BCOPY(pData, pCur->pImage + pCur->pos, len);
+        }
+    }
+    pCur->pos += CAL_IMAGE_ALIGN(len);
+    return TRUE;
+}
+
+/**************************************************************
+ * ar5513CalImageWalk
+ *
+ * Sizes, saves or loads everything after the header.  A load
+ * expects the EEP_MAP from ar5513AllocateProm and allocates the
+ * 5112 expansions and the EAR from the arena as it meets them.
+ */
+static A_BOOL
+ar5513CalImageWalk(CAL_IMAGE_CURSOR *pCur, HAL_INFO *pInfo, A_UINT8 chainCnt)
+{
+    EEP_MAP                *pMap = pInfo->pEepData;
+    EEPROM_POWER_EXPN_5112 *pExpn;
+    EAR_HEADER             *pEarHead = pInfo->pEarHead;
+    EAR_ALLOC              earAlloc;
+    REGISTER_HEADER        *pRH;
+    A_UINT16               counts[2], *pRegs, *pEnd;
+    HEADER_WMODE           headerMode;
+    A_UINT8                chain;
+    int                    i;
+
+    if (!ar5513CalImageMove(pCur, pMap->pEepHeader, sizeof(EEP_HEADER_INFO))) {
+        return FALSE;
+    }
+
+    for (chain = 0; chain < chainCnt; chain++) {
+        if (!ar5513CalImageMove(pCur, pMap->chain[chain].pPcdacInfo, sizeof(PCDACS_ALL_MODES)) ||
+            !ar5513CalImageMove(pCur, pMap->chain[chain].pTrgtPowerInfo, sizeof(TRGT_POWER_ALL_MODES)) ||
+            !ar5513CalImageMove(pCur, pMap->chain[chain].pRdEdgesPower,
+                                sizeof(RD_EDGES_POWER) * NUM_EDGES * NUM_CTLS_3_3))
+        {
+            return FALSE;
+        }
+
+        for (headerMode = headerInfo11A; headerMode <= headerInfo11G; headerMode++) {
+            pExpn     = &pMap->chain[chain].modePowerArray5112[headerMode];
+            counts[0] = pExpn->numChannels;
+            counts[1] = pExpn->xpdMask;
+            if (!ar5513CalImageMove(pCur, counts, sizeof(counts))) {
+                return FALSE;
+            }
+            if (counts[0] == 0) {
+                continue;
+            }
+            if (pCur->load) {
+                /* The channel list comes next - allocate from it */
+                if (counts[0] > ((headerMode == headerInfo11A) ?
+                                 NUM_11A_EEPROM_CHANNELS : NUM_2_4_EEPROM_CHANNELS) ||
+                    CAL_IMAGE_ALIGN(sizeof(A_UINT16) * counts[0]) > pCur->size - pCur->pos ||
+                    ar5513AllocExpnPower5112(pInfo, pExpn, counts[0],
+                                             (A_UINT16 *)(pCur->pImage + pCur->pos)) != A_OK)
+                {
+                    return FALSE;
+                }
+                pExpn->xpdMask = counts[1];
+            }
+            if (!ar5513CalImageMove(pCur, pExpn->pChannels, sizeof(A_UINT16) * counts[0]) ||
+                !ar5513CalImageMove(pCur, pExpn->pDataPerChannel,
+                                    sizeof(EXPN_DATA_PER_CHANNEL_5112) * counts[0]))
+            {
+                return FALSE;
+            }
+        }
+    }
+
+    /* EAR: version and register header count, then locations per header */
+    A_MEM_ZERO(&earAlloc, sizeof(earAlloc));
+    counts[0] = 0;
+    counts[1] = 0;
+    if (pEarHead) {
+        counts[0] = pEarHead->versionId;
+        counts[1] = pEarHead->numRHs;
+        pEnd      = (A_UINT16 *)((A_UINT8 *)pEarHead->pRH + pEarHead->earSize);
+        for (i = 0; i < counts[1]; i++) {
+            pRegs = (i + 1 < counts[1]) ? pEarHead->pRH[i + 1].regs : pEnd;
+            earAlloc.locsPerRH[i] = (A_UINT16)(pRegs - pEarHead->pRH[i].regs);
+        }
+    }
+    if (!ar5513CalImageMove(pCur, counts, sizeof(counts))) {
+        return FALSE;
+    }
+    if (counts[1] == 0) {
+        return TRUE;
+    }
+    if (counts[1] > MAX_NUM_REGISTER_HEADERS ||
+        !ar5513CalImageMove(pCur, earAlloc.locsPerRH, sizeof(A_UINT16) * counts[1]))
+    {
+        return FALSE;
+    }
+
+    if (pCur->load) {
+        earAlloc.numRHs = counts[1];
+        if (ar5513EarAllocate(pInfo, &earAlloc, &pInfo->pEarHead) == FALSE) {
+            return FALSE;
+        }
+        pEarHead = pInfo->pEarHead;
+        pEarHead->versionId = counts[0];
+    }
+
+    /* The register headers, keeping the regs pointers of this copy */
+    for (i = 0; i < counts[1]; i++) {
+        pRH   = &pEarHead->pRH[i];
+        pRegs = pRH->regs;
+        if (!ar5513CalImageMove(pCur, pRH, sizeof(REGISTER_HEADER))) {
+            return FALSE;
+        }
+        pRH->regs = pRegs;
+    }
+    return ar5513CalImageMove(pCur, pEarHead->pRH[0].regs,
+                              pEarHead->earSize - counts[1] * sizeof(REGISTER_HEADER));
+}
+
+/**************************************************************
+ * ar5513CheckCalImage
+ *
+ * A_OK if the image given to the attach is for this EEPROM and
+ * configuration; A_EINVAL if there is no such image.
+ */
+static A_STATUS
+ar5513CheckCalImage(WLAN_DEV_INFO *pDev, A_UINT16 eepVersion, A_UINT32 eepEndLoc, A_UINT8 chainCnt)
+{
+    HAL_INFO            *pInfo = pDev->pHalInfo;
+    const CAL_IMAGE_HDR *pHdr  = (const CAL_IMAGE_HDR *)pInfo->pCalImageIn;
+    CAL_IMAGE_HDR       key;
+    A_UINT8             chain;
+    int                 i;
+
+#ifdef DEBUG
+    /* Debug EAR overrides the EEPROM's */
+    if (pDev->earDebugLength > 0) {
+        return A_EINVAL;
+    }
+#endif
+    if (pHdr == NULL || ((unsigned long)pHdr & 3) ||
+        pInfo->calImageInSize < sizeof(CAL_IMAGE_HDR) + sizeof(EEP_HEADER_INFO) ||
+        pHdr->size != pInfo->calImageInSize ||
+        (pHdr->size & 3) || pHdr->magic != CAL_IMAGE_MAGIC)
+    {
+        return A_EINVAL;
+    }
+
+    if (ar5513CalImageKey(pDev, eepVersion, eepEndLoc, chainCnt, &key) != A_OK) {
+        return A_HARDWARE;
+    }
+    for (i = 0; i < sizeof(key.serialNumber); i++) {
+        if (pHdr->serialNumber[i] != key.serialNumber[i]) {
+            return A_EINVAL;
+        }
+    }
+    for (chain = 0; chain < chainCnt; chain++) {
+        if (pHdr->eepChecksum[chain] != key.eepChecksum[chain]) {
+            return A_EINVAL;
+        }
+    }
+    if (pHdr->layout != key.layout || pHdr->eepVersion != key.eepVersion ||
+        pHdr->eepEndLoc != key.eepEndLoc || pHdr->chainCnt != key.chainCnt ||
+        pHdr->turboGCfg != key.turboGCfg ||
+        (pHdr->expnModes & ~((1 << headerInfo11A) | (1 << headerInfo11B) | (1 << headerInfo11G))) ||
+        pHdr->sum != ar5513CalImageSum(&pHdr->earSize,
+                                       (pHdr->size - CAL_IMAGE_SUM_START) / sizeof(A_UINT32)))
+    {
+        return A_EINVAL;
+    }
+    return A_OK;
+}
+
+/**************************************************************
+ * ar5513LoadCalImage
+ *
+ * Allocates the arena for the image ar5513CheckCalImage accepted
+ * and fills the EEP_MAP and EAR from it.  An image that does not
+ * fit the arena its header sizes is malformed: the arena is freed
+ * and A_EINVAL returned, so the attach can parse the EEPROM.
+ */
+static A_STATUS
+ar5513LoadCalImage(WLAN_DEV_INFO *pDev, A_UINT16 eepVersion, A_UINT8 chainCnt)
+{
+    HAL_INFO            *pInfo = pDev->pHalInfo;
+    const CAL_IMAGE_HDR *pHdr  = (const CAL_IMAGE_HDR *)pInfo->pCalImageIn;
+    CAL_IMAGE_CURSOR    cur;
+    A_STATUS            status;
+
+    status = ar5513AllocateEepArena(pInfo, chainCnt, pHdr->expnModes, pHdr->earSize);
+    if (status != A_OK) {
+        return status;
+    }
+    status = ar5513AllocateProm(pInfo, pInfo->pEepData, chainCnt);
+    if (status == A_OK) {
+        pInfo->pEepData->version   = eepVersion;
+        pInfo->pEepData->expnModes = pHdr->expnModes;
+
+        /* The walk starts with the EEPROM header */
+        cur.pImage = (A_UINT8 *)pHdr;
+        cur.size   = pHdr->size;
+        cur.pos    = sizeof(CAL_IMAGE_HDR);
+        cur.load   = TRUE;
+        if (!ar5513CalImageWalk(&cur, pInfo, chainCnt)) {
+            uiPrintf("ar5513LoadCalImage: Calibration image is malformed - reading the EEPROM\n");
+            status = A_EINVAL;
+        }
+    }
+    if (status != A_OK) {
+        ar5513FreeEepArena(pInfo);
+    }
+    return status;
+}
+
+/**************************************************************
+ * ar5513BuildCalImage
+ *
+ * Saves the EEP_MAP and EAR just parsed from the EEPROM for
+ * halGetCalImage.
+ */
+static A_STATUS
+ar5513BuildCalImage(WLAN_DEV_INFO *pDev, A_UINT32 eepEndLoc, A_UINT8 chainCnt)
+{
+    HAL_INFO         *pInfo = pDev->pHalInfo;
+    CAL_IMAGE_HDR    *pHdr;
+    CAL_IMAGE_CURSOR cur;
+
+#ifdef DEBUG
+    if (pDev->earDebugLength > 0) {
+        return A_EINVAL;
+    }
+#endif
+
+    A_MEM_ZERO(&cur, sizeof(cur));
+    cur.pos = sizeof(CAL_IMAGE_HDR);
+    (void)ar5513CalImageWalk(&cur, pInfo, chainCnt);
+
+    pHdr = (CAL_IMAGE_HDR *)A_DRIVER_MALLOC(cur.pos);
+    if (pHdr == NULL) {
+        return A_NO_MEMORY;
+    }
+    A_MEM_ZERO(pHdr, cur.pos);
+    if (ar5513CalImageKey(pDev, pInfo->pEepData->version, eepEndLoc, chainCnt, pHdr) != A_OK) {
+        A_DRIVER_FREE(pHdr, cur.pos);
+        return A_HARDWARE;
+    }
+
+    cur.pImage = (A_UINT8 *)pHdr;
+    cur.size   = cur.pos;
+    cur.pos    = sizeof(CAL_IMAGE_HDR);
+    (void)ar5513CalImageWalk(&cur, pInfo, chainCnt);
+
+    pHdr->size      = cur.size;
+    pHdr->expnModes = pInfo->pEepData->expnModes;
+    pHdr->earSize   = pInfo->pEarHead ? pInfo->pEarHead->earSize : 0;
+    pHdr->sum       = ar5513CalImageSum(&pHdr->earSize,
+                                      (cur.size - CAL_IMAGE_SUM_START) / sizeof(A_UINT32));
+
+    pInfo->pCalImage    = pHdr;
+    pInfo->calImageSize = cur.size;
+    return A_OK;
+}
+#endif /* HAL_CAL_IMAGE */
+
+/************** EEPROM REV 3/4 DEBUG PRINT FUNCTIONS *****************/
+#if defined(DEBUG)
+static void
+printHeaderInfo(WLAN_DEV_INFO *pDev, EEP_MAP *pEepMap, HEADER_WMODE modeArray)
+{
+    A_UINT16 j;
+    EEP_HEADER_INFO *pHeaderInfo = pEepMap->pEepHeader;
+    A_UINT16 version = pEepMap->version;
+    A_UINT32 regDmn = pDev->pHalInfo->halCapabilities.halRegDmn;
+
+    uiPrintf("\n");
+    uiPrintf(" =======================Header Information======================\n");
+
+    uiPrintf(" |  Major Version           %2d  ", version >> 12);
+    uiPrintf("|  Minor Version           %2d  |\n", version & 0xFFF);
+    uiPrintf(" |-------------------------------------------------------------|\n");
+
+    uiPrintf(" |  A Mode         %1d  ", pHeaderInfo->Amode);
+    uiPrintf("|  B Mode         %1d  ", pHeaderInfo->Bmode);
     uiPrintf("|  G Mode        %1d  |\n", pHeaderInfo->Gmode);
 
     if(regDmn >> 15) {
@@ -3040,6 +3738,9 @@ printEepromStruct(WLAN_DEV_INFO *pDev, EEP_MAP *pEepMap, HEADER_WMODE mode)
     printHeaderInfo(pDev, pEepMap, mode);
 
     for (chnIdx = 0; chnIdx < chainCnt; chnIdx++) {
+	if (ar5513ExpandEepromDataset(pDev, chnIdx, mode) != A_OK) {
+	    continue;
+	}
 	if ((pEepMap->version >= EEPROM_VER4_0) && pEepMap->pEepHeader->eepMap) {
 	    printExpnPower5112(&(pEepMap->chain[chnIdx].modePowerArray5112[mode]), mode);
 	} else {
@@ -3188,14 +3889,32 @@ ar5513EarPreParse(A_UINT16 *in, int numLocs, EAR_ALLOC *earAlloc)
     return curEarLoc;
 }
 
+/**************************************************************************
+ * ar5513EarSize
+ *
+ * Bytes ar5513EarAllocate takes for the register headers and their data
+ */
+static A_UINT32
+ar5513EarSize(EAR_ALLOC *earAlloc)
+{
+    A_UINT32 size;
+    int      i;
+
+    size = earAlloc->numRHs * sizeof(REGISTER_HEADER);
+    for (i = 0; i < earAlloc->numRHs; i++) {
+        size += earAlloc->locsPerRH[i] * sizeof(A_UINT16);
+    }
+    return size;
+}
+
 /**************************************************************************
  * ar5513EarAllocate
  *
  * Now that the Ear structure size is known, allocate the EAR header and
- * the individual register headers
+ * the individual register headers from the EEPROM arena
  */
 static A_BOOL
-ar5513EarAllocate(EAR_ALLOC *earAlloc, EAR_HEADER **ppEarHead)
+ar5513EarAllocate(HAL_INFO *pInfo, EAR_ALLOC *earAlloc, EAR_HEADER **ppEarHead)
 {
     int             sizeForRHs;
     int             sizeForRegs = 0;
@@ -3209,7 +3928,7 @@ ar5513EarAllocate(EAR_ALLOC *earAlloc, EAR_HEADER **ppEarHead)
     }
 
     /* Allocate the Ear Header */
-    *ppEarHead = (EAR_HEADER *)A_DRIVER_MALLOC(sizeof(EAR_HEADER));
+    *ppEarHead = (EAR_HEADER *)ar5513EepAlloc(pInfo, sizeof(EAR_HEADER));
     if (*ppEarHead == NULL) {
         uiPrintf("ar5513EarAllocate: Failed to retrieve space for EAR Header\n");
         return FALSE;
@@ -3230,7 +3949,7 @@ ar5513EarAllocate(EAR_ALLOC *earAlloc, EAR_HEADER **ppEarHead)
     }
 
     /* Malloc and assign the space to the RH's */
-    (*ppEarHead)->pRH = (REGISTER_HEADER *) A_DRIVER_MALLOC(sizeForRegs + sizeForRHs);
+    (*ppEarHead)->pRH = (REGISTER_HEADER *)ar5513EepAlloc(pInfo, sizeForRegs + sizeForRHs);
     if ((*ppEarHead)->pRH == NULL) {
         uiPrintf("ar5513EarAllocate: Failed to retrieve space for EAR individual registers\n");
         return 0;
@@ -3481,6 +4200,421 @@ ar5513EarCheckAndFill(EAR_HEADER *earHead, A_UINT16 *in, int totalLocs, EAR_ALLO
     return TRUE;
 }
 
+/**************************************************************************
+ * ar5513EarRHLocs
+ *
+ * The code locations a register header acts at, as a bit per
+ * EAR_LOC_CHECK: its stage, where its writes are done, and any
+ * the disabler turns off or changes the PLL for.
+ */
+static A_UINT32
+ar5513EarRHLocs(const REGISTER_HEADER *pRH)
+{
+    static const A_UINT8 stageLoc[] = {
+        EAR_LC_RF_WRITE, EAR_LC_PHY_ENABLE, EAR_LC_POST_RESET, EAR_LC_POST_PER_CAL
+    };
+    static const A_UINT8 disableLoc[] = {
+        EAR_LC_RESET_OFFSET, EAR_LC_RESET_NF, EAR_LC_RESET_IQ,
+        EAR_LC_PER_FIXED_GAIN, EAR_LC_PER_NF, EAR_LC_PER_GAIN_CIRC
+    };
+    A_UINT32 locs = 1 << stageLoc[pRH->stage];
+    int      i;
+
+    if (IS_PLL_SET(pRH->disabler.disableField)) {
+        locs |= 1 << EAR_LC_PLL;
+    }
+    if (pRH->disabler.valid) {
+        /* A clear bit, starting at bit 8, disables that calibration */
+        for (i = 0; i < (int)sizeof(disableLoc); i++) {
+            if (!((pRH->disabler.disableField >> (8 + i)) & 0x1)) {
+                locs |= 1 << disableLoc[i];
+            }
+        }
+    }
+    return locs;
+}
+
+/**************************************************************************
+ * ar5513EarCompileRH
+ *
+ * Decodes a register header's writes into ops, or just counts them
+ * if pOps is NULL.  Returns the number of ops.
+ */
+static A_UINT16
+ar5513EarCompileRH(const REGISTER_HEADER *pRH, EAR_OP *pOps)
+{
+    A_UINT16 tag, regLoc = 0, num, numOps = 0, last, i;
+    A_UINT16 numBits, bitsThisWrite, startBit;
+    A_UINT32 address, reg32;
+    EAR_OP   op;
+
+    A_MEM_ZERO(&op, sizeof(op));
+
+    switch (pRH->type) {
+    case EAR_TYPE0:
+        do {
+            address = pRH->regs[regLoc] & ~T0_TAG_M;
+            tag     = pRH->regs[regLoc] & T0_TAG_M;
+            regLoc++;
+            op.addr = address;
+            if ((tag == T0_TAG_32BIT) || (tag == T0_TAG_32BIT_LAST)) {
+                op.kind  = EAR_OP_WRITE;
+                op.value = ((A_UINT32)pRH->regs[regLoc] << 16) | pRH->regs[regLoc + 1];
+                regLoc  += 2;
+            } else if (tag == T0_TAG_16BIT_LOW) {
+                op.kind  = EAR_OP_RMW;
+                op.value = pRH->regs[regLoc++];
+                op.mask  = 0xFFFF;
+            } else {
+                op.kind  = EAR_OP_RMW;
+                op.value = (A_UINT32)pRH->regs[regLoc++] << 16;
+                op.mask  = 0xFFFF0000;
+            }
+            if (pOps) {
+                pOps[numOps] = op;
+            }
+            numOps++;
+        } while (tag != T0_TAG_32BIT_LAST);
+        break;
+    case EAR_TYPE1:
+        address = pRH->regs[regLoc] & ~T1_NUM_M;
+        num     = pRH->regs[regLoc] & T1_NUM_M;
+        regLoc++;
+        op.kind = EAR_OP_WRITE;
+        for (i = 0; i < num + 1; i++) {
+            op.addr  = address + i * sizeof(A_UINT32);
+            op.value = ((A_UINT32)pRH->regs[regLoc] << 16) | pRH->regs[regLoc + 1];
+            regLoc  += 2;
+            if (pOps) {
+                pOps[numOps] = op;
+            }
+            numOps++;
+        }
+        break;
+    case EAR_TYPE2:
+        op.kind = EAR_OP_RF;
+        do {
+            last      = IS_TYPE2_LAST(pRH->regs[regLoc]);
+            op.arg    = (A_UINT8)((pRH->regs[regLoc] & T2_BANK_M) >> T2_BANK_S);
+            op.column = (A_UINT8)((pRH->regs[regLoc] & T2_COL_M) >> T2_COL_S);
+            startBit  = pRH->regs[regLoc] & T2_START_M;
+            if (IS_TYPE2_EXTENDED(pRH->regs[regLoc++])) {
+                numBits = pRH->regs[regLoc++];
+                num     = A_DIV_UP(numBits, 16);
+                for (i = 0; i < num; i++) {
+                    /* The bank is modified 16 bits at a time */
+                    bitsThisWrite = (numBits > 16) ? 16 : numBits;
+                    numBits      -= bitsThisWrite;
+                    op.numBits    = (A_UINT8)bitsThisWrite;
+                    op.addr       = startBit;
+                    op.value      = pRH->regs[regLoc++];
+                    if (pOps) {
+                        pOps[numOps] = op;
+                    }
+                    numOps++;
+                    startBit     += bitsThisWrite;
+                }
+            } else {
+                op.numBits = (A_UINT8)((pRH->regs[regLoc] & T2_NUMB_M) >> T2_NUMB_S);
+                op.addr    = startBit;
+                op.value   = pRH->regs[regLoc++] & T2_DATA_M;
+                if (pOps) {
+                    pOps[numOps] = op;
+                }
+                numOps++;
+            }
+        } while (!last);
+        break;
+    case EAR_TYPE3:
+        op.kind = EAR_OP_TYPE3;
+        do {
+            op.arg   = (A_UINT8)((pRH->regs[regLoc] & T3_OPCODE_M) >> T3_OPCODE_S);
+            last     = IS_TYPE3_LAST(pRH->regs[regLoc]);
+            startBit = (pRH->regs[regLoc] & T3_START_M) >> T3_START_S;
+            numBits  = pRH->regs[regLoc] & T3_NUMB_M;
+            regLoc++;
+            op.addr  = pRH->regs[regLoc++];
+            if (numBits > 16) {
+                reg32   = ((A_UINT32)pRH->regs[regLoc] << 16) | pRH->regs[regLoc + 1];
+                regLoc += 2;
+            } else {
+                reg32 = pRH->regs[regLoc++];
+            }
+            op.value = reg32 << startBit;
+            op.mask  = (((A_UINT32)1 << numBits) - 1) << startBit;
+            if (pOps) {
+                pOps[numOps] = op;
+            }
+            numOps++;
+        } while (!last);
+        break;
+    }
+
+    return numOps;
+}
+
+/* The channel ranges of the channel modifier bits 0 to 13 */
+static const A_UINT16 earFlaggedChannels[14][2] = {
+    {2412, 2412}, {2417, 2437}, {2442, 2457}, {2462, 2467}, {2472, 2472}, {2484, 2484}, {2300, 2407},
+    {4900, 5160}, {5170, 5180}, {5190, 5250}, {5260, 5300}, {5310, 5320}, {5500, 5700}, {5725, 5825}
+};
+
+/*
+ * The channel index tells spur channels apart only within these
+ * bands, which hold every channel the radio tunes.  Each starts
+ * and ends on a multiple of 32 MHz.
+ */
+static const A_UINT16 earSpurBands[2][2] = {
+    {2272, 2720}, {4864, 6112}
+};
+
+/**************************************************************
+ * ar5513IsChannelInEarRegHead
+ *
+ * Does a register header with the given channel modifier apply
+ * to channelMhz
+ */
+static A_BOOL
+ar5513IsChannelInEarRegHead(A_UINT16 earChannel, A_UINT16 channelMhz)
+{
+    int i;
+
+    /* No channel specified - applies to all channels */
+    if (earChannel == 0) {
+        return TRUE;
+    }
+
+    /* Do we match the single channel check if its set? */
+    if (IS_CM_SINGLE(earChannel)) {
+        return ((earChannel & ~0x8000) == channelMhz) ? TRUE : FALSE;
+    }
+
+    /* Rest of the channel modifier bits can be set as one or more ranges - check them all */
+    if ((IS_CM_SPUR(earChannel)) && (IS_SPUR_CHAN(channelMhz))) {
+        return TRUE;
+    }
+    for (i = 0; i < 14; i++) {
+        if ((earChannel >> i) & 1) {
+            if ((earFlaggedChannels[i][0] <= channelMhz) && (earFlaggedChannels[i][1] >= channelMhz)) {
+                return TRUE;
+            }
+        }
+    }
+    return FALSE;
+}
+
+/**************************************************************************
+ * ar5513EarSegEqual
+ *
+ * Do the same entries apply at both channels
+ */
+static A_BOOL
+ar5513EarSegEqual(const EAR_PROGRAM *pProg, A_UINT16 chanA, A_UINT16 chanB)
+{
+    A_UINT32 i;
+
+    for (i = 0; i < pProg->first[EAR_NUM_LC]; i++) {
+        if (ar5513IsChannelInEarRegHead(pProg->pEntries[i].channel, chanA) !=
+            ar5513IsChannelInEarRegHead(pProg->pEntries[i].channel, chanB))
+        {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/**************************************************************************
+ * ar5513EarIndex
+ *
+ * Splits the channels at every edge of an entry's channel modifier
+ * and lists, for each resulting segment, the entries that apply at
+ * each location - so reset finds them with a binary search on the
+ * channel.  Neighbouring segments with the same entries are merged.
+ */
+static A_STATUS
+ar5513EarIndex(EAR_PROGRAM *pProg)
+{
+    EAR_CHAN_SEG *pSeg;
+    A_UINT16     *pBounds, chan, rangeMask = 0;
+    A_UINT32     numEntries = pProg->first[EAR_NUM_LC];
+    A_UINT32     maxBounds, numBounds = 0, numSegs, total = 0, pos, size, i, j;
+    A_BOOL       spur = FALSE;
+    int          loc;
+
+    maxBounds = 1 + 2 * numEntries + 2 * 14 +
+                4 * ((earSpurBands[0][1] - earSpurBands[0][0]) / 32) + 1 +
+                4 * ((earSpurBands[1][1] - earSpurBands[1][0]) / 32) + 1;
+    pBounds = (A_UINT16 *)A_DRIVER_MALLOC(maxBounds * sizeof(A_UINT16));
+    if (pBounds == NULL) {
+        return A_NO_MEMORY;
+    }
+
+    /* Every channel where some entry may start or stop applying */
+    pBounds[numBounds++] = 0;
+    for (i = 0; i < numEntries; i++) {
+        chan = pProg->pEntries[i].channel;
+        if (chan == 0) {
+            continue;
+        }
+        if (IS_CM_SINGLE(chan)) {
+            pBounds[numBounds++] = chan & CM_SINGLE_CHAN_M;
+            pBounds[numBounds++] = (chan & CM_SINGLE_CHAN_M) + 1;
+        } else {
+            rangeMask |= chan & ((1 << 14) - 1);
+            spur      |= IS_CM_SPUR(chan);
+        }
+    }
+    for (i = 0; i < 14; i++) {
+        if ((rangeMask >> i) & 1) {
+            pBounds[numBounds++] = earFlaggedChannels[i][0];
+            pBounds[numBounds++] = earFlaggedChannels[i][1] + 1;
+        }
+    }
+    for (i = 0; spur && i < 2; i++) {
+        /* IS_SPUR_CHAN changes at 1, 10 and 23 MHz past each multiple of 32 */
+        for (chan = earSpurBands[i][0]; chan < earSpurBands[i][1]; chan += 32) {
+            pBounds[numBounds++] = chan;
+            pBounds[numBounds++] = chan + 1;
+            pBounds[numBounds++] = chan + 10;
+            pBounds[numBounds++] = chan + 23;
+        }
+        pBounds[numBounds++] = earSpurBands[i][1];
+    }
+    ASSERT(numBounds <= maxBounds);
+
+    /* Sort, then keep the bounds where the applicable entries change */
+    for (i = 1; i < numBounds; i++) {
+        chan = pBounds[i];
+        for (j = i; j > 0 && pBounds[j - 1] > chan; j--) {
+            pBounds[j] = pBounds[j - 1];
+        }
+        pBounds[j] = chan;
+    }
+    for (i = 1, numSegs = 1; i < numBounds; i++) {
+        if (pBounds[i] != pBounds[numSegs - 1] &&
+            !ar5513EarSegEqual(pProg, pBounds[i], pBounds[numSegs - 1]))
+        {
+            pBounds[numSegs++] = pBounds[i];
+        }
+    }
+
+    for (i = 0; i < numSegs; i++) {
+        for (j = 0; j < numEntries; j++) {
+            total += ar5513IsChannelInEarRegHead(pProg->pEntries[j].channel, pBounds[i]) ? 1 : 0;
+        }
+    }
+
+    size = numSegs * sizeof(EAR_CHAN_SEG) + total * sizeof(A_UINT16);
+    pProg->pSegs = (EAR_CHAN_SEG *)A_DRIVER_MALLOC(size);
+    if (pProg->pSegs == NULL) {
+        A_DRIVER_FREE(pBounds, maxBounds * sizeof(A_UINT16));
+        return A_NO_MEMORY;
+    }
+    A_MEM_ZERO(pProg->pSegs, size);
+    pProg->indexSize   = size;
+    pProg->numSegs     = numSegs;
+    pProg->pSegEntries = (A_UINT16 *)(pProg->pSegs + numSegs);
+
+    for (i = 0, pos = 0; i < numSegs; i++) {
+        pSeg            = &pProg->pSegs[i];
+        pSeg->loChannel = pBounds[i];
+        for (loc = 0; loc < EAR_NUM_LC; loc++) {
+            pSeg->first[loc] = pos;
+            for (j = pProg->first[loc]; j < pProg->first[loc + 1]; j++) {
+                if (ar5513IsChannelInEarRegHead(pProg->pEntries[j].channel, pSeg->loChannel)) {
+                    pProg->pSegEntries[pos++] = (A_UINT16)j;
+                    pSeg->modes |= pProg->pEntries[j].modes;
+                }
+            }
+        }
+        pSeg->first[EAR_NUM_LC] = pos;
+    }
+
+    A_DRIVER_FREE(pBounds, maxBounds * sizeof(A_UINT16));
+    return A_OK;
+}
+
+/**************************************************************************
+ * ar5513EarCompile
+ *
+ * Compiles the EAR register headers into the per location lists
+ * of EAR_PROGRAM, so reset neither decodes them nor visits the
+ * headers that have nothing to do at a location.
+ */
+static A_STATUS
+ar5513EarCompile(HAL_INFO *pInfo)
+{
+    EAR_HEADER     *pEarHead = pInfo->pEarHead;
+    EAR_PROGRAM    *pProg;
+    EAR_PROG_ENTRY *pEnt;
+    A_UINT16       next[EAR_NUM_LC];
+    A_UINT32       numEntries = 0, numOps = 0, size, locs;
+    A_UINT16       opsRH;
+    int            i, loc;
+
+    ASSERT(pEarHead && pInfo->pEarProg == NULL);
+
+    for (i = 0; i < pEarHead->numRHs; i++) {
+        locs = ar5513EarRHLocs(&pEarHead->pRH[i]);
+        for (loc = 0; loc < EAR_NUM_LC; loc++) {
+            numEntries += (locs >> loc) & 1;
+        }
+        numOps += ar5513EarCompileRH(&pEarHead->pRH[i], NULL);
+    }
+
+    size  = sizeof(EAR_PROGRAM) + numOps * sizeof(EAR_OP) + numEntries * sizeof(EAR_PROG_ENTRY);
+    pProg = (EAR_PROGRAM *)A_DRIVER_MALLOC(size);
+    if (pProg == NULL) {
+        uiPrintf("ar5513EarCompile: Could not allocate the compiled EAR\n");
+        return A_NO_MEMORY;
+    }
+    A_MEM_ZERO(pProg, size);
+    pProg->allocSize = size;
+    pProg->pOps      = (EAR_OP *)(pProg + 1);
+    pProg->pEntries  = (EAR_PROG_ENTRY *)(pProg->pOps + numOps);
+
+    /* Lay the locations out one after the other */
+    for (i = 0; i < pEarHead->numRHs; i++) {
+        locs = ar5513EarRHLocs(&pEarHead->pRH[i]);
+        for (loc = 0; loc < EAR_NUM_LC; loc++) {
+            pProg->first[loc + 1] += (locs >> loc) & 1;
+        }
+    }
+    for (loc = 0; loc < EAR_NUM_LC; loc++) {
+        pProg->first[loc + 1] += pProg->first[loc];
+        next[loc] = pProg->first[loc];
+    }
+
+    for (i = 0, numOps = 0; i < pEarHead->numRHs; i++) {
+        locs  = ar5513EarRHLocs(&pEarHead->pRH[i]);
+        opsRH = ar5513EarCompileRH(&pEarHead->pRH[i], &pProg->pOps[numOps]);
+        for (loc = 0; loc < EAR_NUM_LC; loc++) {
+            if (!((locs >> loc) & 1)) {
+                continue;
+            }
+            pEnt           = &pProg->pEntries[next[loc]++];
+            pEnt->modes    = pEarHead->pRH[i].modes;
+            pEnt->channel  = pEarHead->pRH[i].channel;
+            pEnt->pllValue = pEarHead->pRH[i].disabler.pllValue;
+            if (loc <= EAR_LC_POST_PER_CAL) {
+                /* Only the stage location does the writes */
+                pEnt->firstOp = (A_UINT16)numOps;
+                pEnt->numOps  = opsRH;
+            }
+        }
+        numOps += opsRH;
+    }
+
+    if (ar5513EarIndex(pProg) != A_OK) {
+        uiPrintf("ar5513EarCompile: Could not allocate the EAR channel index\n");
+        A_DRIVER_FREE(pProg, size);
+        return A_NO_MEMORY;
+    }
+
+    pInfo->pEarProg = pProg;
+    return A_OK;
+}
+
 static A_UINT16
 ar5513ReadRadioChipRev(WLAN_DEV_INFO *pDev, A_UINT16 chain_base)
 {
@@ -74,10 +74,13 @@ ar5513GetInterrupts(WLAN_DEV_INFO *pDev, HAL_INT_TYPE *pUnmaskedValue, A_UINT32
     A_UINT32        isr, isrS2 = 0, maskedIsr;
     HAL_INT_TYPE    ints = 0, maskedInts = 0;
 
+    HAL_REG_PROFILE_FN(pDev, ar5513GetInterrupts);
+
     *pDescQueueBitMask = 0;
     isr = readPlatformReg(pDev, MAC_ISR);
     
     if (isr == 0xffffffff) {
+        HAL_REG_PROFILE_EXIT(pDev);
         return HAL_INT_NOCARD;
     }
 
@@ -207,6 +210,7 @@ ar5513GetInterrupts(WLAN_DEV_INFO *pDev, HAL_INT_TYPE *pUnmaskedValue, A_UINT32
     *pUnmaskedValue = ints;
 
     /* Return the masked value. */
+    HAL_REG_PROFILE_EXIT(pDev);
     return maskedInts;
 }
 
@@ -225,6 +229,8 @@ ar5513EnableInterrupts(WLAN_DEV_INFO *pDev, HAL_INT_TYPE ints)
     int         intKey = 0;
 #endif
 
+    HAL_REG_PROFILE_FN(pDev, ar5513EnableInterrupts);
+
     if (pDev->powerMgmt.powerState == D3_STATE && 0) {
         A_UINT32 rdData;
         /*
@@ -250,6 +256,7 @@ ar5513EnableInterrupts(WLAN_DEV_INFO *pDev, HAL_INT_TYPE ints)
         if (pDev->pHalInfo->globIntRefCount == 0) {
             writePlatformReg(pDev, MAC_IER, MAC_IER_ENABLE);
         }
+        HAL_REG_PROFILE_EXIT(pDev);
         return;
     }
 
@@ -312,6 +319,7 @@ ar5513EnableInterrupts(WLAN_DEV_INFO *pDev, HAL_INT_TYPE ints)
         writePlatformReg(pDev, MAC_IER, MAC_IER_ENABLE);
 #endif
     }
+    HAL_REG_PROFILE_EXIT(pDev);
 }
 
 /**************************************************************
@@ -329,6 +337,8 @@ ar5513DisableInterrupts(WLAN_DEV_INFO *pDev, HAL_INT_TYPE ints)
     int         intKey = 0;
 #endif
 
+    HAL_REG_PROFILE_FN(pDev, ar5513DisableInterrupts);
+
     if (ints & HAL_INT_GLOBAL) {
 #if AR_PB32
         intKey = intLock();
@@ -345,6 +355,7 @@ ar5513DisableInterrupts(WLAN_DEV_INFO *pDev, HAL_INT_TYPE ints)
         sysPciIntrAck();
         intUnlock(intKey);
 #endif
+        HAL_REG_PROFILE_EXIT(pDev);
         return;
     }
     /*
@@ -401,6 +412,7 @@ ar5513DisableInterrupts(WLAN_DEV_INFO *pDev, HAL_INT_TYPE ints)
         writePlatformReg(pDev, MAC_IER, MAC_IER_ENABLE);
 #endif
     }
+    HAL_REG_PROFILE_EXIT(pDev);
 }
 
 #endif /* BUILD_AR5513 */
@@ -17,6 +17,8 @@
 #include "hal.h"
 #include "ui.h"
 #include "halUtil.h"
+#include "halKeyCache.h"
+#include "halWriteList.h"
 
 /* Headers for HW private items */
 #include "ar5513MacReg.h"
@@ -41,9 +43,101 @@ int kcDebugLevel = 0;
 #define KC_DEBUG_LOG    0x0001
 #define KC_DEBUG_PLUMB  0x0002
 
+#define KEY_CACHE_WORDS (sizeof(AR5513_KEY_CACHE_ENTRY) / sizeof(A_UINT32))
+
+#define KEY_STAGE_SETS          8   /* Entries staged per pass of ar5513SetKeyCacheEntries */
+#define KEY_STAGE_SET_WRITES    40  /* Most writes ar5513SetKeyCacheEntry makes (TKIP: 36) */
+
+/*
+ * The key cache words as last written, so the antenna updates need
+ * not read them back.  The MAC updates lastTxAnt, txChain0Sel and
+ * txChain1Sel itself; those bits are not tracked.
+ */
+struct ar5513KeyShadow {
+    A_UINT32                valid[MAC_KEY_CACHE_SIZE / 32]; /* Entries whose keyType is known */
+    A_BOOL                  kcMaskValid;
+    A_UINT32                kcMask;                         /* MAC_KC_MASK between masked writes */
+    AR5513_KEY_CACHE_ENTRY  entry[MAC_KEY_CACHE_SIZE];
+    A_BOOL                  staging;                        /* Writes go to stage, not the chip */
+    A_UINT32                numStaged;
+    HAL_REG_WRITE           stage[KEY_STAGE_SETS * KEY_STAGE_SET_WRITES];
+};
+
+#define KEY_SHADOW_VALID(_pShadow, _idx) \
+    ((_pShadow)->valid[(_idx) >> 5] & (1 << ((_idx) & 31)))
+
 static void
 ar5513KeyCacheInvalidate(WLAN_DEV_INFO *pdevInfo, A_UINT16 hwIndex);
 
+/**************************************************************
+ * ar5513KeyShadowAttach
+ */
+A_STATUS
+ar5513KeyShadowAttach(WLAN_DEV_INFO *pDev)
+{
+    struct ar5513KeyShadow *pShadow;
+
+    ASSERT(pDev && pDev->pHalInfo);
+
+    pShadow = (struct ar5513KeyShadow *)A_DRIVER_MALLOC(sizeof(struct ar5513KeyShadow));
+    if (pShadow == NULL) {
+        uiPrintf("ar5513KeyShadowAttach: Could not allocate key cache shadow\n");
+        return A_NO_MEMORY;
+    }
+    A_MEM_ZERO(pShadow, sizeof(struct ar5513KeyShadow));
+
+    pDev->pHalInfo->pKeyShadow = pShadow;
+    return A_OK;
+}
+
+/**************************************************************
+ * ar5513KeyShadowDetach
+ */
+void
+ar5513KeyShadowDetach(WLAN_DEV_INFO *pDev)
+{
+    ASSERT(pDev && pDev->pHalInfo);
+
+    if (pDev->pHalInfo->pKeyShadow) {
+        A_DRIVER_FREE(pDev->pHalInfo->pKeyShadow, sizeof(struct ar5513KeyShadow));
+        pDev->pHalInfo->pKeyShadow = NULL;
+    }
+}
+
+/**************************************************************
+ * writeKeyCacheReg
+ *
+ * Unmasked write of a key cache word, copied to the shadow - or
+ * only staged, while ar5513SetKeyCacheEntries is staging.
+ */
+static void
+writeKeyCacheReg(WLAN_DEV_INFO *pDev, A_UINT32 reg, A_UINT32 value)
+{
+    struct ar5513KeyShadow *pShadow = pDev->pHalInfo->pKeyShadow;
+    A_UINT32               word;
+
+    if (pShadow && pShadow->staging) {
+        ASSERT(pShadow->numStaged < KEY_STAGE_SETS * KEY_STAGE_SET_WRITES);
+        pShadow->stage[pShadow->numStaged].addr  = reg;
+        pShadow->stage[pShadow->numStaged].value = value;
+        pShadow->numStaged++;
+        return;
+    }
+
+    writePlatformReg(pDev, reg, value);
+
+    if (pShadow) {
+        word = (reg - MAC_KEY_CACHE) / sizeof(A_UINT32);
+        ASSERT(word < MAC_KEY_CACHE_SIZE * KEY_CACHE_WORDS);
+
+        ((A_UINT32 *)pShadow->entry)[word] = value;
+        if (word % KEY_CACHE_WORDS == KEYREGS_INDEX(keyType)) {
+            word /= KEY_CACHE_WORDS;
+            pShadow->valid[word >> 5] |= 1 << (word & 31);
+        }
+    }
+}
+
 /**************************************************************
  * ar5513GetKeyCacheSize
  *
@@ -140,7 +234,7 @@ ar5513ReserveHalKeyCacheEntries(WLAN_DEV_INFO *pDev)
 
         keyCacheOffset = MAC_KEY_CACHE + (hwIndex * 
                           sizeof(AR5513_KEY_CACHE_ENTRY));
-        writePlatformReg(pDev, keyCacheOffset +
+        writeKeyCacheReg(pDev, keyCacheOffset +
                          FIELD_OFFSET(AR5513_KEY_CACHE_ENTRY, keyType),
                  keyRegs[KEYREGS_INDEX(keyType)].Value);
 
@@ -167,22 +261,22 @@ ar5513ResetKeyCacheEntry(WLAN_DEV_INFO *pDev, A_UINT16 keyCacheIndex)
     keyCacheOffset = MAC_KEY_CACHE +
         (keyCacheIndex * sizeof(AR5513_KEY_CACHE_ENTRY));
 
-    writePlatformReg(pDev, keyCacheOffset +
+    writeKeyCacheReg(pDev, keyCacheOffset +
                      FIELD_OFFSET(AR5513_KEY_CACHE_ENTRY, keyVal0), 0);
-    writePlatformReg(pDev, keyCacheOffset +
+    writeKeyCacheReg(pDev, keyCacheOffset +
                      FIELD_OFFSET(AR5513_KEY_CACHE_ENTRY, keyVal1), 0);
-    writePlatformReg(pDev, keyCacheOffset +
+    writeKeyCacheReg(pDev, keyCacheOffset +
                      FIELD_OFFSET(AR5513_KEY_CACHE_ENTRY, keyVal2), 0);
-    writePlatformReg(pDev, keyCacheOffset +
+    writeKeyCacheReg(pDev, keyCacheOffset +
                      FIELD_OFFSET(AR5513_KEY_CACHE_ENTRY, keyVal3), 0);
-    writePlatformReg(pDev, keyCacheOffset +
+    writeKeyCacheReg(pDev, keyCacheOffset +
                      FIELD_OFFSET(AR5513_KEY_CACHE_ENTRY, keyVal4), 0);
-    writePlatformReg(pDev, keyCacheOffset +
+    writeKeyCacheReg(pDev, keyCacheOffset +
                      FIELD_OFFSET(AR5513_KEY_CACHE_ENTRY, keyType),
                      MAC_KEY_TYPE_CLEAR);
-    writePlatformReg(pDev, keyCacheOffset +
+    writeKeyCacheReg(pDev, keyCacheOffset +
                      FIELD_OFFSET(AR5513_KEY_CACHE_ENTRY, macAddrLo), 0);
-    writePlatformReg(pDev, keyCacheOffset +
+    writeKeyCacheReg(pDev, keyCacheOffset +
                      FIELD_OFFSET(AR5513_KEY_CACHE_ENTRY, macAddrHi), 0);
 }
 
@@ -408,21 +502,21 @@ ar5513SetKeyCacheEntry(WLAN_DEV_INFO *pDev,    A_UINT16 keyCacheIndex,
         for (i = 0; i < (sizeof (keyRegs) / sizeof (REGISTER_VAL)); i++) {
             keyRegs[i].Offset = MAC_KEY_CACHE + (i*4) +
                 (keyCacheIndex * sizeof(AR5513_KEY_CACHE_ENTRY));
-            writePlatformReg(pDev, keyRegs[i].Offset, keyRegs[i].Value);
+            writeKeyCacheReg(pDev, keyRegs[i].Offset, keyRegs[i].Value);
         }
 
         /* Write the correct keyval0 now */
-        writePlatformReg(pDev, MAC_KEY_CACHE +
+        writeKeyCacheReg(pDev, MAC_KEY_CACHE +
                          (keyCacheIndex * sizeof(AR5513_KEY_CACHE_ENTRY)),
                          savedKey[0]);
-        writePlatformReg(pDev, MAC_KEY_CACHE + 4 +
+        writeKeyCacheReg(pDev, MAC_KEY_CACHE + 4 +
                          (keyCacheIndex * sizeof(AR5513_KEY_CACHE_ENTRY)),
                          savedKey[1]);
 
-        writePlatformReg(pDev, MAC_KEY_CACHE + (24) +
+        writeKeyCacheReg(pDev, MAC_KEY_CACHE + (24) +
                          (keyCacheIndex * sizeof(AR5513_KEY_CACHE_ENTRY)),
                          savedMacLo);
-        writePlatformReg(pDev, MAC_KEY_CACHE + (28) +
+        writeKeyCacheReg(pDev, MAC_KEY_CACHE + (28) +
                          (keyCacheIndex * sizeof(AR5513_KEY_CACHE_ENTRY)),
                          savedMacHi);
 
@@ -449,7 +543,7 @@ ar5513SetKeyCacheEntry(WLAN_DEV_INFO *pDev,    A_UINT16 keyCacheIndex,
         for (i = 0; i < (sizeof (keyRegs) / sizeof (REGISTER_VAL)); i++) {
             keyRegs[i].Offset = MAC_KEY_CACHE + (i*4) +
                 (keyCacheIndex * sizeof(AR5513_KEY_CACHE_ENTRY));
-            writePlatformReg(pDev, keyRegs[i].Offset, keyRegs[i].Value);
+            writeKeyCacheReg(pDev, keyRegs[i].Offset, keyRegs[i].Value);
         }
 
         if (keyCacheIndex < MAX_SHARED_KEYS) {
@@ -471,14 +565,14 @@ ar5513SetKeyCacheEntry(WLAN_DEV_INFO *pDev,    A_UINT16 keyCacheIndex,
             for (i = 0; i < (sizeof (keyRegs) / sizeof (REGISTER_VAL)); i++) {
                 keyRegs[i].Offset = MAC_KEY_CACHE + (i*4) +
                     (tkipIndex * sizeof(AR5513_KEY_CACHE_ENTRY));
-                writePlatformReg(pDev, keyRegs[i].Offset, keyRegs[i].Value);
+                writeKeyCacheReg(pDev, keyRegs[i].Offset, keyRegs[i].Value);
             }
 
             /* patch up the encrypt key */
-            writePlatformReg(pDev, MAC_KEY_CACHE +
+            writeKeyCacheReg(pDev, MAC_KEY_CACHE +
                              (keyCacheIndex * sizeof(AR5513_KEY_CACHE_ENTRY)),
                              savedKey[0]);
-            writePlatformReg(pDev, MAC_KEY_CACHE + 4 +
+            writeKeyCacheReg(pDev, MAC_KEY_CACHE + 4 +
                              (keyCacheIndex * sizeof(AR5513_KEY_CACHE_ENTRY)),
                              savedKey[1]);
 
@@ -510,7 +604,7 @@ ar5513SetKeyCacheEntry(WLAN_DEV_INFO *pDev,    A_UINT16 keyCacheIndex,
             for (i = 0; i < (sizeof (keyRegs) / sizeof (REGISTER_VAL)); i++) {
                 keyRegs[i].Offset = MAC_KEY_CACHE + (i*4) +
                     (tkipIndex * sizeof(AR5513_KEY_CACHE_ENTRY));
-                writePlatformReg(pDev, keyRegs[i].Offset,
+                writeKeyCacheReg(pDev, keyRegs[i].Offset,
                                  keyRegs[i].Value);
             }
 
@@ -529,7 +623,7 @@ ar5513SetKeyCacheEntry(WLAN_DEV_INFO *pDev,    A_UINT16 keyCacheIndex,
             for (i = 0; i < (sizeof (keyRegs) / sizeof (REGISTER_VAL)); i++) {
                 keyRegs[i].Offset = MAC_KEY_CACHE + (i*4) +
                     (tkipIndex * sizeof(AR5513_KEY_CACHE_ENTRY));
-                writePlatformReg(pDev, keyRegs[i].Offset,
+                writeKeyCacheReg(pDev, keyRegs[i].Offset,
                                  keyRegs[i].Value);
             }
 
@@ -547,24 +641,24 @@ ar5513SetKeyCacheEntry(WLAN_DEV_INFO *pDev,    A_UINT16 keyCacheIndex,
             for (i = 0; i < (sizeof (keyRegs) / sizeof (REGISTER_VAL)); i++) {
                 keyRegs[i].Offset = MAC_KEY_CACHE + (i*4) +
                     (tkipIndex * sizeof(AR5513_KEY_CACHE_ENTRY));
-                writePlatformReg(pDev, keyRegs[i].Offset, keyRegs[i].Value);
+                writeKeyCacheReg(pDev, keyRegs[i].Offset, keyRegs[i].Value);
             }
 
             /* Now write out the correct values */
             /* encrypt */
-            writePlatformReg(pDev, MAC_KEY_CACHE +
+            writeKeyCacheReg(pDev, MAC_KEY_CACHE +
                              (keyCacheIndex * sizeof(AR5513_KEY_CACHE_ENTRY)),
                              savedKey[0]);
-            writePlatformReg(pDev, MAC_KEY_CACHE + 4 +
+            writeKeyCacheReg(pDev, MAC_KEY_CACHE + 4 +
                              (keyCacheIndex * sizeof(AR5513_KEY_CACHE_ENTRY)),
                              savedKey[1]);
 
             /* then decrypt */
-            writePlatformReg(pDev, MAC_KEY_CACHE +
+            writeKeyCacheReg(pDev, MAC_KEY_CACHE +
                              ((keyCacheIndex + 32) *
                               sizeof(AR5513_KEY_CACHE_ENTRY)),
                              savedKey[0]);
-            writePlatformReg(pDev, MAC_KEY_CACHE + 4 +
+            writeKeyCacheReg(pDev, MAC_KEY_CACHE + 4 +
                              ((keyCacheIndex + 32) *
                               sizeof(AR5513_KEY_CACHE_ENTRY)),
                              savedKey[1]);
@@ -606,7 +700,7 @@ ar5513SetKeyCacheEntry(WLAN_DEV_INFO *pDev,    A_UINT16 keyCacheIndex,
             for (i = 0; i < (sizeof (keyRegs) / sizeof (REGISTER_VAL)); i++) {
                 keyRegs[i].Offset = MAC_KEY_CACHE + (i*4) +
                     (tkipIndex * sizeof(AR5513_KEY_CACHE_ENTRY));
-                writePlatformReg(pDev, keyRegs[i].Offset, keyRegs[i].Value);
+                writeKeyCacheReg(pDev, keyRegs[i].Offset, keyRegs[i].Value);
             }
 
             tkipIndex = keyCacheIndex + 64; /* enmic key */
@@ -624,14 +718,14 @@ ar5513SetKeyCacheEntry(WLAN_DEV_INFO *pDev,    A_UINT16 keyCacheIndex,
             for (i = 0; i < (sizeof (keyRegs) / sizeof (REGISTER_VAL)); i++) {
                 keyRegs[i].Offset = MAC_KEY_CACHE + (i*4) +
                     (tkipIndex * sizeof(AR5513_KEY_CACHE_ENTRY));
-                writePlatformReg(pDev, keyRegs[i].Offset, keyRegs[i].Value);
+                writeKeyCacheReg(pDev, keyRegs[i].Offset, keyRegs[i].Value);
             }
 
             /* patch up the encrypt key */
-            writePlatformReg(pDev, MAC_KEY_CACHE +
+            writeKeyCacheReg(pDev, MAC_KEY_CACHE +
                              (keyCacheIndex * sizeof(AR5513_KEY_CACHE_ENTRY)),
                              savedKey[0]);
-            writePlatformReg(pDev, MAC_KEY_CACHE + 4 +
+            writeKeyCacheReg(pDev, MAC_KEY_CACHE + 4 +
                              (keyCacheIndex * sizeof(AR5513_KEY_CACHE_ENTRY)),
                              savedKey[1]);
 
@@ -659,7 +753,7 @@ ar5513SetKeyCacheEntry(WLAN_DEV_INFO *pDev,    A_UINT16 keyCacheIndex,
             for (i = 0; i < (sizeof (keyRegs) / sizeof (REGISTER_VAL)); i++) {
                 keyRegs[i].Offset = MAC_KEY_CACHE + (i*4) +
                     (tkipIndex * sizeof(AR5513_KEY_CACHE_ENTRY));
-                writePlatformReg(pDev, keyRegs[i].Offset, keyRegs[i].Value);
+                writeKeyCacheReg(pDev, keyRegs[i].Offset, keyRegs[i].Value);
             }
 
             tkipIndex = keyCacheIndex + 64 + 32; /* demic key */
@@ -676,15 +770,15 @@ ar5513SetKeyCacheEntry(WLAN_DEV_INFO *pDev,    A_UINT16 keyCacheIndex,
             for (i = 0; i < (sizeof (keyRegs) / sizeof (REGISTER_VAL)); i++) {
                 keyRegs[i].Offset = MAC_KEY_CACHE + (i*4) +
                     (tkipIndex * sizeof(AR5513_KEY_CACHE_ENTRY));
-                writePlatformReg(pDev, keyRegs[i].Offset, keyRegs[i].Value);
+                writeKeyCacheReg(pDev, keyRegs[i].Offset, keyRegs[i].Value);
             }
 
             /* patch up the decrypt key */
-            writePlatformReg(pDev,MAC_KEY_CACHE +
+            writeKeyCacheReg(pDev,MAC_KEY_CACHE +
                              ((keyCacheIndex + 32) *
                               sizeof(AR5513_KEY_CACHE_ENTRY)),
                              savedKey[0]);
-            writePlatformReg(pDev, MAC_KEY_CACHE + 4 +
+            writeKeyCacheReg(pDev, MAC_KEY_CACHE + 4 +
                              ((keyCacheIndex + 32) *
                               sizeof(AR5513_KEY_CACHE_ENTRY)),
                              savedKey[1]);
@@ -715,7 +809,7 @@ ar5513SetKeyCacheEntry(WLAN_DEV_INFO *pDev,    A_UINT16 keyCacheIndex,
             for (i = 0; i < (sizeof (keyRegs) / sizeof (REGISTER_VAL)); i++) {
                 keyRegs[i].Offset = MAC_KEY_CACHE + (i*4) +
                     (tkipIndex * sizeof(AR5513_KEY_CACHE_ENTRY));
-                writePlatformReg(pDev, keyRegs[i].Offset, keyRegs[i].Value);
+                writeKeyCacheReg(pDev, keyRegs[i].Offset, keyRegs[i].Value);
             }
 
             tkipIndex = keyCacheIndex + 64; /* demic key */
@@ -732,14 +826,14 @@ ar5513SetKeyCacheEntry(WLAN_DEV_INFO *pDev,    A_UINT16 keyCacheIndex,
             for (i = 0; i < (sizeof (keyRegs) / sizeof (REGISTER_VAL)); i++) {
                 keyRegs[i].Offset = MAC_KEY_CACHE + (i*4) +
                     (tkipIndex * sizeof(AR5513_KEY_CACHE_ENTRY));
-                writePlatformReg(pDev, keyRegs[i].Offset, keyRegs[i].Value);
+                writeKeyCacheReg(pDev, keyRegs[i].Offset, keyRegs[i].Value);
             }
 
             /* patch up the decrypt key */
-            writePlatformReg(pDev, MAC_KEY_CACHE +
+            writeKeyCacheReg(pDev, MAC_KEY_CACHE +
                              (keyCacheIndex * sizeof(AR5513_KEY_CACHE_ENTRY)),
                              savedKey[0]);
-            writePlatformReg(pDev, MAC_KEY_CACHE + 4 +
+            writeKeyCacheReg(pDev, MAC_KEY_CACHE + 4 +
                              (keyCacheIndex * sizeof(AR5513_KEY_CACHE_ENTRY)),
                              savedKey[1]);
         }
@@ -748,19 +842,279 @@ ar5513SetKeyCacheEntry(WLAN_DEV_INFO *pDev,    A_UINT16 keyCacheIndex,
     return;
 }
 
+/**************************************************************
+ * ar5513KeyStageFresh
+ *
+ * TRUE if none of the entries written by stage[first..end) is
+ * valid in the chip, so none is in use while it is written.
+ */
+static A_BOOL
+ar5513KeyStageFresh(struct ar5513KeyShadow *pShadow, A_UINT32 first, A_UINT32 end)
+{
+    A_UINT32 k, idx, keyField;
+
+    for (k = first; k < end; k++) {
+        idx = (pShadow->stage[k].addr - MAC_KEY_CACHE) / sizeof(AR5513_KEY_CACHE_ENTRY);
+        if (!KEY_SHADOW_VALID(pShadow, idx)) {
+            return FALSE;
+        }
+        keyField = pShadow->entry[idx].macAddrHi;
+        if (((MAC_ADDR_HI_KEY_VALID *)&keyField)->keyValid) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/**************************************************************
+ * ar5513KeyStageEmit
+ *
+ * Writes out the staged writes listed in pOrder.  Word pairs go
+ * to a 64 bit register and must be written even then odd, so a
+ * write is only skipped along with the rest of its pair, when the
+ * shadow shows the chip already holds both.  keyType is always
+ * written as the MAC updates bits of it.
+ */
+static void
+ar5513KeyStageEmit(WLAN_DEV_INFO *pDev, struct ar5513KeyShadow *pShadow,
+                   const A_UINT16 *pOrder, A_UINT32 num, HAL_KEY_CACHE_SET_STATS *pStats)
+{
+    const A_UINT32      *pWords = (const A_UINT32 *)pShadow->entry;
+    const HAL_REG_WRITE *pWr, *pNext;
+    A_UINT32            i, word;
+
+    for (i = 0; i < num; i++) {
+        pWr  = &pShadow->stage[pOrder[i]];
+        word = (pWr->addr - MAC_KEY_CACHE) / sizeof(A_UINT32);
+
+        if (i + 1 < num && (word & 1) == 0 &&
+            word % KEY_CACHE_WORDS != KEYREGS_INDEX(keyVal4) &&
+            KEY_SHADOW_VALID(pShadow, word / KEY_CACHE_WORDS))
+        {
+            pNext = &pShadow->stage[pOrder[i + 1]];
+            if (pNext->addr == pWr->addr + sizeof(A_UINT32) &&
+                pWords[word] == pWr->value && pWords[word + 1] == pNext->value)
+            {
+                pStats->writesSkipped += 2;
+                i++;
+                continue;
+            }
+        }
+        writeKeyCacheReg(pDev, pWr->addr, pWr->value);
+        pStats->writes++;
+    }
+}
+
+/**************************************************************
+ * ar5513KeyStageApply
+ *
+ * Writes out the entry staged in stage[first..end).  If none of
+ * the entries it writes is valid yet there is no need to cover
+ * the key with its complement while the rest is set up: each word
+ * is written once, with its final value, and the MAC address
+ * pairs - which carry the valid bit - last.  Otherwise the writes
+ * go out as ar5513SetKeyCacheEntry made them.
+ */
+static void
+ar5513KeyStageApply(WLAN_DEV_INFO *pDev, struct ar5513KeyShadow *pShadow,
+                    A_UINT32 first, A_UINT32 end, HAL_KEY_CACHE_SET_STATS *pStats)
+{
+    HAL_REG_WRITE *pStage = pShadow->stage;
+    A_UINT16      order[KEY_STAGE_SET_WRITES];
+    A_UINT32      num = 0, k, j, pass, word;
+
+    ASSERT(end - first <= KEY_STAGE_SET_WRITES);
+
+    if (!ar5513KeyStageFresh(pShadow, first, end)) {
+        for (k = first; k < end; k++) {
+            order[num++] = (A_UINT16)k;
+        }
+        ar5513KeyStageEmit(pDev, pShadow, order, num, pStats);
+        return;
+    }
+
+    /* Fold later writes of a word into its first */
+    for (k = first; k < end; k++) {
+        if (pStage[k].addr == 0) {
+            continue;
+        }
+        for (j = k + 1; j < end; j++) {
+            if (pStage[j].addr == pStage[k].addr) {
+                pStage[k].value = pStage[j].value;
+                pStage[j].addr  = 0;
+                pStats->writesSkipped++;
+            }
+        }
+    }
+
+    for (pass = 0; pass < 2; pass++) {
+        for (k = first; k < end; k++) {
+            if (pStage[k].addr == 0) {
+                continue;
+            }
+            word = ((pStage[k].addr - MAC_KEY_CACHE) / sizeof(A_UINT32)) % KEY_CACHE_WORDS;
+            if ((word >= KEYREGS_INDEX(macAddrLo)) == (pass == 1)) {
+                order[num++] = (A_UINT16)k;
+            }
+        }
+    }
+    ar5513KeyStageEmit(pDev, pShadow, order, num, pStats);
+}
+
+/**************************************************************
+ * ar5513SetKeyCacheEntries
+ *
+ * Sets numSets key cache entries, in order.  The writes for up to
+ * KEY_STAGE_SETS entries are worked out before any is written.
+ */
+A_STATUS
+ar5513SetKeyCacheEntries(WLAN_DEV_INFO *pDev, const HAL_KEY_CACHE_SET *pSets,
+                         A_UINT32 numSets, HAL_KEY_CACHE_SET_STATS *pStats)
+{
+    struct ar5513KeyShadow *pShadow = pDev->pHalInfo->pKeyShadow;
+    A_UINT32               end[KEY_STAGE_SETS];
+    A_UINT32               i, n, numPass;
+
+    if (pShadow == NULL) {
+        for (i = 0; i < numSets; i++) {
+            ar5513SetKeyCacheEntry(pDev, pSets[i].keyCacheIndex, pSets[i].pMacAddr,
+                                   pSets[i].pWlanPrivRecord, pSets[i].bXorKey);
+        }
+        return A_OK;
+    }
+
+    for (i = 0; i < numSets; i += numPass) {
+        numPass = A_MIN(numSets - i, KEY_STAGE_SETS);
+
+        pShadow->numStaged = 0;
+        pShadow->staging   = TRUE;
+        for (n = 0; n < numPass; n++) {
+            ar5513SetKeyCacheEntry(pDev, pSets[i + n].keyCacheIndex, pSets[i + n].pMacAddr,
+                                   pSets[i + n].pWlanPrivRecord, pSets[i + n].bXorKey);
+            end[n] = pShadow->numStaged;
+        }
+        pShadow->staging = FALSE;
+
+        for (n = 0; n < numPass; n++) {
+            ar5513KeyStageApply(pDev, pShadow, n ? end[n - 1] : 0, end[n], pStats);
+        }
+    }
+    return A_OK;
+}
+
+/* A station's entries must stay put while it has frames queued */
+#ifdef AR5513_QOS
+#define KEY_SIB_IDLE(_pSib)     ((_pSib)->totalTxPending <= 0)
+#else
+#define KEY_SIB_IDLE(_pSib)     ((_pSib)->numTxPending <= 0)
+#endif
+
+/**************************************************************
+ * ar5513KeyGroupClearable
+ *
+ * TRUE if TKIP group hwIndex can be given to pSib once its upper
+ * entries (hwIndex + 32, + 64, + 96) are cleared: each is free,
+ * owned by pOwner, or the only entry of an idle station other
+ * than pSib that can be evicted.
+ */
+static A_BOOL
+ar5513KeyGroupClearable(WLAN_DEV_INFO *pdevInfo, A_UINT16 hwIndex,
+                        SIB_ENTRY *pOwner, SIB_ENTRY *pSib)
+{
+    SIB_ENTRY *pSibtmp;
+    A_UINT16  idx;
+
+    ASSERT(hwIndex < (pdevInfo->keyCacheSize >> 2));
+
+    for (idx = hwIndex + 32; idx <= hwIndex + 32 + 64; idx += 32) {
+        pSibtmp = pdevInfo->keyCacheSib[idx];
+        if (pSibtmp != NULL && pSibtmp != pOwner &&
+            (pSibtmp == pSib || pSibtmp == pdevInfo->localSta ||
+             pSibtmp->hwIndex != idx || !KEY_SIB_IDLE(pSibtmp)))
+        {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/**************************************************************
+ * ar5513KeyGroupClear
+ *
+ * Evicts the single entry keys that ar5513KeyGroupClearable
+ * found in the upper entries of TKIP group hwIndex.  Their
+ * stations get new entries when next keyed.
+ */
+static void
+ar5513KeyGroupClear(WLAN_DEV_INFO *pdevInfo, A_UINT16 hwIndex, SIB_ENTRY *pOwner)
+{
+    SIB_ENTRY *pVictimSib;
+    A_UINT16  idx;
+
+    for (idx = hwIndex + 32; idx <= hwIndex + 32 + 64; idx += 32) {
+        pVictimSib = pdevInfo->keyCacheSib[idx];
+        if (pVictimSib == NULL || pVictimSib == pOwner) {
+            continue;
+        }
+#ifdef DEBUG
+        if (keyDebugLevel > 0) {
+            uiPrintf("ar5513KeyGroupClear: moving Sib 0x%x out of group %d\n",
+                     (A_UINT32)pVictimSib, hwIndex);
+        }
+#endif
+        A_SIB_ENTRY_LOCK(pVictimSib);
+        ASSERT(pVictimSib->hwIndex == idx);
+
+        ar5513KeyCacheFree(pdevInfo, idx);
+
+        pdevInfo->keyCache[idx] = NULL;
+        pVictimSib->hwIndex     = HWINDEX_INVALID;
+
+        swretryStateReset(pdevInfo, pVictimSib, TRUE, FALSE);
+        A_SIB_ENTRY_UNLOCK(pVictimSib);
+    }
+}
+
+/**************************************************************
+ * ar5513KeyGroupCompact
+ *
+ * Finds the lowest TKIP group below indexLimit whose first
+ * entry is free and whose upper entries hold only keys that can
+ * be evicted, and clears it for pSib.  Returns HWINDEX_INVALID
+ * if there is none.
+ */
+static A_UINT16
+ar5513KeyGroupCompact(WLAN_DEV_INFO *pdevInfo, A_UINT16 indexLimit,
+                      A_BOOL skipShared, SIB_ENTRY *pSib)
+{
+    A_UINT16 hwIndex;
+
+    for (hwIndex = MAX_SHARED_KEYS; hwIndex < indexLimit; hwIndex++) {
+        if ((skipShared && (hwIndex & 0x1F) < MAX_SHARED_KEYS) ||
+            pdevInfo->keyCacheSib[hwIndex] != NULL ||
+            hwIndex >= (pdevInfo->keyCacheSize >> 2))
+        {
+            continue;
+        }
+        if (ar5513KeyGroupClearable(pdevInfo, hwIndex, NULL, pSib)) {
+            ar5513KeyGroupClear(pdevInfo, hwIndex, NULL);
+            return hwIndex;
+        }
+    }
+    return HWINDEX_INVALID;
+}
+
 A_UINT16
 ar5513KeyCacheAlloc(WLAN_DEV_INFO *pdevInfo, A_UINT16 hwIndex,
                     SIB_ENTRY *pSib, A_UINT16 keyType,
                     A_BOOL *pHwEncrypt)
 {
     SIB_ENTRY        *pVictimSib = NULL;
-    SIB_ENTRY        *pAssocSib  = NULL;
-    SIB_ENTRY        *pFreeSib   = NULL;
-    A_UINT32         tsAssoc     = 0xffffffff;
-    A_UINT32         tsFree      = 0xffffffff;
     SIB_ENTRY        *pSibtmp;
     SIB_ENTRY        **keyCacheSib;
-    A_UINT16         indexLimit, singleEntry = 0;
+    A_UINT16         indexLimit, idx;
+    A_UINT32         list;
+    A_BOOL           skipShared;
 #ifdef AR5513_QOS
     int i;
 #endif
@@ -800,21 +1154,19 @@ ar5513KeyCacheAlloc(WLAN_DEV_INFO *pdevInfo, A_UINT16 hwIndex,
             keyInfo.keyType = PRIV_KEY_TYPE_WEP;
 
             if (hwIndex < (pdevInfo->keyCacheSize >> 2) &&
-                (!keyCacheSib[hwIndex + 32] ||
-                 keyCacheSib[hwIndex + 32] == pSib) &&
-                (!keyCacheSib[hwIndex + 64] ||
-                 keyCacheSib[hwIndex + 64] == pSib) &&
-                (!keyCacheSib[hwIndex + 32 + 64] ||
-                keyCacheSib[hwIndex + 32 + 64] == pSib) )
+                ar5513KeyGroupClearable(pdevInfo, hwIndex, pSib, pSib))
             {
-                keyCacheSib[hwIndex + 32] = pSib;
-                keyCacheSib[hwIndex + 64] = pSib;
-                keyCacheSib[hwIndex + 32 + 64] = pSib;
+                /* Rather than fall back to software crypto */
+                ar5513KeyGroupClear(pdevInfo, hwIndex, pSib);
+                halKeySlotSet(pdevInfo, hwIndex + 32, pSib);
+                halKeySlotSet(pdevInfo, hwIndex + 64, pSib);
+                halKeySlotSet(pdevInfo, hwIndex + 32 + 64, pSib);
             } else if (pHwEncrypt) {
                *pHwEncrypt = FALSE;
             }
         }
-        keyCacheSib[hwIndex] = pSib;
+        halKeySlotSet(pdevInfo, hwIndex, pSib);
+        halKeySlotTouch(pdevInfo, hwIndex);
         return (hwIndex);
     }
     if (pdevInfo->staConfig.encryptionAlg == ENCRYPTION_TKIP ||
@@ -842,55 +1194,52 @@ ar5513KeyCacheAlloc(WLAN_DEV_INFO *pdevInfo, A_UINT16 hwIndex,
         }
     }
 
-    for (hwIndex = MAX_SHARED_KEYS; hwIndex < indexLimit; hwIndex++) {
-        if (((hwIndex & 0x1F) < MAX_SHARED_KEYS) &&
-            pdevInfo->localSta->serviceType == WLAN_STA_SERVICE)
-        {
-            /*
-             * Do not allocate an index which would be required by a
-             * broadcast key using TKIP
-             */
-            continue;
-        }
+    skipShared = (A_BOOL)(pdevInfo->localSta->serviceType == WLAN_STA_SERVICE);
 
-        pSibtmp = keyCacheSib[hwIndex];
-        if (pSibtmp == NULL) {
-            if (keyType != PRIV_KEY_TYPE_TKIP) {
-                break;
-            } else {
-                singleEntry = hwIndex;
-                if (hwIndex < (pdevInfo->keyCacheSize >> 2) &&
-                    keyCacheSib[hwIndex + 32] == NULL &&
-                    keyCacheSib[hwIndex + 64] == NULL &&
-                    keyCacheSib[hwIndex + 32 + 64] == NULL)
+    /*
+     * With TKIP in use the key cache is allocated in groups of four,
+     * entries n, n+32, n+64 and n+96.  Single entry keys stay below
+     * the group limit too, since the station may later be rekeyed to
+     * TKIP at the index it holds, and a TKIP key held up only by
+     * single entry keys moves them out.
+     */
+    hwIndex = halKeySlotFindFree(pdevInfo, indexLimit, skipShared,
+                                 (A_BOOL)(keyType == PRIV_KEY_TYPE_TKIP));
+    if (hwIndex == HWINDEX_INVALID && keyType == PRIV_KEY_TYPE_TKIP) {
+        hwIndex = ar5513KeyGroupCompact(pdevInfo, indexLimit, skipShared, pSib);
+    }
+    if (hwIndex == HWINDEX_INVALID) {
+        /*
+         * Nothing free.  Take the least recently active station without
+         * pending tx frames, with preference to stations that are not
+         * associated.  The LRU lists hold them in that order.
+         */
+        for (list = 0; list < 2 && pVictimSib == NULL; list++) {
+            for (idx = halKeySlotLruFirst(pdevInfo, list); idx != HWINDEX_INVALID;
+                 idx = halKeySlotLruNext(pdevInfo, idx))
+            {
+                pSibtmp = keyCacheSib[idx];
+                if (idx < MAX_SHARED_KEYS || idx >= indexLimit ||
+                    (skipShared && (idx & 0x1F) < MAX_SHARED_KEYS) ||
+                    !KEY_SIB_IDLE(pSibtmp) || pSibtmp == pdevInfo->localSta)
                 {
-                     break;
-                }
-            }
-#ifdef AR5513_QOS
-        } else if (pSibtmp->totalTxPending <= 0 &&
-                   pSibtmp != pdevInfo->localSta)
-#else
-        } else if (pSibtmp->numTxPending <= 0 &&
-                   pSibtmp != pdevInfo->localSta)
-#endif
-        {
-            /* Is there a race condition here?  The sib may wake up? */
-            if (pSibtmp->staState & (STATE_AUTH|STATE_ASSOC)) {
-                if (pSibtmp->staLastActivityTime < tsAssoc) {
-                    tsAssoc   = pSibtmp->staLastActivityTime;
-                    pAssocSib = pSibtmp;
+                    continue;
                 }
-            } else {
-                if (pSibtmp->staLastActivityTime < tsFree) {
-                    tsFree   = pSibtmp->staLastActivityTime;
-                    pFreeSib = pSibtmp;
+                if (keyType == PRIV_KEY_TYPE_TKIP &&
+                    (idx >= (pdevInfo->keyCacheSize >> 2) ||
+                     !ar5513KeyGroupClearable(pdevInfo, idx, pSibtmp, pSib)))
+                {
+                    /* Stealing it would not free a whole group */
+                    continue;
                 }
+                /* Is there a race condition here?  The sib may wake up? */
+                pVictimSib = pSibtmp;
+                break;
             }
         }
     }
 
-    if (hwIndex < indexLimit) {
+    if (hwIndex != HWINDEX_INVALID) {
         /*
          * We found an available entry (or 4 for tkip)
          * Update entry to reflect new owner and return
@@ -898,19 +1247,18 @@ ar5513KeyCacheAlloc(WLAN_DEV_INFO *pdevInfo, A_UINT16 hwIndex,
          */
         if (keyType == PRIV_KEY_TYPE_TKIP) {
                 ASSERT(hwIndex < (pdevInfo->keyCacheSize >> 2));
-                keyCacheSib[hwIndex + 32] = pSib;
-                keyCacheSib[hwIndex + 64] = pSib;
-                keyCacheSib[hwIndex + 32 + 64] = pSib;
+                halKeySlotSet(pdevInfo, hwIndex + 32, pSib);
+                halKeySlotSet(pdevInfo, hwIndex + 64, pSib);
+                halKeySlotSet(pdevInfo, hwIndex + 32 + 64, pSib);
         }
-        keyCacheSib[hwIndex] = pSib;
+        halKeySlotSet(pdevInfo, hwIndex, pSib);
+        halKeySlotTouch(pdevInfo, hwIndex);
         return (hwIndex);
     }
 
     /*
      * No easy key cache entry was found. We will steal an entry
      */
-    pVictimSib = pFreeSib ? pFreeSib : pAssocSib;
-
     if (pVictimSib == NULL) {
 #ifdef DEBUG
         if (keyDebugLevel > 0) {
@@ -963,14 +1311,16 @@ ar5513KeyCacheAlloc(WLAN_DEV_INFO *pdevInfo, A_UINT16 hwIndex,
      */
     if (keyType == PRIV_KEY_TYPE_TKIP) {
         ASSERT(hwIndex < (pdevInfo->keyCacheSize >> 2));
+        ar5513KeyGroupClear(pdevInfo, hwIndex, pSib);
         ASSERT(keyCacheSib[hwIndex + 32] == NULL);
         ASSERT(keyCacheSib[hwIndex + 64] == NULL);
         ASSERT(keyCacheSib[hwIndex + 32 + 64] == NULL);
-        keyCacheSib[hwIndex + 32] = pSib;
-        keyCacheSib[hwIndex + 64] = pSib;
-        keyCacheSib[hwIndex + 32 + 64] = pSib;
+        halKeySlotSet(pdevInfo, hwIndex + 32, pSib);
+        halKeySlotSet(pdevInfo, hwIndex + 64, pSib);
+        halKeySlotSet(pdevInfo, hwIndex + 32 + 64, pSib);
     }
-    keyCacheSib[hwIndex] = pSib;
+    halKeySlotSet(pdevInfo, hwIndex, pSib);
+    halKeySlotTouch(pdevInfo, hwIndex);
 
     return hwIndex;
 }
@@ -983,7 +1333,7 @@ ar5513KeyCacheFree(WLAN_DEV_INFO *pdevInfo, A_UINT16 hwIndex)
     ar5513KeyCacheInvalidate(pdevInfo, hwIndex);
     pSib = pdevInfo->keyCacheSib[hwIndex];
     ASSERT(pSib != NULL);
-    pdevInfo->keyCacheSib[hwIndex] = NULL;
+    halKeySlotSet(pdevInfo, hwIndex, NULL);
 
     /*
      * shouldn't be freeing hwIndex if frames are pending! swretry
@@ -1031,17 +1381,17 @@ ar5513KeyCacheInvalidate(WLAN_DEV_INFO *pdevInfo, A_UINT16 hwIndex)
      */
     if (hwIndex < (pdevInfo->keyCacheSize >> 2)) {
         if (pdevInfo->keyCacheSib[hwIndex + 32] == pSib) {
-            pdevInfo->keyCacheSib[hwIndex + 32] = NULL;
+            halKeySlotSet(pdevInfo, hwIndex + 32, NULL);
             pdevInfo->keyCache[hwIndex + 32]    = NULL;
             ar5513ResetKeyCacheEntry(pdevInfo, hwIndex + 32);
         }
         if (pdevInfo->keyCacheSib[hwIndex + 64] == pSib) {
-            pdevInfo->keyCacheSib[hwIndex + 64] = NULL;
+            halKeySlotSet(pdevInfo, hwIndex + 64, NULL);
             pdevInfo->keyCache[hwIndex + 64]    = NULL;
             ar5513ResetKeyCacheEntry(pdevInfo, hwIndex + 64);
         }
         if (pdevInfo->keyCacheSib[hwIndex + 32 + 64] == pSib) {
-            pdevInfo->keyCacheSib[hwIndex + 32 + 64] = NULL;
+            halKeySlotSet(pdevInfo, hwIndex + 32 + 64, NULL);
             pdevInfo->keyCache[hwIndex + 32 + 64]    = NULL;
             ar5513ResetKeyCacheEntry(pdevInfo, hwIndex + 32 + 64);
         }
@@ -1093,31 +1443,90 @@ extern A_UINT32 log_war_count;
 A_UINT32    log_desc_comb;
 #endif
 
-/*
- * Update Key Cache rxChain0Ack field.
- * HW updates txChain0Sel from this.
+/**************************************************************
+ * getKeyType
+ *
+ * The keyType word of the entry at keyCacheOffset, from the shadow
+ * if it has it.
  */
-static void
-setRxChain0Ant(WLAN_DEV_INFO *pDev, A_UINT32 keyCacheOffset, A_UINT8 value)
+static A_UINT32
+getKeyType(WLAN_DEV_INFO *pDev, A_UINT32 keyCacheOffset)
 {
-    A_UINT32        savMaskReg;
-    A_UINT32        keyField;
+    struct ar5513KeyShadow *pShadow = pDev->pHalInfo->pKeyShadow;
+    A_UINT32               idx;
 
-    savMaskReg = readPlatformReg(pDev, MAC_KC_MASK);
-    keyField   = readPlatformReg(pDev, 
+    idx = (keyCacheOffset - MAC_KEY_CACHE) / sizeof(AR5513_KEY_CACHE_ENTRY);
+    if (pShadow && KEY_SHADOW_VALID(pShadow, idx)) {
+        return pShadow->entry[idx].keyType;
+    }
+    return readPlatformReg(pDev,
             keyCacheOffset + FIELD_OFFSET(AR5513_KEY_CACHE_ENTRY, keyType));
+}
+
+/**************************************************************
+ * setKeyType
+ *
+ * Writes the fieldMask bits of keyField to the keyType word of the
+ * entry at keyCacheOffset with the rest masked off in MAC_KC_MASK,
+ * so the bits HW updates are left alone.  Nothing is written if the
+ * shadow shows the bits already set.  keyField must come from
+ * getKeyType.
+ */
+static void
+setKeyType(WLAN_DEV_INFO *pDev, A_UINT32 keyCacheOffset, A_UINT32 fieldMask,
+           A_UINT32 keyField)
+{
+    struct ar5513KeyShadow *pShadow = pDev->pHalInfo->pKeyShadow;
+    AR5513_KEY_CACHE_ENTRY *pEntry = NULL;
+    A_UINT32               idx, savMaskReg;
+
+    idx = (keyCacheOffset - MAC_KEY_CACHE) / sizeof(AR5513_KEY_CACHE_ENTRY);
+    ASSERT(idx < MAC_KEY_CACHE_SIZE);
+
+    if (pShadow) {
+        pEntry = &pShadow->entry[idx];
+        if (KEY_SHADOW_VALID(pShadow, idx) &&
+            ((pEntry->keyType ^ keyField) & fieldMask) == 0)
+        {
+            return;
+        }
+        if (!pShadow->kcMaskValid) {
+            pShadow->kcMask      = readPlatformReg(pDev, MAC_KC_MASK);
+            pShadow->kcMaskValid = TRUE;
+        }
+        savMaskReg = pShadow->kcMask;
+    } else {
+        savMaskReg = readPlatformReg(pDev, MAC_KC_MASK);
+    }
 
     /* Mask unwanted writes */
-    writePlatformReg(pDev, MAC_KC_MASK, ~MAC_KC_MASK_RX_CHAIN0_ACK);
+    writePlatformReg(pDev, MAC_KC_MASK, ~fieldMask);
 
-    /* Update Key Cache rxChain0Ack field */
-    ((DUAL_CHAIN_BF_KEY_TYPE *)&keyField)->rxChain0Ack = value;
     writePlatformReg(pDev,
             keyCacheOffset + FIELD_OFFSET(AR5513_KEY_CACHE_ENTRY, keyType),
             keyField);
 
     /* Restore mask */
     writePlatformReg(pDev, MAC_KC_MASK, savMaskReg);
+
+    if (pEntry) {
+        pEntry->keyType = keyField;
+        pShadow->valid[idx >> 5] |= 1 << (idx & 31);
+    }
+}
+
+/*
+ * Update Key Cache rxChain0Ack field.
+ * HW updates txChain0Sel from this.
+ */
+static void
+setRxChain0Ant(WLAN_DEV_INFO *pDev, A_UINT32 keyCacheOffset, A_UINT8 value)
+{
+    A_UINT32        keyField;
+
+    keyField = getKeyType(pDev, keyCacheOffset);
+    ((DUAL_CHAIN_BF_KEY_TYPE *)&keyField)->rxChain0Ack = value;
+    setKeyType(pDev, keyCacheOffset, MAC_KC_MASK_RX_CHAIN0_ACK, keyField);
 }
 
 /*
@@ -1127,24 +1536,11 @@ setRxChain0Ant(WLAN_DEV_INFO *pDev, A_UINT32 keyCacheOffset, A_UINT8 value)
 static void
 setRxChain1Ant(WLAN_DEV_INFO *pDev, A_UINT32 keyCacheOffset, A_UINT8 value)
 {
-    A_UINT32        savMaskReg;
     A_UINT32        keyField;
 
-    savMaskReg = readPlatformReg(pDev, MAC_KC_MASK);
-    keyField   = readPlatformReg(pDev, 
-            keyCacheOffset + FIELD_OFFSET(AR5513_KEY_CACHE_ENTRY, keyType));
-
-    /* Mask unwanted writes */
-    writePlatformReg(pDev, MAC_KC_MASK, ~MAC_KC_MASK_RX_CHAIN1_ACK);
-
-    /* Update Key Cache rxChain0Ack field */
+    keyField = getKeyType(pDev, keyCacheOffset);
     ((DUAL_CHAIN_BF_KEY_TYPE *)&keyField)->rxChain1Ack = value;
-    writePlatformReg(pDev,
-            keyCacheOffset + FIELD_OFFSET(AR5513_KEY_CACHE_ENTRY, keyType),
-            keyField);
-
-    /* Restore mask */
-    writePlatformReg(pDev, MAC_KC_MASK, savMaskReg);
+    setKeyType(pDev, keyCacheOffset, MAC_KC_MASK_RX_CHAIN1_ACK, keyField);
 }
 
 
@@ -1155,24 +1551,11 @@ setRxChain1Ant(WLAN_DEV_INFO *pDev, A_UINT32 keyCacheOffset, A_UINT8 value)
 static void
 setStrongChain(WLAN_DEV_INFO *pDev, A_UINT32 keyCacheOffset, A_UINT8 value)
 {
-    A_UINT32        savMaskReg;
     A_UINT32        keyField;
 
-    savMaskReg = readPlatformReg(pDev, MAC_KC_MASK);
-    keyField   = readPlatformReg(pDev, 
-            keyCacheOffset + FIELD_OFFSET(AR5513_KEY_CACHE_ENTRY, keyType));
-
-    /* Mask unwanted writes */
-    writePlatformReg(pDev, MAC_KC_MASK, ~MAC_KC_MASK_CHAIN_SEL);
-
-    /* Update Key Cache rxChain0Ack field */
+    keyField = getKeyType(pDev, keyCacheOffset);
     ((DUAL_CHAIN_BF_KEY_TYPE *)&keyField)->txChainSel = value;
-    writePlatformReg(pDev,
-            keyCacheOffset + FIELD_OFFSET(AR5513_KEY_CACHE_ENTRY, keyType),
-            keyField);
-
-    /* Restore mask */
-    writePlatformReg(pDev, MAC_KC_MASK, savMaskReg);
+    setKeyType(pDev, keyCacheOffset, MAC_KC_MASK_CHAIN_SEL, keyField);
 }
 
 
@@ -13,6 +13,12 @@
 extern "C" {
 #endif
 
+A_STATUS
+ar5513KeyShadowAttach(WLAN_DEV_INFO *pDev);
+
+void
+ar5513KeyShadowDetach(WLAN_DEV_INFO *pDev);
+
 A_UINT32
 ar5513GetKeyCacheSize(WLAN_DEV_INFO *pDev);
 
@@ -27,6 +33,10 @@ ar5513SetKeyCacheEntry(WLAN_DEV_INFO *pDev, A_UINT16 keyCacheIndex,
                        WLAN_MACADDR *pMacAddr, WLAN_PRIV_RECORD *pWlanPrivRecord,
                     A_BOOL bXorKey);
 
+A_STATUS
+ar5513SetKeyCacheEntries(WLAN_DEV_INFO *pDev, const HAL_KEY_CACHE_SET *pSets,
+                         A_UINT32 numSets, HAL_KEY_CACHE_SET_STATS *pStats);
+
 A_UINT16
 ar5513KeyCacheAlloc(WLAN_DEV_INFO *pDev, A_UINT16 hwIndex, SIB_ENTRY *pSib,
                     A_UINT16 keyType, A_BOOL *pHwEncrypt);
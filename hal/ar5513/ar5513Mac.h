@@ -763,7 +763,14 @@ typedef struct eepMap {
     A_UINT16         version;        /* Version field */
     A_UINT16         protect;        /* EEPROM protect field */
     EEP_HEADER_INFO  *pEepHeader;
+    A_UINT16         *pRawEeprom;    /* Chain images still to be expanded, NULL once all are */
+    A_UINT32         rawWords;       /* Words in each chain's image */
+    A_UINT8          numChains;
+    A_UINT8          expnModes;      /* 1 << HEADER_WMODE for each mode a chain's 5112 calibration holds */
     struct chainInfo {
+	A_BOOL           expanded;       /* Pier, target power and CTL info parsed */
+	A_UINT8          calModes;       /* 5112 modes this chain's own header calibrates */
+	A_UINT8          expnModes;      /* modePowerArray5112 entries parsed */
 	PCDACS_ALL_MODES *pPcdacInfo;
 	TRGT_POWER_ALL_MODES  *pTrgtPowerInfo;
 	RD_EDGES_POWER   *pRdEdgesPower;
@@ -771,6 +778,9 @@ typedef struct eepMap {
     } chain[2];
 } EEP_MAP;
 
+/* Parses a chain's calibration for headerMode on first use */
+extern A_STATUS ar5513ExpandEepromDataset(WLAN_DEV_INFO *pDev, A_UINT8 chnIdx, HEADER_WMODE headerMode);
+
 /* Data structures initialization for gainF functions */
 
 #define NUM_CORNER_FIX_BITS      4
@@ -962,9 +972,59 @@ typedef enum {
     EAR_LC_RESET_IQ,           /* Enable/disable IQ in reset */
     EAR_LC_PER_FIXED_GAIN,     /* Enable/disable fixed gain */
     EAR_LC_PER_GAIN_CIRC,      /* Enable/disable gain circulation */
-    EAR_LC_PER_NF              /* Enable/disable periodic cal NF */
+    EAR_LC_PER_NF,             /* Enable/disable periodic cal NF */
+    EAR_NUM_LC
 } EAR_LOC_CHECK;
 
+/*
+ * The register headers compiled at attach.  Each code location has
+ * a list of entries in register header order; an entry applies to
+ * the channels its header does and, at the stage locations, runs
+ * its header's decoded writes.
+ */
+typedef enum {
+    EAR_OP_WRITE,              /* addr = value */
+    EAR_OP_RMW,                /* A_REG_RMW of value under mask */
+    EAR_OP_RF,                 /* Analog bank field */
+    EAR_OP_TYPE3               /* Type 3 arithmetic on the field under mask */
+} EAR_OP_KIND;
+
+typedef struct earOp {
+    A_UINT8  kind;
+    A_UINT8  arg;              /* RF bank or Type 3 opcode */
+    A_UINT8  column;           /* RF column */
+    A_UINT8  numBits;          /* RF field width */
+    A_UINT32 addr;             /* Register, or RF start bit */
+    A_UINT32 value;            /* Already shifted into the field */
+    A_UINT32 mask;
+} EAR_OP;
+
+typedef struct earProgEntry {
+    A_UINT16 modes;
+    A_UINT16 channel;
+    A_UINT16 firstOp;
+    A_UINT16 numOps;           /* 0 away from the stage locations */
+    A_UINT16 pllValue;         /* EAR_LC_PLL */
+} EAR_PROG_ENTRY;
+
+/* The channels split into segments over which every entry either applies or not */
+typedef struct earChanSeg {
+    A_UINT16 loChannel;        /* Runs up to the next segment's loChannel */
+    A_UINT16 modes;            /* Modes of the headers that apply here */
+    A_UINT32 first[EAR_NUM_LC + 1]; /* Their entries at location l, in pSegEntries */
+} EAR_CHAN_SEG;
+
+typedef struct earProgram {
+    A_UINT32       allocSize;
+    A_UINT16       first[EAR_NUM_LC + 1]; /* Entries of location l are first[l] up to first[l + 1] */
+    EAR_OP         *pOps;
+    EAR_PROG_ENTRY *pEntries;
+    A_UINT32       indexSize;
+    A_UINT32       numSegs;
+    EAR_CHAN_SEG   *pSegs;     /* By loChannel; one allocation with pSegEntries */
+    A_UINT16       *pSegEntries;
+} EAR_PROGRAM;
+
 /* EAR Macros */
 #define IS_SPUR_CHAN(x)     ( (((x) % 32) != 0) && ((((x) % 32) < 10) || (((x) % 32) > 22)) )
 
@@ -765,6 +765,7 @@ enum ar5513Registers {
 
     MAC_SPI_CS_RD_SIGN        = 0x114,   // SPI Read Signature
     MAC_SPI_CS_RD_2BYTES      = 0x124,   // SPI Read 2 Byte Command
+    MAC_SPI_CS_RD_4BYTES      = 0x144,   // SPI Read 4 Byte Command
 
     MAC_SPI_AO            = 0x17004, // SPI Address/Opcode register
     MAC_SPI_AO_RD_DATA        = 0x03, // SPI Read Data Opcode
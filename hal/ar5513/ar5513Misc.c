@@ -207,134 +207,172 @@ ee_error:
 #endif
 }
 
+#define TIMEOUT_SPI_CS                  10000   /* us */
+#define TIMEOUT_SPI_WRITE_IN_PROGRESS   10000   /* us */
+#define SPI_MAX_RD_WORDS                2       /* MAC_SPI_D holds 4 bytes */
+
+#if defined(PCI_INTERFACE)
+#define CB63_NDIS 
+
 /**************************************************************
- * ar5513EepromRead
+ * ar5513SpiWait
  *
- * Read 16 bits of data from offset into *data
+ * Wait for the SPI transaction in flight to finish
  */
-A_STATUS
-ar5513EepromRead(WLAN_DEV_INFO *pDev, A_UINT32 offset, A_UINT16 *data)
+static A_STATUS
+ar5513SpiWait(WLAN_DEV_INFO *pDev)
 {
-#if defined(PCI_INTERFACE)
-    A_UINT32 temp, sector;
-    int to = 10000;
-    int fDone = FALSE;
+    int to = TIMEOUT_SPI_CS;
 
-// Long - Really should use a static instead of reading signature 
-// for every 2 byte read
-#define CB63_NDIS 
+    while (readPlatformReg(pDev, MAC_SPI_CS) & MAC_SPI_CS_BUSY) {
+        if (--to == 0) {
+            return A_HARDWARE;
+        }
+        udelay(1);
+    }
+    return A_OK;
+}
+
+#if defined(AV10_NDIS)
+/**************************************************************
+ * ar5513FlashSector
+ *
+ * The EEPROM image lives in the last sector of the flash.  The
+ * flash signature giving its size is read once and kept.
+ */
+static A_STATUS
+ar5513FlashSector(WLAN_DEV_INFO *pDev, A_UINT32 *pSector)
+{
+    HAL_INFO *pInfo = pDev->pHalInfo;
+
+    if (pInfo->eepromSector == 0) {
+        writePlatformReg(pDev, MAC_SPI_AO, MAC_SPI_AO_RD_SIG);
+        writePlatformReg(pDev, MAC_SPI_CS, MAC_SPI_CS_RD_SIGN);
+        if (ar5513SpiWait(pDev) != A_OK) {
+            return A_HARDWARE;
+        }
+
+        switch (readPlatformReg(pDev, MAC_SPI_D) & 0xff) {
+        case 0x13:  // 1MB Flash
+            pInfo->eepromSector = 0xf0000;
+            break;
+        case 0x14:  // 2MB Flash
+            pInfo->eepromSector = 0x1f0000;
+            break;
+        case 0x15:  // 4MB Flash
+            pInfo->eepromSector = 0x3f0000;
+            break;
+        default:
+            return A_HARDWARE;
+        }
+    }
+    *pSector = pInfo->eepromSector;
+    return A_OK;
+}
+#endif /* AV10_NDIS */
+
+/**************************************************************
+ * ar5513SpiReadWords
+ *
+ * Read count (at most SPI_MAX_RD_WORDS) 16 bit words from offset
+ * in one SPI transaction.  The first byte received is the low
+ * byte of MAC_SPI_D.
+ */
+static A_STATUS
+ar5513SpiReadWords(WLAN_DEV_INFO *pDev, A_UINT32 offset, A_UINT16 *pData, A_UINT32 count)
+{
+    A_UINT32 temp, i;
 #if defined(AV10_NDIS)
+    A_UINT32 sector;
+
+    ASSERT(count > 0 && count <= SPI_MAX_RD_WORDS);
 
-    writePlatformReg(pDev, MAC_SPI_AO, MAC_SPI_AO_RD_SIG);
-    writePlatformReg(pDev, MAC_SPI_CS, MAC_SPI_CS_RD_SIGN);
-
-    while (to > 0) {
-	    if (readPlatformReg(pDev, MAC_SPI_CS) & MAC_SPI_CS_BUSY) {
-	        udelay(1);
-	        to--;
-	    }
-	    else {
-	        fDone = TRUE;
-	        break;
-	    }
-    }
-
-    if (fDone == TRUE) {
-	    temp = readPlatformReg(pDev, MAC_SPI_D) & 0xff;
-
-	    switch (temp) {
-	    case 0x13:  // 1MB Flash
-	        sector = 0xf0000;
-	        break;
-	    case 0x14:  // 2MB Flash
-	        sector = 0x1f0000;
-	        break;
-	    case 0x15:  // 4MB Flash
-	        sector = 0x3f0000;
-	        break;
-	    default:
-	        return A_HARDWARE;
-	    }
-    }
-    else {
-	    uiPrintf("ar5513EepromRead: eeprom read error at offset %d\n",offset);
-	    return A_HARDWARE;
+    if (ar5513FlashSector(pDev, &sector) != A_OK) {
+        return A_HARDWARE;
     }
 
     temp = MAC_SPI_AO_RD_DATA | ((sector | (offset << 1)) << 8);
     writePlatformReg(pDev, MAC_SPI_AO, temp);
-    writePlatformReg(pDev, MAC_SPI_CS, MAC_SPI_CS_RD_2BYTES);
-
-    while (to > 0) {
-	    if (readPlatformReg(pDev, MAC_SPI_CS) & MAC_SPI_CS_BUSY) {
-	        udelay(1);
-	        to--;
-	    }
-	    else {
-	        fDone = TRUE;
-	        break;
-	    }
-    }
-
-    if (fDone == TRUE) {
-	    temp = readPlatformReg(pDev, MAC_SPI_D);
-	    /*
-	    **  XXXX - GDS 07/17/2004
-	    **  Temporarily Swap bytes as Work-Around for Falcon 1.0 Silicon.
-	    **  MIPS CPU is executing to prevent NMI from flooding x86 CPU
-	    */
-	    *data = (A_UINT16) (((temp & 0xff) << 8) | ((temp & 0xff00) >> 8));
-        return A_OK;
-    }
-    else {
-	    uiPrintf("ar5513EepromRead: eeprom read error at offset %d\n",offset);
-	    return A_HARDWARE;
+    writePlatformReg(pDev, MAC_SPI_CS, (count == 1) ? MAC_SPI_CS_RD_2BYTES : MAC_SPI_CS_RD_4BYTES);
+    if (ar5513SpiWait(pDev) != A_OK) {
+        return A_HARDWARE;
+    }
+
+    temp = readPlatformReg(pDev, MAC_SPI_D);
+    for (i = 0; i < count; i++, temp >>= 16) {
+        /*
+        **  XXXX - GDS 07/17/2004
+        **  Temporarily Swap bytes as Work-Around for Falcon 1.0 Silicon.
+        **  MIPS CPU is executing to prevent NMI from flooding x86 CPU
+        */
+        pData[i] = (A_UINT16) (((temp & 0xff) << 8) | ((temp & 0xff00) >> 8));
     }
 #elif defined(CB63_NDIS)
 
+    ASSERT(count > 0 && count <= SPI_MAX_RD_WORDS);
+
     temp = MAC_SPI_EEPROM_RD | ((offset * 2) << 16);
     writePlatformReg(pDev, MAC_SPI_AO, temp);
     writePlatformReg(pDev, MAC_SPI_CS, (MAC_SPI_CS_SPI_FORCE_SZ_16 << MAC_SPI_CS_SPI_AUTO_SZ_S) 
                             | MAC_SPI_CS_START 
-                            | ((2 << MAC_SPI_CS_RX_BYTE_CNT_S) & MAC_SPI_CS_RX_BYTE_CNT_M)
+                            | (((count * 2) << MAC_SPI_CS_RX_BYTE_CNT_S) & MAC_SPI_CS_RX_BYTE_CNT_M)
                             | ((3 << MAC_SPI_CS_TX_BYTE_CNT_S) & MAC_SPI_CS_TX_BYTE_CNT_M));
-
-    while (to > 0) {
-	    if (readPlatformReg(pDev, MAC_SPI_CS) & MAC_SPI_CS_BUSY) {
-	        udelay(1);
-	        to--;
-	    }
-	    else {
-	        fDone = TRUE;
-	        break;
-	    }
+    if (ar5513SpiWait(pDev) != A_OK) {
+        return A_HARDWARE;
     }
 
-    if (fDone == TRUE) {
-	    temp = readPlatformReg(pDev, MAC_SPI_D);
-	    *data = (A_UINT16) (temp & 0xffff);
-        return A_OK;
-    }
-    else {
-	    uiPrintf("ar5513EepromRead: eeprom read error at offset %d\n",offset);
-	    return A_HARDWARE;
+    temp = readPlatformReg(pDev, MAC_SPI_D);
+    for (i = 0; i < count; i++, temp >>= 16) {
+        pData[i] = (A_UINT16) (temp & 0xffff);
     }
 #else
 #error "define AV10_NDIS or CB63_NDIS to define Board" 
 #endif
+    return A_OK;
+}
+#endif /* PCI_INTERFACE */
+
+/**************************************************************
+ * ar5513EepromRead
+ *
+ * Read 16 bits of data from offset into *data
+ */
+A_STATUS
+ar5513EepromRead(WLAN_DEV_INFO *pDev, A_UINT32 offset, A_UINT16 *data)
+{
+    return ar5513EepromReadBlock(pDev, offset, data, 1);
+}
 
+/**************************************************************
+ * ar5513EepromReadBlock
+ *
+ * Read count 16 bit words starting at offset into pData, taking
+ * as many words per SPI transaction as the data register holds.
+ */
+A_STATUS
+ar5513EepromReadBlock(WLAN_DEV_INFO *pDev, A_UINT32 offset, A_UINT16 *pData, A_UINT32 count)
+{
+#if defined(PCI_INTERFACE)
+    A_UINT32 n;
+
+    for (; count > 0; offset += n, pData += n, count -= n) {
+        n = A_MIN(count, SPI_MAX_RD_WORDS);
+        if (ar5513SpiReadWords(pDev, offset, pData, n) != A_OK) {
+            uiPrintf("ar5513EepromRead: eeprom read error at offset %d\n", offset);
+            return A_HARDWARE;
+        }
+    }
+    return A_OK;
 #elif defined(AR531X) || defined(AR5513)
     /* radio configuration data is stored in the system flash */
-    *data = sysFlashConfigRead(FLC_RADIOCFG, (offset * 2) + 1) |
-            (sysFlashConfigRead(FLC_RADIOCFG, offset * 2) << 8);
+    for (; count > 0; offset++, pData++, count--) {
+        *pData = sysFlashConfigRead(FLC_RADIOCFG, (offset * 2) + 1) |
+                 (sysFlashConfigRead(FLC_RADIOCFG, offset * 2) << 8);
+    }
     return A_OK;
 #endif /* PLATFORM */
 }
 
-
-#define TIMEOUT_SPI_CS                  10000   /* us */
-#define TIMEOUT_SPI_WRITE_IN_PROGRESS   10000   /* us */
-
 /**************************************************************
  * ar5513EepromWrite
  *
@@ -351,6 +389,23 @@ ar5513EepromWrite(WLAN_DEV_INFO *pDev, A_UINT32 offset, A_UINT16 data)
     int toWriteInProgress;
     int byteCount;
     A_UINT32 writeAddr, writeData;
+#elif defined(AR531X) || defined(AR5513)
+    char str[2];
+#endif /* PLATFORM */
+
+    /* Channel programming computed from the old contents must not be replayed */
+#ifdef HAL_RESET_RECIPE
+    if (pDev->pHalInfo) {
+        halFlushResetRecipes(pDev);
+    }
+#endif
+#ifdef HAL_TXPOWER_CACHE
+    if (pDev->pHalInfo) {
+        halFlushTxPowerCache(pDev);
+    }
+#endif
+
+#if defined(PCI_INTERFACE)
 
 // Long - Really should use a static instead of reading signature 
 // for every 2 byte read
@@ -464,8 +519,6 @@ ar5513EepromWrite(WLAN_DEV_INFO *pDev, A_UINT32 offset, A_UINT16 data)
 #error "define AV10_NDIS or CB63_NDIS to define Board" 
 #endif
 #elif defined(AR531X) || defined(AR5513)
-    char str[2];
-
     /* Radio configuration data is stored in system flash (in reverse endian) */
     str[0] = (data >> 8) & 0xff;
     str[1] = data & 0xff;
@@ -1322,6 +1375,10 @@ ar5513AniControl(WLAN_DEV_INFO *pDev, HAL_ANI_CMD cmd, int param)
 {
 #define TABLE_SIZE(_table) (sizeof(_table)/sizeof((_table)[0]))
     typedef int TABLE[];
+    HAL_RMW_BATCH batch;
+
+    /* Runs every beacon interval - merge the updates to each register */
+    HAL_RMW_INIT(&batch, pDev);
 
     switch (cmd) {
     case SET_NOISE_IMMUNITY_LEVEL: {
@@ -1336,10 +1393,10 @@ ar5513AniControl(WLAN_DEV_INFO *pDev, HAL_ANI_CMD cmd, int param)
 
             ASSERT(level < TABLE_SIZE(totalSizeDesired));
 
-            A_REG_RMW_FIELD(pDev, PHY_DESIRED_SZ, TOT_DES, totalSizeDesired[level]);
-            A_REG_RMW_FIELD(pDev, PHY_AGC_CTL1, COARSE_HIGH, coarseHigh[level]);
-            A_REG_RMW_FIELD(pDev, PHY_AGC_CTL1, COARSE_LOW, coarseLow[level]);
-            A_REG_RMW_FIELD(pDev, PHY_FIND_SIG, FIRPWR, firpwr[level]);
+            HAL_RMW_FIELD(&batch, PHY_DESIRED_SZ, TOT_DES, totalSizeDesired[level]);
+            HAL_RMW_FIELD(&batch, PHY_AGC_CTL1, COARSE_HIGH, coarseHigh[level]);
+            HAL_RMW_FIELD(&batch, PHY_AGC_CTL1, COARSE_LOW, coarseLow[level]);
+            HAL_RMW_FIELD(&batch, PHY_FIND_SIG, FIRPWR, firpwr[level]);
         } else {
             const TABLE totalSizeDesired = { -55, -55, -55, -55, -62 };
             const TABLE coarseHigh       = { -14, -14, -14, -14, -12 };
@@ -1348,10 +1405,10 @@ ar5513AniControl(WLAN_DEV_INFO *pDev, HAL_ANI_CMD cmd, int param)
 
             ASSERT(level < TABLE_SIZE(totalSizeDesired));
 
-            A_REG_RMW_FIELD(pDev, PHY_DESIRED_SZ, TOT_DES, totalSizeDesired[level]);
-            A_REG_RMW_FIELD(pDev, PHY_AGC_CTL1, COARSE_HIGH, coarseHigh[level]);
-            A_REG_RMW_FIELD(pDev, PHY_AGC_CTL1, COARSE_LOW, coarseLow[level]);
-            A_REG_RMW_FIELD(pDev, PHY_FIND_SIG, FIRPWR, firpwr[level]);
+            HAL_RMW_FIELD(&batch, PHY_DESIRED_SZ, TOT_DES, totalSizeDesired[level]);
+            HAL_RMW_FIELD(&batch, PHY_AGC_CTL1, COARSE_HIGH, coarseHigh[level]);
+            HAL_RMW_FIELD(&batch, PHY_AGC_CTL1, COARSE_LOW, coarseLow[level]);
+            HAL_RMW_FIELD(&batch, PHY_FIND_SIG, FIRPWR, firpwr[level]);
         }
 
         break;
@@ -1367,17 +1424,17 @@ ar5513AniControl(WLAN_DEV_INFO *pDev, HAL_ANI_CMD cmd, int param)
 
         unsigned int on = param ? 1 : 0;
 
-        A_REG_RMW_FIELD(pDev, PHY_SFCORR_LOW, M1_THRESH_LOW, m1ThreshLow[on]);
-        A_REG_RMW_FIELD(pDev, PHY_SFCORR_LOW, M2_THRESH_LOW, m2ThreshLow[on]);
-        A_REG_RMW_FIELD(pDev, PHY_SFCORR, M1_THRESH, m1Thresh[on]);
-        A_REG_RMW_FIELD(pDev, PHY_SFCORR, M2_THRESH, m2Thresh[on]);
-        A_REG_RMW_FIELD(pDev, PHY_SFCORR, M2COUNT_THR, m2CountThr[on]);
-        A_REG_RMW_FIELD(pDev, PHY_SFCORR_LOW, M2COUNT_THR_LOW, m2CountThrLow[on]);
+        HAL_RMW_FIELD(&batch, PHY_SFCORR_LOW, M1_THRESH_LOW, m1ThreshLow[on]);
+        HAL_RMW_FIELD(&batch, PHY_SFCORR_LOW, M2_THRESH_LOW, m2ThreshLow[on]);
+        HAL_RMW_FIELD(&batch, PHY_SFCORR, M1_THRESH, m1Thresh[on]);
+        HAL_RMW_FIELD(&batch, PHY_SFCORR, M2_THRESH, m2Thresh[on]);
+        HAL_RMW_FIELD(&batch, PHY_SFCORR, M2COUNT_THR, m2CountThr[on]);
+        HAL_RMW_FIELD(&batch, PHY_SFCORR_LOW, M2COUNT_THR_LOW, m2CountThrLow[on]);
 
         if (on) {
-            A_REG_SET_BIT(pDev, PHY_SFCORR_LOW, USE_SELF_CORR_LOW);
+            HAL_RMW_SET_BIT(&batch, PHY_SFCORR_LOW, USE_SELF_CORR_LOW);
         } else {
-            A_REG_CLR_BIT(pDev, PHY_SFCORR_LOW, USE_SELF_CORR_LOW);
+            HAL_RMW_CLR_BIT(&batch, PHY_SFCORR_LOW, USE_SELF_CORR_LOW);
         }
 
         break;
@@ -1388,7 +1445,7 @@ ar5513AniControl(WLAN_DEV_INFO *pDev, HAL_ANI_CMD cmd, int param)
 
         unsigned int high = param ? 1 : 0;
 
-        A_REG_RMW_FIELD(pDev, PHY_CCK_DETECT, WEAK_SIG_THR_CCK, weakSigThrCck[high]);
+        HAL_RMW_FIELD(&batch, PHY_CCK_DETECT, WEAK_SIG_THR_CCK, weakSigThrCck[high]);
 
         break;
     }
@@ -1400,7 +1457,7 @@ ar5513AniControl(WLAN_DEV_INFO *pDev, HAL_ANI_CMD cmd, int param)
 
         ASSERT(level < TABLE_SIZE(firstep));
 
-        A_REG_RMW_FIELD(pDev, PHY_FIND_SIG, FIRSTEP, firstep[level]);
+        HAL_RMW_FIELD(&batch, PHY_FIND_SIG, FIRSTEP, firstep[level]);
 
         break;
     }
@@ -1412,7 +1469,7 @@ ar5513AniControl(WLAN_DEV_INFO *pDev, HAL_ANI_CMD cmd, int param)
 
         ASSERT(level < TABLE_SIZE(cycpwrThr1));
 
-        A_REG_RMW_FIELD(pDev, PHY_TIMING5, CYCPWR_THR1, cycpwrThr1[level]);
+        HAL_RMW_FIELD(&batch, PHY_TIMING5, CYCPWR_THR1, cycpwrThr1[level]);
 
         break;
     }
@@ -1421,6 +1478,7 @@ ar5513AniControl(WLAN_DEV_INFO *pDev, HAL_ANI_CMD cmd, int param)
         ASSERT(0);
     }
 
+    halRmwCommit(&batch);
     return;
 }
 
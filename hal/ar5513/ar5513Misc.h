@@ -19,6 +19,9 @@ ar5513InitFrmTypeCapTable(WLAN_DEV_INFO *pDev);
 A_STATUS
 ar5513EepromRead(WLAN_DEV_INFO *pDev, A_UINT32 offset, A_UINT16 *data);
 
+A_STATUS
+ar5513EepromReadBlock(WLAN_DEV_INFO *pDev, A_UINT32 offset, A_UINT16 *pData, A_UINT32 count);
+
 A_STATUS
 ar5513EepromWrite(WLAN_DEV_INFO *pDev, A_UINT32 offset, A_UINT16 data);
 
@@ -292,11 +292,14 @@ ar5513ProcessRxDesc(WLAN_DEV_INFO *pDev, ATHEROS_DESC *pDesc)
     SIB_ENTRY        *pSib;
     A_RSSI           rssi;
 
+    HAL_REG_PROFILE_FN(pDev, ar5513ProcessRxDesc);
+
     A_RX_DESC_CACHE_INVAL(pDesc);
 
     pRxStatus = RX_STATUS(pDesc);
 
     if (!pRxStatus->done) {
+        HAL_REG_PROFILE_EXIT(pDev);
         return A_EBUSY;
     }
 
@@ -310,6 +313,7 @@ ar5513ProcessRxDesc(WLAN_DEV_INFO *pDev, ATHEROS_DESC *pDesc)
     if ((!pNextStatus->done) &&
         (readPlatformReg(pDev, MAC_RXDP) == pDesc->thisPhysPtr))
     {
+        HAL_REG_PROFILE_EXIT(pDev);
         return A_EBUSY;
     }
 
@@ -322,6 +326,7 @@ ar5513ProcessRxDesc(WLAN_DEV_INFO *pDev, ATHEROS_DESC *pDesc)
     if (pRxStatus->more || pDev->partialRxDesc) {
         /* capture if the next one has to be discarded */
         pDev->partialRxDesc = pRxStatus->more ? TRUE : FALSE;
+        HAL_REG_PROFILE_EXIT(pDev);
         return A_ERROR;
     }
 
@@ -471,11 +476,13 @@ ar5513ProcessRxDesc(WLAN_DEV_INFO *pDev, ATHEROS_DESC *pDesc)
          */
         if (pRxStatus->CRCError) {
             pLocalStats->RcvCrcErrors++;
+            HAL_REG_PROFILE_EXIT(pDev);
             return A_ERROR;
         }
         if (pRxStatus->phyErrorOccured) {
             pLocalStats->RcvPhyErrors++;
             pDesc->status.rx.phyError = (A_UINT8)PHY_ERROR_CODE(pRxStatus);
+            HAL_REG_PROFILE_EXIT(pDev);
             return A_PHY_ERROR;
         }
     }
@@ -505,6 +512,7 @@ ar5513ProcessRxDesc(WLAN_DEV_INFO *pDev, ATHEROS_DESC *pDesc)
         }
         if (faulted == TRUE) {
             /* A real key cache miss.  This frame should be dropped. */
+            HAL_REG_PROFILE_EXIT(pDev);
             return A_ERROR;
         }
     }
@@ -533,6 +541,7 @@ ar5513ProcessRxDesc(WLAN_DEV_INFO *pDev, ATHEROS_DESC *pDesc)
     ar5513ProcRxAntennaData(pDev, pSib, pDesc);
 #endif /* ! PT_2_PT_ANT_DIV */
 
+    HAL_REG_PROFILE_EXIT(pDev);
     return A_OK;
 }
 
@@ -17,8 +17,20 @@
 #include "hal.h"
 #include "ui.h"
 #include "halUtil.h"
+#include "halCalInterp.h"
 #include "halDevId.h"
 #include "vport.h"
+#include "halWriteList.h"
+#include "halResetProfile.h"
+#ifdef HAL_REG_CACHE
+#include "halRegCache.h"
+#endif
+#ifdef HAL_RESET_RECIPE
+#include "halResetRecipe.h"
+#endif
+#ifdef HAL_TXPOWER_CACHE
+#include "halTxPowerCache.h"
+#endif
 
 /* Headers for HW private items */
 #include "ar5513MacReg.h"
@@ -46,12 +58,64 @@
 #include "apcfg.h"
 #endif
 
+#define AR5513_TX_CHAINS    (CHAIN_1 + 1)
+
+/*
+ * A chain's per rate powers before the power limit and TPC
+ * reduction are applied - see ar5513ClampRateTable.
+ */
+typedef struct ar5513RateTargets {
+    A_BOOL          valid;              /* A limit change can start from these */
+    A_UINT32        channelFlags;
+    A_UINT16        channel;
+    A_BOOL          ofdm;
+    A_BOOL          cck;
+    A_INT16         ofdmMaxPower;       /* Edge, regulatory and turbo limits */
+    A_INT16         cckMaxPower;
+    A_INT16         xrTargetPower;
+    A_UINT16        powerIndexOffset;
+    TRGT_POWER_INFO targetOfdm;
+    TRGT_POWER_INFO targetCck;
+} AR5513_RATE_TARGETS;
+
 static void
 ar5513GetNf(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval);
 
+static void
+ar5513NfCalChainRange(WLAN_DEV_INFO *pDev, int *pFirst, int *pLast);
+
+static void
+ar5513NfCalLoaded(WLAN_DEV_INFO *pDev);
+
+static void
+ar5513NfCalStart(WLAN_DEV_INFO *pDev);
+
+static A_UINT32
+ar5513NfCalPoll(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval);
+
+static void
+ar5513IQCalStart(WLAN_DEV_INFO *pDev, A_UINT32 logCountMax, A_UINT32 chains);
+
+static A_UINT32
+ar5513IQCalChains(WLAN_DEV_INFO *pDev);
+
+/* TODO: temp debug */
+void logNfCal_Add(WLAN_DEV_INFO *pDev, int flag);
+
 static A_STATUS
 ar5513SetResetReg(WLAN_DEV_INFO *pDev, A_UINT32 resetMask);
 
+static void
+ar5513GetPhyModeRegs(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval, A_UINT32 *pRfMode,
+                     A_UINT32 *pTurbo, A_UINT32 *pPll);
+
+static A_BOOL
+ar5513FastChannelChange(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval, A_UINT16 modesIndex);
+
+static A_STATUS
+ar5513SetChannelRegs(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval, A_UINT16 modesIndex,
+                     A_INT16 powerLimit);
+
 static A_STATUS
 ar5513SetChannel5112(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval);
 
@@ -88,7 +152,13 @@ static void
 ar5513SetRateTable(WLAN_DEV_INFO *pDev, A_UINT16 *pRatesPower,
                    TRGT_POWER_ALL_MODES *pTargetPowers, CHAN_VALUES *pChval,
                    A_INT16 tpcScaleReduction, A_INT16 powerLimit, struct eepMap *pData,
-                   A_INT16 *pMinPower, A_INT16 *pMaxPower, A_INT16 *pBandEdge, A_UINT8 chnIdx);
+                   A_INT16 *pMinPower, A_INT16 *pMaxPower, A_INT16 *pBandEdge, A_UINT8 chnIdx,
+                   AR5513_RATE_TARGETS *pTargets);
+
+static void
+ar5513ClampRateTable(WLAN_DEV_INFO *pDev, const AR5513_RATE_TARGETS *pTargets,
+                     A_INT16 tpcScaleReduction, A_INT16 powerLimit, A_UINT16 *pRatesPower,
+                     A_INT16 *pMinPower, A_INT16 *pMaxPower);
 
 static void
 ar5513CorrectGainDelta(WLAN_DEV_INFO *pDev, A_UINT16 *pRatesPower,
@@ -101,14 +171,6 @@ ar5513GetTargetPowers(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval, TRGT_POWER_INFO
 static A_UINT16
 ar5513GetMaxEdgePower(A_UINT16 channel, RD_EDGES_POWER  *pRdEdgesPower);
 
-static A_UINT16
-ar5513GetInterpolatedValue(A_UINT16 target, A_UINT16 srcLeft, A_UINT16 srcRight,
-                           A_UINT16 targetLeft, A_UINT16 targetRight, A_BOOL scaleUp);
-
-static void
-ar5513GetLowerUpperValues(A_UINT16 value, A_UINT16 *pList, A_UINT16 listSize,
-                          A_UINT16 *pLowerValue, A_UINT16 *pUpperValue);
-
 static void
 ar5513RequestRfgain(WLAN_DEV_INFO *pDev);
 
@@ -133,20 +195,25 @@ ar5513SetXrMode(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType);
 static A_BOOL
 ar5513IsEarEngaged(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval);
 
+static const EAR_CHAN_SEG *
+ar5513EarLookup(const EAR_PROGRAM *pProg, A_UINT16 channel);
+
 static A_BOOL
 ar5513EarModify(WLAN_DEV_INFO *pDev, EAR_LOC_CHECK loc, CHAN_VALUES *pChval, A_UINT32 *modifier);
 
-static A_UINT16
-ar5513EarDoRH(WLAN_DEV_INFO *pDev, REGISTER_HEADER *pRH);
+static void
+ar5513EarRunOps(WLAN_DEV_INFO *pDev, const EAR_OP *pOp, A_UINT16 numOps);
 
 static A_UINT32 *
 ar5513GetRfBank(WLAN_DEV_INFO *pDev, A_UINT16 bank);
 
+static A_BOOL
+ar5513RfBankChanged(WLAN_DEV_INFO *pDev, A_UINT16 bank, const A_UINT32 *pData,
+                    A_UINT32 *pWritten, A_UINT32 size);
+
 static A_UINT16
 ar5513CFlagsToEarMode(WLAN_CFLAGS cflags);
 
-static A_BOOL
-ar5513IsChannelInEarRegHead(A_UINT16 earChannel, A_UINT16 channelMhz);
 
 static A_UINT32
 ar5513AdjustPhaseRamp(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval);
@@ -164,6 +231,47 @@ typedef struct ar5513RfBanks5112 {
     A_UINT32 Bank7Data[sizeof(ar5212Bank7) / sizeof(*(ar5212Bank7))];
 } AR5513_RF_BANKS_5112;
 
+#define AR5513_RF_BANKS_5112_MASK   ((1 << 1) | (1 << 2) | (1 << 3) | (1 << 6) | (1 << 7))
+
+/* Writes an analog bank unless the radio already holds it */
+#define AR5513_WRITE_RF_BANK(_pDev, _bank, _regArray, _pRfBanks, _pWritten)   do {     \
+    if (ar5513RfBankChanged((_pDev), (_bank), (_pRfBanks)->Bank##_bank##Data,           \
+                            (_pWritten)->Bank##_bank##Data,                             \
+                            sizeof((_pRfBanks)->Bank##_bank##Data)))                    \
+    {                                                                                   \
+        HAL_WL_WRITE_RF_ARRAY((_pDev), _regArray, (_pRfBanks)->Bank##_bank##Data);      \
+    }                                                                                   \
+} while (0)
+
+/* One chain's transmit power programming for a channel, as written to the chip */
+typedef struct ar5513TxPowerRegs {
+    A_UINT32    pcdacRegs[PWR_TABLE_SIZE / 2];  /* Two PCDAC table entries per register */
+    A_UINT32    rateRegs[4];                    /* PHY_POWER_TX_RATE1 - 4 */
+    A_UINT16    rfXpdGain[2];
+    A_INT16     twiceBandEdgePower;
+    A_INT16     txPowerIndexOffset;
+    A_BOOL      pcdacTableModified;             /* Gain delta WAR changed the table */
+    AR5513_RATE_TARGETS targets;
+    A_UINT32    ofdmTxPower;
+    A_INT32     tx6PowerInHalfDbm;
+    A_INT32     maxTxPowerAvail;
+} AR5513_TXPOWER_REGS;
+
+#ifdef HAL_RESET_RECIPE
+/* Software state ar5513SetChannelRegs leaves behind, kept with each reset recipe */
+typedef struct ar5513RecipeState {
+    AR5513_RF_BANKS_5112    banks;
+    A_INT16                 txPowerIndexOffset;
+    A_UINT32                ofdmTxPower;
+    A_INT32                 tx6PowerInHalfDbm;
+    AR5513_RATE_TARGETS     rateTargets[AR5513_TX_CHAINS];
+} AR5513_RECIPE_STATE;
+
+static A_STATUS
+ar5513SetChannelRegsCached(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval, A_UINT16 modesIndex,
+                           A_INT16 powerLimit);
+#endif
+
 const struct RfHalFuncs ar5112Funcs = {
     ar5513SetChannel5112,
     ar5513SetRfRegs5112,
@@ -187,60 +295,49 @@ const struct RfHalFuncs ar5112Funcs = {
 #define FALCON_TWICE_COHERENT_COMB_GAIN    12 
 
 /*
- * Bug 10685, need to provide a registry based control for
- * the maximum number of registers that can be written to by
- * REG_WRITE_ARRAY and REG_WRITE_RF_ARRAY, without a 1 us delay
- * This is to provide some level of flexibility for only the ndis
- * drivers to better interoperate with out drivers, namely the
- * sound drivers.
- * Provided a new Registry entry writeBlockSize, defaults to 64
- * note, for the BUILD_AP this will always be 64.
- * Also this was only implemented for the AR5513 hal and not the
- * AR5211 hal.
+ * Init tables in the order the reset used to write them; 5112 based
+ * boards write the tables a second time.  Folded into one address
+ * sorted write list per modesIndex at attach.  Pacing (bug 10685
+ * writeBlockSize, bug 6773) is applied by the write list engine.
  */
-#define REG_WRITE_ARRAY(regArray, column, regWar, writeBlockSize)           \
-{   int entries, r;                                                         \
-    udelay(1);                                                              \
-    entries = sizeof(regArray) / sizeof(*(regArray));                       \
-    for (r = 0; r < entries; r++) {                                         \
-        A_REG_WR(pDev, (regArray)[r][0], (regArray)[r][(column)]);          \
-        if ((++(regWar) % writeBlockSize) == 0) {                           \
-            udelay(1);                                                      \
-        }                                                                   \
-    }                                                                       \
-}
-
-#define REG_WRITE_RF_ARRAY(regAddress, regData, regWar, writeBlockSize)     \
-{   int entries, r;                                                         \
-    udelay(1);                                                              \
-    entries = sizeof(regAddress) / sizeof(*(regAddress));                   \
-    for (r = 0; r < entries; r++) {                                         \
-        A_REG_WR(pDev, (regAddress)[r][0], (regData)[r]);                   \
-        if ((++(regWar) % writeBlockSize) == 0) {                           \
-            udelay(1);                                                      \
-        }                                                                   \
-    }                                                                       \
-}
+static const HAL_WL_SOURCE ar5513IniSources[] = {
+    HAL_WL_SOURCE_INIT(ar5212Modes,     HAL_WL_COL_MODE,   0),
+    HAL_WL_SOURCE_INIT(ar5212Common,    HAL_WL_COL_COMMON, HAL_WL_KEEP_PCU),
+    /* IS_5112 only */
+    HAL_WL_SOURCE_INIT(ar5212Modes,     HAL_WL_COL_MODE,   0),
+    HAL_WL_SOURCE_INIT(ar5212Common,    HAL_WL_COL_COMMON, 0),
+    HAL_WL_SOURCE_INIT(ar5212BB_RfGain, HAL_WL_COL_FREQ,   0),
+};
+#define AR5513_INI_SOURCES_BASE     2
 
 /*
- * WAR for bug 6773.  udelay() does a PIO READ on the PCI bus which allows
- * other cards' DMA reads to complete in the middle of our reset.
+ * Init table registers the reset, calibration or ANI change after
+ * the tables are written.  A fast channel change writes these
+ * whether or not the table values differ.
  */
-#define WAR_6773(x)          \
-    if ((++(x) % 64) == 0) { \
-        udelay(1);           \
-    }
+static const A_UINT32 ar5513IniVolatileRegs[] = {
+    PHY_AGC_CONTROL,        /* NF cal enables */
+    PHY_TIMING_CTRL4,       /* IQ cal results */
+    PHY_TXBF_CTRL,          /* Chain force bits are or'ed in */
+    PHY_DAG_CTRLCCK,
+    PHY_DESIRED_SZ,         /* ANI */
+    PHY_AGC_CTL1,
+    PHY_FIND_SIG,
+    PHY_SFCORR,
+    PHY_SFCORR_LOW,
+    PHY_CCK_DETECT,
+    PHY_TIMING5,
+};
 
 #if defined(WMAC_WRITE_REG)
-int dump5513Regs = 1;
-
 #ifdef BUILD_AP
-void writePlatformReg(WLAN_DEV_INFO *pdevInfo, ULONG reg, ULONG val)
+/*
+ * Name in parentheses so a register I/O hook macro does not expand it.
+ * Build with HAL_REG_TRACE and use halRegTraceEnable to log writes.
+ */
+void (writePlatformReg)(WLAN_DEV_INFO *pdevInfo, ULONG reg, ULONG val)
 {
     (*((volatile ULONG *)((pdevInfo)->baseAddress + (reg))) = (val));
-    if (dump5513Regs) {
-	uiPrintf("0x%04lX: 0x%08lX\n", reg, val);
-    }
 }
 #endif /* BUILD_AP */
 #endif /* WMAC_WRITE_REG */
@@ -265,10 +362,8 @@ ar5513Reset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval,
     A_UINT32           ulAddressLow, ulAddressHigh;
     A_UINT32           macStaId1;
     A_UINT32           i;
-    A_UINT32           reg, data, synthDelay;
-    A_UINT16           rfXpdGain[2];
+    A_UINT32           reg, data, synthDelay, multiChnEnb;
     A_STATUS           status;
-    A_UINT16           arrayEntries;
     A_INT16            powerLimit = MAX_RATE_POWER;
     A_INT16            cckOfdmPwrDelta = 0;
     A_UINT16           modesIndex = 0, freqIndex = 0;
@@ -277,13 +372,14 @@ ar5513Reset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval,
     A_BOOL             earHere;
     struct eepMap      *pEepData = pDev->pHalInfo->pEepData;
     WLAN_STA_CONFIG    *pCfg = &pDev->staConfig;
-    int                regWrites = 0;
     const RF_HAL_FUNCS *pRfHal = pDev->pHalInfo->pRfHal;
     A_UINT32           useMic;
     VPORT_BSS          *pVportBaseBss = GET_BASE_BSS(pDev);
     A_UINT32           testReg;
     A_STATUS           ret;
-    A_UINT32           writeBlockSize;
+    A_BOOL             fastChannel;
+
+    HAL_REG_PROFILE_FN(pDev, ar5513Reset);
 
     ASSERT(((pChval->channelFlags & CHANNEL_2GHZ) || 0) ^
            ((pChval->channelFlags & CHANNEL_5GHZ) || 0));
@@ -325,7 +421,7 @@ ar5513Reset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval,
         saveFrameSeqCount = readPlatformReg(pDev, MAC_D0_SEQNUM);
 
         /* Save off the latest NF calibration */
-        ar5513GetNf(pDev, pDev->staConfig.phwChannel);
+        (void)ar5513NfCalPoll(pDev, pDev->staConfig.phwChannel);
     }
 
     /*
@@ -377,17 +473,6 @@ ar5513Reset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval,
     }
     pDev->pHalInfo->halInit = FALSE;
 
-    status = ar5513ChipReset(pDev, pChval);
-    if (status != A_OK) {
-        return status;
-    }
-
-    /*
-     * Initialize the global Interrupt Enable reference count.
-     * Assume interrupts were disabled.
-     */
-    pDev->pHalInfo->globIntRefCount = 1;
-
     /* Setup the indices for the next set of register array writes */
     switch (pChval->channelFlags & CHANNEL_ALL) {
     case CHANNEL_A:
@@ -419,33 +504,39 @@ ar5513Reset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval,
         break;
     }
 
-    /* Set correct Baseband to analog shift setting to access analog chips. */
-    writePlatformReg(pDev, PHY_BASE, 0x00000007);
+    fastChannel = bChannelChange && ar5513FastChannelChange(pDev, pChval, modesIndex);
+    if (!fastChannel) {
+        HAL_RESET_PHASE_START(pDev, HAL_RESET_PHASE_CHIP_RESET);
+        status = ar5513ChipReset(pDev, pChval);
+        HAL_RESET_PHASE_END(pDev, HAL_RESET_PHASE_CHIP_RESET);
+        if (status != A_OK) {
+            HAL_REG_PROFILE_EXIT(pDev);
+            return status;
+        }
+    }
 
-#ifdef BUILD_AP
-    writeBlockSize = MAX_WRITEBLOCKSIZE;
-#else
-    writeBlockSize = pDev->staConfig.writeBlockSize;
-#endif
+    /*
+     * Initialize the global Interrupt Enable reference count.
+     * Assume interrupts were disabled.
+     */
+    pDev->pHalInfo->globIntRefCount = 1;
 
-    REG_WRITE_ARRAY(ar5212Modes, modesIndex, regWrites, writeBlockSize);
-    /* Write Common Array Parameters */
-    arrayEntries = sizeof(ar5212Common) / sizeof(*ar5212Common);
-    for (i = 0; i < arrayEntries; i++) {
-        reg = ar5212Common[i][0];
+    /* Set correct Baseband to analog shift setting to access analog chips. */
+    writePlatformReg(pDev, PHY_BASE, 0x00000007);
 
-        /* On channel change, don't reset the PCU registers */
-        if ( !(bChannelChange && (reg >= 0x8000 && reg < 0x9000)) ) {
-            /* TODO: Is this still needed here for 5212? */
-            A_REG_WR(pDev, reg, ar5212Common[i][1]);
-            WAR_6773(regWrites);
-        }
-    }
-    if (IS_5112(pDev)) {
-        REG_WRITE_ARRAY(ar5212Modes, modesIndex, regWrites, writeBlockSize);
-        REG_WRITE_ARRAY(ar5212Common, 1, regWrites, writeBlockSize);
-        REG_WRITE_ARRAY(ar5212BB_RfGain, freqIndex, regWrites, writeBlockSize);
+    /* Write the Modes, Common and RfGain init tables - on channel change, don't reset the PCU registers */
+    HAL_RESET_PHASE_START(pDev, HAL_RESET_PHASE_INI_WRITES);
+    if (fastChannel) {
+        /* Only the rows that differ from the tables already loaded */
+        halWriteListApply(pDev, pDev->pHalInfo->pIniDeltaList[pDev->pHalInfo->iniModesIndex][modesIndex],
+                          TRUE);
+        pDev->pHalInfo->writeStats.fastChanChanges++;
+    } else {
+        halWriteListApply(pDev, pDev->pHalInfo->pIniWriteList[modesIndex], bChannelChange);
     }
+    HAL_RESET_PHASE_END(pDev, HAL_RESET_PHASE_INI_WRITES);
+    pDev->pHalInfo->iniModesIndex = modesIndex;
+    pDev->pHalInfo->iniEarEngaged = earHere;
 
     /*
     ** Set Antenna Fast Diversity Bias to 10 dB in order
@@ -459,13 +550,14 @@ ar5513Reset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval,
     A_REG_WR(pDev,PHY_MULTICHN_GAIN_CTRL,reg);
 #endif
 
-    A_REG_WR(pDev,PHY_MULTICHN_ENB, 0);
+    /* Nothing else writes MULTICHN_ENB - keep a copy rather than read it back */
+    multiChnEnb = 0;
+    A_REG_WR(pDev,PHY_MULTICHN_ENB, multiChnEnb);
 
     switch (pDev->staConfig.txChainCtrl) {
     case CHAIN_FIXED_A:
-        reg = A_REG_RD(pDev, PHY_MULTICHN_ENB);
-        reg |= (PHY_CHN_0_ENB << PHY_TX_CHN_SHIFT);
-        A_REG_WR(pDev, PHY_MULTICHN_ENB, reg);
+        multiChnEnb |= (PHY_CHN_0_ENB << PHY_TX_CHN_SHIFT);
+        A_REG_WR(pDev, PHY_MULTICHN_ENB, multiChnEnb);
 
         reg = A_REG_RD(pDev,PHY_TXBF_CTRL);
         reg |= PHY_CHN_0_FORCE;        /* Force Chain 0 as static chain sel */
@@ -473,9 +565,8 @@ ar5513Reset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval,
         break;
 
     case CHAIN_FIXED_B:
-        reg = A_REG_RD(pDev, PHY_MULTICHN_ENB);
-        reg |= (PHY_CHN_1_ENB << PHY_TX_CHN_SHIFT);
-        A_REG_WR(pDev,PHY_MULTICHN_ENB,reg);
+        multiChnEnb |= (PHY_CHN_1_ENB << PHY_TX_CHN_SHIFT);
+        A_REG_WR(pDev,PHY_MULTICHN_ENB,multiChnEnb);
 
         reg = A_REG_RD(pDev,PHY_TXBF_CTRL);
         reg |= PHY_CHN_1_FORCE;       /* Force Chain 1 as static chain sel */
@@ -483,9 +574,8 @@ ar5513Reset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval,
         break;
 
     case DUAL_CHAIN:
-        reg = A_REG_RD(pDev, PHY_MULTICHN_ENB);
-        reg |= (PHY_CHN_ALL_ENB << PHY_TX_CHN_SHIFT);
-        A_REG_WR(pDev,PHY_MULTICHN_ENB,reg);
+        multiChnEnb |= (PHY_CHN_ALL_ENB << PHY_TX_CHN_SHIFT);
+        A_REG_WR(pDev,PHY_MULTICHN_ENB,multiChnEnb);
 
         /*
          * Compute Phase Ramp between Chain 0 & Chain 1.
@@ -545,21 +635,18 @@ ar5513Reset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval,
 
     switch (pDev->staConfig.rxChainCtrl) {
     case CHAIN_FIXED_A:
-        reg = A_REG_RD(pDev, PHY_MULTICHN_ENB);
-        reg |= (PHY_CHN_0_ENB << PHY_RX_CHN_SHIFT);
-        A_REG_WR(pDev,PHY_MULTICHN_ENB,reg);
+        multiChnEnb |= (PHY_CHN_0_ENB << PHY_RX_CHN_SHIFT);
+        A_REG_WR(pDev,PHY_MULTICHN_ENB,multiChnEnb);
         break;
 
     case CHAIN_FIXED_B:
-        reg = A_REG_RD(pDev, PHY_MULTICHN_ENB);
-        reg |= (PHY_CHN_1_ENB << PHY_RX_CHN_SHIFT);
-        A_REG_WR(pDev,PHY_MULTICHN_ENB,reg);
+        multiChnEnb |= (PHY_CHN_1_ENB << PHY_RX_CHN_SHIFT);
+        A_REG_WR(pDev,PHY_MULTICHN_ENB,multiChnEnb);
         break;
 
     case DUAL_CHAIN:
-        reg = A_REG_RD(pDev, PHY_MULTICHN_ENB);
-        reg |= (PHY_CHN_ALL_ENB << PHY_RX_CHN_SHIFT);
-        A_REG_WR(pDev,PHY_MULTICHN_ENB,reg);
+        multiChnEnb |= (PHY_CHN_ALL_ENB << PHY_RX_CHN_SHIFT);
+        A_REG_WR(pDev,PHY_MULTICHN_ENB,multiChnEnb);
         break;
     }
 
@@ -609,30 +696,16 @@ ar5513Reset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval,
         powerLimit = A_MIN(pDev->bssDescr->tpcIe.pwrLimit, powerLimit);
     }
 
-    if (ar5513SetTransmitPower(pDev, pChval, rfXpdGain,
-                               powerLimit, TRUE, CHAIN_0) != A_OK)
-    {
-        return A_ERROR;
-    }
-
-    if (ar5513SetTransmitPower(pDev, pChval, rfXpdGain,
-                               powerLimit, TRUE, CHAIN_1) != A_OK)
-    {
+#ifdef HAL_RESET_RECIPE
+    status = ar5513SetChannelRegsCached(pDev, pChval, modesIndex, powerLimit);
+#else
+    status = ar5513SetChannelRegs(pDev, pChval, modesIndex, powerLimit);
+#endif
+    if (status != A_OK) {
+        HAL_REG_PROFILE_EXIT(pDev);
         return A_ERROR;
     }
 
-    /* Write the analog registers */
-    pRfHal->ar5513SetRfRegs(pDev, pEepData->pEepHeader, pChval, modesIndex, rfXpdGain);
-
-    /* Write delta slope for OFDM enabled modes (A, G, Turbo) */
-    if (IS_CHAN_OFDM(pChval->channelFlags)) {
-        ar5513SetDeltaSlope(pDev, pChval);
-    }
-
-    /* Setup board specific options for EEPROM version 3 */
-    /* this fcn calls ar5513SetAntennaSwitch() */
-    ar5513SetBoardValues(pDev, pEepData->pEepHeader, pChval);
-
     /* Restore certain DMA hardware registers on a channel change */
     if (bChannelChange) {
         writePlatformReg(pDev, MAC_D0_SEQNUM, saveFrameSeqCount);
@@ -725,6 +798,7 @@ ar5513Reset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval,
 
     status = pRfHal->ar5513SetChannel(pDev, pChval);
     if (status != A_OK) {
+        HAL_REG_PROFILE_EXIT(pDev);
         return status;
     }
 
@@ -780,6 +854,7 @@ ar5513Reset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval,
 
     /* Activate the PHY (includes baseband activate and synthesizer on) */
     writePlatformReg(pDev, PHY_ACTIVE, PHY_ACTIVE_EN);
+    HAL_RESET_PHASE_START(pDev, HAL_RESET_PHASE_SYNTH_SETTLE);
 
     /*
      * There is an issue if the AP starts the calibration before the base
@@ -809,6 +884,7 @@ ar5513Reset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval,
     ASSERT(i < 20);                         /* ASSERT i limit is reached */
 
     A_REG_WR(pDev, PHY_TESTCTRL, testReg);
+    HAL_RESET_PHASE_END(pDev, HAL_RESET_PHASE_SYNTH_SETTLE);
 
     /* Should the Ear disable offset cal? */
     if (!(earHere && ar5513EarModify(pDev, EAR_LC_RESET_OFFSET, pChval, &modifier))) {
@@ -816,8 +892,11 @@ ar5513Reset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval,
     }
 
     /* Should the Ear disable noise floor cal? */
+    pDev->pHalInfo->nfCalState   = NF_CAL_IDLE;
+    pDev->pHalInfo->nfCalRestart = FALSE;
     if (!(earHere && ar5513EarModify(pDev, EAR_LC_RESET_NF, pChval, &modifier))) {
         A_REG_SET_BIT(pDev, PHY_AGC_CONTROL, NF);
+        pDev->pHalInfo->nfCalState = NF_CAL_RUNNING;
     }
 
     /*
@@ -825,17 +904,18 @@ ar5513Reset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval,
      * -Cal is not necessary for CCK-only operation or scan-only channels
      * -Don't run cal if previous results exist (and no current request)
      */
+    HAL_RESET_PHASE_START(pDev, HAL_RESET_PHASE_IQ_CAL);
     if ((pCfg->calibrationTime != 0) && !IS_CHAN_B(pChval->channelFlags) &&
         !(pDev->pHalInfo->iqCalState == IQ_CAL_DONE) &&
         !(earHere && ar5513EarModify(pDev, EAR_LC_RESET_IQ, pChval, &modifier)))
     {
         /* Start IQ calibration w/ 2^(INIT_IQCAL_LOG_COUNT_MAX+1) samples */
-        A_REG_RMW_FIELD(pDev, PHY_TIMING_CTRL4, IQCAL_LOG_COUNT_MAX, INIT_IQCAL_LOG_COUNT_MAX);
-        A_REG_SET_BIT(pDev, PHY_TIMING_CTRL4, DO_IQCAL);
-        pDev->pHalInfo->iqCalState       = IQ_CAL_RUNNING;
+        ar5513IQCalStart(pDev, INIT_IQCAL_LOG_COUNT_MAX, ar5513IQCalChains(pDev));
     } else {
         pDev->pHalInfo->iqCalState       = IQ_CAL_INACTIVE;
+        pDev->pHalInfo->iqCalChains      = 0;
     }
+    HAL_RESET_PHASE_END(pDev, HAL_RESET_PHASE_IQ_CAL);
 
     /* Set 1:1 QCU to DCU mapping for all queues */
     for (i = 0; i < MAC_NUM_DCU; i++) {
@@ -884,12 +964,14 @@ ar5513Reset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval,
     /* Should the Ear disable offset cal? */
     if (!(earHere && ar5513EarModify(pDev, EAR_LC_RESET_OFFSET, pChval, &modifier))) {
         /* At the end of reset - poll for a completed offset calibration */
+        HAL_RESET_PHASE_START(pDev, HAL_RESET_PHASE_NF_CAL);
         for (i = 0; i < 100; i++) {
             if ( (A_REG_RD(pDev, PHY_AGC_CONTROL) & PHY_AGC_CONTROL_CAL) == 0 ) {
                 break;
             }
             udelay(10);
         }
+        HAL_RESET_PHASE_END(pDev, HAL_RESET_PHASE_NF_CAL);
         if (i == 100) {
             uiPrintf("WARNING: ar5513Reset: offset calibration failed to complete in 1 ms - noisy environment?\n");
         }
@@ -939,6 +1021,7 @@ ar5513Reset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval,
     A_REG_WR(pDev, MAC_TXOP_8_11,   0xFFFFFFFF);
     A_REG_WR(pDev, MAC_TXOP_12_15,  0xFFFFFFFF);
 
+    HAL_REG_PROFILE_EXIT(pDev);
     return A_OK;
 }
 
@@ -1056,6 +1139,252 @@ ar5513Disable(WLAN_DEV_INFO *pDev)
     return status;
 }
 
+/**************************************************************
+ * ar5513GetPhyModeRegs
+ *
+ * Returns the PHY_MODE, PHY_TURBO and PHY_PLL_CTL values for
+ * the given channel.
+ */
+static void
+ar5513GetPhyModeRegs(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval, A_UINT32 *pRfMode,
+                     A_UINT32 *pTurbo, A_UINT32 *pPll)
+{
+    WLAN_CFLAGS cflags = pChval->channelFlags;
+    A_UINT32    rfMode, phyPLLCtlVal, newPll = 0;
+
+    /* xxx: 'G' should set CCK Flag! */
+    if (IS_CHAN_G(cflags)) {
+        cflags |= CHANNEL_CCK;
+    }
+
+    if (IS_5112(pDev)) {
+        rfMode       = PHY_MODE_AR5112;
+        phyPLLCtlVal = IS_CHAN_CCK(cflags) ? PHY_PLL_CTL_44_5112 : PHY_PLL_CTL_40_5112;
+    } else {
+        rfMode       = PHY_MODE_AR5111;
+        phyPLLCtlVal = IS_CHAN_CCK(cflags) ? PHY_PLL_CTL_44 : PHY_PLL_CTL_40;
+    }
+
+    if (IS_CHAN_OFDM(cflags) && IS_CHAN_CCK(cflags)) {
+        rfMode |= PHY_MODE_DYNAMIC;
+    } else if (IS_CHAN_OFDM(cflags)) {
+        rfMode |= PHY_MODE_OFDM;
+    } else {
+        ASSERT(IS_CHAN_CCK(cflags));
+        rfMode |= PHY_MODE_CCK;
+    }
+
+    if (IS_CHAN_5GHZ(cflags)) {
+        rfMode |= PHY_MODE_RF5GHZ;
+    } else {
+        ASSERT(IS_CHAN_2GHZ(cflags));
+        rfMode |= PHY_MODE_RF2GHZ;
+    }
+
+    /*
+     * Enable XR in the chip if the hardware supports it and
+     * not disabled by the user.
+     */
+    if ((pDev->staConfig.abolt & ABOLT_XR) != 0) {
+        rfMode |= PHY_MODE_XR;
+    }
+
+    if (ar5513IsEarEngaged(pDev, pChval) && ar5513EarModify(pDev, EAR_LC_PLL, pChval, &newPll)) {
+        phyPLLCtlVal = newPll;
+    }
+
+    *pRfMode = rfMode;
+    *pTurbo  = IS_CHAN_TURBO(cflags) ? (PHY_FC_TURBO_MODE | PHY_FC_TURBO_SHORT) : 0;
+    *pPll    = phyPLLCtlVal;
+}
+
+/**************************************************************
+ * ar5513FastChannelChange
+ *
+ * Readies a channel change that keeps the chip out of reset, so
+ * that only the init table delta from iniModesIndex to modesIndex
+ * needs writing.  Possible within a band when the PLL stays put.
+ * The EAR stages program registers per channel range outside of
+ * the init tables, so a change to or from a channel the EAR
+ * covers takes the full reset.
+ * Returns FALSE if a full chip reset is needed instead.
+ */
+static A_BOOL
+ar5513FastChannelChange(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval, A_UINT16 modesIndex)
+{
+    HAL_INFO *pInfo = pDev->pHalInfo;
+    A_UINT32 rfMode, turbo, phyPLLCtlVal;
+
+    if (!pInfo->fastChanChange || pInfo->iniModesIndex == 0 ||
+        pInfo->pIniDeltaList[pInfo->iniModesIndex][modesIndex] == NULL ||
+        pInfo->iniEarEngaged || ar5513IsEarEngaged(pDev, pChval) ||
+        pDev->powerMgmt.powerState == D3_STATE)
+    {
+        return FALSE;
+    }
+
+    ar5513GetPhyModeRegs(pDev, pChval, &rfMode, &turbo, &phyPLLCtlVal);
+#ifndef FALCON_EMUL
+    if (readPlatformReg(pDev, PHY_PLL_CTL) != phyPLLCtlVal) {
+        return FALSE;
+    }
+#endif /* !FALCON_EMUL */
+
+    /* Radio off while the mode and synthesizer change - PHY_ACTIVE_EN restarts it */
+    writePlatformReg(pDev, PHY_ACTIVE, PHY_ACTIVE_DIS);
+
+    /* Turbo cannot be set at the same time as CCK or DYNAMIC */
+    if (IS_CHAN_CCK(pChval->channelFlags) || IS_CHAN_G(pChval->channelFlags)) {
+        writePlatformReg(pDev, PHY_TURBO, turbo);
+        writePlatformReg(pDev, PHY_MODE, rfMode);
+    } else {
+        writePlatformReg(pDev, PHY_MODE, rfMode);
+        writePlatformReg(pDev, PHY_TURBO, turbo);
+    }
+    return TRUE;
+}
+
+/**************************************************************
+ * ar5513SetChannelRegs
+ *
+ * Programs transmit power, the analog banks, delta slope and
+ * the board values for the channel.  Everything written here
+ * follows from the channel, chain and power configuration, the
+ * EEPROM and the EAR.
+ */
+static A_STATUS
+ar5513SetChannelRegs(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval, A_UINT16 modesIndex,
+                     A_INT16 powerLimit)
+{
+    struct eepMap      *pEepData = pDev->pHalInfo->pEepData;
+    const RF_HAL_FUNCS *pRfHal = pDev->pHalInfo->pRfHal;
+    A_UINT16           rfXpdGain[2];
+
+    HAL_RESET_PHASE_START(pDev, HAL_RESET_PHASE_TX_POWER);
+    if (ar5513SetTransmitPower(pDev, pChval, rfXpdGain,
+                               powerLimit, TRUE, CHAIN_0) != A_OK)
+    {
+        return A_ERROR;
+    }
+
+    if (ar5513SetTransmitPower(pDev, pChval, rfXpdGain,
+                               powerLimit, TRUE, CHAIN_1) != A_OK)
+    {
+        return A_ERROR;
+    }
+    HAL_RESET_PHASE_END(pDev, HAL_RESET_PHASE_TX_POWER);
+
+    /* Write the analog registers */
+    HAL_RESET_PHASE_START(pDev, HAL_RESET_PHASE_RF_BANKS);
+    pRfHal->ar5513SetRfRegs(pDev, pEepData->pEepHeader, pChval, modesIndex, rfXpdGain);
+    HAL_RESET_PHASE_END(pDev, HAL_RESET_PHASE_RF_BANKS);
+
+    /* Write delta slope for OFDM enabled modes (A, G, Turbo) */
+    if (IS_CHAN_OFDM(pChval->channelFlags)) {
+        ar5513SetDeltaSlope(pDev, pChval);
+    }
+
+    /* Setup board specific options for EEPROM version 3 */
+    /* this fcn calls ar5513SetAntennaSwitch() */
+    ar5513SetBoardValues(pDev, pEepData->pEepHeader, pChval);
+
+    return A_OK;
+}
+
+#ifdef HAL_RESET_RECIPE
+/**************************************************************
+ * ar5513SetChannelRegsCached
+ *
+ * ar5513SetChannelRegs through the reset recipe cache.  The key
+ * holds every input of ar5513SetChannelRegs that changes while
+ * attached; ar5513EepromWrite flushes the cache.  The read-modify-
+ * writes are replayed as the values captured, so the cache also
+ * checks that the registers they read still hold what they did.
+ */
+static A_STATUS
+ar5513SetChannelRegsCached(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval, A_UINT16 modesIndex,
+                           A_INT16 powerLimit)
+{
+    HAL_INFO                  *pInfo = pDev->pHalInfo;
+    WLAN_STA_CONFIG           *pCfg = &pDev->staConfig;
+    HAL_RESET_RECIPE_KEY      key;
+    const AR5513_RECIPE_STATE *pSaved;
+    AR5513_RECIPE_STATE       *pState;
+    A_STATUS                  status;
+
+    A_MEM_ZERO(&key, sizeof(key));
+    key.channelFlags = pChval->channelFlags;
+    key.channel      = pChval->channel;
+    key.powerLimit   = powerLimit;
+    key.txChainCtrl  = pCfg->txChainCtrl;
+    key.rxChainCtrl  = pCfg->rxChainCtrl;
+    key.config[0]    = ((A_UINT32)pCfg->tpcHalfDbm5 & 0xffff) | ((A_UINT32)pCfg->tpcHalfDbm2 << 16);
+    key.config[1]    = (A_UINT32)pCfg->tpScale | ((A_UINT32)pCfg->eirpLtdMode << 8) |
+                       ((A_UINT32)pCfg->diversityControl << 16) |
+                       (pCfg->iqOverride ? 0x1000000 : 0) | (pChval->iqCalValid ? 0x2000000 : 0);
+    key.config[2]    = ((A_UINT32)pCfg->iCoff & 0xffff) | ((A_UINT32)pCfg->qCoff << 16);
+    key.config[3]    = ((A_UINT32)pChval->iCoff & 0xffff) | ((A_UINT32)pChval->qCoff << 16);
+    key.config[4]    = (A_UINT32)wlanGetChannelPower(pDev, pChval);
+    key.config[5]    = pInfo->pGainValues->currStepNum;
+    key.config[6]    = modesIndex;
+    key.config[7]    = (A_UINT32)pCfg->overRideTxPower;
+
+    pSaved = (const AR5513_RECIPE_STATE *)halResetRecipeReplay(pDev, &key);
+    if (pSaved) {
+        /* The recipe holds every bank write, see below */
+        A_BCOPY(&pSaved->banks, pInfo->pAnalogBanks, sizeof(AR5513_RF_BANKS_5112));
+        A_BCOPY(&pSaved->banks, pInfo->pAnalogBanksWritten, sizeof(AR5513_RF_BANKS_5112));
+        pInfo->analogBanksValid   = AR5513_RF_BANKS_5112_MASK;
+        pInfo->txPowerIndexOffset = pSaved->txPowerIndexOffset;
+        pInfo->ofdmTxPower        = pSaved->ofdmTxPower;
+        pDev->tx6PowerInHalfDbm   = pSaved->tx6PowerInHalfDbm;
+        if (pInfo->pRateTargets) {
+            A_BCOPY(pSaved->rateTargets, pInfo->pRateTargets, sizeof(pSaved->rateTargets));
+        }
+        pInfo->rfgainState        = RFGAIN_INACTIVE;
+        return A_OK;
+    }
+
+    /* A recipe must not depend on the banks the radio held when it was captured */
+    pInfo->analogBanksValid = 0;
+    halResetRecipeCaptureStart(pDev);
+    status = ar5513SetChannelRegs(pDev, pChval, modesIndex, powerLimit);
+    pState = (AR5513_RECIPE_STATE *)halResetRecipeCaptureEnd(pDev, (status == A_OK) ? &key : NULL);
+    if (pState) {
+        A_BCOPY(pInfo->pAnalogBanks, &pState->banks, sizeof(AR5513_RF_BANKS_5112));
+        pState->txPowerIndexOffset = pInfo->txPowerIndexOffset;
+        pState->ofdmTxPower        = pInfo->ofdmTxPower;
+        pState->tx6PowerInHalfDbm  = pDev->tx6PowerInHalfDbm;
+        if (pInfo->pRateTargets) {
+            A_BCOPY(pInfo->pRateTargets, pState->rateTargets, sizeof(pState->rateTargets));
+        } else {
+            A_MEM_ZERO(pState->rateTargets, sizeof(pState->rateTargets));
+        }
+    }
+    return status;
+}
+
+/**************************************************************
+ * ar5513AllocateResetRecipes
+ */
+A_STATUS
+ar5513AllocateResetRecipes(WLAN_DEV_INFO *pDev)
+{
+    return halResetRecipeAttach(pDev, sizeof(AR5513_RECIPE_STATE));
+}
+#endif /* HAL_RESET_RECIPE */
+
+#ifdef HAL_TXPOWER_CACHE
+/**************************************************************
+ * ar5513AllocateTxPowerCache
+ */
+A_STATUS
+ar5513AllocateTxPowerCache(WLAN_DEV_INFO *pDev)
+{
+    return halTxPowerCacheAttach(pDev, sizeof(AR5513_TXPOWER_REGS));
+}
+#endif /* HAL_TXPOWER_CACHE */
+
 /**************************************************************
  * ar5513ChipReset
  *
@@ -1074,57 +1403,13 @@ ar5513ChipReset(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval)
     A_BOOL   resetOnly    = TRUE;
     A_UINT32 rfMode       = 0;
     A_UINT32 turbo        = 0;
-    A_UINT32 phyPLLCtlVal = 0, newPll = 0;
+    A_UINT32 phyPLLCtlVal = 0;
     A_UINT32 currentPllVal = 0;
     A_STATUS status;
 
     if (pChval) {
-        WLAN_CFLAGS cflags = pChval->channelFlags;
-
-        /* xxx: 'G' should set CCK Flag! */
-        if (IS_CHAN_G(cflags)) {
-            cflags |= CHANNEL_CCK;
-        }
-
-        if (IS_5112(pDev)) {
-            rfMode       = PHY_MODE_AR5112;
-            phyPLLCtlVal = IS_CHAN_CCK(cflags) ? PHY_PLL_CTL_44_5112 : PHY_PLL_CTL_40_5112;
-        } else {
-            rfMode       = PHY_MODE_AR5111;
-            phyPLLCtlVal = IS_CHAN_CCK(cflags) ? PHY_PLL_CTL_44 : PHY_PLL_CTL_40;
-        }
-
-        if (IS_CHAN_OFDM(cflags) && IS_CHAN_CCK(cflags)) {
-            rfMode |= PHY_MODE_DYNAMIC;
-        } else if (IS_CHAN_OFDM(cflags)) {
-            rfMode |= PHY_MODE_OFDM;
-        } else {
-            ASSERT(IS_CHAN_CCK(cflags));
-            rfMode |= PHY_MODE_CCK;
-        }
-
-        if (IS_CHAN_5GHZ(cflags)) {
-            rfMode |= PHY_MODE_RF5GHZ;
-        } else {
-            ASSERT(IS_CHAN_2GHZ(cflags));
-            rfMode |= PHY_MODE_RF2GHZ;
-        }
-
-        /*
-         * Enable XR in the chip if the hardware supports it and
-         * not disabled by the user.
-         */
-        if ((pDev->staConfig.abolt & ABOLT_XR) != 0) {
-            rfMode |= PHY_MODE_XR;
-        }
-
-        turbo = IS_CHAN_TURBO(cflags) ? (PHY_FC_TURBO_MODE | PHY_FC_TURBO_SHORT) : 0;
-
+        ar5513GetPhyModeRegs(pDev, pChval, &rfMode, &turbo, &phyPLLCtlVal);
         resetOnly = FALSE;
-
-        if (ar5513IsEarEngaged(pDev, pChval) && ar5513EarModify(pDev, EAR_LC_PLL, pChval, &newPll)) {
-            phyPLLCtlVal = newPll;
-        }
     } else {
         /* Cold starts need to initialize E2.0 chip 2.4 synth workaround logic */
         pDev->pHalInfo->done_synth_state_check_2_4 = FALSE;
@@ -1352,62 +1637,106 @@ ar5513IQCalibrationChain(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval, int chainInde
     return status;
 }
 /**************************************************************************
- * ar5513IQCalibration - Periodic calibration of PHY
- *
- * Recalibrate the lower PHY chips to account for temperature/environment
- * changes.
+ * ar5513IQCalChains - HAL_CAL_IQ_CHAINx bits for the rx chains in use
  */
-LOCAL void
-ar5513IQCalibration(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval)
+static A_UINT32
+ar5513IQCalChains(WLAN_DEV_INFO *pDev)
 {
-    A_UINT32 modifier;
-    A_BOOL   earHere;
-    WLAN_STA_CONFIG *pConfig = &pDev->staConfig;
-    A_STATUS statusChain0 = A_OK, statusChain1 = A_OK;
-
-    earHere = ar5513IsEarEngaged(pDev, pChval);
+    switch (pDev->staConfig.rxChainCtrl) {
+    case DUAL_CHAIN:
+        return HAL_CAL_IQ_CHAIN0 | HAL_CAL_IQ_CHAIN1;
+    case CHAIN_FIXED_A:
+        return HAL_CAL_IQ_CHAIN0;
+    case CHAIN_FIXED_B:
+        return HAL_CAL_IQ_CHAIN1;
+    default:
+        return 0;
+    }
+}
 
-    /* IQ calibration in progress. Check to see if it has finished. */
-    if ((pDev->pHalInfo->iqCalState == IQ_CAL_RUNNING) &&
-        !(A_REG_RD(pDev, PHY_TIMING_CTRL4) & PHY_TIMING_CTRL4_DO_IQCAL) &&
-        !pConfig->iqOverride)
-    {
-        /* IQ Calibration has finished.  Set to INACTIVE unless cal is valid */
-        pDev->pHalInfo->iqCalState = IQ_CAL_INACTIVE;
+/**************************************************************************
+ * ar5513IQCalStart - Start IQ calibration w/ 2^(logCountMax+1) samples
+ *
+ * The results for the given chains are applied by ar5513IQCalPoll.
+ */
+static void
+ar5513IQCalStart(WLAN_DEV_INFO *pDev, A_UINT32 logCountMax, A_UINT32 chains)
+{
+    A_REG_RMW_FIELD(pDev, PHY_TIMING_CTRL4, IQCAL_LOG_COUNT_MAX, logCountMax);
+    A_REG_SET_BIT(pDev, PHY_TIMING_CTRL4, DO_IQCAL);
+    pDev->pHalInfo->iqCalState  = IQ_CAL_RUNNING;
+    pDev->pHalInfo->iqCalChains = chains;
+}
 
-        /* Process IQ calibration per chain */
-        if (pDev->staConfig.rxChainCtrl == DUAL_CHAIN ||
-            pDev->staConfig.rxChainCtrl == CHAIN_FIXED_A) 
-        {
-            statusChain0 = ar5513IQCalibrationChain(pDev, pChval, CHAIN_0);
-        }
+/**************************************************************************
+ * ar5513IQCalPoll - Apply IQ calibration results if they are ready
+ *
+ * Each chain's correction is written as soon as it reads back good;
+ * the measurement is rerun for the misgated chains only.  Returns the
+ * chains still waiting for a result.  With iqOverride set the fixed
+ * coefficients stay in use and the run is dropped.
+ */
+static A_UINT32
+ar5513IQCalPoll(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval)
+{
+    HAL_INFO *pInfo = pDev->pHalInfo;
+    int      chain;
 
-        if (pDev->staConfig.rxChainCtrl == DUAL_CHAIN ||
-            pDev->staConfig.rxChainCtrl == CHAIN_FIXED_B) 
+    if (pInfo->iqCalState != IQ_CAL_RUNNING) {
+        return 0;
+    }
+    if (pDev->staConfig.iqOverride) {
+        pInfo->iqCalState  = IQ_CAL_INACTIVE;
+        pInfo->iqCalChains = 0;
+        return 0;
+    }
+    if (A_REG_RD(pDev, PHY_TIMING_CTRL4) & PHY_TIMING_CTRL4_DO_IQCAL) {
+        return pInfo->iqCalChains;
+    }
+
+    for (chain = CHAIN_0; chain <= CHAIN_1; chain++) {
+        if ((pInfo->iqCalChains & (HAL_CAL_IQ_CHAIN0 << chain)) &&
+            ar5513IQCalibrationChain(pDev, pChval, chain) == A_OK)
         {
-            statusChain1 = ar5513IQCalibrationChain(pDev, pChval, CHAIN_1);
+            pInfo->iqCalChains &= ~(HAL_CAL_IQ_CHAIN0 << chain);
         }
+    }
 
-        if ((statusChain0 == A_OK) && (statusChain1 == A_OK)) {
-            pDev->pHalInfo->iqCalState = IQ_CAL_DONE;
-         
-        } else {
-            /* Misgated IQ Cal => restart IQ Cal */
-            A_REG_SET_BIT(pDev, PHY_TIMING_CTRL4, DO_IQCAL);
-            ASSERT(!A_REG_IS_BIT_SET(pDev, PHY_TIMING_CTRL4, DO_IQCAL));
+    if (pInfo->iqCalChains) {
+        /* Misgated IQ Cal => restart IQ Cal */
+        A_REG_SET_BIT(pDev, PHY_TIMING_CTRL4, DO_IQCAL);
+        ASSERT(!A_REG_IS_BIT_SET(pDev, PHY_TIMING_CTRL4, DO_IQCAL));
+    } else {
+        pInfo->iqCalState = IQ_CAL_DONE;
+    }
+    return pInfo->iqCalChains;
+}
 
-            pDev->pHalInfo->iqCalState = IQ_CAL_RUNNING;
-        }
+/**************************************************************************
+ * ar5513IQCalibration - Periodic calibration of PHY
+ *
+ * Recalibrate the lower PHY chips to account for temperature/environment
+ * changes.
+ */
+LOCAL void
+ar5513IQCalibration(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval)
+{
+    A_UINT32 modifier;
+    A_BOOL   earHere;
+    WLAN_STA_CONFIG *pConfig = &pDev->staConfig;
+
+    earHere = ar5513IsEarEngaged(pDev, pChval);
+
+    if (pDev->pHalInfo->iqCalState == IQ_CAL_RUNNING) {
+        /* IQ calibration in progress. Apply the results if it has finished. */
+        (void)ar5513IQCalPoll(pDev, pChval);
     } else if (!IS_CHAN_B(pChval->channelFlags) &&
                (pDev->pHalInfo->iqCalState == IQ_CAL_DONE) && (pChval->iqCalValid == FALSE) &&
                !(earHere && ar5513EarModify(pDev, EAR_LC_RESET_IQ, pChval, &modifier)) &&
                !pConfig->iqOverride)
     {
         /* Start IQ calibration if configured channel has changed */
-        A_REG_RMW_FIELD(pDev, PHY_TIMING_CTRL4, IQCAL_LOG_COUNT_MAX,
-                        pConfig->iqLogCountMax);
-        A_REG_SET_BIT(pDev, PHY_TIMING_CTRL4, DO_IQCAL);
-        pDev->pHalInfo->iqCalState = IQ_CAL_RUNNING;
+        ar5513IQCalStart(pDev, pConfig->iqLogCountMax, ar5513IQCalChains(pDev));
     }
 }
 
@@ -1415,33 +1744,48 @@ ar5513IQCalibration(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval)
  * ar5513PerCalibration - Periodic calibration of PHY
  *
  * Recalibrate the lower PHY chips to account for temperature/environment
- * changes.
+ * changes.  Nothing here waits on the hardware: calibrations still
+ * running are picked up on the next call or by ar5513CalibrationStatus.
  */
 A_STATUS
 ar5513PerCalibration(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval)
 {
-    A_STATUS status      = A_OK;
-    A_UINT32 modifier;
-    A_BOOL   earHere;
+    A_STATUS      status      = A_OK;
+    A_UINT32      modifier;
+    A_BOOL        earHere;
+    NF_CAL_STATES nfCalState;
+
+    HAL_REG_PROFILE_FN(pDev, ar5513PerCalibration);
 
     earHere = ar5513IsEarEngaged(pDev, pChval);
 
     /* IQ Calibration (chain 0, chain 1) */
     ar5513IQCalibration(pDev, pChval);
 
-    /* Check noise floor results */
-    ar5513GetNf(pDev, pChval);
+    /*
+     * Check noise floor results.  Only a measurement that was already
+     * running has missed the window - one the poll has just restarted
+     * after loading the history has not.
+     */
+    nfCalState = pDev->pHalInfo->nfCalState;
+    if (ar5513NfCalPoll(pDev, pChval) && nfCalState == NF_CAL_RUNNING &&
+        pDev->pHalInfo->nfCalState == NF_CAL_RUNNING)
+    {
+        /* TODO: temp debug */
+        logNfCal_Add(pDev, 1);
+#ifdef DEBUG
+        uiPrintf("NF failed to complete in calibration window\n");
+#endif
+        pChval->rawNoiseFloor = 0;
+    }
     if (pChval->channelFlags & CHANNEL_CW_INT) {
+        HAL_REG_PROFILE_EXIT(pDev);
         return A_EBADCHANNEL;
     }
 
     if (!(earHere && ar5513EarModify(pDev, EAR_LC_PER_NF, pChval, &modifier))) {
         /* Run noise floor calibration */
-        if (pDev->staConfig.nfCalHistEnable) {
-            A_REG_SET_BIT(pDev, PHY_AGC_CONTROL, ENABLE_NF);
-            A_REG_SET_BIT(pDev, PHY_AGC_CONTROL, NO_UPDATE_NF);
-        }
-        A_REG_SET_BIT(pDev, PHY_AGC_CONTROL, NF);
+        ar5513NfCalStart(pDev);
     }
 
     /* Perform calibration for 5GHz channels and any OFDM on 5112 */
@@ -1458,9 +1802,69 @@ ar5513PerCalibration(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval)
         ar5513EarModify(pDev, EAR_LC_POST_PER_CAL, pChval, &modifier);
     }
 
+    HAL_REG_PROFILE_EXIT(pDev);
     return status;
 }
 
+/**************************************************************************
+ * ar5513StartCalibration
+ *
+ * Starts NF and/or per chain IQ calibration without waiting for it.
+ * An IQ request while IQ cal is running joins the run in progress.
+ * IQ chains not in rxChainCtrl are dropped from the request; it is
+ * refused if none is left, or if the EAR or iqOverride disables IQ
+ * calibration.
+ */
+A_STATUS
+ar5513StartCalibration(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval, A_UINT32 calMask)
+{
+    HAL_INFO *pInfo = pDev->pHalInfo;
+    A_UINT32 chains, modifier;
+
+    if (calMask & ~(HAL_CAL_NF | HAL_CAL_IQ)) {
+        return A_EINVAL;
+    }
+
+    if (calMask & HAL_CAL_IQ) {
+        /* IQ cal is not necessary for CCK-only operation */
+        chains = calMask & ar5513IQCalChains(pDev);
+        if (IS_CHAN_B(pChval->channelFlags) || chains == 0 || pDev->staConfig.iqOverride ||
+            (ar5513IsEarEngaged(pDev, pChval) &&
+             ar5513EarModify(pDev, EAR_LC_RESET_IQ, pChval, &modifier)))
+        {
+            return A_EINVAL;
+        }
+        if (pInfo->iqCalState == IQ_CAL_RUNNING) {
+            pInfo->iqCalChains |= chains;
+        } else {
+            ar5513IQCalStart(pDev, pDev->staConfig.iqLogCountMax, chains);
+        }
+    }
+
+    if (calMask & HAL_CAL_NF) {
+        ar5513NfCalStart(pDev);
+    }
+    return A_OK;
+}
+
+/**************************************************************************
+ * ar5513CalibrationStatus
+ *
+ * Applies whatever NF and IQ results are ready - one read of each
+ * status register - and returns the calibrations still running.  A
+ * noise floor over the EEPROM threshold sets CHANNEL_CW_INT in pChval.
+ */
+A_UINT32
+ar5513CalibrationStatus(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval)
+{
+    A_UINT32 pending;
+    HAL_REG_PROFILE_FN(pDev, ar5513CalibrationStatus);
+
+    pending = ar5513IQCalPoll(pDev, pChval) | ar5513NfCalPoll(pDev, pChval);
+    HAL_REG_PROFILE_EXIT(pDev);
+    return pending;
+}
+
 #ifdef BUILD_AP
 #define MAX_RESET_WAIT                         2000
 #else
@@ -1660,6 +2064,12 @@ ar5513SetResetReg(WLAN_DEV_INFO *pDev, A_UINT32 resetMask)
     NDIS_HANDLE handle = pDev->pOSHandle->NicAdapterHandle;
 #endif
 
+    if (resetMask) {
+        /* The init tables and analog banks must be written in full again */
+        pDev->pHalInfo->iniModesIndex    = 0;
+        pDev->pHalInfo->analogBanksValid = 0;
+    }
+
     if (resetMask & (MAC_RC_MAC | MAC_RC_PCI)) {
         /*
          * To ensure that the driver can reset the
@@ -1709,6 +2119,12 @@ ar5513SetResetReg(WLAN_DEV_INFO *pDev, A_UINT32 resetMask)
     A_REG_RD(pDev, MAC_RXDP);
 
     A_REG_WR(pDev, MAC_RC, resetMask);
+#ifdef HAL_REG_CACHE
+    if (resetMask) {
+        /* Registers return to their defaults */
+        halRegCacheInvalidate(pDev);
+    }
+#endif
 
 #ifndef BUILD_AP
     if (resetMask & MAC_RC_PCI) {
@@ -1787,6 +2203,9 @@ ar5513SetResetReg(WLAN_DEV_INFO *pDev, A_UINT32 resetMask)
     reg = sysRegRead(AR5513_RESET);             /* read before */
 
     if (resetMask) {
+        /* The analog banks must be written in full again */
+        pDev->pHalInfo->analogBanksValid = 0;
+
         /*
          * Reset the MAC and baseband.  This is a bit different than
          * the PCI version, but holding in reset causes problems.
@@ -1800,6 +2219,10 @@ ar5513SetResetReg(WLAN_DEV_INFO *pDev, A_UINT32 resetMask)
             reg |= resetBits;
 
         sysRegWrite(AR5513_RESET, reg);
+#ifdef HAL_REG_CACHE
+        /* Registers return to their defaults */
+        halRegCacheInvalidate(pDev);
+#endif
 
 #if defined(FALCON1_0_WAR)
         sysRegWrite(AR5513_AMBACLK, 0x1);
@@ -1898,22 +2321,41 @@ ar5513SetChannel5112(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval)
     return A_OK;
 }
 
-/* TODO: temp debug */
-void logNfCal_Add(WLAN_DEV_INFO *pDev, int flag);
+/**************************************************************************
+ * ar5513NfCalChainRange - Chains the NF calibration reads
+ */
+static void
+ar5513NfCalChainRange(WLAN_DEV_INFO *pDev, int *pFirst, int *pLast)
+{
+    switch (pDev->staConfig.rxChainCtrl) {
+    case DUAL_CHAIN:
+        *pFirst = CHAIN_0;
+        *pLast  = CHAIN_1;
+        break;
+    case CHAIN_FIXED_A:
+        *pFirst = *pLast = CHAIN_0;
+        break;
+    default:
+        *pFirst = *pLast = CHAIN_1;
+        break;
+    }
+}
 
 /**************************************************************************
  * Read the NF and check it against the noise floor threshhold
  *
- * Returns: The signed NF value.
+ * Called once the NF measurement has completed.  With the NF history
+ * enabled the median of the recent readings is then loaded into the
+ * baseband; ar5513NfCalPoll sees that through.
  */
-void
+static void
 ar5513GetNf(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval)
 {
     A_INT16       nf = 0, nfThresh, temp, *curr, tmpNfBuffer[NF_CAL_HIST_MAX];
     HEADER_WMODE  eepMode = 0;
     NFCAL_HIST    *h;
     A_INT32        val, base[2] = {(PHY_BASE+(25<<2)), (CHN_1_BASE+(25<<2))};
-    int            i, nchains, j, startIndex;
+    int            i, j, firstChain, lastChain;
 
     switch (pChval->channelFlags & CHANNEL_ALL) {
     case CHANNEL_A:
@@ -1935,115 +2377,159 @@ ar5513GetNf(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval)
         break;
     }
 
-    if (readPlatformReg(pDev, PHY_AGC_CONTROL) & PHY_AGC_CONTROL_NF) {
-        /* TODO: temp debug */
-        logNfCal_Add(pDev, 1);
-#ifdef DEBUG
-        uiPrintf("NF failed to complete in calibration window\n");
-#endif
-    } else {
-        /* TODO: temp debug */
-        logNfCal_Add(pDev, 0);
-        /* Finished NF cal, check against threshold */
-        nfThresh = pDev->pHalInfo->pEepData->pEepHeader->noiseFloorThresh[eepMode];
-        if (pDev->staConfig.rxChainCtrl == DUAL_CHAIN) {
-            startIndex = 0;
-            nchains    = 2;
-        } else if (pDev->staConfig.rxChainCtrl == CHAIN_FIXED_A) {
-            startIndex = 0;
-            nchains    = 1;
-        } else {
-            startIndex = 1;
-            nchains    = 1;
-        }
+    /* Finished NF cal, check against threshold */
+    nfThresh = pDev->pHalInfo->pEepData->pEepHeader->noiseFloorThresh[eepMode];
+    ar5513NfCalChainRange(pDev, &firstChain, &lastChain);
 
-        /*
-         * Run NF cal algo according to chain config selected
-         */
+    /*
+     * Run NF cal algo according to chain config selected
+     */
+    for (j = firstChain; j <= lastChain; j++) {
+        nf = (A_INT16)(readPlatformReg(pDev, base[j]) >> 19) & 0x1FF;
 
-        for (j = startIndex; ;) {
-            nf = (A_INT16)(readPlatformReg(pDev, base[j]) >> 19) & 0x1FF;
+        if (nf & 0x100) {
+            nf = 0 - ((nf ^ 0x1ff) + 1);
+        }
+        if (nf > nfThresh) {
+            uiPrintf("NF failed detected %d higher than thresh %d\n", 
+                      nf, nfThresh);
+            pChval->channelFlags |= CHANNEL_CW_INT;
+        }
 
-            if (nf & 0x100) {
-                nf = 0 - ((nf ^ 0x1ff) + 1);
-            }
-            if (nf > nfThresh) {
-                uiPrintf("NF failed detected %d higher than thresh %d\n", 
-                          nf, nfThresh);
-                pChval->channelFlags |= CHANNEL_CW_INT;
-            }
+        if (!pDev->staConfig.nfCalHistEnable) {
+            pChval->rawNoiseFloor = nf;
+            pDev->pHalInfo->nfCalState = NF_CAL_IDLE;
+            return;
+        }
+        
+        h = &pChval->nfCalHist[j];
+        h->nfCalBuffer[h->currIndex] = nf;
+        h->currIndex ++;
 
-            if (!pDev->staConfig.nfCalHistEnable) {
-                goto done;
+        if(!h->isBufferFull) {
+            if (h->currIndex == pDev->staConfig.nfCalHistSize) {
+                h->isBufferFull = 1;
             }
-            
-            h = &pChval->nfCalHist[j];
-            h->nfCalBuffer[h->currIndex] = nf;
-            h->currIndex ++;
-
-            if(!h->isBufferFull) {
-                if (h->currIndex == pDev->staConfig.nfCalHistSize) {
-                    h->isBufferFull = 1;
-                }
-            }
-            uiPrintf("nf value measured chain %d: %d\n", j, nf);
+        }
+        uiPrintf("nf value measured chain %d: %d\n", j, nf);
 
-            if (h->isBufferFull) {
+        if (h->isBufferFull) {
 
-                A_BCOPY(h->nfCalBuffer, tmpNfBuffer, sizeof(tmpNfBuffer));
+            A_BCOPY(h->nfCalBuffer, tmpNfBuffer, sizeof(tmpNfBuffer));
 
-                for(i = 1; i < pDev->staConfig.nfCalHistSize; i++) {
-                    for (curr = &tmpNfBuffer[i]; (curr > tmpNfBuffer) && 
-                         (*(curr - 1) > *curr); curr --)
-                    {
-                        temp = *curr;
-                        *curr = *(curr - 1);
-                        *(curr - 1) = temp;
-                    }
-                }
-                switch(pDev->staConfig.nfCalHistSize) {
-                    case 3:
-                        nf = tmpNfBuffer[1];
-                        break;
-                    case 5:
-                        nf = tmpNfBuffer[2];
-                        break;
-                }
-                if (h->currIndex == pDev->staConfig.nfCalHistSize) {
-                    h->currIndex = 0;
+            for(i = 1; i < pDev->staConfig.nfCalHistSize; i++) {
+                for (curr = &tmpNfBuffer[i]; (curr > tmpNfBuffer) && 
+                     (*(curr - 1) > *curr); curr --)
+                {
+                    temp = *curr;
+                    *curr = *(curr - 1);
+                    *(curr - 1) = temp;
                 }
             }
-
-            val = readPlatformReg(pDev, base[j]);
-            val &= 0xFFFFFE00;
-            val |= (((A_INT32)nf & 0x1FF) << 1);
-            writePlatformReg(pDev, base[j], val);
-        }
-
-        A_REG_CLR_BIT(pDev, PHY_AGC_CONTROL, ENABLE_NF);
-        A_REG_CLR_BIT(pDev, PHY_AGC_CONTROL, NO_UPDATE_NF);
-        A_REG_SET_BIT(pDev, PHY_AGC_CONTROL, NF);
-        while (readPlatformReg(pDev, PHY_AGC_CONTROL) & PHY_AGC_CONTROL_NF) {
-            udelay(10);
-        }
-        /*
-         * Now load a high maxCCAPower value again so that we're not capped
-         * by the median we just loaded
-         */
-        for (j = startIndex; ; ){
-            uiPrintf("CCA1 chn %d: 0x%lx\n", j, readPlatformReg(pDev, base[j]));
-            val &= 0xFFFFFE00;
-            val |= (((A_INT32)(-50) & 0x1FF) << 1);
-            writePlatformReg(pDev, base[j], val);
-            uiPrintf("CCA2 chn %d: 0x%lx\n", j, readPlatformReg(pDev, base[j]));
-
-            if (++j >= nchains) {
-                break;
+            switch(pDev->staConfig.nfCalHistSize) {
+                case 3:
+                    nf = tmpNfBuffer[1];
+                    break;
+                case 5:
+                    nf = tmpNfBuffer[2];
+                    break;
+            }
+            if (h->currIndex == pDev->staConfig.nfCalHistSize) {
+                h->currIndex = 0;
             }
         }
+
+        val = readPlatformReg(pDev, base[j]);
+        val &= 0xFFFFFE00;
+        val |= (((A_INT32)nf & 0x1FF) << 1);
+        writePlatformReg(pDev, base[j], val);
     }
-done:
     pChval->rawNoiseFloor = nf;
+
+    /* Load the filtered values - ar5513NfCalLoaded finishes up */
+    A_REG_CLR_BIT(pDev, PHY_AGC_CONTROL, ENABLE_NF);
+    A_REG_CLR_BIT(pDev, PHY_AGC_CONTROL, NO_UPDATE_NF);
+    A_REG_SET_BIT(pDev, PHY_AGC_CONTROL, NF);
+    pDev->pHalInfo->nfCalState = NF_CAL_LOADING;
+}
+
+/**************************************************************************
+ * ar5513NfCalLoaded
+ *
+ * The filtered noise floor has been loaded.  Now load a high
+ * maxCCAPower value again so that we're not capped by the median
+ * we just loaded.
+ */
+static void
+ar5513NfCalLoaded(WLAN_DEV_INFO *pDev)
+{
+    A_INT32 val, base[2] = {(PHY_BASE+(25<<2)), (CHN_1_BASE+(25<<2))};
+    int     j, firstChain, lastChain;
+
+    ar5513NfCalChainRange(pDev, &firstChain, &lastChain);
+    for (j = firstChain; j <= lastChain; j++) {
+        val = readPlatformReg(pDev, base[j]);
+        uiPrintf("CCA1 chn %d: 0x%lx\n", j, val);
+        val &= 0xFFFFFE00;
+        val |= (((A_INT32)(-50) & 0x1FF) << 1);
+        writePlatformReg(pDev, base[j], val);
+        uiPrintf("CCA2 chn %d: 0x%lx\n", j, readPlatformReg(pDev, base[j]));
+    }
+
+    pDev->pHalInfo->nfCalState = NF_CAL_IDLE;
+    if (pDev->pHalInfo->nfCalRestart) {
+        pDev->pHalInfo->nfCalRestart = FALSE;
+        ar5513NfCalStart(pDev);
+    }
+}
+
+/**************************************************************************
+ * ar5513NfCalStart - Start a noise floor measurement
+ */
+static void
+ar5513NfCalStart(WLAN_DEV_INFO *pDev)
+{
+    HAL_INFO *pInfo = pDev->pHalInfo;
+
+    if (pInfo->nfCalState == NF_CAL_LOADING) {
+        /* Started once the load completes */
+        pInfo->nfCalRestart = TRUE;
+        return;
+    }
+    if (pDev->staConfig.nfCalHistEnable) {
+        A_REG_SET_BIT(pDev, PHY_AGC_CONTROL, ENABLE_NF);
+        A_REG_SET_BIT(pDev, PHY_AGC_CONTROL, NO_UPDATE_NF);
+    }
+    A_REG_SET_BIT(pDev, PHY_AGC_CONTROL, NF);
+    pInfo->nfCalState = NF_CAL_RUNNING;
+}
+
+/**************************************************************************
+ * ar5513NfCalPoll
+ *
+ * Advances the noise floor calibration if the hardware has finished
+ * the current step.  Returns HAL_CAL_NF while it is still busy.
+ */
+static A_UINT32
+ar5513NfCalPoll(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval)
+{
+    HAL_INFO *pInfo = pDev->pHalInfo;
+
+    if (pInfo->nfCalState == NF_CAL_IDLE) {
+        return 0;
+    }
+    if (readPlatformReg(pDev, PHY_AGC_CONTROL) & PHY_AGC_CONTROL_NF) {
+        return HAL_CAL_NF;
+    }
+
+    if (pInfo->nfCalState == NF_CAL_RUNNING) {
+        /* TODO: temp debug */
+        logNfCal_Add(pDev, 0);
+        ar5513GetNf(pDev, pChval);
+    } else {
+        ar5513NfCalLoaded(pDev);
+    }
+    return (pInfo->nfCalState == NF_CAL_IDLE) ? 0 : HAL_CAL_NF;
 }
 
 /**************************************************************
@@ -2058,15 +2544,15 @@ static void
 ar5513SetRfRegs5112(WLAN_DEV_INFO *pDev, EEP_HEADER_INFO *pHeaderInfo,
                     CHAN_VALUES *pChval, A_UINT16 modesIndex, A_UINT16 *rfXpdGain)
 {
-    int                   arrayEntries, i, regWrites = 0;
+    int                   arrayEntries, i;
     A_UINT16              rfXpdSel, gainI;
     A_UINT16              ob5GHz = 0, db5GHz = 0;
     A_UINT16              ob2GHz = 0, db2GHz = 0;
     A_BOOL                arrayMode = 0;
     A_UINT32              modifier;
     AR5513_RF_BANKS_5112  *pRfBanks = pDev->pHalInfo->pAnalogBanks;
+    AR5513_RF_BANKS_5112  *pWritten = pDev->pHalInfo->pAnalogBanksWritten;
     GAIN_VALUES           *pGainValues = pDev->pHalInfo->pGainValues;
-    A_UINT32              writeBlockSize;
 
     ASSERT(pRfBanks);
 
@@ -2185,18 +2671,12 @@ ar5513SetRfRegs5112(WLAN_DEV_INFO *pDev, EEP_HEADER_INFO *pHeaderInfo,
         ar5513EarModify(pDev, EAR_LC_RF_WRITE, pChval, &modifier);
     }
 
-#ifdef BUILD_AP
-    writeBlockSize = MAX_WRITEBLOCKSIZE;
-#else
-    writeBlockSize = pDev->staConfig.writeBlockSize;
-#endif
-
-    /* Write Analog registers */
-    REG_WRITE_RF_ARRAY(ar5212Bank1, pRfBanks->Bank1Data, regWrites, writeBlockSize);
-    REG_WRITE_RF_ARRAY(ar5212Bank2, pRfBanks->Bank2Data, regWrites, writeBlockSize);
-    REG_WRITE_RF_ARRAY(ar5212Bank3, pRfBanks->Bank3Data, regWrites, writeBlockSize);
-    REG_WRITE_RF_ARRAY(ar5212Bank6, pRfBanks->Bank6Data, regWrites, writeBlockSize);
-    REG_WRITE_RF_ARRAY(ar5212Bank7, pRfBanks->Bank7Data, regWrites, writeBlockSize);
+    /* Write Analog registers - only those the radio does not already hold */
+    AR5513_WRITE_RF_BANK(pDev, 1, ar5212Bank1, pRfBanks, pWritten);
+    AR5513_WRITE_RF_BANK(pDev, 2, ar5212Bank2, pRfBanks, pWritten);
+    AR5513_WRITE_RF_BANK(pDev, 3, ar5212Bank3, pRfBanks, pWritten);
+    AR5513_WRITE_RF_BANK(pDev, 6, ar5212Bank6, pRfBanks, pWritten);
+    AR5513_WRITE_RF_BANK(pDev, 7, ar5212Bank7, pRfBanks, pWritten);
 
     /* Now that we have reprogrammed rfgain value, clear the flag. */
     pDev->pHalInfo->rfgainState = RFGAIN_INACTIVE;
@@ -2266,10 +2746,39 @@ ar5513GetRfField(A_UINT32 *rfBuf, A_UINT32 numBits, A_UINT32 firstBit, A_UINT32
     return reg32;
 }
 
+/**************************************************************
+ * ar5513RfBankChanged
+ *
+ * Returns TRUE if the radio may not hold the given bank contents,
+ * noting them as written; the caller then writes the bank.
+ */
+static A_BOOL
+ar5513RfBankChanged(WLAN_DEV_INFO *pDev, A_UINT16 bank, const A_UINT32 *pData,
+                    A_UINT32 *pWritten, A_UINT32 size)
+{
+    HAL_INFO *pInfo = pDev->pHalInfo;
+    A_UINT32 i, numWords = size / sizeof(A_UINT32);
+
+    if (pInfo->analogBanksValid & (1 << bank)) {
+        for (i = 0; i < numWords && pData[i] == pWritten[i]; i++) {
+            ;
+        }
+        if (i == numWords) {
+            pInfo->writeStats.rfBankSkips++;
+            return FALSE;
+        }
+    }
+    A_BCOPY(pData, pWritten, size);
+    pInfo->analogBanksValid |= 1 << bank;
+    pInfo->writeStats.rfBankWrites++;
+    return TRUE;
+}
+
 /**************************************************************
  * ar5513AllocateRfBanks
  *
- * Allocate memory for analog bank scratch buffers
+ * Allocate memory for analog bank scratch buffers, and for the
+ * copy of what was last written to the radio.
  * Scratch Buffer will be reinitialized every reset so no need to zero now
  */
 A_BOOL
@@ -2280,6 +2789,13 @@ ar5513AllocateRfBanks(WLAN_DEV_INFO *pDev, HAL_INFO *pHalInfo)
     if (pHalInfo->pAnalogBanks == NULL) {
         return FALSE;
     }
+    pHalInfo->pAnalogBanksWritten = A_DRIVER_MALLOC(sizeof(AR5513_RF_BANKS_5112));
+    if (pHalInfo->pAnalogBanksWritten == NULL) {
+        A_DRIVER_FREE(pHalInfo->pAnalogBanks, sizeof(AR5513_RF_BANKS_5112));
+        pHalInfo->pAnalogBanks = NULL;
+        return FALSE;
+    }
+    pHalInfo->analogBanksValid = 0;
     return TRUE;
 }
 
@@ -2295,6 +2811,105 @@ ar5513FreeRfBanks(WLAN_DEV_INFO *pDev, HAL_INFO *pHalInfo)
         A_DRIVER_FREE(pHalInfo->pAnalogBanks, sizeof(AR5513_RF_BANKS_5112));
         pHalInfo->pAnalogBanks = NULL;
     }
+    if (pHalInfo->pAnalogBanksWritten) {
+        A_DRIVER_FREE(pHalInfo->pAnalogBanksWritten, sizeof(AR5513_RF_BANKS_5112));
+        pHalInfo->pAnalogBanksWritten = NULL;
+    }
+    pHalInfo->analogBanksValid = 0;
+}
+
+/**************************************************************
+ * ar5513AllocateRateTargets
+ *
+ * Without these every limit change recomputes transmit power in
+ * full.
+ */
+A_BOOL
+ar5513AllocateRateTargets(WLAN_DEV_INFO *pDev, HAL_INFO *pHalInfo)
+{
+    ASSERT(pHalInfo->pRateTargets == NULL);
+    pHalInfo->pRateTargets = A_DRIVER_MALLOC(AR5513_TX_CHAINS * sizeof(AR5513_RATE_TARGETS));
+    if (pHalInfo->pRateTargets == NULL) {
+        return FALSE;
+    }
+    A_MEM_ZERO(pHalInfo->pRateTargets, AR5513_TX_CHAINS * sizeof(AR5513_RATE_TARGETS));
+    return TRUE;
+}
+
+/**************************************************************
+ * ar5513FreeRateTargets
+ */
+void
+ar5513FreeRateTargets(WLAN_DEV_INFO *pDev, HAL_INFO *pHalInfo)
+{
+    if (pHalInfo->pRateTargets) {
+        A_DRIVER_FREE(pHalInfo->pRateTargets, AR5513_TX_CHAINS * sizeof(AR5513_RATE_TARGETS));
+        pHalInfo->pRateTargets = NULL;
+    }
+}
+
+/**************************************************************
+ * ar5513AllocateIniWriteLists
+ *
+ * Compile the init tables into one write list per modesIndex,
+ * and a delta list for every pair of modes within a band for
+ * fast channel changes.  Needs the analog revision to pick the
+ * 5112 table set.
+ */
+A_STATUS
+ar5513AllocateIniWriteLists(WLAN_DEV_INFO *pDev, HAL_INFO *pHalInfo)
+{
+#define INI_FREQ_INDEX(_m)  (((_m) <= 2) ? 1 : 2)
+    A_UINT32 numSrc = IS_5112(pDev) ? sizeof(ar5513IniSources) / sizeof(ar5513IniSources[0]) :
+                                      AR5513_INI_SOURCES_BASE;
+    A_UINT16 modesIndex, from;
+    A_STATUS status;
+
+    /* modesIndex 1, 2 are 5 GHz (freqIndex 1), 3 - 5 are 2.4 GHz (freqIndex 2) */
+    for (modesIndex = 1; modesIndex < HAL_WL_NUM_MODES; modesIndex++) {
+        status = halWriteListCompile(&pHalInfo->pIniWriteList[modesIndex], ar5513IniSources,
+                                     numSrc, modesIndex, INI_FREQ_INDEX(modesIndex));
+        if (status != A_OK) {
+            ar5513FreeIniWriteLists(pDev, pHalInfo);
+            return status;
+        }
+    }
+
+    for (from = 1; from < HAL_WL_NUM_MODES; from++) {
+        for (modesIndex = 1; modesIndex < HAL_WL_NUM_MODES; modesIndex++) {
+            if (INI_FREQ_INDEX(from) != INI_FREQ_INDEX(modesIndex)) {
+                continue;
+            }
+            status = halWriteListDiff(&pHalInfo->pIniDeltaList[from][modesIndex],
+                                      pHalInfo->pIniWriteList[from],
+                                      pHalInfo->pIniWriteList[modesIndex],
+                                      ar5513IniVolatileRegs,
+                                      sizeof(ar5513IniVolatileRegs) / sizeof(ar5513IniVolatileRegs[0]));
+            if (status != A_OK) {
+                ar5513FreeIniWriteLists(pDev, pHalInfo);
+                return status;
+            }
+        }
+    }
+    pHalInfo->iniModesIndex = 0;
+    return A_OK;
+}
+
+/**************************************************************
+ * ar5513FreeIniWriteLists
+ */
+void
+ar5513FreeIniWriteLists(WLAN_DEV_INFO *pDev, HAL_INFO *pHalInfo)
+{
+    int i, j;
+
+    for (i = 0; i < HAL_WL_NUM_MODES; i++) {
+        halWriteListFree(&pHalInfo->pIniWriteList[i]);
+        for (j = 0; j < HAL_WL_NUM_MODES; j++) {
+            halWriteListFree(&pHalInfo->pIniDeltaList[i][j]);
+        }
+    }
+    pHalInfo->iniModesIndex = 0;
 }
 
 #define NO_FALSE_DETECT_BACKOFF   2
@@ -2519,95 +3134,184 @@ ar5513PrintPowerPerRate(A_UINT16 *pRatesPower)
     }
 }
 
+#ifdef HAL_TXPOWER_CACHE
 /**************************************************************
- * ar5513SetTransmitPower
+ * ar5513TxPowerKey
  *
- * Sets the transmit power in the baseband for the given
- * operating channel and mode.
+ * Everything the transmit power tables for a channel and chain
+ * are computed from, other than the EEPROM contents.
  */
-A_STATUS
-ar5513SetTransmitPower(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval,
-                       A_UINT16 *rfXpdGain, A_INT16 powerLimit, 
-                       A_BOOL calledDuringReset, A_UINT8 chnIdx)
+static void
+ar5513TxPowerKey(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval, A_INT16 powerLimit,
+                 A_INT16 tpcInDb, A_UINT8 chnIdx, HAL_TXPOWER_KEY *pKey)
+{
+    EEP_HEADER_INFO *pHeaderInfo = pDev->pHalInfo->pEepData->pEepHeader;
+    A_INT8          twiceAntennaGain;
+
+    twiceAntennaGain = IS_CHAN_5GHZ(pChval->channelFlags) ? pHeaderInfo->antennaGainMax[0] :
+                                                            pHeaderInfo->antennaGainMax[1];
+    A_MEM_ZERO(pKey, sizeof(*pKey));
+    pKey->channelFlags = pChval->channelFlags;
+    pKey->channel      = pChval->channel;
+    pKey->powerLimit   = powerLimit;
+    pKey->chnIdx       = chnIdx;
+    pKey->config[0]    = ((A_UINT32)tpcInDb & 0xff) | (pDev->staConfig.eirpLtdMode ? 0x100 : 0) |
+                         ((A_UINT32)pDev->staConfig.overRideTxPower << 16);
+    pKey->config[1]    = ((A_UINT32)wlanGetChannelPower(pDev, pChval) & 0xffff) |
+                         ((A_UINT32)wlanGetCtl(pDev, pChval) << 16);
+    pKey->config[2]    = (A_UINT8)wlanGetAntennaReduction(pDev, pChval, twiceAntennaGain);
+}
+#endif /* HAL_TXPOWER_CACHE */
+
+/**************************************************************
+ * ar5513TxPowerLimit
+ *
+ * Applies the configured TPC limits to *pPowerLimit and returns
+ * the TPC scale reduction in dB.
+ */
+static A_INT16
+ar5513TxPowerLimit(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval, A_INT16 *pPowerLimit)
 {
     static const A_UINT16 tpcScaleReductionTable[5] = {0, 3, 6, 9, MAX_RATE_POWER};
 
+    A_INT16 powerLimit = *pPowerLimit;
+
+    if (IS_CHAN_5GHZ(pChval->channelFlags)) {
+        powerLimit = A_MIN(pDev->staConfig.tpcHalfDbm5, powerLimit);
+    } else {
+        powerLimit = A_MIN(pDev->staConfig.tpcHalfDbm2, powerLimit);
+    }
+    powerLimit = A_MIN(MAX_RATE_POWER, powerLimit);
+    *pPowerLimit = powerLimit;
+
+    if ((powerLimit >= MAX_RATE_POWER) || (powerLimit == 0)) {
+        return tpcScaleReductionTable[pDev->staConfig.tpScale];
+    }
+    return 0;
+}
+
+/**************************************************************
+ * ar5513OffsetRatePowers
+ *
+ * Moves the per rate powers from ar5513SetRateTable onto the
+ * power table as programmed.
+ */
+static void
+ar5513OffsetRatePowers(WLAN_DEV_INFO *pDev, A_UINT16 *pRatesPower, A_UINT16 powerIndexOffset)
+{
+    int i;
+
+    /* Adjust XR power/rate up by 2 dB to account for greater peak to avg ratio */
+    pRatesPower[15] += 4;
+
+    if (IS_5112(pDev)) {
+        /* Move 5112 rates to match power tables where the max power table entry corresponds with maxPower */
+        for (i = 0; i < NUM_RATES; i++) {
+            pRatesPower[i] += powerIndexOffset;
+            if (pRatesPower[i] > 63) {
+                pRatesPower[i] = 63;
+            }
+        }
+    }
+}
+
+/**************************************************************
+ * ar5513PackRatePowers
+ *
+ * Packs the per rate powers into PHY_POWER_TX_RATE1 - 4
+ */
+static void
+ar5513PackRatePowers(const A_UINT16 *ratesArray, A_UINT32 *pRateRegs)
+{
+    const A_BOOL    paPreDEnable = 0;
+    const A_UINT16  mask = 0x3f;
+
+    /* The OFDM power per rate set */
+    pRateRegs[0] = (((paPreDEnable & 1)<< 30) | ((ratesArray[3] & mask) << 24) |
+                    ((paPreDEnable & 1)<< 22) | ((ratesArray[2] & mask) << 16) |
+                    ((paPreDEnable & 1)<< 14) | ((ratesArray[1] & mask) <<  8) |
+                    ((paPreDEnable & 1)<< 6 ) |  (ratesArray[0] & mask));
+
+    pRateRegs[1] = (((paPreDEnable & 1)<< 30) | ((ratesArray[7] & mask) << 24) |
+                    ((paPreDEnable & 1)<< 22) | ((ratesArray[6] & mask) << 16) |
+                    ((paPreDEnable & 1)<< 14) | ((ratesArray[5] & mask) <<  8) |
+                    ((paPreDEnable & 1)<< 6 ) |  (ratesArray[4] & mask));
+
+    /* The CCK power per rate set */
+    pRateRegs[2] = (((ratesArray[10] & mask) << 24) |
+                    ((ratesArray[9]  & mask) << 16) |
+                    ((ratesArray[15] & mask) <<  8) |   // XR target power
+                     (ratesArray[8]  & mask));
+
+    pRateRegs[3] = (((ratesArray[14] & mask) << 24) |
+                    ((ratesArray[13] & mask) << 16) |
+                    ((ratesArray[12] & mask) <<  8) |
+                     (ratesArray[11] & mask));
+}
+
+/**************************************************************
+ * ar5513WriteRatePowers
+ */
+static void
+ar5513WriteRatePowers(WLAN_DEV_INFO *pDev, A_UINT8 chnIdx, const A_UINT32 *pRateRegs)
+{
+    A_UINT16 chain_base = chnIdx ? CHN_1_BASE : CHN_0_BASE;
+
+    writePlatformReg(pDev, chain_base + (PHY_POWER_TX_RATE1 - CHN_0_BASE), pRateRegs[0]);
+    writePlatformReg(pDev, chain_base + (PHY_POWER_TX_RATE2 - CHN_0_BASE), pRateRegs[1]);
+    writePlatformReg(pDev, chain_base + (PHY_POWER_TX_RATE3 - CHN_0_BASE), pRateRegs[2]);
+    writePlatformReg(pDev, chain_base + (PHY_POWER_TX_RATE4 - CHN_0_BASE), pRateRegs[3]);
+}
+
+/**************************************************************
+ * ar5513ComputeTransmitPower
+ *
+ * Computes the PCDAC table and per rate powers for the channel
+ * and chain from the EEPROM calibration, as the register values
+ * ar5513WriteTransmitPower writes.
+ */
+static void
+ar5513ComputeTransmitPower(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval, A_INT16 powerLimit,
+                           A_INT16 tpcInDb, A_UINT8 chnIdx, AR5513_TXPOWER_REGS *pRegs)
+{
     A_UINT16        pcdacTable[PWR_TABLE_SIZE];
     A_UINT16        ratesArray[NUM_RATES];
-    A_UINT16        regOffset;
-    A_UINT32        reg32;
-    A_STATUS        status = A_OK;
-    struct eepMap   *pData;
+    struct eepMap   *pData = pDev->pHalInfo->pEepData;
     int             i;
-    const A_BOOL    paPreDEnable = 0;
-    const A_UINT16  mask = 0x3f;
     A_INT16         minPower, maxPower;
     A_UINT16        powerIndexOffset;
     A_INT16         cckOfdmPwrDelta = 0;
-    A_INT16         tpcInDb = 0;
-    A_BOOL          pcdacTableModified = FALSE;
     A_UINT16        chain_base = chnIdx ? CHN_1_BASE : CHN_0_BASE;
-    A_INT16         twiceBandEdgePower;
-    A_INT16         twiceBandEirp;
 
-    ASSERT(pDev->pHalInfo && pDev->pHalInfo->pEepData);
     A_MEM_ZERO(pcdacTable, sizeof(A_UINT16) * PWR_TABLE_SIZE);
     A_MEM_ZERO(ratesArray, sizeof(A_UINT16) * NUM_RATES);
-
-    pData = pDev->pHalInfo->pEepData;
-
-    /* WAR BUG #XXXXX
-     * Return if requested chain index not enabled/configured
-     */
-    if (pDev->staConfig.txChainCtrl == CHAIN_FIXED_A && chnIdx != CHAIN_0) {
-        return status;
-    }
-    /* end WAR */
-
-    /* Calculate transmit power control reductions or limits */
-    if (IS_CHAN_5GHZ(pChval->channelFlags)) {
-        powerLimit = A_MIN(pDev->staConfig.tpcHalfDbm5, powerLimit);
-    } else {
-        powerLimit = A_MIN(pDev->staConfig.tpcHalfDbm2, powerLimit);
-    }
-    powerLimit = A_MIN(MAX_RATE_POWER, powerLimit);
-    if ((powerLimit >= MAX_RATE_POWER) || (powerLimit == 0)) {
-        tpcInDb = tpcScaleReductionTable[pDev->staConfig.tpScale];
-    }
+    A_MEM_ZERO(pRegs, sizeof(*pRegs));
 
     ar5513SetRateTable(pDev, ratesArray, pData->chain[chnIdx].pTrgtPowerInfo, pChval,
-                       tpcInDb, powerLimit, pData, &minPower, &maxPower, &twiceBandEdgePower, chnIdx);
+                       tpcInDb, powerLimit, pData, &minPower, &maxPower, &pRegs->twiceBandEdgePower, chnIdx,
+                       &pRegs->targets);
 
     if (TxPowerDebugLevel >= TXPOWER_DEBUG_BASIC) {
         uiPrintf("*** Rates per Power (chain_base = 0x%04x) - exact dBm (pre power table adjustment) ***\n",chain_base);
         ar5513PrintPowerPerRate(ratesArray);
     }
 
-    pDev->pHalInfo->pRfHal->ar5513SetPowerTable(pDev, pcdacTable, &minPower, &maxPower, pChval, rfXpdGain, chnIdx);
-
-    /* Adjust XR power/rate up by 2 dB to account for greater peak to avg ratio */
-    ratesArray[15] += 4;
+    pDev->pHalInfo->pRfHal->ar5513SetPowerTable(pDev, pcdacTable, &minPower, &maxPower, pChval, pRegs->rfXpdGain, chnIdx);
 
     if (IS_5112(pDev)) {
-        /* Move 5112 rates to match power tables where the max power table entry corresponds with maxPower */
         ASSERT(maxPower <= PCDAC_STOP);
         powerIndexOffset = PCDAC_STOP - maxPower;
-        for (i = 0; i < NUM_RATES; i++) {
-            ratesArray[i] += powerIndexOffset;
-            if (ratesArray[i] > 63) {
-                ratesArray[i] = 63;
-            }
-        }
     } else {
         powerIndexOffset = 0;
     }
+    ar5513OffsetRatePowers(pDev, ratesArray, powerIndexOffset);
     pDev->pHalInfo->txPowerIndexOffset = powerIndexOffset;
 
     if (TxPowerDebugLevel >= TXPOWER_DEBUG_EXTREME) {
         uiPrintf("\nChain_base = 0x%04x\n",chain_base);
         uiPrintf("\nTX Power settings: curve(s) returned minPower %d (2x dBm), maxPower %d (2x dBm)\n\tPower Offset %d (2x dBm)\n",
             minPower, maxPower, powerIndexOffset);
-        uiPrintf("XpdGain's [0] 0x%x, [1] 0x%x\n", rfXpdGain[0], rfXpdGain[1]);
+        uiPrintf("XpdGain's [0] 0x%x, [1] 0x%x\n", pRegs->rfXpdGain[0], pRegs->rfXpdGain[1]);
     }
 
 
@@ -2620,27 +3324,19 @@ ar5513SetTransmitPower(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval,
         }
         ar5513CorrectGainDelta(pDev, ratesArray, pcdacTable, cckOfdmPwrDelta);
         /* Requires a rewrite of the pcdac table in all cases */
-        pcdacTableModified = TRUE;
+        pRegs->pcdacTableModified = TRUE;
     }
 
-    if (calledDuringReset || pcdacTableModified) {
-        /* Finally, write the power values into the baseband power table */
-        regOffset = chain_base + (608 << 2);
-        for (i = 0; i < 32; i++) {
-            if (TxPowerDebugLevel >= TXPOWER_DEBUG_VERBOSE) {
-                uiPrintf("dBm %2d -> pcdac %2d | dBm %2d.5 -> pcdac %2d\n",
-                    i, pcdacTable[2 * i], i, pcdacTable[2 * i + 1]);
-            }
-
-            /*
-            **  New AR5513 PCDAC Table entry format
-            */
-            reg32 = 0xffff & (pcdacTable[2 * i + 1]);
-            reg32 = (reg32 << 16) | (0xffff & (pcdacTable[2 * i]));
-
-            writePlatformReg(pDev, regOffset, reg32);
-            regOffset += 4;
+    for (i = 0; i < PWR_TABLE_SIZE / 2; i++) {
+        if (TxPowerDebugLevel >= TXPOWER_DEBUG_VERBOSE) {
+            uiPrintf("dBm %2d -> pcdac %2d | dBm %2d.5 -> pcdac %2d\n",
+                i, pcdacTable[2 * i], i, pcdacTable[2 * i + 1]);
         }
+
+        /*
+        **  New AR5513 PCDAC Table entry format
+        */
+        pRegs->pcdacRegs[i] = ((A_UINT32)pcdacTable[2 * i + 1] << 16) | pcdacTable[2 * i];
     }
 
     if (TxPowerDebugLevel >= TXPOWER_DEBUG_VERBOSE) {
@@ -2648,35 +3344,51 @@ ar5513SetTransmitPower(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval,
         ar5513PrintPowerPerRate(ratesArray);
     }
 
-    /* Write the OFDM power per rate set */
-    reg32 = (((paPreDEnable & 1)<< 30) | ((ratesArray[3] & mask) << 24) |
-             ((paPreDEnable & 1)<< 22) | ((ratesArray[2] & mask) << 16) |
-             ((paPreDEnable & 1)<< 14) | ((ratesArray[1] & mask) <<  8) |
-             ((paPreDEnable & 1)<< 6 ) |  (ratesArray[0] & mask));
-    writePlatformReg(pDev, chain_base + (PHY_POWER_TX_RATE1 - CHN_0_BASE), reg32);
-
-    reg32 = (((paPreDEnable & 1)<< 30) | ((ratesArray[7] & mask) << 24) |
-             ((paPreDEnable & 1)<< 22) | ((ratesArray[6] & mask) << 16) |
-             ((paPreDEnable & 1)<< 14) | ((ratesArray[5] & mask) <<  8) |
-             ((paPreDEnable & 1)<< 6 ) |  (ratesArray[4] & mask));
-    writePlatformReg(pDev, chain_base + (PHY_POWER_TX_RATE2 - CHN_0_BASE), reg32);
-
-    /* Write the CCK power per rate set */
-    reg32 = (((ratesArray[10] & mask) << 24) |
-             ((ratesArray[9]  & mask) << 16) |
-             ((ratesArray[15] & mask) <<  8) |   // XR target power
-              (ratesArray[8]  & mask));
-    writePlatformReg(pDev, chain_base + (PHY_POWER_TX_RATE3 - CHN_0_BASE), reg32);
-
-    reg32 = (((ratesArray[14] & mask) << 24) |
-             ((ratesArray[13] & mask) << 16) |
-             ((ratesArray[12] & mask) <<  8) |
-              (ratesArray[11] & mask));
-    writePlatformReg(pDev, chain_base + (PHY_POWER_TX_RATE4 - CHN_0_BASE), reg32);
+    ar5513PackRatePowers(ratesArray, pRegs->rateRegs);
+
+    /* A limit change can redo the rates alone unless the gain delta WAR ran */
+    pRegs->targets.valid            = !pRegs->pcdacTableModified;
+    pRegs->targets.channelFlags     = pChval->channelFlags;
+    pRegs->targets.channel          = pChval->channel;
+    pRegs->targets.powerIndexOffset = powerIndexOffset;
+
+    /* The software state the computation leaves behind */
+    pRegs->txPowerIndexOffset = powerIndexOffset;
+    pRegs->ofdmTxPower        = pDev->pHalInfo->ofdmTxPower;
+    pRegs->tx6PowerInHalfDbm  = pDev->tx6PowerInHalfDbm;
+    pRegs->maxTxPowerAvail    = pDev->maxTxPowerAvail;
+}
+
+/**************************************************************
+ * ar5513WriteTransmitPower
+ *
+ * Writes computed transmit power tables to the chain's baseband
+ * power registers.  The PCDAC table only needs writing on reset
+ * or when the gain delta WAR has changed it.
+ */
+static void
+ar5513WriteTransmitPower(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval, A_UINT8 chnIdx,
+                         const AR5513_TXPOWER_REGS *pRegs, A_BOOL calledDuringReset)
+{
+    A_UINT16        chain_base = chnIdx ? CHN_1_BASE : CHN_0_BASE;
+    A_UINT16        regOffset;
+    A_INT16         twiceBandEirp;
+    int             i;
+
+    if (calledDuringReset || pRegs->pcdacTableModified) {
+        /* Finally, write the power values into the baseband power table */
+        regOffset = chain_base + (608 << 2);
+        for (i = 0; i < PWR_TABLE_SIZE / 2; i++) {
+            writePlatformReg(pDev, regOffset, pRegs->pcdacRegs[i]);
+            regOffset += 4;
+        }
+    }
+
+    ar5513WriteRatePowers(pDev, chnIdx, pRegs->rateRegs);
 
     if (IS_CHAN_OFDM(pChval->channelFlags) && pDev->staConfig.eirpLtdMode) {
     
-        twiceBandEirp = twiceBandEdgePower + FALCON_TWICE_COHERENT_COMB_GAIN;
+        twiceBandEirp = pRegs->twiceBandEdgePower + FALCON_TWICE_COHERENT_COMB_GAIN;
         twiceBandEirp = A_MIN((wlanGetChannelPower(pDev, pChval) * 2), twiceBandEirp);
         /* Set the band eirp for eirp limted mode */
         A_REG_RMW_FIELD (pDev, PHY_TXBF_CTRL, BAND_EIRP, twiceBandEirp);
@@ -2689,98 +3401,188 @@ ar5513SetTransmitPower(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval,
 
     } 
     A_REG_WR(pDev, PHY_POWER_TX_RATE_MAX, MAX_RATE_POWER);
-    return status;
 }
 
 /**************************************************************
- * ar5513SetTxPowerLimit
- *
- * Sets a limit on the overall output power.  Used for dynamic
- * transmit power control and the like.
+ * ar5513SetTransmitPower
  *
- * NOTE: The power passed in is in units of 0.5 dBm.
+ * Sets the transmit power in the baseband for the given
+ * operating channel and mode.
  */
-void
-ar5513SetTxPowerLimit(WLAN_DEV_INFO *pDev, A_UINT32 limit)
+A_STATUS
+ar5513SetTransmitPower(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval,
+                       A_UINT16 *rfXpdGain, A_INT16 powerLimit, 
+                       A_BOOL calledDuringReset, A_UINT8 chnIdx)
 {
-    /* These are filled in by the function but unused here */
-    A_UINT16 dummyXpdGains[2];
+    AR5513_TXPOWER_REGS       regs;
+    const AR5513_TXPOWER_REGS *pRegs = NULL;
+    A_STATUS                  status = A_OK;
+    A_INT16                   tpcInDb = 0;
+    HEADER_WMODE              eepMode = 0;
+#ifdef HAL_TXPOWER_CACHE
+    HAL_TXPOWER_KEY           key;
+    AR5513_TXPOWER_REGS       *pNew;
+#endif
 
-    /* Make sure we don't exceed the maximum. */
-    limit = A_MIN(limit, MAX_RATE_POWER);
+    ASSERT(pDev->pHalInfo && pDev->pHalInfo->pEepData);
 
-    ar5513SetTransmitPower(pDev, pDev->staConfig.pChannel, dummyXpdGains, (A_INT16) limit, FALSE, CHAIN_0);
+    /* WAR BUG #XXXXX
+     * Return if requested chain index not enabled/configured
+     */
+    if (pDev->staConfig.txChainCtrl == CHAIN_FIXED_A && chnIdx != CHAIN_0) {
+        return status;
+    }
+    /* end WAR */
 
-    ar5513SetTransmitPower(pDev, pDev->staConfig.pChannel, dummyXpdGains, (A_INT16) limit, FALSE, CHAIN_1);
+    /* Calculate transmit power control reductions or limits */
+    tpcInDb = ar5513TxPowerLimit(pDev, pChval, &powerLimit);
+
+#ifdef HAL_TXPOWER_CACHE
+    /* Debug output comes from the computation - always redo it then */
+    if (TxPowerDebugLevel == TXPOWER_DEBUG_OFF) {
+        ar5513TxPowerKey(pDev, pChval, powerLimit, tpcInDb, chnIdx, &key);
+        pRegs = (const AR5513_TXPOWER_REGS *)halTxPowerCacheFind(pDev, &key);
+        if (pRegs) {
+            pDev->pHalInfo->txPowerIndexOffset = pRegs->txPowerIndexOffset;
+            if (IS_CHAN_OFDM(pChval->channelFlags)) {
+                pDev->pHalInfo->ofdmTxPower = pRegs->ofdmTxPower;
+            }
+            pDev->tx6PowerInHalfDbm = pRegs->tx6PowerInHalfDbm;
+            pDev->maxTxPowerAvail   = pRegs->maxTxPowerAvail;
+        }
+    }
+#endif
+
+    if (pRegs == NULL) {
+        switch (pChval->channelFlags & CHANNEL_ALL) {
+        case CHANNEL_A:
+        case CHANNEL_T:
+        case CHANNEL_XR_A:
+        case CHANNEL_XR_T:
+            eepMode = headerInfo11A;
+            break;
+        case CHANNEL_B:
+            eepMode = headerInfo11B;
+            break;
+        case CHANNEL_G:
+        case CHANNEL_108G:
+        case CHANNEL_XR_G:
+            eepMode = headerInfo11G;
+            break;
+        default:
+            ASSERT(0);
+            break;
+        }
+
+        /* The chain's calibration for this mode is parsed on first use */
+        status = ar5513ExpandEepromDataset(pDev, chnIdx, eepMode);
+        if (status != A_OK) {
+            return status;
+        }
+
+        ar5513ComputeTransmitPower(pDev, pChval, powerLimit, tpcInDb, chnIdx, &regs);
+        pRegs = &regs;
+#ifdef HAL_TXPOWER_CACHE
+        if (TxPowerDebugLevel == TXPOWER_DEBUG_OFF) {
+            pNew = (AR5513_TXPOWER_REGS *)halTxPowerCacheAdd(pDev, &key);
+            if (pNew) {
+                *pNew = regs;
+            }
+        }
+#endif
+    }
 
+    rfXpdGain[0] = pRegs->rfXpdGain[0];
+    rfXpdGain[1] = pRegs->rfXpdGain[1];
+
+    /* Kept for ar5513UpdateRatePowers */
+    if (pDev->pHalInfo->pRateTargets) {
+        ((AR5513_RATE_TARGETS *)pDev->pHalInfo->pRateTargets)[chnIdx] = pRegs->targets;
+    }
+
+    ar5513WriteTransmitPower(pDev, pChval, chnIdx, pRegs, calledDuringReset);
+    return status;
 }
 
-/*
- * LARGE TODO: update power calibration with upcoming changes and cleanup the
- * direct from DK code below to better merge with current similar functions
- * and stylize the Atheros SW way
+/**************************************************************
+ * ar5513UpdateRatePowers
+ *
+ * Re-derives the chain's per rate powers for a new power limit
+ * from the targets kept at the last reset and writes just the
+ * PHY_POWER_TX_RATE registers.  Returns FALSE, having written
+ * nothing, if there are no usable targets for the channel.
  */
-A_INT16
-GetInterpolatedValue_Signed16(A_UINT16 target, A_UINT16 srcLeft, A_UINT16 srcRight,
-                             A_INT16 targetLeft, A_INT16 targetRight)
+static A_BOOL
+ar5513UpdateRatePowers(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval, A_INT16 powerLimit,
+                       A_UINT8 chnIdx)
 {
-  A_INT16 returnValue;
-
-  if (srcRight != srcLeft) {
-        returnValue = (A_INT16)( ( (target - srcLeft)*targetRight + (srcRight - target)*targetLeft)/(srcRight - srcLeft));
-  }
-  else {
-        returnValue = targetLeft;
-  }
-  return (returnValue);
+    AR5513_RATE_TARGETS *pTargets;
+    A_UINT16            ratesArray[NUM_RATES];
+    A_UINT32            rateRegs[4];
+    A_INT16             tpcInDb, minPower, maxPower;
+
+    if (pDev->pHalInfo->pRateTargets == NULL) {
+        return FALSE;
+    }
+    pTargets = &((AR5513_RATE_TARGETS *)pDev->pHalInfo->pRateTargets)[chnIdx];
+    if (!pTargets->valid || pTargets->channel != pChval->channel ||
+        pTargets->channelFlags != pChval->channelFlags)
+    {
+        return FALSE;
+    }
+
+    /* Chain not enabled - see ar5513SetTransmitPower */
+    if (pDev->staConfig.txChainCtrl == CHAIN_FIXED_A && chnIdx != CHAIN_0) {
+        return TRUE;
+    }
+
+    tpcInDb = ar5513TxPowerLimit(pDev, pChval, &powerLimit);
+
+    A_MEM_ZERO(ratesArray, sizeof(A_UINT16) * NUM_RATES);
+    ar5513ClampRateTable(pDev, pTargets, tpcInDb, powerLimit, ratesArray, &minPower, &maxPower);
+    ar5513OffsetRatePowers(pDev, ratesArray, pTargets->powerIndexOffset);
+    ar5513PackRatePowers(ratesArray, rateRegs);
+
+    ar5513WriteRatePowers(pDev, chnIdx, rateRegs);
+    return TRUE;
 }
 
+/**************************************************************
+ * ar5513SetTxPowerLimit
+ *
+ * Sets a limit on the overall output power.  Used for dynamic
+ * transmit power control and the like.
+ *
+ * Only the rate power registers change with the limit; they
+ * are re-derived from the targets of the last reset when there
+ * are any.
+ *
+ * NOTE: The power passed in is in units of 0.5 dBm.
+ */
+void
+ar5513SetTxPowerLimit(WLAN_DEV_INFO *pDev, A_UINT32 limit)
+{
+    /* These are filled in by the function but unused here */
+    A_UINT16 dummyXpdGains[2];
+
+    /* Make sure we don't exceed the maximum. */
+    limit = A_MIN(limit, MAX_RATE_POWER);
 
-// returns indices surrounding the value in sorted integer lists. used for channel and pcdac lists
-void
-GetLowerUpperIndex (A_UINT16 value, A_UINT16 *pList, A_UINT16 listSize, A_UINT32 *pLowerValue,
-                    A_UINT32 *pUpperValue)
-{
-    A_UINT16    i;
-    A_UINT16    listEndValue = *(pList + listSize - 1);
-    A_UINT16    target = value ;
-
-    //see if value is lower than the first value in the list
-    //if so return first value
-    if (target <= (*pList)) {
-        *pLowerValue = 0;
-        *pUpperValue = 0;
-        return;
+    if (!ar5513UpdateRatePowers(pDev, pDev->staConfig.pChannel, (A_INT16) limit, CHAIN_0)) {
+        ar5513SetTransmitPower(pDev, pDev->staConfig.pChannel, dummyXpdGains, (A_INT16) limit, FALSE, CHAIN_0);
     }
 
-    //see if value is greater than last value in list
-    //if so return last value
-    if (target >= listEndValue) {
-        *pLowerValue = listSize - 1;
-        *pUpperValue = listSize - 1;
-        return;
+    if (!ar5513UpdateRatePowers(pDev, pDev->staConfig.pChannel, (A_INT16) limit, CHAIN_1)) {
+        ar5513SetTransmitPower(pDev, pDev->staConfig.pChannel, dummyXpdGains, (A_INT16) limit, FALSE, CHAIN_1);
     }
 
-    //look for value being near or between 2 values in list
-    for(i = 0; i < listSize; i++) {
-        //if value is close to the current value of the list
-        //then target is not between values, it is one of the values
-        if (pList[i] == target) {
-            *pLowerValue = i;
-            *pUpperValue = i;
-            return;
-        }
-
-        //look for value being between current value and next value
-        //if so return these 2 values
-        if (target < pList[i + 1]) {
-            *pLowerValue = i;
-            *pUpperValue = i + 1;
-            return;
-        }
-    }
 }
 
+/*
+ * LARGE TODO: update power calibration with upcoming changes and cleanup the
+ * direct from DK code below to better merge with current similar functions
+ * and stylize the Atheros SW way
+ */
 A_BOOL
 getFullPwrTable(A_UINT16 numPcdacs, A_UINT16 *pcdacs, A_INT16 *power, A_INT16 maxPower, A_INT16 *retVals)
 {
@@ -2798,7 +3600,7 @@ getFullPwrTable(A_UINT16 numPcdacs, A_UINT16 *pcdacs, A_INT16 *power, A_INT16 ma
             idxL++;
             idxR++;
         }
-        retVals[ii] = GetInterpolatedValue_Signed16(ii, pcdacs[idxL], pcdacs[idxR], power[idxL], power[idxR]);
+        retVals[ii] = halCalInterpolateSigned16(ii, pcdacs[idxL], pcdacs[idxR], power[idxL], power[idxR]);
         if (retVals[ii] >= maxPower) {
             while (ii<64) {
                 retVals[ii++] = maxPower;
@@ -3012,7 +3814,7 @@ ar5513SetPowerTable5112(WLAN_DEV_INFO *pDev, A_UINT16 *pPcdacTable, A_INT16 *pPo
         }
     }
 
-    GetLowerUpperIndex(pChval->channel, &(pPowerExpn->pChannels[0]), pPowerExpn->numChannels, &(chan_idx_L), &(chan_idx_R));
+    halCalGetLowerUpperIndex(pChval->channel, &(pPowerExpn->pChannels[0]), pPowerExpn->numChannels, &(chan_idx_L), &(chan_idx_R));
 
     kk = 0;
     for (ii=chan_idx_L; ii<=chan_idx_R; ii++) {
@@ -3060,9 +3862,7 @@ ar5513SetPowerTable5112(WLAN_DEV_INFO *pDev, A_UINT16 *pPcdacTable, A_INT16 *pPo
     kk = chan_idx_R - chan_idx_L;
 
     if (xgainList[1] == 0xDEAD) {
-        for (jj = 0; jj < 64; jj++) {
-            pwr_table0[jj] = GetInterpolatedValue_Signed16(pChval->channel, chan_L, chan_R, powTableLXPD[0][jj], powTableLXPD[kk][jj]);
-        }
+        halCalInterpolateVector(pChval->channel, chan_L, chan_R, powTableLXPD[0], powTableLXPD[kk], pwr_table0, 64);
         Pmin = getPminAndPcdacTableFromPowerTable(&(pwr_table0[0]), pPcdacTable);
         *pPowerMin = (A_INT16) (Pmin / 2);
         *pPowerMid = (A_INT16) (pwr_table0[63] / 2);
@@ -3070,10 +3870,8 @@ ar5513SetPowerTable5112(WLAN_DEV_INFO *pDev, A_UINT16 *pPcdacTable, A_INT16 *pPo
         rfXpdGain[0] = xgainList[0];
         rfXpdGain[1] = rfXpdGain[0];
     } else {
-        for (jj = 0; jj < 64; jj++) {
-            pwr_table0[jj] = GetInterpolatedValue_Signed16(pChval->channel, chan_L, chan_R, powTableLXPD[0][jj], powTableLXPD[kk][jj]);
-            pwr_table1[jj] = GetInterpolatedValue_Signed16(pChval->channel, chan_L, chan_R, powTableHXPD[0][jj], powTableHXPD[kk][jj]);
-        }
+        halCalInterpolateVector(pChval->channel, chan_L, chan_R, powTableLXPD[0], powTableLXPD[kk], pwr_table0, 64);
+        halCalInterpolateVector(pChval->channel, chan_L, chan_R, powTableHXPD[0], powTableHXPD[kk], pwr_table1, 64);
         if (numXpdGain == 2) {
             Pmin = getPminAndPcdacTableFromTwoPowerTables(&(pwr_table0[0]), &(pwr_table1[0]), pPcdacTable, &Pmid);
             *pPowerMin = (A_INT16) (Pmin / 2);
@@ -3110,13 +3908,16 @@ ar5513SetPowerTable5112(WLAN_DEV_INFO *pDev, A_UINT16 *pPcdacTable, A_INT16 *pPo
  * ar5513SetRateTable
  *
  * Sets the transmit power in the baseband for the given
- * operating channel and mode.
+ * operating channel and mode.  The limits that do not depend on
+ * the power limit or TPC reduction are returned in pTargets so
+ * that ar5513ClampRateTable can redo just the last step.
  */
 void
 ar5513SetRateTable(WLAN_DEV_INFO *pDev, A_UINT16 *pRatesPower,
                    TRGT_POWER_ALL_MODES *pTargetPowers, CHAN_VALUES *pChval,
                    A_INT16 tpcScaleReduction, A_INT16 powerLimit, struct eepMap *pData,
-                   A_INT16 *pMinPower, A_INT16 *pMaxPower, A_INT16 *pBandEdge, A_UINT8 chnIdx)
+                   A_INT16 *pMinPower, A_INT16 *pMaxPower, A_INT16 *pBandEdge, A_UINT8 chnIdx,
+                   AR5513_RATE_TARGETS *pTargets)
 {
     A_UINT16        twiceMaxEdgePower = MAX_RATE_POWER;
     A_UINT16        twiceMaxEdgePowerCck = MAX_RATE_POWER;
@@ -3126,13 +3927,11 @@ ar5513SetRateTable(WLAN_DEV_INFO *pDev, A_UINT16 *pRatesPower,
     A_INT8          twiceAntennaGain, twiceAntennaReduction = 0;
     A_UINT16        chanMode;
     RD_EDGES_POWER  *pRdEdgesPower = NULL, *pRdEdgesPowerCck = NULL;
-    TRGT_POWER_INFO targetPowerOfdm, targetPowerCck;
     A_INT16         scaledPower, maxAvailPower = 0;
 
+    A_MEM_ZERO(pTargets, sizeof(*pTargets));
     chanMode = pChval->channelFlags & CHANNEL_ALL;
     twiceMaxRDPower = wlanGetChannelPower(pDev, pChval) * 2;
-    *pMaxPower = -MAX_RATE_POWER;
-    *pMinPower = MAX_RATE_POWER;
 
     /* Get conformance test limit maximum for this channel */
     cfgCtl = wlanGetCtl(pDev, pChval);
@@ -3193,13 +3992,15 @@ ar5513SetRateTable(WLAN_DEV_INFO *pDev, A_UINT16 *pRatesPower,
     twiceAntennaReduction = wlanGetAntennaReduction(pDev, pChval, twiceAntennaGain);
 
     if (IS_CHAN_OFDM(chanMode)) {
+        pTargets->ofdm = TRUE;
+
         /* Get final OFDM target powers */
         if (IS_CHAN_2GHZ(chanMode)) {
             ar5513GetTargetPowers(pDev, pChval, pTargetPowers->trgtPwr_11g,
-                pTargetPowers->numTargetPwr_11g, &targetPowerOfdm);
+                pTargetPowers->numTargetPwr_11g, &pTargets->targetOfdm);
         } else {
             ar5513GetTargetPowers(pDev, pChval, pTargetPowers->trgtPwr_11a,
-                pTargetPowers->numTargetPwr_11a, &targetPowerOfdm);
+                pTargetPowers->numTargetPwr_11a, &pTargets->targetOfdm);
         }
 
         /* Get Maximum OFDM power */
@@ -3226,14 +4027,72 @@ ar5513SetRateTable(WLAN_DEV_INFO *pDev, A_UINT16 *pRatesPower,
             scaledPower = scaledPower + FALCON_TWICE_SINGLE_CHAIN_GAIN;
         }
 
-        maxAvailPower = A_MIN(scaledPower, targetPowerOfdm.twicePwr6_24);
+        maxAvailPower = A_MIN(scaledPower, pTargets->targetOfdm.twicePwr6_24);
+        pTargets->ofdmMaxPower = scaledPower;
+
+        if (pData->version >= EEPROM_VER4_0) {
+            /* Setup XR target power from EEPROM */
+            pTargets->xrTargetPower = IS_CHAN_2GHZ(chanMode) ?
+                pData->pEepHeader->xrTargetPower2 : pData->pEepHeader->xrTargetPower5;
+        } else {
+            /* XR uses 6mb power */
+            pTargets->xrTargetPower = MAX_RATE_POWER;
+        }
+
+        if (TxPowerDebugLevel >= TXPOWER_DEBUG_VERBOSE) {
+            uiPrintf("OFDM 2X Maxes: MaxRD: %d TurboMax: %d MaxCTL: %d TPC_Reduction %d\n",
+                twiceMaxRDPower, pData->pEepHeader->turbo2WMaxPower5, twiceMaxEdgePower,
+                (tpcScaleReduction * 2));
+        }
+
+    }
+
+    /* xxx: 'G' should set the CCK Flag! */
+    if (IS_CHAN_CCK(chanMode) || IS_CHAN_G(chanMode)) {
+        pTargets->cck = TRUE;
+
+        /* Get final CCK target powers */
+        ar5513GetTargetPowers(pDev, pChval, pTargetPowers->trgtPwr_11b,
+            pTargetPowers->numTargetPwr_11b, &pTargets->targetCck);
+
+        /* Reduce power by max regulatory domain allowed restrictions */
+        scaledPower = A_MIN(twiceMaxEdgePowerCck, twiceMaxRDPower - twiceAntennaReduction);
+
+        if (maxAvailPower < A_MIN(scaledPower, pTargets->targetCck.twicePwr6_24)) {
+            maxAvailPower = A_MIN(scaledPower, pTargets->targetCck.twicePwr6_24);
+        }
+        pTargets->cckMaxPower = scaledPower;
+    }
+
+    pDev->maxTxPowerAvail = maxAvailPower;
+
+    ar5513ClampRateTable(pDev, pTargets, tpcScaleReduction, powerLimit, pRatesPower,
+                         pMinPower, pMaxPower);
+}
+
+/**************************************************************
+ * ar5513ClampRateTable
+ *
+ * Applies the TPC reduction and power limit to the rate targets
+ * from ar5513SetRateTable, giving the power per rate.
+ */
+void
+ar5513ClampRateTable(WLAN_DEV_INFO *pDev, const AR5513_RATE_TARGETS *pTargets,
+                     A_INT16 tpcScaleReduction, A_INT16 powerLimit, A_UINT16 *pRatesPower,
+                     A_INT16 *pMinPower, A_INT16 *pMaxPower)
+{
+    A_INT16 scaledPower;
+
+    *pMaxPower = -MAX_RATE_POWER;
+    *pMinPower = MAX_RATE_POWER;
 
+    if (pTargets->ofdm) {
         /* Reduce Power by user selection */
-        scaledPower -= (tpcScaleReduction * 2);
+        scaledPower = pTargets->ofdmMaxPower - (tpcScaleReduction * 2);
         scaledPower = (scaledPower < 0)? 0: scaledPower;
         scaledPower = A_MIN(scaledPower, powerLimit);
         
-        scaledPower = A_MIN(scaledPower, targetPowerOfdm.twicePwr6_24);
+        scaledPower = A_MIN(scaledPower, pTargets->targetOfdm.twicePwr6_24);
 
         /* Override XR, 6-24 Tx Power to any level - 36-54 still cannot exceed target power levels */
         if (pDev->staConfig.overRideTxPower) {
@@ -3244,18 +4103,10 @@ ar5513SetRateTable(WLAN_DEV_INFO *pDev, A_UINT16 *pRatesPower,
         pRatesPower[0] = pRatesPower[1] = pRatesPower[2] = pRatesPower[3] = pRatesPower[4] = scaledPower;
 
         /* Set OFDM rates 36, 48, 54, XR */
-        pRatesPower[5] = A_MIN(scaledPower, targetPowerOfdm.twicePwr36);
-        pRatesPower[6] = A_MIN(scaledPower, targetPowerOfdm.twicePwr48);
-        pRatesPower[7] = A_MIN(scaledPower, targetPowerOfdm.twicePwr54);
-
-        if (pData->version >= EEPROM_VER4_0) {
-            /* Setup XR target power from EEPROM */
-            pRatesPower[15] = A_MIN(scaledPower, (IS_CHAN_2GHZ(chanMode) ?
-                pData->pEepHeader->xrTargetPower2 : pData->pEepHeader->xrTargetPower5));
-        } else {
-            /* XR uses 6mb power */
-            pRatesPower[15] = pRatesPower[0];
-        }
+        pRatesPower[5] = A_MIN(scaledPower, pTargets->targetOfdm.twicePwr36);
+        pRatesPower[6] = A_MIN(scaledPower, pTargets->targetOfdm.twicePwr48);
+        pRatesPower[7] = A_MIN(scaledPower, pTargets->targetOfdm.twicePwr54);
+        pRatesPower[15] = A_MIN(scaledPower, pTargets->xrTargetPower);
 
         *pMinPower = pRatesPower[7];
         *pMaxPower = pRatesPower[0];
@@ -3264,38 +4115,23 @@ ar5513SetRateTable(WLAN_DEV_INFO *pDev, A_UINT16 *pRatesPower,
         pDev->pHalInfo->ofdmTxPower = *pMaxPower;
 
         if (TxPowerDebugLevel >= TXPOWER_DEBUG_VERBOSE) {
-            uiPrintf("OFDM 2X Maxes: MaxRD: %d TurboMax: %d MaxCTL: %d TPC_Reduction %d Final Scaled Power %d\n",
-                twiceMaxRDPower, pData->pEepHeader->turbo2WMaxPower5, twiceMaxEdgePower,
-                (tpcScaleReduction * 2), scaledPower);
+            uiPrintf("OFDM Final Scaled Power %d\n", scaledPower);
         }
-
     }
 
-    /* xxx: 'G' should set the CCK Flag! */
-    if (IS_CHAN_CCK(chanMode) || IS_CHAN_G(chanMode)) {
-        /* Get final CCK target powers */
-        ar5513GetTargetPowers(pDev, pChval, pTargetPowers->trgtPwr_11b,
-            pTargetPowers->numTargetPwr_11b, &targetPowerCck);
-
-        /* Reduce power by max regulatory domain allowed restrictions */
-        scaledPower = A_MIN(twiceMaxEdgePowerCck, twiceMaxRDPower - twiceAntennaReduction);
-
-        if (maxAvailPower < A_MIN(scaledPower, targetPowerCck.twicePwr6_24)) {
-            maxAvailPower = A_MIN(scaledPower, targetPowerCck.twicePwr6_24);
-        }
-
+    if (pTargets->cck) {
         /* Reduce Power by user selection */
-        scaledPower -= (tpcScaleReduction * 2);
+        scaledPower = pTargets->cckMaxPower - (tpcScaleReduction * 2);
         scaledPower = (scaledPower < 0)? 0: scaledPower;
         scaledPower = A_MIN(scaledPower, powerLimit);
 
         /* Set CCK rates 2L, 2S, 5.5L, 5.5S, 11L, 11S */
-        pRatesPower[8]  = A_MIN(scaledPower, targetPowerCck.twicePwr6_24);
-        pRatesPower[9]  = A_MIN(scaledPower, targetPowerCck.twicePwr36);
+        pRatesPower[8]  = A_MIN(scaledPower, pTargets->targetCck.twicePwr6_24);
+        pRatesPower[9]  = A_MIN(scaledPower, pTargets->targetCck.twicePwr36);
         pRatesPower[10] = pRatesPower[9];
-        pRatesPower[11] = A_MIN(scaledPower, targetPowerCck.twicePwr48);
+        pRatesPower[11] = A_MIN(scaledPower, pTargets->targetCck.twicePwr48);
         pRatesPower[12] = pRatesPower[11];
-        pRatesPower[13] = A_MIN(scaledPower, targetPowerCck.twicePwr54);
+        pRatesPower[13] = A_MIN(scaledPower, pTargets->targetCck.twicePwr54);
         pRatesPower[14] = pRatesPower[13];
 
         if (pDev->staConfig.overRideTxPower) {
@@ -3314,8 +4150,6 @@ ar5513SetRateTable(WLAN_DEV_INFO *pDev, A_UINT16 *pRatesPower,
 
     /* Report the current power as the max set power */
     pDev->tx6PowerInHalfDbm = *pMaxPower;
-
-    pDev->maxTxPowerAvail = maxAvailPower;
 }
 
 /***************************************************************************
@@ -3426,7 +4260,7 @@ ar5513GetMaxEdgePower(A_UINT16 channel, RD_EDGES_POWER *pRdEdgesPower)
     }
     numEdges = i;
 
-    ar5513GetLowerUpperValues(channel, tempChannelList, numEdges, &lowerChannel, &upperChannel);
+    halCalGetLowerUpperValues(channel, tempChannelList, numEdges, &lowerChannel, &upperChannel);
     /* Get the index for the lower channel */
     for (i = 0; i < numEdges; i++) {
         if (lowerChannel == tempChannelList[i]) {
@@ -3469,7 +4303,7 @@ ar5513GetTargetPowers(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval, TRGT_POWER_INFO
         tempChannelList[i] = pPowerInfo[i].testChannel;
     }
 
-    ar5513GetLowerUpperValues(pChval->channel, tempChannelList, numChannels, &lowerChannel, &upperChannel);
+    halCalGetLowerUpperValues(pChval->channel, tempChannelList, numChannels, &lowerChannel, &upperChannel);
 
     /* Get the index for the channel */
     for (i = 0; i < numChannels; i++) {
@@ -3485,134 +4319,22 @@ ar5513GetTargetPowers(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval, TRGT_POWER_INFO
     /* Get the lower and upper channels target powers and interpolate between them */
     lowerPower = pPowerInfo[lowerIndex].twicePwr6_24;
     upperPower = pPowerInfo[upperIndex].twicePwr6_24;
-    pNewPower->twicePwr6_24 = ar5513GetInterpolatedValue(pChval->channel, lowerChannel,
+    pNewPower->twicePwr6_24 = halCalInterpolate(pChval->channel, lowerChannel,
         upperChannel, lowerPower, upperPower, 0);
     lowerPower = pPowerInfo[lowerIndex].twicePwr36;
     upperPower = pPowerInfo[upperIndex].twicePwr36;
-    pNewPower->twicePwr36 = ar5513GetInterpolatedValue(pChval->channel, lowerChannel,
+    pNewPower->twicePwr36 = halCalInterpolate(pChval->channel, lowerChannel,
         upperChannel, lowerPower, upperPower, 0);
     lowerPower = pPowerInfo[lowerIndex].twicePwr48;
     upperPower = pPowerInfo[upperIndex].twicePwr48;
-    pNewPower->twicePwr48 = ar5513GetInterpolatedValue(pChval->channel, lowerChannel,
+    pNewPower->twicePwr48 = halCalInterpolate(pChval->channel, lowerChannel,
         upperChannel, lowerPower, upperPower, 0);
     lowerPower = pPowerInfo[lowerIndex].twicePwr54;
     upperPower = pPowerInfo[upperIndex].twicePwr54;
-    pNewPower->twicePwr54 = ar5513GetInterpolatedValue(pChval->channel, lowerChannel,
+    pNewPower->twicePwr54 = halCalInterpolate(pChval->channel, lowerChannel,
         upperChannel, lowerPower, upperPower, 0);
 }
 
-/**************************************************************
- * ar5513GetInterpolatedValue
- *
- * Returns interpolated or the scaled up interpolated value
- */
-A_UINT16
-ar5513GetInterpolatedValue(A_UINT16 target, A_UINT16 srcLeft, A_UINT16 srcRight,
-                           A_UINT16 targetLeft, A_UINT16 targetRight, A_BOOL scaleUp)
-{
-    A_UINT16 returnValue;
-    A_INT16 lRatio;
-    A_UINT16 scaleValue = EEP_SCALE;
-
-    /*
-     * To get an accurate ratio, always scale, If we want to scale, then
-     * don't scale back down.
-     */
-    if ((targetLeft * targetRight) == 0) {
-        return 0;
-    }
-
-    if (scaleUp) {
-        scaleValue = 1;
-    }
-
-    if (srcRight != srcLeft) {
-        /* note the ratio always need to be scaled, since it will be a fraction */
-        lRatio = ((target - srcLeft) * EEP_SCALE / (srcRight - srcLeft));
-        if (lRatio < 0) {
-            /* Return as Left target if value would be negative */
-            returnValue = targetLeft * (scaleUp ? EEP_SCALE : 1);
-        } else if (lRatio > EEP_SCALE) {
-            /* Return as Right target if Ratio is greater than 100% (SCALE) */
-            returnValue = targetRight * (scaleUp ? EEP_SCALE : 1);
-        } else {
-            returnValue = ((lRatio * targetRight + (EEP_SCALE - lRatio) *
-                           targetLeft) / scaleValue);
-        }
-    } else {
-        returnValue = targetLeft * (scaleUp ? EEP_SCALE : 1);
-    }
-
-    return returnValue;
-}
-
-/**************************************************************
- * ar5513GetLowerUpperValues
- *
- *  Look for value being within 0.1 of the search values
- *  however, NDIS can't do float calculations, so multiply everything
- *  up by EEP_SCALE so can do integer arithmatic
- *
- * INPUT  value       -value to search for
- * INPUT  pList       -ptr to the list to search
- * INPUT  listSize    -number of entries in list
- * OUTPUT pLowerValue -return the lower value
- * OUTPUT pUpperValue -return the upper value
- *
- * WARNING: This input list should be filled and in ascending order
- */
-void
-ar5513GetLowerUpperValues(A_UINT16 value, A_UINT16 *pList, A_UINT16 listSize,
-                          A_UINT16 *pLowerValue, A_UINT16 *pUpperValue)
-{
-    A_UINT16    i;
-    A_UINT16    listEndValue = *(pList + listSize - 1);
-    A_UINT32    target       = value * EEP_SCALE;
-
-    /*
-     * See if value is lower than the first value in the list
-     * if so return first value
-     */
-    if (target < (A_UINT32)(*pList * EEP_SCALE - EEP_DELTA)) {
-        *pLowerValue = *pList;
-        *pUpperValue = *pList;
-        return;
-    }
-
-    /*
-     * See if value is greater than last value in list
-     * if so return last value
-     */
-    if (target > (A_UINT32)(listEndValue * EEP_SCALE + EEP_DELTA)) {
-        *pLowerValue = listEndValue;
-        *pUpperValue = listEndValue;
-        return;
-    }
-
-    /* look for value being near or between 2 values in list */
-    for (i = 0; i < listSize; i++) {
-        /*
-         * If value is close to the current value of the list
-         * then target is not between values, it is one of the values
-         */
-        if (A_ABS(pList[i] * EEP_SCALE - (A_INT32)target) < EEP_DELTA) {
-            *pLowerValue = pList[i];
-            *pUpperValue = pList[i];
-            return;
-        }
-
-        /*
-         * Look for value being between current value and next value
-         * if so return these 2 values
-         */
-        if (target < (A_UINT32)(pList[i + 1] * EEP_SCALE - EEP_DELTA)) {
-            *pLowerValue = pList[i];
-            *pUpperValue = pList[i + 1];
-            return;
-        }
-    }
-}
-
 /************** Transmit Gain Optimization Routines ******************/
 const static GAIN_OPTIMIZATION_LADDER GainLadder = {
     9, //numStepsInLadder
@@ -4012,31 +4734,16 @@ ar5513SetRateDurationTable(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval)
 static A_BOOL
 ar5513IsEarEngaged(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval)
 {
-    EAR_HEADER   *pEarHead;
-    int          i;
-
-    pEarHead = pDev->pHalInfo->pEarHead;
+    EAR_PROGRAM *pProg = pDev->pHalInfo->pEarProg;
 
-    /* Check for EAR */
-    if (!pEarHead) {
-        return FALSE;
-    }
-
-    /* Check for EAR found some reg headers */
-    if (pEarHead->numRHs == 0) {
+    /* Check for EAR with some reg headers */
+    if (!pProg) {
         return FALSE;
     }
 
     /* Check register headers for match on channel and mode */
-    for (i = 0; i < pEarHead->numRHs; i++) {
-        if (pEarHead->pRH[i].modes & ar5513CFlagsToEarMode(pChval->channelFlags) &&
-            ar5513IsChannelInEarRegHead(pEarHead->pRH[i].channel, pChval->channel))
-        {
-            return TRUE;
-        }
-    }
-
-    return FALSE;
+    return (ar5513EarLookup(pProg, pChval->channel)->modes &
+            ar5513CFlagsToEarMode(pChval->channelFlags)) ? TRUE : FALSE;
 }
 
 /**************************************************************
@@ -4048,134 +4755,51 @@ ar5513IsEarEngaged(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval)
 static A_BOOL
 ar5513EarModify(WLAN_DEV_INFO *pDev, EAR_LOC_CHECK loc, CHAN_VALUES *pChval, A_UINT32 *modifier)
 {
-    EAR_HEADER   *pEarHead;
-    int          i;
+    EAR_PROGRAM        *pProg;
+    EAR_PROG_ENTRY     *pEnt;
+    const EAR_CHAN_SEG *pSeg;
+    A_UINT16           earMode;
+    A_UINT32           i;
 
-    pEarHead = pDev->pHalInfo->pEarHead;
-    ASSERT(pEarHead);
+    pProg = pDev->pHalInfo->pEarProg;
+    ASSERT(pProg);
     /* Should only be called if EAR is engaged */
     ASSERT(ar5513IsEarEngaged(pDev, pChval));
 
-    /* Check to see if there are any EAR modifications for the given code location */
-    for (i = 0; i < pEarHead->numRHs; i++) {
-        /* Check register headers for match on channel and mode */
-        if (pEarHead->pRH[i].modes & ar5513CFlagsToEarMode(pChval->channelFlags) &&
-            ar5513IsChannelInEarRegHead(pEarHead->pRH[i].channel, pChval->channel))
-        {
-            switch (loc) {
-                /* Stage: 0 */
-            case EAR_LC_RF_WRITE:
-                if (pEarHead->pRH[i].stage == EAR_STAGE_ANALOG_WRITE) {
-                    if (EarDebugLevel >= EAR_DEBUG_VERBOSE) {
-                        uiPrintf("ar5513EarModify: Performing stage 0 ops on RH %d\n", i);
-                    }
-                    ar5513EarDoRH(pDev, &(pEarHead->pRH[i]));
-                }
-                break;
-                /* Stage: 1 */
-            case EAR_LC_PHY_ENABLE:
-                if (pEarHead->pRH[i].stage == EAR_STAGE_PRE_PHY_ENABLE) {
-                    if (EarDebugLevel >= EAR_DEBUG_VERBOSE) {
-                        uiPrintf("ar5513EarModify: Performing stage 1 ops on RH %d\n", i);
-                    }
-                    ar5513EarDoRH(pDev, &(pEarHead->pRH[i]));
-                }
-                break;
-                /* Stage: 2 */
-            case EAR_LC_POST_RESET:
-                if (pEarHead->pRH[i].stage == EAR_STAGE_POST_RESET) {
-                    if (EarDebugLevel >= EAR_DEBUG_VERBOSE) {
-                        uiPrintf("ar5513EarModify: Performing stage 2 ops on RH %d\n", i);
-                    }
-                    ar5513EarDoRH(pDev, &(pEarHead->pRH[i]));
-                }
-                break;
-                /* Stage: 3 */
-            case EAR_LC_POST_PER_CAL:
-                if (pEarHead->pRH[i].stage == EAR_STAGE_POST_PER_CAL) {
-                    if (EarDebugLevel >= EAR_DEBUG_VERBOSE) {
-                        uiPrintf("ar5513EarModify: Performing stage 3 ops on RH %d\n", i);
-                    }
-                    ar5513EarDoRH(pDev, &(pEarHead->pRH[i]));
-                }
-                break;
-                /* Stage: Any */
-            case EAR_LC_PLL:
-                if (IS_PLL_SET(pEarHead->pRH[i].disabler.disableField)) {
-                    *modifier = pEarHead->pRH[i].disabler.pllValue;
-                    if (EarDebugLevel >= EAR_DEBUG_VERBOSE) {
-                        uiPrintf("ar5513EarModify: Modifying PLL value!!! to %d\n", *modifier);
-                    }
-                    return TRUE;
-                }
-                break;
-                /* Stage: Any */
-            case EAR_LC_RESET_OFFSET:
-                if ((pEarHead->pRH[i].disabler.valid) &&
-                    !((pEarHead->pRH[i].disabler.disableField >> 8) & 0x1))
-                {
-                    if (EarDebugLevel >= EAR_DEBUG_VERBOSE) {
-                        uiPrintf("ar5513EarModify: Disabling reset code Offset cal\n");
-                    }
-                    return TRUE;
-                }
-                break;
-                /* Stage: Any */
-            case EAR_LC_RESET_NF:
-                if ((pEarHead->pRH[i].disabler.valid) &&
-                    !((pEarHead->pRH[i].disabler.disableField >> 9) & 0x1))
-                {
-                    if (EarDebugLevel >= EAR_DEBUG_VERBOSE) {
-                        uiPrintf("ar5513EarModify: Disabling reset code Noise Floor cal\n");
-                    }
-                    return TRUE;
-                }
-                break;
-                /* Stage: Any */
-            case EAR_LC_RESET_IQ:
-                if ((pEarHead->pRH[i].disabler.valid) &&
-                    !((pEarHead->pRH[i].disabler.disableField >> 10) & 0x1))
-                {
-                    if (EarDebugLevel >= EAR_DEBUG_VERBOSE) {
-                        uiPrintf("ar5513EarModify: Disabling reset code IQ cal\n");
-                    }
-                    return TRUE;
-                }
-                break;
-                /* Stage: Any */
-            case EAR_LC_PER_FIXED_GAIN:
-                if ((pEarHead->pRH[i].disabler.valid) &&
-                    !((pEarHead->pRH[i].disabler.disableField >> 11) & 0x1))
-                {
-                    if (EarDebugLevel >= EAR_DEBUG_VERBOSE) {
-                        uiPrintf("ar5513EarModify: Disabling periodic fixed gain calibration\n");
-                    }
-                    return TRUE;
-                }
-                break;
-                /* Stage: Any */
-            case EAR_LC_PER_NF:
-                if ((pEarHead->pRH[i].disabler.valid) &&
-                    !((pEarHead->pRH[i].disabler.disableField >> 12) & 0x1))
-                {
-                    if (EarDebugLevel >= EAR_DEBUG_VERBOSE) {
-                        uiPrintf("ar5513EarModify: Disabling periodic noise floor cal\n");
-                    }
-                    return TRUE;
-                }
-                break;
-                /* Stage: Any */
-            case EAR_LC_PER_GAIN_CIRC:
-                if ((pEarHead->pRH[i].disabler.valid) &&
-                    !((pEarHead->pRH[i].disabler.disableField >> 13) & 0x1))
-                {
-                    if (EarDebugLevel >= EAR_DEBUG_VERBOSE) {
-                        uiPrintf("ar5513EarModify: Disabling gain circulation\n");
-                    }
-                    return TRUE;
-                }
-                break;
+    earMode = ar5513CFlagsToEarMode(pChval->channelFlags);
+
+    /* Only the register headers for this channel that act at this location are listed */
+    pSeg = ar5513EarLookup(pProg, pChval->channel);
+    for (i = pSeg->first[loc]; i < pSeg->first[loc + 1]; i++) {
+        pEnt = &pProg->pEntries[pProg->pSegEntries[i]];
+        /* Check register headers for match on mode */
+        if (!(pEnt->modes & earMode)) {
+            continue;
+        }
+        switch (loc) {
+            /* Stages: 0 through 3 */
+        case EAR_LC_RF_WRITE:
+        case EAR_LC_PHY_ENABLE:
+        case EAR_LC_POST_RESET:
+        case EAR_LC_POST_PER_CAL:
+            if (EarDebugLevel >= EAR_DEBUG_VERBOSE) {
+                uiPrintf("ar5513EarModify: Performing stage %d ops, %d writes\n", loc, pEnt->numOps);
+            }
+            ar5513EarRunOps(pDev, &pProg->pOps[pEnt->firstOp], pEnt->numOps);
+            break;
+            /* Stage: Any */
+        case EAR_LC_PLL:
+            *modifier = pEnt->pllValue;
+            if (EarDebugLevel >= EAR_DEBUG_VERBOSE) {
+                uiPrintf("ar5513EarModify: Modifying PLL value!!! to %d\n", *modifier);
+            }
+            return TRUE;
+            /* Stage: Any - the disablers */
+        default:
+            if (EarDebugLevel >= EAR_DEBUG_VERBOSE) {
+                uiPrintf("ar5513EarModify: Disabling calibration at location %d\n", loc);
             }
+            return TRUE;
         }
     }
     /* TODO: Track modified analog registers outside of stage 0 and write them with protection */
@@ -4187,159 +4811,88 @@ ar5513EarModify(WLAN_DEV_INFO *pDev, EAR_LOC_CHECK loc, CHAN_VALUES *pChval, A_U
 /******************** EAR Support Routines ********************/
 
 /**************************************************************
- * ar5513EarDoRH
+ * ar5513EarLookup
  *
- * The given register header needs to be executed by performing
- * a register write, modify, or analog bank modify
- *
- * If an ananlog bank is modified - return the bank number as a
- * bit mask.  (bit 0 is bank 0)
+ * The channel segment of the compiled EAR holding channel
  */
-static A_UINT16
-ar5513EarDoRH(WLAN_DEV_INFO *pDev, REGISTER_HEADER *pRH)
+static const EAR_CHAN_SEG *
+ar5513EarLookup(const EAR_PROGRAM *pProg, A_UINT16 channel)
 {
-    A_UINT16 tag, regLoc = 0, num, opCode;
-    A_UINT16 bitsThisWrite, numBits, startBit, bank, column, last, i;
-    A_UINT32 address, reg32, mask, regInit;
-    A_UINT32 *rfBuf;
-    A_UINT16 rfBankMask = 0;
-
-    switch (pRH->type) {
-    case EAR_TYPE0:
-        do {
-            address = pRH->regs[regLoc] & ~T0_TAG_M;
-            tag = pRH->regs[regLoc] & T0_TAG_M;
-            regLoc++;
-            if ((tag == T0_TAG_32BIT) || (tag == T0_TAG_32BIT_LAST)) {
-                /* Full word writes */
-                reg32 = pRH->regs[regLoc++] << 16;
-                reg32 |= pRH->regs[regLoc++];
-                if (EarDebugLevel >= EAR_DEBUG_VERBOSE) {
-                    uiPrintf("ar5513EarDoRH: Type 0 EAR 32-bit write to 0x%04X : 0x%08x\n", address, reg32);
-                }
-                A_REG_WR(pDev, address, reg32);
-            } else if (tag == T0_TAG_16BIT_LOW) {
-                /* Half word read/modify/write low data */
-                if (EarDebugLevel >= EAR_DEBUG_VERBOSE) {
-                    uiPrintf("ar5513EarDoRH: Type 0 EAR 16-bit low write to 0x%04X : 0x%04x\n",
-                             address, pRH->regs[regLoc]);
-                }
-                A_REG_RMW(pDev, address, pRH->regs[regLoc++], 0xFFFF);
-            } else {
-                /* Half word read/modify/write high data */
-                if (EarDebugLevel >= EAR_DEBUG_VERBOSE) {
-                    uiPrintf("ar5513EarDoRH: Type 0 EAR 16-bit high write to 0x%04X : 0x%04x\n",
-                             address, pRH->regs[regLoc]);
-                }
-                A_REG_RMW(pDev, address, pRH->regs[regLoc++] << 16, 0xFFFF0000);
-            }
-        } while (tag != T0_TAG_32BIT_LAST);
-        break;
-    case EAR_TYPE1:
-        address = pRH->regs[regLoc] & ~T1_NUM_M;
-        num = pRH->regs[regLoc] & T1_NUM_M;
-        regLoc++;
-        for (i = 0; i < num + 1; i++) {
-            /* Sequential Full word writes */
-            reg32 = pRH->regs[regLoc++] << 16;
-            reg32 |= pRH->regs[regLoc++];
-            if (EarDebugLevel >= EAR_DEBUG_VERBOSE) {
-                uiPrintf("ar5513EarDoRH: Type 1 EAR 32-bit write to 0x%04X : 0x%08x\n", address, reg32);
-            }
-            A_REG_WR(pDev, address, reg32);
-            address += sizeof(A_UINT32);
+    A_UINT32 lo = 0, hi = pProg->numSegs - 1, mid;
+
+    /* The first segment starts at channel 0 */
+    while (lo < hi) {
+        mid = (lo + hi + 1) / 2;
+        if (pProg->pSegs[mid].loChannel <= channel) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
         }
-        break;
-    case EAR_TYPE2:
-        do {
-            last = IS_TYPE2_LAST(pRH->regs[regLoc]);
-            bank = (pRH->regs[regLoc] & T2_BANK_M) >> T2_BANK_S;
-            /* Record which bank is written */
-            rfBankMask |= 1 << bank;
-            column = (pRH->regs[regLoc] & T2_COL_M) >> T2_COL_S;
-            startBit = pRH->regs[regLoc] & T2_START_M;
-            rfBuf = ar5513GetRfBank(pDev, bank);
-            if (IS_TYPE2_EXTENDED(pRH->regs[regLoc++])) {
-                num = A_DIV_UP(pRH->regs[regLoc], 16);
-                numBits = pRH->regs[regLoc];
-                regLoc++;
-                for (i = 0; i < num; i++) {
-                    /* Modify the bank 16 bits at a time */
-                    bitsThisWrite = (numBits > 16) ? 16 : numBits;
-                    numBits -= bitsThisWrite;
-                    reg32 = pRH->regs[regLoc++];
-                    if (EarDebugLevel >= EAR_DEBUG_VERBOSE) {
-                        uiPrintf("ar5513EarDoRH: Type 2 EAR E analog modify bank %d, startBit %d, column %d numBits %d data %d\n",
-                                 bank, startBit, column, bitsThisWrite, reg32);
-                    }
-                    ar5513ModifyRfBuffer(rfBuf, reg32, bitsThisWrite, startBit, column);
-                    startBit += bitsThisWrite;
-                }
-            } else {
-                numBits = (pRH->regs[regLoc] & T2_NUMB_M) >> T2_NUMB_S;
-                reg32   = pRH->regs[regLoc++] & T2_DATA_M;
-                if (EarDebugLevel >= EAR_DEBUG_VERBOSE) {
-                    uiPrintf("ar5513EarDoRH: Type 2 EAR analog modify bank %d, startBit %d, column %d numBits %d data %d\n",
-                             bank, startBit, column, numBits, reg32);
-                }
-                ar5513ModifyRfBuffer(rfBuf, reg32, numBits, startBit, column);
-            }
-        } while (!last);
-        break;
-    case EAR_TYPE3:
-        do {
-            opCode = (pRH->regs[regLoc] & T3_OPCODE_M) >> T3_OPCODE_S;
-            last = IS_TYPE3_LAST(pRH->regs[regLoc]);
-            startBit = (pRH->regs[regLoc] & T3_START_M) >> T3_START_S;
-            numBits = pRH->regs[regLoc] & T3_NUMB_M;
-            regLoc++;
-            /* Grab Address */
-            address = pRH->regs[regLoc++];
-            if (numBits > 16) {
-                reg32 = pRH->regs[regLoc++] << 16;
-                reg32 |= pRH->regs[regLoc++];
-            } else {
-                reg32 = pRH->regs[regLoc++];
-            }
-            mask = ((1 << numBits) - 1) << startBit;
-            regInit = A_REG_RD(pDev, address);
-            switch (opCode) {
+    }
+    return &pProg->pSegs[lo];
+}
+
+/**************************************************************
+ * ar5513EarRunOps
+ *
+ * Performs a register header's writes, RMWs and analog bank
+ * modifies as compiled at attach
+ */
+static void
+ar5513EarRunOps(WLAN_DEV_INFO *pDev, const EAR_OP *pOp, A_UINT16 numOps)
+{
+    const EAR_OP *pEnd = pOp + numOps;
+    A_UINT32     regInit, reg32;
+
+    for (; pOp < pEnd; pOp++) {
+        switch (pOp->kind) {
+        case EAR_OP_WRITE:
+            A_REG_WR(pDev, pOp->addr, pOp->value);
+            break;
+        case EAR_OP_RMW:
+            A_REG_RMW(pDev, pOp->addr, pOp->value, pOp->mask);
+            break;
+        case EAR_OP_RF:
+            ar5513ModifyRfBuffer(ar5513GetRfBank(pDev, pOp->arg), pOp->value, pOp->numBits,
+                                 pOp->addr, pOp->column);
+            break;
+        case EAR_OP_TYPE3:
+            regInit = A_REG_RD(pDev, pOp->addr);
+            switch (pOp->arg) {
             case T3_OC_REPLACE:
-                reg32 = (regInit & ~mask) | ((reg32 << startBit) & mask);
+                reg32 = pOp->value;
                 break;
             case T3_OC_ADD:
-                reg32 = (regInit & ~mask) |
-                    (((regInit & mask) + (reg32 << startBit)) & mask);
+                reg32 = (regInit & pOp->mask) + pOp->value;
                 break;
             case T3_OC_SUB:
-                reg32 = (regInit & ~mask) |
-                    (((regInit & mask) - (reg32 << startBit)) & mask);
+                reg32 = (regInit & pOp->mask) - pOp->value;
                 break;
             case T3_OC_MUL:
-                reg32 = (regInit & ~mask) |
-                    (((regInit & mask) * (reg32 << startBit)) & mask);
+                reg32 = (regInit & pOp->mask) * pOp->value;
                 break;
             case T3_OC_XOR:
-                reg32 = (regInit & ~mask) |
-                    (((regInit & mask) ^ (reg32 << startBit)) & mask);
+                reg32 = (regInit & pOp->mask) ^ pOp->value;
                 break;
             case T3_OC_OR:
-                reg32 = (regInit & ~mask) |
-                    (((regInit & mask) | (reg32 << startBit)) & mask);
+                reg32 = (regInit & pOp->mask) | pOp->value;
                 break;
             case T3_OC_AND:
-                reg32 = (regInit & ~mask) |
-                    (((regInit & mask) & (reg32 << startBit)) & mask);
+                reg32 = (regInit & pOp->mask) & pOp->value;
+                break;
+            default:
+                /* An unknown opcode leaves the field alone */
+                reg32 = regInit;
                 break;
             }
-            A_REG_WR(pDev, address, reg32);
-            if (EarDebugLevel >= EAR_DEBUG_VERBOSE) {
-                uiPrintf("ar5513EarDoRH: Type 3 EAR 32-bit rmw to 0x%04X : 0x%08x\n", address, reg32);
-            }
-        } while (!last);
-        break;
+            A_REG_WR(pDev, pOp->addr, (regInit & ~pOp->mask) | (reg32 & pOp->mask));
+            break;
+        }
+        if (EarDebugLevel >= EAR_DEBUG_EXTREME) {
+            uiPrintf("ar5513EarRunOps: op %d to 0x%04X : 0x%08x mask 0x%08x\n",
+                     pOp->kind, pOp->addr, pOp->value, pOp->mask);
+        }
     }
-    return rfBankMask;
 }
 
 /**************************************************************
@@ -4419,44 +4972,6 @@ ar5513CFlagsToEarMode(WLAN_CFLAGS cflags)
     return EAR_11A;
 }
 
-/**************************************************************
- * ar5513IsChannelInEarRegHead
- *
- * Convert from WLAN_CFLAGS to the EAR bitmap format
- */
-static A_BOOL
-ar5513IsChannelInEarRegHead(A_UINT16 earChannel, A_UINT16 channelMhz)
-{
-    int i;
-    const A_UINT16 earFlaggedChannels[14][2] = {
-        {2412, 2412}, {2417, 2437}, {2442, 2457}, {2462, 2467}, {2472, 2472}, {2484, 2484}, {2300, 2407},
-        {4900, 5160}, {5170, 5180}, {5190, 5250}, {5260, 5300}, {5310, 5320}, {5500, 5700}, {5725, 5825}
-    };
-
-    /* No channel specified - applies to all channels */
-    if (earChannel == 0) {
-        return TRUE;
-    }
-
-    /* Do we match the single channel check if its set? */
-    if (IS_CM_SINGLE(earChannel)) {
-        return ((earChannel & ~0x8000) == channelMhz) ? TRUE : FALSE;
-    }
-
-    /* Rest of the channel modifier bits can be set as one or more ranges - check them all */
-    if ((IS_CM_SPUR(earChannel)) && (IS_SPUR_CHAN(channelMhz))) {
-        return TRUE;
-    }
-    for (i = 0; i < 14; i++) {
-        if ((earChannel >> i) & 1) {
-            if ((earFlaggedChannels[0][i] <= channelMhz) && (earFlaggedChannels[1][i] >= channelMhz)) {
-                return TRUE;
-            }
-        }
-    }
-    return FALSE;
-}
-
 /**************************************************************
  * ar5513AdjustPhaseRamp
  *
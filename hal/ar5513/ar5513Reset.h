@@ -22,6 +22,12 @@ ar5513Reset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval,
 A_STATUS
 ar5513PerCalibration(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval);
 
+A_STATUS
+ar5513StartCalibration(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval, A_UINT32 calMask);
+
+A_UINT32
+ar5513CalibrationStatus(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval);
+
 A_STATUS
 ar5513SleepExit(WLAN_DEV_INFO *pDev);
 
@@ -43,6 +49,28 @@ ar5513AllocateRfBanks(WLAN_DEV_INFO *pDev, HAL_INFO *pHalInfo);
 void
 ar5513FreeRfBanks(WLAN_DEV_INFO *pDev, HAL_INFO *pHalInfo);
 
+A_BOOL
+ar5513AllocateRateTargets(WLAN_DEV_INFO *pDev, HAL_INFO *pHalInfo);
+
+void
+ar5513FreeRateTargets(WLAN_DEV_INFO *pDev, HAL_INFO *pHalInfo);
+
+A_STATUS
+ar5513AllocateIniWriteLists(WLAN_DEV_INFO *pDev, HAL_INFO *pHalInfo);
+
+void
+ar5513FreeIniWriteLists(WLAN_DEV_INFO *pDev, HAL_INFO *pHalInfo);
+
+#ifdef HAL_RESET_RECIPE
+A_STATUS
+ar5513AllocateResetRecipes(WLAN_DEV_INFO *pDev);
+#endif
+
+#ifdef HAL_TXPOWER_CACHE
+A_STATUS
+ar5513AllocateTxPowerCache(WLAN_DEV_INFO *pDev);
+#endif
+
 void
 ar5513SetTxPowerLimit(WLAN_DEV_INFO *pDev, A_UINT32 limit);
 
@@ -0,0 +1,331 @@
+/*
+ *  Copyright (c) 2004 Atheros Communications, Inc., All Rights Reserved
+ *
+ *  Host register level simulator of the AR5513.  Register masks and
+ *  reset values come from the falcon .cfg field descriptions (see
+ *  mkfalconsim.py); the few registers with side effects the HAL
+ *  depends on are scripted below.  There is no DMA engine or radio:
+ *  queues drain and calibrations finish as soon as they are started.
+ *
+ *  Only one simulated device exists at a time.
+ */
+
+#if defined(BUILD_AR5513) && defined(AR5513_SIM)
+
+#ident "$Id: //depot/sw/branches/AV_dev/src/hal/ar5513/ar5513Sim.c#1 $"
+
+#if !defined(PCI_INTERFACE)
+#error "AR5513_SIM models the PCI register interface"
+#endif
+
+/* Standard HAL Headers */
+#include "wlantype.h"
+#include "wlandrv.h"
+#include "halApi.h"
+#include "hal.h"
+#include "ui.h"
+
+/* Headers for HW private items */
+#include "ar5513MacReg.h"
+#include "ar5513Sim.h"
+
+#if defined(FALCON_EMUL)
+#include "ar5513/falcon_mac_emul_sim.ini"
+#else
+#include "ar5513/falcon1_0_sim.ini"
+#endif
+
+#define AR5513_SIM_NUM_REGS     (sizeof(ar5513SimRegs) / sizeof(ar5513SimRegs[0]))
+#define AR5513_SIM_NUM_ISR_S    5
+
+/* Analog bank readback of a 5112 rev 2.0, as shifted out - see ar5513ReadRadioChipRev */
+#define AR5513_SIM_RADIO_SREV   0xca
+#define AR5513_SIM_RADIO_REV_REG(_base)  ((_base) + (256 << 2))
+
+typedef struct ar5513SimState {
+    A_UINT32    regs[AR5513_SIM_ADDR_SPACE / sizeof(A_UINT32)];
+    A_UINT16    regIdx[AR5513_SIM_ADDR_SPACE / sizeof(A_UINT32)];  /* 1 + ar5513SimRegs index, 0 if undescribed */
+    A_UINT8     eeprom[AR5513_SIM_EEPROM_SIZE];
+} AR5513_SIM_STATE;
+
+static AR5513_SIM_STATE *pSim;
+
+#define SIM_REG(_reg)           (pSim->regs[(_reg) >> 2])
+
+/**************************************************************
+ * ar5513SimResetRange
+ *
+ * Return the described registers in [start, end) to their reset values
+ */
+static void
+ar5513SimResetRange(A_UINT32 start, A_UINT32 end)
+{
+    A_UINT32 i;
+
+    for (i = 0; i < AR5513_SIM_NUM_REGS; i++) {
+        if (ar5513SimRegs[i].addr >= start && ar5513SimRegs[i].addr < end) {
+            SIM_REG(ar5513SimRegs[i].addr) = ar5513SimRegs[i].resetVal;
+        }
+    }
+}
+
+/**************************************************************
+ * ar5513SimAttach
+ *
+ * Power on the simulated chip.  pEeprom optionally supplies the
+ * EEPROM contents, one 16 bit word per EEPROM offset.
+ */
+A_STATUS
+ar5513SimAttach(const A_UINT16 *pEeprom, A_UINT32 eepromWords)
+{
+    A_UINT32 i;
+
+    ASSERT(pSim == NULL);
+
+    if (eepromWords * sizeof(A_UINT16) > AR5513_SIM_EEPROM_SIZE) {
+        return A_EINVAL;
+    }
+
+    pSim = (AR5513_SIM_STATE *)A_DRIVER_MALLOC(sizeof(AR5513_SIM_STATE));
+    if (pSim == NULL) {
+        uiPrintf("ar5513SimAttach: Could not allocate simulator state\n");
+        return A_NO_MEMORY;
+    }
+    A_MEM_ZERO(pSim, sizeof(AR5513_SIM_STATE));
+
+    for (i = 0; i < AR5513_SIM_NUM_REGS; i++) {
+        ASSERT(ar5513SimRegs[i].addr < AR5513_SIM_ADDR_SPACE);
+        pSim->regIdx[ar5513SimRegs[i].addr >> 2] = (A_UINT16)(i + 1);
+    }
+    ar5513SimResetRange(0, AR5513_SIM_ADDR_SPACE);
+
+    /* Blank parts read back all ones */
+    for (i = 0; i < AR5513_SIM_EEPROM_SIZE; i++) {
+        pSim->eeprom[i] = 0xff;
+    }
+    for (i = 0; i < eepromWords; i++) {
+#if defined(AV10_NDIS)
+        /* The flash image is stored high byte first */
+        pSim->eeprom[2 * i]     = (A_UINT8)(pEeprom[i] >> 8);
+        pSim->eeprom[2 * i + 1] = (A_UINT8)(pEeprom[i] & 0xff);
+#else
+        pSim->eeprom[2 * i]     = (A_UINT8)(pEeprom[i] & 0xff);
+        pSim->eeprom[2 * i + 1] = (A_UINT8)(pEeprom[i] >> 8);
+#endif
+    }
+
+    return A_OK;
+}
+
+/**************************************************************
+ * ar5513SimDetach
+ */
+void
+ar5513SimDetach(void)
+{
+    if (pSim) {
+        A_DRIVER_FREE(pSim, sizeof(AR5513_SIM_STATE));
+        pSim = NULL;
+    }
+}
+
+/**************************************************************
+ * ar5513SimSpiRead
+ *
+ * Receive the RX_BYTE_CNT bytes (at most 4) from addr on into
+ * MAC_SPI_D, the first byte in bits 7:0
+ */
+static void
+ar5513SimSpiRead(A_UINT32 addr)
+{
+    A_UINT32 count = (SIM_REG(MAC_SPI_CS) & MAC_SPI_CS_RX_BYTE_CNT_M) >> MAC_SPI_CS_RX_BYTE_CNT_S;
+    A_UINT32 data  = 0;
+    A_UINT32 i;
+
+    ASSERT(count <= sizeof(A_UINT32));
+
+    for (i = 0; i < count && i < sizeof(A_UINT32); i++) {
+        data |= (A_UINT32)pSim->eeprom[(addr + i) & (AR5513_SIM_EEPROM_SIZE - 1)] << (i * 8);
+    }
+    SIM_REG(MAC_SPI_D) = data;
+}
+
+/**************************************************************
+ * ar5513SimSpi
+ *
+ * Carry out the SPI command in MAC_SPI_AO.  CB63 boards have an
+ * EEPROM: opcode in bits 7:0, byte address in bits 31:16.  AV10
+ * boards keep the image in the last sector of a 1MB flash: opcode
+ * in bits 7:0, flash address in bits 31:8.  The sector is mapped
+ * onto the simulated image.
+ */
+static void
+ar5513SimSpi(void)
+{
+    A_UINT32 ao = SIM_REG(MAC_SPI_AO);
+
+#if defined(AV10_NDIS)
+    switch (ao & 0xff) {
+    case MAC_SPI_AO_RD_DATA:
+        ar5513SimSpiRead(ao >> 8);
+        break;
+    case MAC_SPI_AO_RD_SIG:
+        /* 1MB flash */
+        SIM_REG(MAC_SPI_D) = 0x13;
+        break;
+    default:
+        break;
+    }
+#else
+    A_UINT32 addr = (ao >> 16) & (AR5513_SIM_EEPROM_SIZE - 1);
+
+    switch (ao & 0xff) {
+    case MAC_SPI_EEPROM_RD:
+        ar5513SimSpiRead(addr);
+        break;
+    case MAC_SPI_EEPROM_WR:
+        /* One byte per command, data in bits 15:8 */
+        pSim->eeprom[addr] = (A_UINT8)((ao >> 8) & 0xff);
+        break;
+    case MAC_SPI_EEPROM_RD_STATUS:
+        /* Writes complete at once - never write-in-progress */
+        SIM_REG(MAC_SPI_D) = 0;
+        break;
+    default:
+        break;
+    }
+#endif
+}
+
+/**************************************************************
+ * ar5513SimRead
+ */
+A_UINT32
+ar5513SimRead(WLAN_DEV_INFO *pDev, A_UINT32 reg)
+{
+    A_UINT32 val, idx, i;
+
+    ASSERT(pSim);
+    ASSERT(reg < AR5513_SIM_ADDR_SPACE && (reg & 3) == 0);
+
+    val = SIM_REG(reg);
+
+    switch (reg) {
+    case MAC_ISR_RAC:
+        /* Read-and-clear: latch the secondaries into their shadows */
+        val = SIM_REG(MAC_ISR);
+        for (i = 0; i < AR5513_SIM_NUM_ISR_S; i++) {
+            SIM_REG(MAC_ISR_S0_S + i * sizeof(A_UINT32)) = SIM_REG(MAC_ISR_S0 + i * sizeof(A_UINT32));
+            SIM_REG(MAC_ISR_S0 + i * sizeof(A_UINT32))   = 0;
+        }
+        SIM_REG(MAC_ISR) = 0;
+        break;
+    case MAC_Q_TXE:
+        /* No DMA - an enabled queue has drained by the time it is polled */
+        SIM_REG(MAC_Q_TXE) = 0;
+        break;
+    case AR5513_SIM_RADIO_REV_REG(CHN_0_BASE):
+    case AR5513_SIM_RADIO_REV_REG(CHN_1_BASE):
+        /* Both chains carry the same radio */
+        val = (A_UINT32)AR5513_SIM_RADIO_SREV << 24;
+        break;
+    default:
+        break;
+    }
+
+    idx = pSim->regIdx[reg >> 2];
+    return idx ? (val & ar5513SimRegs[idx - 1].readMask) : val;
+}
+
+/**************************************************************
+ * ar5513SimWrite
+ */
+void
+ar5513SimWrite(WLAN_DEV_INFO *pDev, A_UINT32 reg, A_UINT32 val)
+{
+    A_UINT32 idx, mask;
+
+    ASSERT(pSim);
+    ASSERT(reg < AR5513_SIM_ADDR_SPACE && (reg & 3) == 0);
+
+    switch (reg) {
+    case MAC_CR:
+        /* Only ones have effect; RXE reads back as the receive state */
+        if (val & MAC_CR_RXD) {
+            SIM_REG(MAC_CR) &= ~MAC_CR_RXE;
+        } else if (val & MAC_CR_RXE) {
+            SIM_REG(MAC_CR) |= MAC_CR_RXE;
+        }
+        if (val & MAC_CR_SWI) {
+            SIM_REG(MAC_ISR) |= MAC_ISR_SWI;
+        }
+        return;
+    case MAC_ISR:
+    case MAC_ISR_S0:
+    case MAC_ISR_S1:
+    case MAC_ISR_S2:
+    case MAC_ISR_S3:
+    case MAC_ISR_S4:
+        /* Write one to clear */
+        SIM_REG(reg) &= ~val;
+        return;
+    case MAC_Q_TXE:
+        /* Write one to set; disabled queues cannot be enabled */
+        SIM_REG(MAC_Q_TXE) |= val & MAC_Q_TXE_M & ~SIM_REG(MAC_Q_TXD);
+        return;
+    case MAC_Q_TXD:
+        SIM_REG(MAC_Q_TXE) &= ~val;
+        break;
+    case MAC_D_TXPSE:
+        /* The pause is served at once */
+        val &= MAC_D_TXPSE_CTRL_M;
+        SIM_REG(MAC_D_TXPSE) = val | (val ? MAC_D_TXPSE_STATUS : 0);
+        return;
+    case MAC_RC:
+        if (val & MAC_RC_MAC) {
+            ar5513SimResetRange(0, MAC_RC);
+            ar5513SimResetRange(0x8000, 0x9800);
+        }
+        if (val & MAC_RC_BB) {
+            ar5513SimResetRange(0x9800, 0xc000);
+        }
+        break;
+    case PHY_AGC_CONTROL:
+        /* Calibration and noise floor measurement finish instantly */
+        val &= ~(PHY_AGC_CONTROL_CAL | PHY_AGC_CONTROL_NF);
+        break;
+    case MAC_SPI_CS:
+        SIM_REG(MAC_SPI_CS) = val & ~(MAC_SPI_CS_START | MAC_SPI_CS_BUSY);
+        if (val & MAC_SPI_CS_START) {
+            ar5513SimSpi();
+        }
+        return;
+    default:
+        break;
+    }
+
+    idx = pSim->regIdx[reg >> 2];
+    if (idx) {
+        mask = ar5513SimRegs[idx - 1].writeMask;
+        SIM_REG(reg) = (SIM_REG(reg) & ~mask) | (val & mask);
+    } else {
+        SIM_REG(reg) = val;
+    }
+}
+
+/**************************************************************
+ * ar5513SimPoke
+ *
+ * Backdoor write with no masking or side effects - used by the
+ * host harness to raise interrupts, set revision IDs and so on.
+ */
+void
+ar5513SimPoke(A_UINT32 reg, A_UINT32 val)
+{
+    ASSERT(pSim);
+    ASSERT(reg < AR5513_SIM_ADDR_SPACE && (reg & 3) == 0);
+
+    SIM_REG(reg) = val;
+}
+
+#endif /* BUILD_AR5513 && AR5513_SIM */
@@ -0,0 +1,48 @@
+/*
+ * Copyright  2004 Atheros Communications, Inc.,  All Rights Reserved.
+ *
+ * Host register level simulator of the AR5513 MAC/BB.  Built with
+ * AR5513_SIM, it stands in for the platform register accessors so the
+ * HAL can be run and profiled on a host without a radio.
+ *
+ * $Id: //depot/sw/branches/AV_dev/src/hal/ar5513/ar5513Sim.h#1 $
+ */
+
+#ifndef _AR5513_SIM_H_
+#define _AR5513_SIM_H_
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+
+#define AR5513_SIM_ADDR_SPACE   0x18000         /* MAC, PCI, BB and SPI registers */
+#define AR5513_SIM_EEPROM_SIZE  0x8000          /* bytes */
+
+/* One entry per register described by the falcon .cfg - see mkfalconsim.py */
+typedef struct ar5513SimReg {
+    A_UINT32    addr;
+    A_UINT32    writeMask;                  /* bits software can change */
+    A_UINT32    readMask;                   /* bits that read back */
+    A_UINT32    resetVal;
+} AR5513_SIM_REG;
+
+A_STATUS
+ar5513SimAttach(const A_UINT16 *pEeprom, A_UINT32 eepromWords);
+
+void
+ar5513SimDetach(void);
+
+A_UINT32
+ar5513SimRead(WLAN_DEV_INFO *pDev, A_UINT32 reg);
+
+void
+ar5513SimWrite(WLAN_DEV_INFO *pDev, A_UINT32 reg, A_UINT32 val);
+
+void
+ar5513SimPoke(A_UINT32 reg, A_UINT32 val);
+
+#ifdef _cplusplus
+}
+#endif
+
+#endif /* _AR5513_SIM_H_ */
@@ -19,7 +19,9 @@
 #include "halApi.h"
 #include "hal.h"
 #include "halDevId.h"
+#include "halUtil.h"
 #include "ui.h"
+#include "halResetProfile.h"
 #include "display.h"
 #include "ratectrl.h"
 #include "vport.h"
@@ -171,7 +173,8 @@ static INLINE void
 ar5513ResetTxQueue(WLAN_DEV_INFO *pDev, int queueNum, HAL_TX_QUEUE_INFO *queueInfo)
 {
     A_UINT32 queueOffset = queueNum * sizeof(A_UINT32);
-    A_UINT32 retryReg, value;
+    A_UINT32 retryReg, value, qMisc;
+    HAL_RMW_BATCH batch;
 
     if (queueInfo->mode == TXQ_MODE_INACTIVE) {
         return;
@@ -200,18 +203,20 @@ ar5513ResetTxQueue(WLAN_DEV_INFO *pDev, int queueNum, HAL_TX_QUEUE_INFO *queueIn
     /* Set retry limit values */
     writePlatformReg(pDev, MAC_D0_RETRY_LIMIT + queueOffset, retryReg);
 
-    /* enable early termination on QCUs */
-    writePlatformReg(pDev, MAC_Q0_MISC + queueOffset, MAC_Q_MISC_DCU_EARLY_TERM_REQ);
+    /*
+     * enable early termination on QCUs.  Q_MISC is built up here and
+     * written once below; the D_MISC and IMR_S updates are batched.
+     */
+    qMisc = MAC_Q_MISC_DCU_EARLY_TERM_REQ;
+    HAL_RMW_INIT(&batch, pDev);
 
     if (queueInfo->cbrPeriod) {
         writePlatformReg(pDev, MAC_Q0_CBRCFG + queueOffset,
                 A_FIELD_VALUE(MAC_Q_CBRCFG, INTERVAL, queueInfo->cbrPeriod) |
                 A_FIELD_VALUE(MAC_Q_CBRCFG, OVF_THRESH, queueInfo->cbrOverflowLimit));
 
-        writePlatformReg(pDev, MAC_Q0_MISC + queueOffset,
-                readPlatformReg(pDev, MAC_Q0_MISC + queueOffset) |
-                MAC_Q_MISC_FSP_CBR |
-                (queueInfo->cbrOverflowLimit ? MAC_Q_MISC_CBR_EXP_CNTR_LIMIT_EN : 0));
+        qMisc |= MAC_Q_MISC_FSP_CBR |
+                 (queueInfo->cbrOverflowLimit ? MAC_Q_MISC_CBR_EXP_CNTR_LIMIT_EN : 0);
     }
 
     if (queueInfo->readyTime) {
@@ -225,35 +230,28 @@ ar5513ResetTxQueue(WLAN_DEV_INFO *pDev, int queueNum, HAL_TX_QUEUE_INFO *queueIn
                 A_FIELD_VALUE(MAC_D_CHNTIME, DUR, queueInfo->burstTime) |
                 MAC_D_CHNTIME_EN);
         if (queueInfo->qFlags & TXQ_FLAG_RDYTIME_EXP_POLICY_ENABLE) {
-            writePlatformReg(pDev, MAC_Q0_MISC + queueOffset,
-                                readPlatformReg(pDev, MAC_Q0_MISC + queueOffset) |
-                                MAC_Q_MISC_RDYTIME_EXP_POLICY);
-                }        
+            qMisc |= MAC_Q_MISC_RDYTIME_EXP_POLICY;
+        }
     }
 
     if (queueInfo->qFlags & TXQ_FLAG_BACKOFF_DISABLE) {
-        writePlatformReg(pDev, MAC_D0_MISC + queueOffset,
-                readPlatformReg(pDev, MAC_D0_MISC + queueOffset) |
-                MAC_D_MISC_POST_FR_BKOFF_DIS);
+        halRmwAdd(&batch, MAC_D0_MISC + queueOffset,
+                  MAC_D_MISC_POST_FR_BKOFF_DIS, MAC_D_MISC_POST_FR_BKOFF_DIS);
     }
 
     if (queueInfo->qFlags & TXQ_FLAG_FRAG_BURST_BACKOFF_ENABLE) {
-        writePlatformReg(pDev, MAC_D0_MISC + queueOffset,
-                readPlatformReg(pDev, MAC_D0_MISC + queueOffset) |
-                MAC_D_MISC_FRAG_BKOFF_EN);
+        halRmwAdd(&batch, MAC_D0_MISC + queueOffset,
+                  MAC_D_MISC_FRAG_BKOFF_EN, MAC_D_MISC_FRAG_BKOFF_EN);
     }
 
     if (queueInfo->mode == TXQ_MODE_BEACON) {
         /* Configure QCU for beacons */
-        value = MAC_Q_MISC_FSP_DBA_GATED | MAC_Q_MISC_CBR_INCR_DIS1 | MAC_Q_MISC_BEACON_USE;
-        writePlatformReg(pDev, MAC_Q0_MISC + queueOffset,
-                readPlatformReg(pDev, MAC_Q0_MISC + queueOffset) | value);
+        qMisc |= MAC_Q_MISC_FSP_DBA_GATED | MAC_Q_MISC_CBR_INCR_DIS1 | MAC_Q_MISC_BEACON_USE;
 
         /* Configure DCU for beacons */
         value = A_FIELD_VALUE(MAC_D_MISC, ARB_LOCKOUT_CNTRL, MAC_D_MISC_ARB_LOCKOUT_CNTRL_GLOBAL) |
                 MAC_D_MISC_POST_FR_BKOFF_DIS | MAC_D_MISC_BEACON_USE;
-        writePlatformReg(pDev, MAC_D0_MISC + queueOffset,
-                readPlatformReg(pDev, MAC_D0_MISC + queueOffset) | value);
+        halRmwAdd(&batch, MAC_D0_MISC + queueOffset, value, value);
     }
 
 #define EXTREMEWME
@@ -267,16 +265,14 @@ ar5513ResetTxQueue(WLAN_DEV_INFO *pDev, int queueNum, HAL_TX_QUEUE_INFO *queueIn
     if (queueNum==TXQ_ID_FOR_AC2||queueNum==TXQ_ID_FOR_AC3) {
         value = A_FIELD_VALUE(MAC_D_MISC, ARB_LOCKOUT_CNTRL, MAC_D_MISC_ARB_LOCKOUT_CNTRL_GLOBAL) |
                 MAC_D_MISC_POST_FR_BKOFF_DIS;
-        writePlatformReg(pDev, MAC_D0_MISC + queueOffset,
-                readPlatformReg(pDev, MAC_D0_MISC + queueOffset) | value);
+        halRmwAdd(&batch, MAC_D0_MISC + queueOffset, value, value);
     }
 #endif
 #ifdef UPSD
     if (queueNum==TXQ_ID_FOR_UPSD) {
         value = A_FIELD_VALUE(MAC_D_MISC, ARB_LOCKOUT_CNTRL, MAC_D_MISC_ARB_LOCKOUT_CNTRL_GLOBAL) |
                 MAC_D_MISC_POST_FR_BKOFF_DIS;
-        writePlatformReg(pDev, MAC_D0_MISC + queueOffset,
-                readPlatformReg(pDev, MAC_D0_MISC + queueOffset) | value);
+        halRmwAdd(&batch, MAC_D0_MISC + queueOffset, value, value);
     }
 #endif
 
@@ -291,14 +287,11 @@ ar5513ResetTxQueue(WLAN_DEV_INFO *pDev, int queueNum, HAL_TX_QUEUE_INFO *queueIn
          * not properly refreshing the Tx descriptor if
          * the TXE clear setting is used.
          */
-        value = MAC_Q_MISC_FSP_DBA_GATED | MAC_Q_MISC_CBR_INCR_DIS1 | MAC_Q_MISC_CBR_INCR_DIS0;
-        writePlatformReg(pDev, MAC_Q0_MISC + queueOffset,
-                readPlatformReg(pDev, MAC_Q0_MISC + queueOffset) | value);
+        qMisc |= MAC_Q_MISC_FSP_DBA_GATED | MAC_Q_MISC_CBR_INCR_DIS1 | MAC_Q_MISC_CBR_INCR_DIS0;
 
         /* Configure DCU for CAB */
-        writePlatformReg(pDev, MAC_D0_MISC + queueOffset,
-                readPlatformReg(pDev, MAC_D0_MISC + queueOffset) |
-                A_FIELD_VALUE(MAC_D_MISC, ARB_LOCKOUT_CNTRL, MAC_D_MISC_ARB_LOCKOUT_CNTRL_GLOBAL));
+        value = A_FIELD_VALUE(MAC_D_MISC, ARB_LOCKOUT_CNTRL, MAC_D_MISC_ARB_LOCKOUT_CNTRL_GLOBAL);
+        halRmwAdd(&batch, MAC_D0_MISC + queueOffset, value, value);
     }
 
     if (queueInfo->mode == TXQ_MODE_PSPOLL) {
@@ -310,9 +303,7 @@ ar5513ResetTxQueue(WLAN_DEV_INFO *pDev, int queueNum, HAL_TX_QUEUE_INFO *queueIn
          * non-TIM elements and send PS-poll PS poll processing
          * will be done in software
          */
-        writePlatformReg(pDev, MAC_Q0_MISC + queueOffset,
-                readPlatformReg(pDev, MAC_Q0_MISC + queueOffset) |
-                MAC_Q_MISC_CBR_INCR_DIS1);
+        qMisc |= MAC_Q_MISC_CBR_INCR_DIS1;
     }
 
     if (queueInfo->qFlags & TXQ_FLAG_COMPRESSION_ENABLE) {
@@ -326,12 +317,12 @@ ar5513ResetTxQueue(WLAN_DEV_INFO *pDev, int queueNum, HAL_TX_QUEUE_INFO *queueIn
             A_REG_WR(pDev, MAC_Q_CBBS, (80 + 2*queueNum));
             A_REG_WR(pDev, MAC_Q_CBBA, queueInfo->physCompBuf);
             A_REG_WR(pDev, MAC_Q_CBC,  HAL_COMP_BUF_MAX_SIZE/1024);
-            A_REG_WR(pDev, MAC_Q0_MISC + queueOffset,
-                     A_REG_RD(pDev, MAC_Q0_MISC + queueOffset)
-                     | MAC_Q_MISC_QCU_COMP_EN);
+            qMisc |= MAC_Q_MISC_QCU_COMP_EN;
         }
     }    
 
+    writePlatformReg(pDev, MAC_Q0_MISC + queueOffset, qMisc);
+
     /*
      * Always update the secondary interrupt mask registers - this
      * could be a new queue getting enabled in a running system or
@@ -341,10 +332,11 @@ ar5513ResetTxQueue(WLAN_DEV_INFO *pDev, int queueNum, HAL_TX_QUEUE_INFO *queueIn
      * tx interrupts are enabled/disabled for all queues collectively
      * using the primary mask reg
      */
-    A_REG_RMW_FIELD(pDev, MAC_IMR_S0, QCU_TXOK,   pDev->pHalInfo->txNormalIntMask);
-    A_REG_RMW_FIELD(pDev, MAC_IMR_S1, QCU_TXERR,  pDev->pHalInfo->txNormalIntMask);
-    A_REG_RMW_FIELD(pDev, MAC_IMR_S2, QCU_TXURN,  pDev->pHalInfo->txNormalIntMask);
-    A_REG_RMW_FIELD(pDev, MAC_IMR_S0, QCU_TXDESC, pDev->pHalInfo->txDescIntMask);
+    HAL_RMW_FIELD(&batch, MAC_IMR_S0, QCU_TXOK,   pDev->pHalInfo->txNormalIntMask);
+    HAL_RMW_FIELD(&batch, MAC_IMR_S1, QCU_TXERR,  pDev->pHalInfo->txNormalIntMask);
+    HAL_RMW_FIELD(&batch, MAC_IMR_S2, QCU_TXURN,  pDev->pHalInfo->txNormalIntMask);
+    HAL_RMW_FIELD(&batch, MAC_IMR_S0, QCU_TXDESC, pDev->pHalInfo->txDescIntMask);
+    halRmwCommit(&batch);
 
 #ifdef MULTI_RATE_DEBUG
     memset(txRateSeriesStat, 0, sizeof(TX_RATE_SERIES_STAT)*MAX_RATE_SERIES);
@@ -375,7 +367,9 @@ ar5513SetupTxQueue(WLAN_DEV_INFO *pDev, HAL_TX_QUEUE_INFO *queueInfo)
         pDev->pHalInfo->txDescIntMask |= queueMask;
     }
 
+    HAL_RESET_PHASE_START(pDev, HAL_RESET_PHASE_TX_QUEUES);
     ar5513ResetTxQueue(pDev, queueNum, queueInfo);
+    HAL_RESET_PHASE_END(pDev, HAL_RESET_PHASE_TX_QUEUES);
 
     return queueNum;
 }
@@ -428,6 +422,8 @@ ar5513SetTxDP(WLAN_DEV_INFO *pDev, int queueNum, A_UINT32 txdp)
     A_UINT32 txdpDebug;
 #endif /* DEBUG */
 
+    HAL_REG_PROFILE_FN(pDev, ar5513SetTxDP);
+
     ASSERT(pDev->pHalInfo->txQueueAllocMask & (1 << queueNum));
 
     /*
@@ -482,6 +478,7 @@ ar5513SetTxDP(WLAN_DEV_INFO *pDev, int queueNum, A_UINT32 txdp)
     }
 #endif
 #endif /* DEBUG */
+    HAL_REG_PROFILE_EXIT(pDev);
 }
 
 /**************************************************************
@@ -494,12 +491,15 @@ ar5513StartTxDma(WLAN_DEV_INFO *pDev, int queueNum)
 {
     A_UINT32 queueMask = (1 << queueNum);
 
+    HAL_REG_PROFILE_FN(pDev, ar5513StartTxDma);
+
     ASSERT(pDev->pHalInfo->txQueueAllocMask & queueMask);
 
     // Check to be sure we're not enabling a queue that has its TXD bit set.
     ASSERT( !(readPlatformReg(pDev, MAC_Q_TXD) & queueMask) );
 
     writePlatformReg(pDev, MAC_Q_TXE, queueMask);
+    HAL_REG_PROFILE_EXIT(pDev);
 }
 
 /**************************************************************
@@ -516,7 +516,10 @@ ar5513NumTxPending(WLAN_DEV_INFO *pDev, int queueNum)
     A_UINT32 pfcReg    = MAC_Q0_STS + (queueNum * sizeof(A_UINT32));
     A_UINT32 numPending;
 
+    HAL_REG_PROFILE_FN(pDev, ar5513NumTxPending);
+
     if (!(pDev->pHalInfo->txQueueAllocMask & queueMask)) {
+        HAL_REG_PROFILE_EXIT(pDev);
         return 0;
     }
 
@@ -533,6 +536,7 @@ ar5513NumTxPending(WLAN_DEV_INFO *pDev, int queueNum)
         }
     }
 
+    HAL_REG_PROFILE_EXIT(pDev);
     return numPending;
 }
 
@@ -1314,11 +1318,14 @@ ar5513ProcessTxDesc(WLAN_DEV_INFO *pdevInfo, ATHEROS_DESC *pTxDesc)
     A_RSSI            rssi;
     A_RSSI            rssi1, rssi2, max_rssi, diff_rssi;
 
+    HAL_REG_PROFILE_FN(pdevInfo, ar5513ProcessTxDesc);
+
     ASSERT(pTxDesc->status.tx.status == NOT_DONE);
 
     /* ensure we have the status correctly */
     A_TX_DESC_CACHE_INVAL(pTxDesc);
     if (!ar5513GetTxDescDone(pdevInfo, pTxDesc, TRUE)) {
+        HAL_REG_PROFILE_EXIT(pdevInfo);
         return A_EBUSY;
     }
     
@@ -1585,6 +1592,7 @@ ar5513ProcessTxDesc(WLAN_DEV_INFO *pdevInfo, ATHEROS_DESC *pTxDesc)
 #endif /* ! PT_2_PT_ANT_DIV */
     }
 
+    HAL_REG_PROFILE_EXIT(pdevInfo);
     return A_OK;
 }
 
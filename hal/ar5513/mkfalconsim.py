@@ -0,0 +1,99 @@
+#!/usr/bin/env python
+
+"mkfalconsim.py -- Build the AR5513 simulator register map from a falcon .cfg file"
+
+import sys
+import time
+
+# print usage and exit
+def usage():
+    sys.stderr.write("usage:  mkfalconsim cfgFile outFile\n")
+    sys.exit(1)
+
+# "31:16" or "5" -> mask of the field
+def field_mask(bitStr):
+    bits = bitStr.split(':')
+    hi = int(bits[0])
+    lo = int(bits[-1])
+    return ((1 << (hi - lo + 1)) - 1) << lo, lo
+
+# collect write/read masks and reset values for every mac/bb register
+def parse_cfg(inf):
+    regs = {}
+
+    for eachLine in inf.readlines():
+        newLine = eachLine.split('#')[0].strip()
+        if len(newLine) == 0:
+            continue
+        # the mode specific section only repeats field values
+        if newLine.startswith('@MODE'):
+            break
+        if newLine[0] == '@':
+            continue
+
+        tokens = newLine.split()
+        if len(tokens) < 10:
+            continue
+        # rf fields give a bank number rather than an address
+        if not tokens[3].startswith('0x'):
+            continue
+
+        regAddr = int(tokens[3], 16)
+        mask, shift = field_mask(tokens[4])
+        value = (int(tokens[1], 0) << shift) & mask
+
+        if regAddr not in regs:
+            regs[regAddr] = [tokens[2], 0, 0, 0]
+        reg = regs[regAddr]
+        if tokens[6] == '1':
+            reg[1] = reg[1] | mask
+        if tokens[7] == '1':
+            reg[2] = reg[2] | mask
+        reg[3] = reg[3] | value
+
+    return regs
+
+def convert_cfg(cfgFile, outFile):
+
+    # can we open file?
+    try:
+        inf = open(cfgFile, 'r')
+    # if not, exit
+    except:
+        sys.stderr.write("%s : %s\n" % (cfgFile, sys.exc_info()[1]))
+        usage()
+
+    regs = parse_cfg(inf)
+    inf.close()
+
+    # can we open output file
+    try:
+        outf = open(outFile, 'w')
+    # if not, exit
+    except:
+        sys.stderr.write("%s : %s\n" % (outFile, sys.exc_info()[1]))
+        usage()
+
+    outf.write("/* Auto Generated Simulator Register Map from %s.  Created: %s */\n\n" %
+               (cfgFile.split('/')[-1], time.strftime("%m/%d/%y")))
+    outf.write("static const AR5513_SIM_REG ar5513SimRegs[] = {\n")
+    outf.write("/*  address     writable    readable    reset */\n")
+    for regAddr in sorted(regs.keys()):
+        reg = regs[regAddr]
+        outf.write("{ 0x%08x, 0x%08x, 0x%08x, 0x%08x },    /* %s */\n" %
+                   (regAddr, reg[1], reg[2], reg[3], reg[0]))
+    outf.write("};\n")
+    outf.close()
+
+# validate arguments and calls convert_cfg()
+def checkargs():
+
+    # check args; 'argv' comes from 'sys' module
+    argc = len(sys.argv)
+    if argc != 3:
+        usage()
+
+    convert_cfg(sys.argv[1], sys.argv[2])
+
+if __name__ == '__main__':
+    checkargs()
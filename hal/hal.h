@@ -22,14 +22,45 @@ typedef enum {
     IQ_CAL_DONE,
 } IQ_CAL_STATES;
 
+typedef enum {
+    NF_CAL_IDLE,
+    NF_CAL_RUNNING,                     /* Measuring the noise floor */
+    NF_CAL_LOADING,                     /* Loading the filtered noise floor */
+} NF_CAL_STATES;
+
 
 #ifdef AR5513
 #define HAL_NUM_TX_QUEUES       5
 #else
 #define HAL_NUM_TX_QUEUES       10
 #endif
+#define HAL_WL_NUM_MODES        6               /* modesIndex 1..5 */
 #define HAL_COMP_BUF_MAX_SIZE   9216            /* 9K */
 #define HAL_COMP_BUF_ALIGN_SIZE 512
+#define HAL_KEY_SLOT_MAX        128             /* Key cache entries tracked by keySlots */
+#define HAL_KEY_SLOT_WORDS      (HAL_KEY_SLOT_MAX / 32)
+#define HAL_KEY_SLOT_NONE       0xff            /* End of a keySlots LRU list */
+
+/*
+ * Key cache slot maps - a bit per entry with no keyCacheSib owner,
+ * and a bit per TKIP quad n whose entries n, n+32, n+64 and n+96 are
+ * all free.  Each station other than localSta is also on one of two
+ * LRU lists, linked through lruPrev/lruNext at the entry it holds,
+ * oldest staLastActivityTime first: list 0 for stations neither
+ * authenticated nor associated, list 1 for the rest.  Rebuilt from
+ * keyCacheSib[] whenever valid is clear.
+ */
+typedef struct HalKeySlots {
+    A_BOOL    valid;
+    A_UINT32  numSlots;                     /* Entries mapped, at most HAL_KEY_SLOT_MAX */
+    A_UINT32  freeMap[HAL_KEY_SLOT_WORDS];
+    A_UINT32  quadMap;
+    A_UINT8   lruHead[2];
+    A_UINT8   lruTail[2];
+    A_UINT8   lruList[HAL_KEY_SLOT_MAX];    /* List the entry is on, HAL_KEY_SLOT_NONE if none */
+    A_UINT8   lruPrev[HAL_KEY_SLOT_MAX];
+    A_UINT8   lruNext[HAL_KEY_SLOT_MAX];
+} HAL_KEY_SLOTS;
 
 /*
  * WARNING - this struct must remain A_UINT32 elements only and must exactly match
@@ -71,6 +102,10 @@ typedef struct HalCapabilities {
 /* Storage for HAL-specific items */
 typedef struct HalInfo {
     struct eepMap       *pEepData;          /* Holds all info read from EEPROM on first reset */
+    void                *pEepArena;         /* Backs pEepData and pEarHead; one allocation */
+    A_UINT32            eepArenaSize;
+    A_UINT32            eepArenaUsed;
+    A_UINT32            eepromSector;       /* Flash sector holding the EEPROM image, 0 until probed */
     struct gainValues   *pGainValues;       /* The thermal gain adjustment structure */
     A_UINT32            txQueueAllocMask;   /* Holds the allocation vector for tx queues */
     A_UINT32            txNormalIntMask;    /* Holds the Normal Interrupt bits for the Queues */
@@ -78,10 +113,17 @@ typedef struct HalInfo {
     A_UINT32            globIntRefCount;    /* Reference count for global interrupt enable */
     const struct RfHalFuncs *pRfHal;        /* Used for RF Hal */
     struct earHeader    *pEarHead;          /* All EAR information */
+    struct earProgram   *pEarProg;          /* pEarHead compiled for reset */
     void                *pAnalogBanks;      /* Analog Bank scratchpad */
+    void                *pAnalogBanksWritten; /* Analog Banks as last written to the radio */
+    A_UINT32            analogBanksValid;   /* Bit per bank pAnalogBanksWritten holds for the radio */
     A_INT16             txPowerIndexOffset; /* Offset of transmit power table */
+    void                *pRateTargets;      /* Per chain rate power targets from the last reset */
     A_UINT32            ofdmTxPower;        /* Tracks the nominal OFDM tx power level - mostly for probe requests */
     IQ_CAL_STATES       iqCalState;         /* Current state of IQ calibration */
+    A_UINT32            iqCalChains;        /* HAL_CAL_IQ_CHAINx still to be applied */
+    NF_CAL_STATES       nfCalState;         /* Current state of noise floor calibration */
+    A_BOOL              nfCalRestart;       /* Measure again once loading is done */
     RFGAIN_STATES       rfgainState;        /* Current state of rfgain */
     A_BOOL              swSwapDesc;         /* flag indicating sw needs to swap descriptor fields */
     HAL_CAPABILITIES    halCapabilities;    /* capability values for misc small returns */
@@ -91,6 +133,8 @@ typedef struct HalInfo {
 	A_UINT8             halAntCnt;          /* Antenna Count */
 	A_UINT8             halAntWinCnt;       /* Antenna Window Count */
     } beaconAntCtrl;
+    HAL_KEY_SLOTS       keySlots;           /* Free key cache entries */
+    struct ar5513KeyShadow *pKeyShadow;     /* Key cache as last written */
     A_BOOL              halInit;
     A_BOOL              macReset;
     A_UINT32            pciCfg; 
@@ -106,6 +150,41 @@ typedef struct HalInfo {
                                              *       LNA off, RX open for Chain1,
                                              *       Turn on the post-LNA feed-through
                                              *       circuitry with GPIO 11 */
+    struct halWriteList *pIniWriteList[HAL_WL_NUM_MODES]; /* Compiled init tables, by modesIndex */
+    HAL_WRITE_PACING    writePacing;        /* Pacing of write list and RF bank writes */
+    HAL_WRITE_STATS     writeStats;
+    A_UINT32            writePaceCount;     /* Writes since the last pacing stall */
+    struct halWriteList *pIniDeltaList[HAL_WL_NUM_MODES][HAL_WL_NUM_MODES]; /* [from][to], same band only */
+    A_UINT16            iniModesIndex;      /* Init tables the chip holds, 0 if unknown */
+    A_BOOL              fastChanChange;     /* Channel changes may use pIniDeltaList */
+    A_BOOL              iniEarEngaged;      /* The EAR programmed registers for that channel */
+#ifdef HAL_REG_CACHE
+    struct halRegCache  *pRegCache;         /* Shadow register cache */
+#endif
+#ifdef HAL_REG_PROFILE
+    struct halRegProfile *pRegProfile;      /* Register access profile */
+#endif
+#ifdef HAL_REG_TRACE
+    struct halRegTrace  *pRegTrace;         /* Register access trace ring */
+#endif
+#ifdef HAL_RESET_RECIPE
+    struct halResetRecipeCache *pResetRecipes; /* Cached channel programming */
+#endif
+#ifdef HAL_TXPOWER_CACHE
+    struct halTxPowerCache *pTxPowerCache;  /* Computed transmit power tables */
+#endif
+#ifdef HAL_RESET_PROFILE
+    struct halResetProfile *pResetProfile;  /* Reset phase latency histograms */
+#endif
+#ifdef HAL_CAL_IMAGE
+    const void          *pCalImageIn;       /* Image offered to the attach in progress */
+    A_UINT32            calImageInSize;
+    void                *pCalImage;         /* Image of the calibration data read at attach */
+    A_UINT32            calImageSize;
+#endif
+#if defined(HAL_REG_PROFILE) || defined(HAL_REG_TRACE)
+    const char          *pRegIoFn;          /* Tag of the accesses in progress */
+#endif
 } HAL_INFO;
 
 #define RX_FLIP_THRESHOLD 3 /* Count successful Tx before switching Rx Ant */
@@ -120,6 +199,8 @@ typedef struct HwFuncs {
     A_STATUS  (*hwPhyDisable)(WLAN_DEV_INFO *pDev);
     A_STATUS  (*hwDisable)(WLAN_DEV_INFO *pDev);
     A_STATUS  (*hwPerCalibration)(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval);
+    A_STATUS  (*hwStartCalibration)(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval, A_UINT32 calMask);
+    A_UINT32  (*hwCalibrationStatus)(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval);
     RFGAIN_STATES (*hwGetRfgain)(WLAN_DEV_INFO *pDev);
     void      (*hwSetTxPowerLimit)(WLAN_DEV_INFO *pDev, A_UINT32 limit);
 
@@ -220,6 +301,10 @@ typedef struct HwFuncs {
                                     WLAN_MACADDR *pMacAddr,
                                     WLAN_PRIV_RECORD *pWlanPrivRecord,
                                     A_BOOL bXorKey);
+    A_STATUS  (*hwSetKeyCacheEntries)(WLAN_DEV_INFO *pDev,
+                                      const HAL_KEY_CACHE_SET *pSets,
+                                      A_UINT32 numSets,
+                                      HAL_KEY_CACHE_SET_STATS *pStats);
     A_UINT16  (*hwKeyCacheAlloc)(WLAN_DEV_INFO *pDev, A_UINT16 keyCacheIndex,
                                  SIB_ENTRY *pSib, A_UINT16 keyType,
                                  A_BOOL *pHwEncrypt);
@@ -257,4 +342,6 @@ extern int GainDebug;
 }
 #endif
 
+#include "halRegIo.h"
+
 #endif /* _HAL_H */
@@ -19,6 +19,14 @@ extern "C" {
 A_STATUS
 halAttach(WLAN_DEV_INFO *pDev);
 
+#ifdef HAL_CAL_IMAGE
+A_STATUS
+halAttachWithCalImage(WLAN_DEV_INFO *pDev, const void *pImage, A_UINT32 size);
+
+A_STATUS
+halGetCalImage(WLAN_DEV_INFO *pDev, const void **ppImage, A_UINT32 *pSize);
+#endif
+
 A_UINT32
 halGetNumDevid(void);
 
@@ -44,6 +52,18 @@ halDisable(WLAN_DEV_INFO *pDev);
 A_STATUS
 halPerCalibration(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval);
 
+/* Calibrations for halStartCalibration and halCalibrationStatus */
+#define HAL_CAL_NF              0x00000001  /* Noise floor */
+#define HAL_CAL_IQ_CHAIN0       0x00000002  /* IQ mismatch, per rx chain */
+#define HAL_CAL_IQ_CHAIN1       0x00000004
+#define HAL_CAL_IQ              (HAL_CAL_IQ_CHAIN0 | HAL_CAL_IQ_CHAIN1)
+
+A_STATUS
+halStartCalibration(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval, A_UINT32 calMask);
+
+A_UINT32
+halCalibrationStatus(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval);
+
 void
 halSetTxPowerLimit(WLAN_DEV_INFO *pDev, A_UINT32 limit);
 #define MAX_TX_POWER 0xffffffff
@@ -452,6 +472,25 @@ halSetKeyCacheEntry(WLAN_DEV_INFO *pDev, A_UINT16 keyCacheIndex,
                     WLAN_MACADDR *pMacAddr, WLAN_PRIV_RECORD *pWlanPrivRecord,
                     A_BOOL bXorKey);
 
+/* One entry of a halSetKeyCacheEntries batch */
+typedef struct halKeyCacheSet {
+    A_UINT16            keyCacheIndex;
+    WLAN_MACADDR        *pMacAddr;
+    WLAN_PRIV_RECORD    *pWlanPrivRecord;
+    A_BOOL              bXorKey;
+} HAL_KEY_CACHE_SET;
+
+/* What a halSetKeyCacheEntries batch cost */
+typedef struct halKeyCacheSetStats {
+    A_UINT32    writes;             /* key cache words written, if the chip batches */
+    A_UINT32    writesSkipped;      /* words not written as the chip held them already */
+    A_UINT32    cycles;             /* halRegIoCycles() ticks for the whole batch */
+} HAL_KEY_CACHE_SET_STATS;
+
+A_STATUS
+halSetKeyCacheEntries(WLAN_DEV_INFO *pDev, const HAL_KEY_CACHE_SET *pSets, A_UINT32 numSets,
+                      HAL_KEY_CACHE_SET_STATS *pStats);
+
 A_UINT16
 halKeyCacheAlloc(WLAN_DEV_INFO *pDev, A_UINT16 hwIndex, SIB_ENTRY *pSib,
                  A_UINT16 keyType, A_BOOL *pHwEncrypt);
@@ -459,6 +498,9 @@ halKeyCacheAlloc(WLAN_DEV_INFO *pDev, A_UINT16 hwIndex, SIB_ENTRY *pSib,
 void
 halKeyCacheFree(WLAN_DEV_INFO *pDev, A_UINT16 hwIndex);
 
+void
+halKeyCacheTouch(WLAN_DEV_INFO *pDev, SIB_ENTRY *pSib);
+
 
 enum halPowerModes {
     AWAKE,
@@ -495,6 +537,147 @@ halUseShortSlotTime(WLAN_DEV_INFO *pDev, A_BOOL en, A_BOOL prev);
 void
 halSendXrChirp(WLAN_DEV_INFO *pDev);
 
+/* Pacing of the reset register write lists */
+typedef enum {
+    HAL_WRITE_PACE_NONE,        /* Back to back writes */
+    HAL_WRITE_PACE_DELAY,       /* udelay(delayUs) every blockSize writes - bug 10685 */
+    HAL_WRITE_PACE_FLUSH,       /* PIO read of flushReg every blockSize writes - bug 6773 */
+} HAL_WRITE_PACE;
+
+typedef struct halWritePacing {
+    HAL_WRITE_PACE  policy;
+    A_UINT32        blockSize;
+    A_UINT32        delayUs;
+    A_UINT32        flushReg;
+} HAL_WRITE_PACING;
+
+typedef struct halWriteStats {
+    A_UINT32    writes;         /* register writes issued by the write lists */
+    A_UINT32    stalls;         /* pacing delays or flushes taken */
+    A_UINT32    fastChanChanges;/* resets that only wrote the table differences */
+    A_UINT32    rfBankWrites;   /* analog banks shifted into the radio */
+    A_UINT32    rfBankSkips;    /* analog banks unchanged since last written, left alone */
+} HAL_WRITE_STATS;
+
+void
+halSetWritePacing(WLAN_DEV_INFO *pDev, const HAL_WRITE_PACING *pPacing);
+
+void
+halGetWritePacing(WLAN_DEV_INFO *pDev, HAL_WRITE_PACING *pPacing);
+
+void
+halGetWriteStats(WLAN_DEV_INFO *pDev, HAL_WRITE_STATS *pStats, A_BOOL clear);
+
+void
+halSetFastChannelChange(WLAN_DEV_INFO *pDev, A_BOOL enable);
+
+#ifdef HAL_REG_CACHE
+/* Shadow register cache statistics */
+typedef struct halRegCacheStats {
+    A_UINT32    writes;             /* register writes requested */
+    A_UINT32    writesSkipped;      /* writes dropped - register already held the value */
+    A_UINT32    reads;              /* register reads requested */
+    A_UINT32    readsCached;        /* reads served from the shadow */
+    A_UINT32    invalidates;        /* full invalidations (chip resets) */
+} HAL_REG_CACHE_STATS;
+
+A_STATUS
+halGetRegCacheStats(WLAN_DEV_INFO *pDev, HAL_REG_CACHE_STATS *pStats, A_BOOL clear);
+#endif
+
+#ifdef HAL_RESET_RECIPE
+/* Reset recipe cache statistics */
+typedef struct halResetRecipeStats {
+    A_UINT32    hits;               /* resets that replayed a recipe */
+    A_UINT32    misses;             /* resets that computed the channel programming */
+    A_UINT32    captures;           /* recipes stored */
+    A_UINT32    overflows;          /* captures too long to keep */
+    A_UINT32    evictions;          /* recipes dropped to make room */
+    A_UINT32    flushes;            /* whole cache invalidations */
+    A_UINT32    stale;              /* recipes dropped as a register they read had changed */
+} HAL_RESET_RECIPE_STATS;
+
+A_STATUS
+halGetResetRecipeStats(WLAN_DEV_INFO *pDev, HAL_RESET_RECIPE_STATS *pStats, A_BOOL clear);
+
+void
+halFlushResetRecipes(WLAN_DEV_INFO *pDev);
+#endif
+
+#ifdef HAL_TXPOWER_CACHE
+/* Transmit power table cache statistics */
+typedef struct halTxPowerCacheStats {
+    A_UINT32    hits;               /* tables written from the cache */
+    A_UINT32    misses;             /* tables computed from the EEPROM data */
+    A_UINT32    evictions;          /* tables dropped to make room */
+    A_UINT32    flushes;            /* whole cache invalidations */
+} HAL_TXPOWER_CACHE_STATS;
+
+A_STATUS
+halGetTxPowerCacheStats(WLAN_DEV_INFO *pDev, HAL_TXPOWER_CACHE_STATS *pStats, A_BOOL clear);
+
+void
+halFlushTxPowerCache(WLAN_DEV_INFO *pDev);
+#endif
+
+#ifdef HAL_RESET_PROFILE
+/* Reset phases, the same for every chip family */
+typedef enum {
+    HAL_RESET_PHASE_TOTAL = 0,      /* whole of halReset */
+    HAL_RESET_PHASE_CHIP_RESET,     /* reset assert/deassert and polling, PLL settle */
+    HAL_RESET_PHASE_INI_WRITES,     /* init table writes */
+    HAL_RESET_PHASE_RF_BANKS,       /* analog bank setup and writes */
+    HAL_RESET_PHASE_TX_POWER,       /* power tables and per rate power */
+    HAL_RESET_PHASE_SYNTH_SETTLE,   /* synthDelay wait and baseband ready poll */
+    HAL_RESET_PHASE_IQ_CAL,         /* IQ calibration start */
+    HAL_RESET_PHASE_NF_CAL,         /* wait for offset and noise floor calibration */
+    HAL_RESET_PHASE_TX_QUEUES,      /* tx queue setup after reset, per queue */
+    HAL_RESET_PHASE_COUNT
+} HAL_RESET_PHASE;
+
+/* Per phase latency, in halRegIoCycles() ticks */
+typedef struct halResetPhaseStats {
+    A_UINT32    count;              /* times the phase ran */
+    A_UINT32    minCycles;
+    A_UINT32    avgCycles;
+    A_UINT32    p99Cycles;          /* 99th percentile, rounded up to a histogram bucket */
+    A_UINT32    maxCycles;
+} HAL_RESET_PHASE_STATS;
+
+A_STATUS
+halGetResetProfile(WLAN_DEV_INFO *pDev, HAL_RESET_PHASE_STATS pStats[HAL_RESET_PHASE_COUNT],
+                   A_BOOL clear);
+#endif
+
+#ifdef HAL_REG_PROFILE
+void
+halRegProfileDump(WLAN_DEV_INFO *pDev, A_UINT32 maxEntries);
+
+void
+halRegProfileClear(WLAN_DEV_INFO *pDev);
+#endif
+
+#ifdef HAL_REG_TRACE
+/* Register trace replay results, spans are first to last access */
+typedef struct halRegTraceReplayStats {
+    A_UINT32    records;            /* accesses replayed */
+    A_UINT32    readMismatches;     /* reads that did not return the captured value */
+    A_UINT32    incomplete;         /* records being written or overwritten, skipped */
+    A_UINT32    tracedCycles;       /* span as captured */
+    A_UINT32    replayCycles;       /* span on replay */
+} HAL_REG_TRACE_REPLAY_STATS;
+
+void
+halRegTraceEnable(WLAN_DEV_INFO *pDev, A_BOOL enable);
+
+A_STATUS
+halRegTraceGetImage(WLAN_DEV_INFO *pDev, const void **ppImage, A_UINT32 *pSize);
+
+A_STATUS
+halRegTraceReplay(WLAN_DEV_INFO *pDev, const void *pImage, A_UINT32 size, const char *pFn,
+                  HAL_REG_TRACE_REPLAY_STATS *pStats);
+#endif
+
 /* Interrupt functions */
 
 /*
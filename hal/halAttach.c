@@ -13,6 +13,15 @@
 #include "ui.h"
 
 #include "halDevId.h"
+#ifdef HAL_REG_PROFILE
+#include "halRegProfile.h"
+#endif
+#ifdef HAL_REG_TRACE
+#include "halRegTrace.h"
+#endif
+#ifdef HAL_RESET_PROFILE
+#include "halResetProfile.h"
+#endif
 
 #ifdef BUILD_AR5211
 #include "ar5211/ar5211Attach.h"
@@ -98,6 +107,7 @@ static MAC_REV_DATA ar5kMacRevData[] = {
 const static A_UINT32 NumMacRev = (sizeof(ar5kMacRevData) / sizeof(MAC_REV_DATA));
 
 static void halGetDeviceId(WLAN_DEV_INFO *pDev);
+static A_STATUS halAttachDevice(WLAN_DEV_INFO *pDev, const void *pCalImage, A_UINT32 calImageSize);
 
 /**************************************************************
  * halGetDeviceId
@@ -144,6 +154,32 @@ halGetDeviceId(WLAN_DEV_INFO *pDev)
 
 A_STATUS
 halAttach(WLAN_DEV_INFO *pDev)
+{
+    return halAttachDevice(pDev, NULL, 0);
+}
+
+#ifdef HAL_CAL_IMAGE
+/**************************************************************
+ * halAttachWithCalImage
+ *
+ * halAttach, offering the device the calibration image saved
+ * from an earlier attach (see halGetCalImage).  A device that
+ * finds the image matches its EEPROM takes its calibration data
+ * from it instead of reading and parsing the EEPROM; otherwise
+ * the image is ignored.  The image need only last the call.
+ */
+A_STATUS
+halAttachWithCalImage(WLAN_DEV_INFO *pDev, const void *pImage, A_UINT32 size)
+{
+    return halAttachDevice(pDev, pImage, size);
+}
+#endif
+
+/**************************************************************
+ * halAttachDevice
+ */
+static A_STATUS
+halAttachDevice(WLAN_DEV_INFO *pDev, const void *pCalImage, A_UINT32 calImageSize)
 {
     A_STATUS      status;
     unsigned int  i;
@@ -172,11 +208,41 @@ halAttach(WLAN_DEV_INFO *pDev)
     }
     A_MEM_ZERO(pDev->pHalInfo, sizeof(HAL_INFO));
 
+#ifdef HAL_REG_PROFILE
+    /* Profiling and tracing are best effort - carry on without them */
+    (void)halRegProfileAttach(pDev);
+#endif
+#ifdef HAL_REG_TRACE
+    (void)halRegTraceAttach(pDev);
+#endif
+#ifdef HAL_RESET_PROFILE
+    (void)halResetProfileAttach(pDev);
+#endif
+
+#ifdef HAL_CAL_IMAGE
+    pDev->pHalInfo->pCalImageIn    = pCalImage;
+    pDev->pHalInfo->calImageInSize = calImageSize;
+#endif
+
     /* Call the device specific attach function */
     status = ar5kAttachData[i].hwAttach(pDev, pDev->pciInfo.DeviceID);
 
+#ifdef HAL_CAL_IMAGE
+    pDev->pHalInfo->pCalImageIn    = NULL;
+    pDev->pHalInfo->calImageInSize = 0;
+#endif
+
     /* If unsuccessful, free any allocated memory */
     if (status != A_OK) {
+#ifdef HAL_REG_PROFILE
+        halRegProfileDetach(pDev);
+#endif
+#ifdef HAL_REG_TRACE
+        halRegTraceDetach(pDev);
+#endif
+#ifdef HAL_RESET_PROFILE
+        halResetProfileDetach(pDev);
+#endif
         A_DRIVER_FREE(pDev->pHalInfo, sizeof(HAL_INFO));
         pDev->pHalInfo = NULL;
     }
@@ -204,6 +270,16 @@ halDetach(WLAN_DEV_INFO *pDev)
     ASSERT(pDev->pHwFunc->hwDetach);
     status = pDev->pHwFunc->hwDetach(pDev);
 
+#ifdef HAL_REG_PROFILE
+    halRegProfileDetach(pDev);
+#endif
+#ifdef HAL_REG_TRACE
+    halRegTraceDetach(pDev);
+#endif
+#ifdef HAL_RESET_PROFILE
+    halResetProfileDetach(pDev);
+#endif
+
     /* Free HAL info struct */
     A_DRIVER_FREE(pDev->pHalInfo, sizeof(HAL_INFO));
     pDev->pHalInfo = NULL;
@@ -0,0 +1,240 @@
+/*
+ *  Copyright (c) 2004 Atheros Communications, Inc., All Rights Reserved
+ *
+ *  Calibration interpolation.  These give the same results as the
+ *  linear scans the chip files used to carry, for lists in ascending
+ *  order as the EEPROM readers build them.
+ */
+
+#ident "$Id: //depot/sw/branches/AV_dev/src/hal/halCalInterp.c#1 $"
+
+#include "wlantype.h"
+#include "wlandrv.h"
+#include "halApi.h"
+#include "hal.h"
+#include "halCalInterp.h"
+
+/**************************************************************
+ * halCalLowerBound
+ *
+ * Index of the first of pList[lo..hi] not below value; pList[hi]
+ * must not be below value.
+ */
+static INLINE A_UINT16
+halCalLowerBound(A_INT32 value, const A_UINT16 *pList, A_UINT16 lo, A_UINT16 hi)
+{
+    A_UINT16 mid;
+
+    while (lo < hi) {
+        mid = (A_UINT16)((lo + hi) >> 1);
+        if ((A_INT32)pList[mid] < value) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/**************************************************************
+ * halCalFindIndex
+ *
+ * Returns the index of the first entry equal to value, or
+ * listSize if there is none.
+ */
+A_UINT16
+halCalFindIndex(A_UINT16 value, const A_UINT16 *pList, A_UINT16 listSize)
+{
+    A_UINT16 i;
+
+    if (listSize == 0 || pList[listSize - 1] < value) {
+        return listSize;
+    }
+    i = halCalLowerBound(value, pList, 0, listSize - 1);
+    return (pList[i] == value) ? i : listSize;
+}
+
+/**************************************************************
+ * halCalGetLowerUpperValues
+ *
+ *  Look for value being within 0.1 of the search values
+ *  however, NDIS can't do float calculations, so multiply everything
+ *  up by HAL_CAL_SCALE so can do integer arithmatic
+ *
+ * INPUT  value       -value to search for
+ * INPUT  pList       -ptr to the list to search
+ * INPUT  listSize    -number of entries in list
+ * OUTPUT pLowerValue -return the lower value
+ * OUTPUT pUpperValue -return the upper value
+ *
+ * WARNING: This input list should be filled and in ascending order
+ */
+void
+halCalGetLowerUpperValues(A_UINT16 value, const A_UINT16 *pList, A_UINT16 listSize,
+                          A_UINT16 *pLowerValue, A_UINT16 *pUpperValue)
+{
+    A_UINT16    i;
+    A_UINT16    listEndValue = *(pList + listSize - 1);
+    A_UINT32    target       = value * HAL_CAL_SCALE;
+
+    /*
+     * See if value is lower than the first value in the list
+     * if so return first value
+     */
+    if (target < (A_UINT32)(*pList * HAL_CAL_SCALE - HAL_CAL_DELTA)) {
+        *pLowerValue = *pList;
+        *pUpperValue = *pList;
+        return;
+    }
+
+    /*
+     * See if value is greater than last value in list
+     * if so return last value
+     */
+    if (target > (A_UINT32)(listEndValue * HAL_CAL_SCALE + HAL_CAL_DELTA)) {
+        *pLowerValue = listEndValue;
+        *pUpperValue = listEndValue;
+        return;
+    }
+
+    /*
+     * The values are integers, so within HAL_CAL_DELTA is equal.
+     * pList[0] <= value <= listEndValue here.
+     */
+    i = halCalLowerBound(value, pList, 0, listSize - 1);
+    if (pList[i] == value) {
+        *pLowerValue = value;
+        *pUpperValue = value;
+    } else {
+        *pLowerValue = pList[i - 1];
+        *pUpperValue = pList[i];
+    }
+}
+
+/**************************************************************
+ * halCalGetLowerUpperIndex
+ *
+ * Returns the indices of the entries either side of value, or
+ * the index of the entry equal to it twice.  Values off either
+ * end of the list give that end.
+ */
+void
+halCalGetLowerUpperIndex(A_INT32 value, const A_UINT16 *pList, A_UINT16 listSize,
+                         A_UINT32 *pLowerIdx, A_UINT32 *pUpperIdx)
+{
+    A_UINT16 i;
+
+    if (value <= (A_INT32)pList[0]) {
+        *pLowerIdx = 0;
+        *pUpperIdx = 0;
+        return;
+    }
+    if (value >= (A_INT32)pList[listSize - 1]) {
+        *pLowerIdx = listSize - 1;
+        *pUpperIdx = listSize - 1;
+        return;
+    }
+
+    /* pList[0] < value < pList[listSize - 1], so 0 < i < listSize - 1 */
+    i = halCalLowerBound(value, pList, 0, listSize - 1);
+    if ((A_INT32)pList[i] == value) {
+        *pLowerIdx = i;
+        *pUpperIdx = i;
+    } else {
+        *pLowerIdx = i - 1;
+        *pUpperIdx = i;
+    }
+}
+
+/**************************************************************
+ * halCalInterpolate
+ *
+ * Returns interpolated or the scaled up interpolated value
+ */
+A_UINT16
+halCalInterpolate(A_UINT16 target, A_UINT16 srcLeft, A_UINT16 srcRight,
+                  A_UINT16 targetLeft, A_UINT16 targetRight, A_BOOL scaleUp)
+{
+    A_UINT16 returnValue;
+    A_INT16 lRatio;
+    A_UINT16 scaleValue = HAL_CAL_SCALE;
+
+    /*
+     * To get an accurate ratio, always scale, If we want to scale, then
+     * don't scale back down.
+     */
+    if ((targetLeft * targetRight) == 0) {
+        return 0;
+    }
+
+    if (scaleUp) {
+        scaleValue = 1;
+    }
+
+    if (srcRight != srcLeft) {
+        /* note the ratio always need to be scaled, since it will be a fraction */
+        lRatio = ((target - srcLeft) * HAL_CAL_SCALE / (srcRight - srcLeft));
+        if (lRatio < 0) {
+            /* Return as Left target if value would be negative */
+            returnValue = targetLeft * (scaleUp ? HAL_CAL_SCALE : 1);
+        } else if (lRatio > HAL_CAL_SCALE) {
+            /* Return as Right target if Ratio is greater than 100% (SCALE) */
+            returnValue = targetRight * (scaleUp ? HAL_CAL_SCALE : 1);
+        } else {
+            returnValue = ((lRatio * targetRight + (HAL_CAL_SCALE - lRatio) *
+                           targetLeft) / scaleValue);
+        }
+    } else {
+        returnValue = targetLeft * (scaleUp ? HAL_CAL_SCALE : 1);
+    }
+
+    return returnValue;
+}
+
+/**************************************************************
+ * halCalInterpolateSigned16
+ *
+ * Straight line between (srcLeft, targetLeft) and (srcRight,
+ * targetRight), unclamped, rounded toward zero.
+ */
+A_INT16
+halCalInterpolateSigned16(A_UINT16 target, A_UINT16 srcLeft, A_UINT16 srcRight,
+                          A_INT16 targetLeft, A_INT16 targetRight)
+{
+    if (srcRight == srcLeft) {
+        return targetLeft;
+    }
+    return (A_INT16)(((target - srcLeft) * targetRight + (srcRight - target) * targetLeft) /
+                     (srcRight - srcLeft));
+}
+
+/**************************************************************
+ * halCalInterpolateVector
+ *
+ * halCalInterpolateSigned16 of each pair pLeft[i], pRight[i] at
+ * the same target - e.g. a power table between two channel
+ * piers.  The weights are worked out once and the loop has no
+ * branches, so the compiler can vectorise it.
+ */
+void
+halCalInterpolateVector(A_UINT16 target, A_UINT16 srcLeft, A_UINT16 srcRight,
+                        const A_INT16 *pLeft, const A_INT16 *pRight, A_INT16 *pOut,
+                        A_UINT32 count)
+{
+    A_INT32  wLeft, wRight, span;
+    A_UINT32 i;
+
+    if (srcRight == srcLeft) {
+        for (i = 0; i < count; i++) {
+            pOut[i] = pLeft[i];
+        }
+        return;
+    }
+
+    wRight = (A_INT32)target - srcLeft;
+    wLeft  = (A_INT32)srcRight - target;
+    span   = (A_INT32)srcRight - srcLeft;
+    for (i = 0; i < count; i++) {
+        pOut[i] = (A_INT16)((wRight * pRight[i] + wLeft * pLeft[i]) / span);
+    }
+}
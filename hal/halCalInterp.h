@@ -0,0 +1,50 @@
+/*
+ * Copyright  2004 Atheros Communications, Inc.,  All Rights Reserved.
+ *
+ * Calibration interpolation shared by the chip power code.  The
+ * calibration piers (channels, PCDACs, powers) are ascending lists,
+ * which are searched by bisection; interpolating a whole power table
+ * between two piers is a single straight loop.
+ *
+ * $Id: //depot/sw/branches/AV_dev/src/hal/halCalInterp.h#1 $
+ */
+
+#ifndef _HAL_CAL_INTERP_H_
+#define _HAL_CAL_INTERP_H_
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+
+#define HAL_CAL_SCALE   100         /* EEP_SCALE - fixed point for the ratio */
+#define HAL_CAL_DELTA   10          /* EEP_DELTA - values this close are equal */
+
+A_UINT16
+halCalFindIndex(A_UINT16 value, const A_UINT16 *pList, A_UINT16 listSize);
+
+void
+halCalGetLowerUpperValues(A_UINT16 value, const A_UINT16 *pList, A_UINT16 listSize,
+                          A_UINT16 *pLowerValue, A_UINT16 *pUpperValue);
+
+void
+halCalGetLowerUpperIndex(A_INT32 value, const A_UINT16 *pList, A_UINT16 listSize,
+                         A_UINT32 *pLowerIdx, A_UINT32 *pUpperIdx);
+
+A_UINT16
+halCalInterpolate(A_UINT16 target, A_UINT16 srcLeft, A_UINT16 srcRight,
+                  A_UINT16 targetLeft, A_UINT16 targetRight, A_BOOL scaleUp);
+
+A_INT16
+halCalInterpolateSigned16(A_UINT16 target, A_UINT16 srcLeft, A_UINT16 srcRight,
+                          A_INT16 targetLeft, A_INT16 targetRight);
+
+void
+halCalInterpolateVector(A_UINT16 target, A_UINT16 srcLeft, A_UINT16 srcRight,
+                        const A_INT16 *pLeft, const A_INT16 *pRight, A_INT16 *pOut,
+                        A_UINT32 count);
+
+#ifdef _cplusplus
+}
+#endif
+
+#endif /* _HAL_CAL_INTERP_H_ */
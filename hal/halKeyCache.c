@@ -9,6 +9,8 @@
 #include "halApi.h"
 #include "hal.h"
 #include "ui.h"
+#include "halUtil.h"
+#include "halKeyCache.h"
 
 /**************************************************************
  * halReserveHalKeyCacheEntries
@@ -72,6 +74,55 @@ halSetKeyCacheEntry(WLAN_DEV_INFO *pDev, A_UINT16 keyCacheIndex,
     pDev->pHwFunc->hwSetKeyCacheEntry(pDev, keyCacheIndex, pMacAddr, pWlanPrivRecord, bXorKey);
 }
 
+/**************************************************************
+ * halSetKeyCacheEntries
+ *
+ * Sets a batch of key cache entries, in order, for a group rekey
+ * or a wave of reassociations.  Chips with hwSetKeyCacheEntries
+ * work out the writes for several entries before making any and
+ * leave out those not needed; others set each entry in turn.
+ * pStats, if not NULL, gets what the batch took.  Nothing is
+ * written if any index is out of range.
+ */
+A_STATUS
+halSetKeyCacheEntries(WLAN_DEV_INFO *pDev, const HAL_KEY_CACHE_SET *pSets, A_UINT32 numSets,
+                      HAL_KEY_CACHE_SET_STATS *pStats)
+{
+    HAL_KEY_CACHE_SET_STATS stats;
+    A_UINT32                i, size, start;
+    A_STATUS                status = A_OK;
+
+    ASSERT(pDev && pDev->pHwFunc && pDev->pHwFunc->hwSetKeyCacheEntry);
+
+    if (numSets && pSets == NULL) {
+        return A_EINVAL;
+    }
+    size = halGetCapability(pDev, HAL_GET_KEY_CACHE_SIZE, 0);
+    for (i = 0; i < numSets; i++) {
+        if (pSets[i].keyCacheIndex >= size) {
+            return A_EINVAL;
+        }
+    }
+
+    A_MEM_ZERO(&stats, sizeof(stats));
+    start = halRegIoCycles();
+
+    if (pDev->pHwFunc->hwSetKeyCacheEntries) {
+        status = pDev->pHwFunc->hwSetKeyCacheEntries(pDev, pSets, numSets, &stats);
+    } else {
+        for (i = 0; i < numSets; i++) {
+            pDev->pHwFunc->hwSetKeyCacheEntry(pDev, pSets[i].keyCacheIndex, pSets[i].pMacAddr,
+                                              pSets[i].pWlanPrivRecord, pSets[i].bXorKey);
+        }
+    }
+
+    stats.cycles = halRegIoCycles() - start;
+    if (pStats) {
+        *pStats = stats;
+    }
+    return status;
+}
+
 
 /**************************************************************
  * halKeyCacheAlloc
@@ -110,6 +161,403 @@ halKeyCacheFree(WLAN_DEV_INFO *pDev, A_UINT16 hwIndex)
     pDev->pHwFunc->hwKeyCacheFree(pDev, hwIndex);
 }
 
+/**************************************************************
+ * halKeyCacheTouch
+ *
+ * Tells the HAL that pSib's staLastActivityTime or staState has
+ * changed, so that halKeyCacheAlloc finds the least recently
+ * active station without walking the key cache.  The driver
+ * calls this wherever it updates either.
+ *
+ * NOTE: caller must hold the keySem.
+ */
+void
+halKeyCacheTouch(WLAN_DEV_INFO *pDev, SIB_ENTRY *pSib)
+{
+    ASSERT(pDev && pSib);
+
+    if (pSib->hwIndex < pDev->pHalInfo->keySlots.numSlots &&
+        pDev->keyCacheSib[pSib->hwIndex] == pSib)
+    {
+        halKeySlotTouch(pDev, pSib->hwIndex);
+    }
+}
+
+/**************************************************************
+ * halKeySlotLowBit
+ *
+ * Position of the lowest set bit of a nonzero word
+ */
+static A_UINT32
+halKeySlotLowBit(A_UINT32 word)
+{
+    A_UINT32 bit = 0;
+
+    if ((word & 0xffff) == 0) {
+        word >>= 16;
+        bit   += 16;
+    }
+    if ((word & 0xff) == 0) {
+        word >>= 8;
+        bit   += 8;
+    }
+    if ((word & 0xf) == 0) {
+        word >>= 4;
+        bit   += 4;
+    }
+    if ((word & 0x3) == 0) {
+        word >>= 2;
+        bit   += 2;
+    }
+    if ((word & 0x1) == 0) {
+        bit++;
+    }
+    return bit;
+}
+
+/**************************************************************
+ * halKeySlotRange
+ *
+ * The bits of map word w that stand for entries lo..hi-1
+ */
+static A_UINT32
+halKeySlotRange(A_UINT32 w, A_UINT32 lo, A_UINT32 hi)
+{
+    A_UINT32 base = w * 32;
+    A_UINT32 mask = 0xffffffff;
+
+    if (hi <= base || lo >= base + 32) {
+        return 0;
+    }
+    if (hi < base + 32) {
+        mask = ((A_UINT32)1 << (hi - base)) - 1;
+    }
+    if (lo > base) {
+        mask &= ~(((A_UINT32)1 << (lo - base)) - 1);
+    }
+    return mask;
+}
+
+/**************************************************************
+ * halKeySlotLruOf
+ *
+ * The LRU list a station belongs on
+ */
+static A_UINT32
+halKeySlotLruOf(SIB_ENTRY *pSib)
+{
+    return (pSib->staState & (STATE_AUTH|STATE_ASSOC)) ? 1 : 0;
+}
+
+/**************************************************************
+ * halKeySlotLruBefore
+ *
+ * TRUE if entry a goes ahead of entry b on an LRU list: less
+ * recently active, or as recently and lower, as the chips'
+ * scans used to pick.  An entry freed behind the maps' back
+ * goes first so that it is found and dropped.
+ */
+static A_BOOL
+halKeySlotLruBefore(SIB_ENTRY **keyCacheSib, A_UINT32 a, A_UINT32 b)
+{
+    if (keyCacheSib[a] == NULL || keyCacheSib[b] == NULL) {
+        return (A_BOOL)(keyCacheSib[a] == NULL);
+    }
+    if (keyCacheSib[a]->staLastActivityTime != keyCacheSib[b]->staLastActivityTime) {
+        return (A_BOOL)(keyCacheSib[a]->staLastActivityTime <
+                        keyCacheSib[b]->staLastActivityTime);
+    }
+    return (A_BOOL)(a < b);
+}
+
+/**************************************************************
+ * halKeySlotLruUnlink
+ *
+ * Takes entry idx off whichever LRU list it is on
+ */
+static void
+halKeySlotLruUnlink(HAL_KEY_SLOTS *pSlots, A_UINT32 idx)
+{
+    A_UINT32 list = pSlots->lruList[idx];
+    A_UINT32 prev = pSlots->lruPrev[idx];
+    A_UINT32 next = pSlots->lruNext[idx];
+
+    if (list == HAL_KEY_SLOT_NONE) {
+        return;
+    }
+    if (prev == HAL_KEY_SLOT_NONE) {
+        pSlots->lruHead[list] = (A_UINT8)next;
+    } else {
+        pSlots->lruNext[prev] = (A_UINT8)next;
+    }
+    if (next == HAL_KEY_SLOT_NONE) {
+        pSlots->lruTail[list] = (A_UINT8)prev;
+    } else {
+        pSlots->lruPrev[next] = (A_UINT8)prev;
+    }
+    pSlots->lruList[idx] = HAL_KEY_SLOT_NONE;
+}
+
+/**************************************************************
+ * halKeySlotLruInsert
+ *
+ * Puts entry idx, on no list, in order on LRU list list.  The
+ * search runs back from the tail, so a station just active is
+ * linked without walking the list.
+ */
+static void
+halKeySlotLruInsert(WLAN_DEV_INFO *pDev, A_UINT32 idx, A_UINT32 list)
+{
+    HAL_KEY_SLOTS *pSlots = &pDev->pHalInfo->keySlots;
+    A_UINT32      prev   = pSlots->lruTail[list];
+    A_UINT32      next;
+
+    ASSERT(pSlots->lruList[idx] == HAL_KEY_SLOT_NONE);
+
+    while (prev != HAL_KEY_SLOT_NONE &&
+           halKeySlotLruBefore(pDev->keyCacheSib, idx, prev))
+    {
+        prev = pSlots->lruPrev[prev];
+    }
+    next = (prev == HAL_KEY_SLOT_NONE) ? pSlots->lruHead[list] : pSlots->lruNext[prev];
+
+    pSlots->lruList[idx] = (A_UINT8)list;
+    pSlots->lruPrev[idx] = (A_UINT8)prev;
+    pSlots->lruNext[idx] = (A_UINT8)next;
+    if (prev == HAL_KEY_SLOT_NONE) {
+        pSlots->lruHead[list] = (A_UINT8)idx;
+    } else {
+        pSlots->lruNext[prev] = (A_UINT8)idx;
+    }
+    if (next == HAL_KEY_SLOT_NONE) {
+        pSlots->lruTail[list] = (A_UINT8)idx;
+    } else {
+        pSlots->lruPrev[next] = (A_UINT8)idx;
+    }
+}
+
+/**************************************************************
+ * halKeySlotsSync
+ *
+ * Rebuilds the free entry maps and the LRU lists from
+ * keyCacheSib[]
+ */
+void
+halKeySlotsSync(WLAN_DEV_INFO *pDev)
+{
+    HAL_KEY_SLOTS *pSlots = &pDev->pHalInfo->keySlots;
+    SIB_ENTRY     *pSib;
+    A_UINT32      i;
+
+    A_MEM_ZERO(pSlots, sizeof(*pSlots));
+    pSlots->numSlots = A_MIN(pDev->keyCacheSize, HAL_KEY_SLOT_MAX);
+    for (i = 0; i < 2; i++) {
+        pSlots->lruHead[i] = HAL_KEY_SLOT_NONE;
+        pSlots->lruTail[i] = HAL_KEY_SLOT_NONE;
+    }
+    for (i = 0; i < HAL_KEY_SLOT_MAX; i++) {
+        pSlots->lruList[i] = HAL_KEY_SLOT_NONE;
+    }
+    for (i = 0; i < pSlots->numSlots; i++) {
+        pSib = pDev->keyCacheSib[i];
+        if (pSib == NULL) {
+            pSlots->freeMap[i >> 5] |= (A_UINT32)1 << (i & 0x1F);
+        } else if (pSib != pDev->localSta && pSib->hwIndex == i) {
+            halKeySlotLruInsert(pDev, i, halKeySlotLruOf(pSib));
+        }
+    }
+    if (pSlots->numSlots == HAL_KEY_SLOT_MAX) {
+        pSlots->quadMap = pSlots->freeMap[0] & pSlots->freeMap[1] &
+                          pSlots->freeMap[2] & pSlots->freeMap[3];
+    }
+    pSlots->valid = TRUE;
+}
+
+/**************************************************************
+ * halKeySlotsCheck
+ *
+ * Rebuilds the maps if they are out of date or were built for
+ * another key cache size
+ */
+static void
+halKeySlotsCheck(WLAN_DEV_INFO *pDev)
+{
+    HAL_KEY_SLOTS *pSlots = &pDev->pHalInfo->keySlots;
+
+    if (!pSlots->valid ||
+        pSlots->numSlots != A_MIN(pDev->keyCacheSize, HAL_KEY_SLOT_MAX))
+    {
+        halKeySlotsSync(pDev);
+    }
+}
+
+/**************************************************************
+ * halKeySlotSet
+ *
+ * Sets the owner of a key cache entry, NULL to free it.  The chip
+ * key cache code makes all its keyCacheSib[] changes through here
+ * so that the free maps stay current.  An entry given to a new
+ * owner leaves the LRU lists until halKeySlotTouch.
+ */
+void
+halKeySlotSet(WLAN_DEV_INFO *pDev, A_UINT16 hwIndex, SIB_ENTRY *pSib)
+{
+    HAL_KEY_SLOTS *pSlots = &pDev->pHalInfo->keySlots;
+    A_UINT32      bit     = (A_UINT32)1 << (hwIndex & 0x1F);
+
+    if (!pSlots->valid || hwIndex >= pSlots->numSlots) {
+        pDev->keyCacheSib[hwIndex] = pSib;
+        return;
+    }
+    if (pDev->keyCacheSib[hwIndex] != pSib) {
+        halKeySlotLruUnlink(pSlots, hwIndex);
+    }
+    pDev->keyCacheSib[hwIndex] = pSib;
+
+    if (pSib) {
+        pSlots->freeMap[hwIndex >> 5] &= ~bit;
+    } else {
+        pSlots->freeMap[hwIndex >> 5] |= bit;
+    }
+    if (pSlots->numSlots == HAL_KEY_SLOT_MAX) {
+        pSlots->quadMap = (pSlots->quadMap & ~bit) |
+                          (pSlots->freeMap[0] & pSlots->freeMap[1] &
+                           pSlots->freeMap[2] & pSlots->freeMap[3] & bit);
+    }
+}
+
+/**************************************************************
+ * halKeySlotFindFree
+ *
+ * Returns the lowest free entry from MAX_SHARED_KEYS up to but not
+ * including indexLimit - the lowest free TKIP quad if tkipQuad is
+ * set - or HWINDEX_INVALID.  skipShared passes over the entries a
+ * TKIP broadcast key would need.  This is the entry the chips'
+ * linear scans pick.  Candidates are checked against keyCacheSib[],
+ * and a map found out of date is rebuilt on the next call.
+ */
+A_UINT16
+halKeySlotFindFree(WLAN_DEV_INFO *pDev, A_UINT16 indexLimit, A_BOOL skipShared,
+                   A_BOOL tkipQuad)
+{
+    HAL_KEY_SLOTS *pSlots      = &pDev->pHalInfo->keySlots;
+    SIB_ENTRY     **keyCacheSib = pDev->keyCacheSib;
+    A_UINT32      limit, w, avail, bit, idx;
+
+    halKeySlotsCheck(pDev);
+    limit = A_MIN(indexLimit, pSlots->numSlots);
+
+    for (w = 0; w < (tkipQuad ? 1 : HAL_KEY_SLOT_WORDS); w++) {
+        avail = tkipQuad ? pSlots->quadMap : pSlots->freeMap[w];
+        avail &= halKeySlotRange(w, MAX_SHARED_KEYS, limit);
+        if (skipShared) {
+            avail &= ~(((A_UINT32)1 << MAX_SHARED_KEYS) - 1);
+        }
+        while (avail) {
+            bit = halKeySlotLowBit(avail);
+            idx = (w << 5) + bit;
+            if (keyCacheSib[idx] == NULL &&
+                (!tkipQuad || (keyCacheSib[idx + 32] == NULL &&
+                               keyCacheSib[idx + 64] == NULL &&
+                               keyCacheSib[idx + 32 + 64] == NULL)))
+            {
+                return (A_UINT16)idx;
+            }
+            /* Owned without going through halKeySlotSet */
+            pSlots->valid = FALSE;
+            avail &= ~((A_UINT32)1 << bit);
+        }
+    }
+    return HWINDEX_INVALID;
+}
+
+/**************************************************************
+ * halKeySlotTouch
+ *
+ * Moves the station holding entry hwIndex to the newest end of
+ * its LRU list, or onto the list it now belongs on.  The chips
+ * call this for the entry a station is given; the driver goes
+ * through halKeyCacheTouch.
+ */
+void
+halKeySlotTouch(WLAN_DEV_INFO *pDev, A_UINT16 hwIndex)
+{
+    HAL_KEY_SLOTS *pSlots = &pDev->pHalInfo->keySlots;
+    SIB_ENTRY     *pSib;
+
+    if (!pSlots->valid || hwIndex >= pSlots->numSlots) {
+        return;
+    }
+    pSib = pDev->keyCacheSib[hwIndex];
+    halKeySlotLruUnlink(pSlots, hwIndex);
+    if (pSib != NULL && pSib != pDev->localSta) {
+        halKeySlotLruInsert(pDev, hwIndex, halKeySlotLruOf(pSib));
+    }
+}
+
+/**************************************************************
+ * halKeySlotLruSkip
+ *
+ * The first entry from idx on along its LRU list that a victim
+ * can be taken from, or HWINDEX_INVALID.  Entries freed behind
+ * the maps' back are dropped and force a rebuild; a station
+ * whose state changed without halKeyCacheTouch is moved to the
+ * list it belongs on.  An entry that is no longer its owner's
+ * hwIndex is passed over.
+ */
+static A_UINT16
+halKeySlotLruSkip(WLAN_DEV_INFO *pDev, A_UINT32 idx)
+{
+    HAL_KEY_SLOTS *pSlots = &pDev->pHalInfo->keySlots;
+    SIB_ENTRY     *pSib;
+    A_UINT32      next;
+
+    while (idx != HAL_KEY_SLOT_NONE) {
+        next = pSlots->lruNext[idx];
+        pSib = pDev->keyCacheSib[idx];
+        if (pSib == NULL) {
+            halKeySlotLruUnlink(pSlots, idx);
+            pSlots->valid = FALSE;
+        } else if (halKeySlotLruOf(pSib) != pSlots->lruList[idx]) {
+            halKeySlotLruUnlink(pSlots, idx);
+            halKeySlotLruInsert(pDev, idx, halKeySlotLruOf(pSib));
+        } else if (pSib->hwIndex == idx) {
+            return (A_UINT16)idx;
+        }
+        idx = next;
+    }
+    return HWINDEX_INVALID;
+}
+
+/**************************************************************
+ * halKeySlotLruFirst
+ *
+ * The least recently active station on LRU list list - 0 for
+ * stations neither authenticated nor associated, 1 for the rest -
+ * as the entry it holds, or HWINDEX_INVALID.  With
+ * halKeySlotLruNext this gives the chips' allocators their
+ * victims in the order their scans preferred them, so the first
+ * that qualifies is the one to steal.
+ */
+A_UINT16
+halKeySlotLruFirst(WLAN_DEV_INFO *pDev, A_UINT32 list)
+{
+    halKeySlotsCheck(pDev);
+
+    return halKeySlotLruSkip(pDev, pDev->pHalInfo->keySlots.lruHead[list]);
+}
+
+/**************************************************************
+ * halKeySlotLruNext
+ *
+ * The station after the one at hwIndex on its LRU list
+ */
+A_UINT16
+halKeySlotLruNext(WLAN_DEV_INFO *pDev, A_UINT16 hwIndex)
+{
+    return halKeySlotLruSkip(pDev, pDev->pHalInfo->keySlots.lruNext[hwIndex]);
+}
+
 /**************************************************************
  * halSetDecompMask
  *
@@ -0,0 +1,46 @@
+/*
+ * Copyright  2004 Atheros Communications, Inc.,  All Rights Reserved.
+ *
+ * Key cache slot maps (HAL_KEY_SLOTS in hal.h), shared by the chips'
+ * key cache allocators.  Every keyCacheSib[] change goes through
+ * halKeySlotSet so that a free entry, or a free TKIP group, is found
+ * without walking the key cache.  When nothing is free the victim
+ * comes off the LRU lists, which halKeySlotTouch and the driver's
+ * halKeyCacheTouch calls keep in activity order.  Pending frames
+ * change too often to be tracked, so the allocators pass over busy
+ * stations as they walk.
+ *
+ * $Id: //depot/sw/branches/AV_dev/src/hal/halKeyCache.h#1 $
+ */
+
+#ifndef _HAL_KEY_CACHE_H_
+#define _HAL_KEY_CACHE_H_
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+
+void
+halKeySlotsSync(WLAN_DEV_INFO *pDev);
+
+void
+halKeySlotSet(WLAN_DEV_INFO *pDev, A_UINT16 hwIndex, SIB_ENTRY *pSib);
+
+A_UINT16
+halKeySlotFindFree(WLAN_DEV_INFO *pDev, A_UINT16 indexLimit, A_BOOL skipShared,
+                   A_BOOL tkipQuad);
+
+void
+halKeySlotTouch(WLAN_DEV_INFO *pDev, A_UINT16 hwIndex);
+
+A_UINT16
+halKeySlotLruFirst(WLAN_DEV_INFO *pDev, A_UINT32 list);
+
+A_UINT16
+halKeySlotLruNext(WLAN_DEV_INFO *pDev, A_UINT16 hwIndex);
+
+#ifdef _cplusplus
+}
+#endif
+
+#endif /* _HAL_KEY_CACHE_H_ */
@@ -10,6 +10,18 @@
 #include "halApi.h"
 #include "hal.h"
 #include "ui.h"
+#ifdef HAL_REG_CACHE
+#include "halRegCache.h"
+#endif
+#ifdef HAL_RESET_RECIPE
+#include "halResetRecipe.h"
+#endif
+#ifdef HAL_TXPOWER_CACHE
+#include "halTxPowerCache.h"
+#endif
+#ifdef HAL_RESET_PROFILE
+#include "halResetProfile.h"
+#endif
 
 /**************************************************************
  * halGetCapability
@@ -554,3 +566,197 @@ halSendXrChirp(WLAN_DEV_INFO *pDev)
         pDev->pHwFunc->hwSendXrChirp(pDev);
     }
 }
+
+/**************************************************************
+ * halSetWritePacing
+ *
+ * Changes how the reset register write lists are paced.
+ */
+void
+halSetWritePacing(WLAN_DEV_INFO *pDev, const HAL_WRITE_PACING *pPacing)
+{
+    ASSERT(pDev && pDev->pHalInfo && pPacing);
+    ASSERT(pPacing->policy <= HAL_WRITE_PACE_FLUSH);
+
+    pDev->pHalInfo->writePacing    = *pPacing;
+    pDev->pHalInfo->writePaceCount = 0;
+}
+
+void
+halGetWritePacing(WLAN_DEV_INFO *pDev, HAL_WRITE_PACING *pPacing)
+{
+    ASSERT(pDev && pDev->pHalInfo && pPacing);
+
+    *pPacing = pDev->pHalInfo->writePacing;
+}
+
+/**************************************************************
+ * halGetWriteStats
+ *
+ * Returns the write list counters, optionally clearing them.
+ */
+void
+halGetWriteStats(WLAN_DEV_INFO *pDev, HAL_WRITE_STATS *pStats, A_BOOL clear)
+{
+    ASSERT(pDev && pDev->pHalInfo && pStats);
+
+    *pStats = pDev->pHalInfo->writeStats;
+    if (clear) {
+        A_MEM_ZERO(&pDev->pHalInfo->writeStats, sizeof(HAL_WRITE_STATS));
+    }
+}
+
+/**************************************************************
+ * halSetFastChannelChange
+ *
+ * Lets channel changes within a band skip the chip reset and
+ * write only the init table rows that differ from those loaded.
+ * Off by default; devices without delta lists ignore it.
+ */
+void
+halSetFastChannelChange(WLAN_DEV_INFO *pDev, A_BOOL enable)
+{
+    ASSERT(pDev && pDev->pHalInfo);
+
+    pDev->pHalInfo->fastChanChange = enable;
+}
+#ifdef HAL_REG_CACHE
+/**************************************************************
+ * halGetRegCacheStats
+ *
+ * Returns the shadow register cache counters, optionally
+ * clearing them.
+ */
+A_STATUS
+halGetRegCacheStats(WLAN_DEV_INFO *pDev, HAL_REG_CACHE_STATS *pStats, A_BOOL clear)
+{
+    ASSERT(pDev && pDev->pHalInfo && pStats);
+
+    if (pDev->pHalInfo->pRegCache == NULL) {
+        A_MEM_ZERO(pStats, sizeof(*pStats));
+        return A_ENOTSUP;
+    }
+
+    halRegCacheGetStats(pDev->pHalInfo->pRegCache, pStats, clear);
+    return A_OK;
+}
+#endif /* HAL_REG_CACHE */
+
+#ifdef HAL_RESET_RECIPE
+/**************************************************************
+ * halGetResetRecipeStats
+ *
+ * Returns the reset recipe cache counters, optionally clearing
+ * them.
+ */
+A_STATUS
+halGetResetRecipeStats(WLAN_DEV_INFO *pDev, HAL_RESET_RECIPE_STATS *pStats, A_BOOL clear)
+{
+    ASSERT(pDev && pDev->pHalInfo && pStats);
+
+    if (pDev->pHalInfo->pResetRecipes == NULL) {
+        A_MEM_ZERO(pStats, sizeof(*pStats));
+        return A_ENOTSUP;
+    }
+
+    halResetRecipeGetStats(pDev->pHalInfo->pResetRecipes, pStats, clear);
+    return A_OK;
+}
+
+/**************************************************************
+ * halFlushResetRecipes
+ *
+ * Forces the next reset on every channel to recompute its
+ * programming.  Needed after changing configuration the recipes
+ * are not keyed on, e.g. the EAR.
+ */
+void
+halFlushResetRecipes(WLAN_DEV_INFO *pDev)
+{
+    ASSERT(pDev && pDev->pHalInfo);
+
+    halResetRecipeFlush(pDev);
+}
+#endif /* HAL_RESET_RECIPE */
+
+#ifdef HAL_TXPOWER_CACHE
+/**************************************************************
+ * halGetTxPowerCacheStats
+ *
+ * Returns the transmit power table cache counters, optionally
+ * clearing them.
+ */
+A_STATUS
+halGetTxPowerCacheStats(WLAN_DEV_INFO *pDev, HAL_TXPOWER_CACHE_STATS *pStats, A_BOOL clear)
+{
+    ASSERT(pDev && pDev->pHalInfo && pStats);
+
+    if (pDev->pHalInfo->pTxPowerCache == NULL) {
+        A_MEM_ZERO(pStats, sizeof(*pStats));
+        return A_ENOTSUP;
+    }
+
+    halTxPowerCacheGetStats(pDev->pHalInfo->pTxPowerCache, pStats, clear);
+    return A_OK;
+}
+
+/**************************************************************
+ * halFlushTxPowerCache
+ *
+ * Forces the transmit power tables to be recomputed, e.g. after
+ * the calibration data or regulatory tables change.
+ */
+void
+halFlushTxPowerCache(WLAN_DEV_INFO *pDev)
+{
+    ASSERT(pDev && pDev->pHalInfo);
+
+    halTxPowerCacheFlush(pDev);
+}
+#endif /* HAL_TXPOWER_CACHE */
+
+#ifdef HAL_RESET_PROFILE
+/**************************************************************
+ * halGetResetProfile
+ *
+ * Returns count, min, average, 99th percentile and max latency
+ * of each reset phase, optionally clearing the histograms.
+ */
+A_STATUS
+halGetResetProfile(WLAN_DEV_INFO *pDev, HAL_RESET_PHASE_STATS pStats[HAL_RESET_PHASE_COUNT],
+                   A_BOOL clear)
+{
+    ASSERT(pDev && pDev->pHalInfo && pStats);
+
+    if (pDev->pHalInfo->pResetProfile == NULL) {
+        A_MEM_ZERO(pStats, HAL_RESET_PHASE_COUNT * sizeof(HAL_RESET_PHASE_STATS));
+        return A_ENOTSUP;
+    }
+
+    halResetProfileGet(pDev->pHalInfo->pResetProfile, pStats, clear);
+    return A_OK;
+}
+#endif /* HAL_RESET_PROFILE */
+
+#ifdef HAL_CAL_IMAGE
+/**************************************************************
+ * halGetCalImage
+ *
+ * Returns the calibration image built when the device read its
+ * EEPROM at attach, for the OS layer to keep and hand back to
+ * halAttachWithCalImage on the next boot.  There is none if the
+ * attach used an image already, or for devices without support.
+ */
+A_STATUS
+halGetCalImage(WLAN_DEV_INFO *pDev, const void **ppImage, A_UINT32 *pSize)
+{
+    ASSERT(pDev && pDev->pHalInfo && ppImage && pSize);
+
+    if (pDev->pHalInfo->pCalImage == NULL) {
+        return A_ENOTSUP;
+    }
+    *ppImage = pDev->pHalInfo->pCalImage;
+    *pSize   = pDev->pHalInfo->calImageSize;
+    return A_OK;
+}
+#endif /* HAL_CAL_IMAGE */
@@ -0,0 +1,260 @@
+/*
+ *  Copyright (c) 2004 Atheros Communications, Inc., All Rights Reserved
+ *
+ *  Per-device shadow register cache.  The device attach code supplies a
+ *  sorted table of register ranges and their attributes; only ranges
+ *  marked HAL_REG_CACHEABLE get shadow storage.
+ */
+
+#ident "$Id: //depot/sw/branches/AV_dev/src/hal/halRegCache.c#1 $"
+
+#ifdef HAL_REG_CACHE
+
+#include "wlantype.h"
+#include "wlandrv.h"
+#include "halApi.h"
+#include "hal.h"
+#include "ui.h"
+#include "halRegCache.h"
+
+struct halRegCache {
+    const HAL_REG_CACHE_ATTR *pAttr;        /* Sorted attribute table */
+    A_UINT32            numAttr;
+    A_UINT32            *pSlotBase;         /* First shadow slot of each range */
+    A_UINT32            *pValue;            /* Shadow values */
+    A_UINT32            *pValid;            /* One valid bit per shadow slot */
+    A_UINT32            numSlots;
+    A_UINT32            allocSize;          /* Size of this structure + storage */
+    HAL_REG_CACHE_STATS stats;
+};
+
+#define REG_SLOT_VALID(pC, s)   ((pC)->pValid[(s) >> 5] & (1 << ((s) & 31)))
+#define REG_SLOT_SET(pC, s)     ((pC)->pValid[(s) >> 5] |= (1 << ((s) & 31)))
+#define REG_SLOT_CLR(pC, s)     ((pC)->pValid[(s) >> 5] &= ~(1 << ((s) & 31)))
+
+/**************************************************************
+ * halRegCacheLookup
+ *
+ * Binary search of the attribute table.  Returns the matching
+ * entry or NULL for an uncovered (volatile) register.
+ */
+static const HAL_REG_CACHE_ATTR *
+halRegCacheLookup(struct halRegCache *pCache, A_UINT32 reg, A_UINT32 *pSlot)
+{
+    const HAL_REG_CACHE_ATTR *pAttr = pCache->pAttr;
+    A_INT32                  lo = 0;
+    A_INT32                  hi = (A_INT32)pCache->numAttr - 1;
+    A_INT32                  mid;
+
+    while (lo <= hi) {
+        mid = (lo + hi) >> 1;
+        if (reg < pAttr[mid].startReg) {
+            hi = mid - 1;
+        } else if (reg > pAttr[mid].endReg) {
+            lo = mid + 1;
+        } else {
+            if (pSlot) {
+                *pSlot = pCache->pSlotBase[mid] + ((reg - pAttr[mid].startReg) >> 2);
+            }
+            return &pAttr[mid];
+        }
+    }
+    return NULL;
+}
+
+/**************************************************************
+ * halRegCacheAttach
+ *
+ * Allocates the shadow storage for the given attribute table.
+ * All entries start out invalid, so the first access of every
+ * register goes to the chip.
+ */
+A_STATUS
+halRegCacheAttach(WLAN_DEV_INFO *pDev, const HAL_REG_CACHE_ATTR *pAttr, A_UINT32 numAttr)
+{
+    struct halRegCache *pCache;
+    A_UINT32           numSlots = 0;
+    A_UINT32           size;
+    A_UINT32           i;
+
+    ASSERT(pDev && pDev->pHalInfo && pAttr);
+
+    for (i = 0; i < numAttr; i++) {
+        ASSERT(pAttr[i].startReg <= pAttr[i].endReg);
+        ASSERT(i == 0 || pAttr[i].startReg > pAttr[i - 1].endReg);
+        if (pAttr[i].flags & HAL_REG_CACHEABLE) {
+            numSlots += ((pAttr[i].endReg - pAttr[i].startReg) >> 2) + 1;
+        }
+    }
+
+    size = sizeof(*pCache) + numAttr * sizeof(A_UINT32) +
+           numSlots * sizeof(A_UINT32) + ((numSlots + 31) >> 5) * sizeof(A_UINT32);
+
+    pCache = (struct halRegCache *)A_DRIVER_MALLOC(size);
+    if (pCache == NULL) {
+        uiPrintf("halRegCacheAttach: Could not allocate %d bytes for register cache\n", size);
+        return A_NO_MEMORY;
+    }
+    A_MEM_ZERO(pCache, size);
+
+    pCache->pAttr     = pAttr;
+    pCache->numAttr   = numAttr;
+    pCache->pSlotBase = (A_UINT32 *)(pCache + 1);
+    pCache->pValue    = pCache->pSlotBase + numAttr;
+    pCache->pValid    = pCache->pValue + numSlots;
+    pCache->numSlots  = numSlots;
+    pCache->allocSize = size;
+
+    for (i = 0, numSlots = 0; i < numAttr; i++) {
+        pCache->pSlotBase[i] = numSlots;
+        if (pAttr[i].flags & HAL_REG_CACHEABLE) {
+            numSlots += ((pAttr[i].endReg - pAttr[i].startReg) >> 2) + 1;
+        }
+    }
+
+    pDev->pHalInfo->pRegCache = pCache;
+    return A_OK;
+}
+
+/**************************************************************
+ * halRegCacheDetach
+ */
+void
+halRegCacheDetach(WLAN_DEV_INFO *pDev)
+{
+    struct halRegCache *pCache;
+
+    ASSERT(pDev && pDev->pHalInfo);
+
+    pCache = pDev->pHalInfo->pRegCache;
+    if (pCache) {
+        pDev->pHalInfo->pRegCache = NULL;
+        A_DRIVER_FREE(pCache, pCache->allocSize);
+    }
+}
+
+/**************************************************************
+ * halRegCacheInvalidate
+ *
+ * Forget every shadowed value - must be called whenever the
+ * chip returns its registers to their defaults (reset).
+ */
+void
+halRegCacheInvalidate(WLAN_DEV_INFO *pDev)
+{
+    struct halRegCache *pCache;
+
+    ASSERT(pDev && pDev->pHalInfo);
+
+    pCache = pDev->pHalInfo->pRegCache;
+    if (pCache) {
+        A_MEM_ZERO(pCache->pValid, ((pCache->numSlots + 31) >> 5) * sizeof(A_UINT32));
+        pCache->stats.invalidates++;
+    }
+}
+
+/**************************************************************
+ * halRegCacheRead
+ *
+ * Returns TRUE and the shadowed value if the register read can
+ * be satisfied without going to the chip.
+ */
+A_BOOL
+halRegCacheRead(struct halRegCache *pCache, A_UINT32 reg, A_UINT32 *pVal)
+{
+    const HAL_REG_CACHE_ATTR *pAttr;
+    A_UINT32                 slot;
+
+    pCache->stats.reads++;
+
+    pAttr = halRegCacheLookup(pCache, reg, &slot);
+    if (pAttr && (pAttr->flags & HAL_REG_CACHEABLE) && REG_SLOT_VALID(pCache, slot)) {
+        *pVal = pCache->pValue[slot];
+        pCache->stats.readsCached++;
+        return TRUE;
+    }
+    return FALSE;
+}
+
+/**************************************************************
+ * halRegCacheFill
+ *
+ * Records a value just read from the chip.
+ */
+void
+halRegCacheFill(struct halRegCache *pCache, A_UINT32 reg, A_UINT32 val)
+{
+    const HAL_REG_CACHE_ATTR *pAttr;
+    A_UINT32                 slot;
+
+    pAttr = halRegCacheLookup(pCache, reg, &slot);
+    if (pAttr && (pAttr->flags & HAL_REG_CACHEABLE)) {
+        pCache->pValue[slot] = val;
+        REG_SLOT_SET(pCache, slot);
+    }
+}
+
+/**************************************************************
+ * halRegCacheWrite
+ *
+ * Updates the shadow for a register write.  Returns TRUE if the
+ * register already holds val and the write may be skipped.
+ */
+A_BOOL
+halRegCacheWrite(struct halRegCache *pCache, A_UINT32 reg, A_UINT32 val)
+{
+    const HAL_REG_CACHE_ATTR *pAttr;
+    const HAL_REG_CACHE_ATTR *pAlias;
+    A_UINT32                 slot;
+    int                      i;
+
+    pCache->stats.writes++;
+
+    pAttr = halRegCacheLookup(pCache, reg, &slot);
+    if (pAttr == NULL) {
+        return FALSE;
+    }
+
+    if (pAttr->flags & HAL_REG_BROADCAST) {
+        /* The write lands in every alias - drop whatever we knew about them */
+        for (i = 0; i < 2; i++) {
+            if (pAttr->aliasOffset[i] == 0) {
+                continue;
+            }
+            pAlias = halRegCacheLookup(pCache, reg - pAttr->aliasOffset[i], &slot);
+            if (pAlias && (pAlias->flags & HAL_REG_CACHEABLE)) {
+                REG_SLOT_CLR(pCache, slot);
+            }
+        }
+        return FALSE;
+    }
+
+    if (!(pAttr->flags & HAL_REG_CACHEABLE)) {
+        return FALSE;
+    }
+
+    if (!(pAttr->flags & HAL_REG_WRITE_EFFECT) &&
+        REG_SLOT_VALID(pCache, slot) && pCache->pValue[slot] == val)
+    {
+        pCache->stats.writesSkipped++;
+        return TRUE;
+    }
+
+    pCache->pValue[slot] = val;
+    REG_SLOT_SET(pCache, slot);
+    return FALSE;
+}
+
+/**************************************************************
+ * halRegCacheGetStats
+ */
+void
+halRegCacheGetStats(struct halRegCache *pCache, HAL_REG_CACHE_STATS *pStats, A_BOOL clear)
+{
+    *pStats = pCache->stats;
+    if (clear) {
+        A_MEM_ZERO(&pCache->stats, sizeof(pCache->stats));
+    }
+}
+
+#endif /* HAL_REG_CACHE */
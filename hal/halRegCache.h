@@ -0,0 +1,63 @@
+/*
+ * Copyright  2004 Atheros Communications, Inc.,  All Rights Reserved.
+ *
+ * Per-device shadow register cache.  Keeps the last value written to
+ * (or read from) the registers a device marks as cacheable so that
+ * writes which would not change the register can be dropped.
+ *
+ * $Id: //depot/sw/branches/AV_dev/src/hal/halRegCache.h#1 $
+ */
+
+#ifndef _HAL_REG_CACHE_H_
+#define _HAL_REG_CACHE_H_
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+
+/* Register attribute flags */
+#define HAL_REG_VOLATILE        0x00    /* Always go to the chip */
+#define HAL_REG_CACHEABLE       0x01    /* Value only changes when we write it */
+#define HAL_REG_WRITE_EFFECT    0x02    /* Write has a side effect - never skip it */
+#define HAL_REG_BROADCAST       0x04    /* Write lands in the aliased registers */
+
+/*
+ * One entry per contiguous range of registers sharing the same
+ * attributes.  Tables must be sorted by startReg and not overlap.
+ * Registers not covered by any range are treated as volatile.
+ */
+typedef struct halRegCacheAttr {
+    A_UINT32    startReg;
+    A_UINT32    endReg;                 /* inclusive */
+    A_UINT32    flags;
+    A_UINT32    aliasOffset[2];         /* HAL_REG_BROADCAST: reg - offset is an alias */
+} HAL_REG_CACHE_ATTR;
+
+struct halRegCache;
+
+A_STATUS
+halRegCacheAttach(WLAN_DEV_INFO *pDev, const HAL_REG_CACHE_ATTR *pAttr, A_UINT32 numAttr);
+
+void
+halRegCacheDetach(WLAN_DEV_INFO *pDev);
+
+void
+halRegCacheInvalidate(WLAN_DEV_INFO *pDev);
+
+A_BOOL
+halRegCacheRead(struct halRegCache *pCache, A_UINT32 reg, A_UINT32 *pVal);
+
+void
+halRegCacheFill(struct halRegCache *pCache, A_UINT32 reg, A_UINT32 val);
+
+A_BOOL
+halRegCacheWrite(struct halRegCache *pCache, A_UINT32 reg, A_UINT32 val);
+
+void
+halRegCacheGetStats(struct halRegCache *pCache, HAL_REG_CACHE_STATS *pStats, A_BOOL clear);
+
+#ifdef _cplusplus
+}
+#endif
+
+#endif /* _HAL_REG_CACHE_H_ */
@@ -0,0 +1,225 @@
+/*
+ *  Copyright (c) 2004 Atheros Communications, Inc., All Rights Reserved
+ *
+ *  Register access hooks - everything the HAL writes to or reads from
+ *  the chip passes through here when HAL_REG_IO_HOOKS is set.
+ */
+
+#ident "$Id: //depot/sw/branches/AV_dev/src/hal/halRegIo.c#1 $"
+
+#define HAL_REG_IO_RAW          /* Use the real platform accessors below */
+
+#include "wlantype.h"
+#include "wlandrv.h"
+#include "halApi.h"
+#include "hal.h"
+#include "ui.h"
+#ifdef HAL_REG_CACHE
+#include "halRegCache.h"
+#endif
+#ifdef HAL_REG_PROFILE
+#include "halRegProfile.h"
+#endif
+#ifdef HAL_REG_TRACE
+#include "halRegTrace.h"
+#endif
+#ifdef HAL_RESET_RECIPE
+#include "halResetRecipe.h"
+#endif
+#ifdef AR5513_SIM
+#include "ar5513/ar5513Sim.h"
+
+/* No chip behind the platform accessors - use the simulator */
+#undef readPlatformReg
+#undef writePlatformReg
+#define readPlatformReg(pDev, reg)          ar5513SimRead((pDev), (reg))
+#define writePlatformReg(pDev, reg, val)    ar5513SimWrite((pDev), (reg), (val))
+#endif
+
+/**************************************************************
+ * halRegIoCycles
+ *
+ * Free running cycle counter used to time each access, resets and
+ * key cache batches.  Platforms without one of the counters below
+ * get no timing, only counts.
+ */
+A_UINT32
+halRegIoCycles(void)
+{
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+    A_UINT32 lo, hi;
+
+    __asm__ __volatile__("rdtsc" : "=a" (lo), "=d" (hi));
+    return lo;
+#elif defined(__GNUC__) && defined(__mips__)
+    A_UINT32 count;
+
+    /* CP0 Count - ticks at half the pipeline clock */
+    __asm__ __volatile__("mfc0 %0, $9" : "=r" (count));
+    return count;
+#else
+    return 0;
+#endif
+}
+
+#ifdef HAL_REG_IO_HOOKS
+
+#ifdef HAL_REG_IO_TIMED
+/**************************************************************
+ * halRegIoEnter
+ *
+ * Tag the following register accesses with pFn.  Returns the tag
+ * it replaces for halRegIoExit.
+ */
+const char *
+halRegIoEnter(WLAN_DEV_INFO *pDev, const char *pFn)
+{
+    const char *pCallerFn = NULL;
+
+    if (pDev->pHalInfo) {
+        pCallerFn = pDev->pHalInfo->pRegIoFn;
+        pDev->pHalInfo->pRegIoFn = pFn;
+    }
+    return pCallerFn;
+}
+
+/**************************************************************
+ * halRegIoExit
+ *
+ * Put back the tag halRegIoEnter replaced
+ */
+void
+halRegIoExit(WLAN_DEV_INFO *pDev, const char *pCallerFn)
+{
+    if (pDev->pHalInfo) {
+        pDev->pHalInfo->pRegIoFn = pCallerFn;
+    }
+}
+
+/**************************************************************
+ * halRegIoDone
+ *
+ * Hands a completed chip access to the profiler and tracer
+ */
+static INLINE void
+halRegIoDone(WLAN_DEV_INFO *pDev, A_UINT32 reg, A_UINT32 val, A_BOOL isWrite, A_UINT32 start)
+{
+    if (pDev->pHalInfo == NULL) {
+        return;
+    }
+#ifdef HAL_REG_PROFILE
+    halRegProfileRecord(pDev, reg, isWrite, halRegIoCycles() - start);
+#endif
+#ifdef HAL_REG_TRACE
+    halRegTraceRecord(pDev, reg, val, isWrite, start);
+#endif
+}
+#endif /* HAL_REG_IO_TIMED */
+
+/**************************************************************
+ * halRegIoRead
+ *
+ * Returns the shadowed value for cacheable registers, otherwise
+ * reads the chip.
+ */
+A_UINT32
+halRegIoRead(WLAN_DEV_INFO *pDev, A_UINT32 reg)
+{
+    A_UINT32 val;
+#ifdef HAL_REG_IO_TIMED
+    A_UINT32 start;
+#endif
+#ifdef HAL_REG_CACHE
+    /* pHalInfo does not exist yet while probing the device id */
+    struct halRegCache *pCache = pDev->pHalInfo ? pDev->pHalInfo->pRegCache : NULL;
+
+    if (pCache && halRegCacheRead(pCache, reg, &val)) {
+        goto readDone;
+    }
+#endif
+
+#ifdef HAL_REG_IO_TIMED
+    start = halRegIoCycles();
+    val   = readPlatformReg(pDev, reg);
+    halRegIoDone(pDev, reg, val, FALSE, start);
+#else
+    val = readPlatformReg(pDev, reg);
+#endif
+
+#ifdef HAL_REG_CACHE
+    if (pCache) {
+        halRegCacheFill(pCache, reg, val);
+    }
+readDone:
+#endif
+#ifdef HAL_RESET_RECIPE
+    /* What a recipe's read-modify-writes were computed from */
+    if (pDev->pHalInfo && pDev->pHalInfo->pResetRecipes) {
+        halResetRecipeRecordRead(pDev->pHalInfo->pResetRecipes, reg, val);
+    }
+#endif
+    return val;
+}
+
+/**************************************************************
+ * halRegIoWrite
+ *
+ * Writes the chip unless the shadow shows the register already
+ * holds val.
+ */
+void
+halRegIoWrite(WLAN_DEV_INFO *pDev, A_UINT32 reg, A_UINT32 val)
+{
+#ifdef HAL_REG_IO_TIMED
+    A_UINT32 start;
+#endif
+#ifdef HAL_REG_CACHE
+    struct halRegCache *pCache = pDev->pHalInfo ? pDev->pHalInfo->pRegCache : NULL;
+#endif
+
+#ifdef HAL_RESET_RECIPE
+    /* A recipe must hold the write even if the shadow drops it */
+    if (pDev->pHalInfo && pDev->pHalInfo->pResetRecipes) {
+        halResetRecipeRecord(pDev->pHalInfo->pResetRecipes, reg, val);
+    }
+#endif
+
+#ifdef HAL_REG_CACHE
+    if (pCache && halRegCacheWrite(pCache, reg, val)) {
+        return;
+    }
+#endif
+
+#ifdef HAL_REG_IO_TIMED
+    start = halRegIoCycles();
+    writePlatformReg(pDev, reg, val);
+    halRegIoDone(pDev, reg, val, TRUE, start);
+#else
+    writePlatformReg(pDev, reg, val);
+#endif
+}
+
+/**************************************************************
+ * halRegIoReadRaw
+ *
+ * Reads the chip, bypassing the shadow and the access hooks.
+ */
+A_UINT32
+halRegIoReadRaw(WLAN_DEV_INFO *pDev, A_UINT32 reg)
+{
+    return readPlatformReg(pDev, reg);
+}
+
+/**************************************************************
+ * halRegIoWriteRaw
+ *
+ * Writes the chip unconditionally, bypassing the shadow and the
+ * access hooks.  The caller must invalidate the shadow after.
+ */
+void
+halRegIoWriteRaw(WLAN_DEV_INFO *pDev, A_UINT32 reg, A_UINT32 val)
+{
+    writePlatformReg(pDev, reg, val);
+}
+
+#endif /* HAL_REG_IO_HOOKS */
@@ -0,0 +1,83 @@
+/*
+ * Copyright  2004 Atheros Communications, Inc.,  All Rights Reserved.
+ *
+ * Hooks the HAL register accessors.  When a register I/O feature is
+ * built in, readPlatformReg/writePlatformReg (and so A_REG_RD/A_REG_WR
+ * and friends) are routed through halRegIoRead/halRegIoWrite, which
+ * call the real platform accessors.  HAL_REG_CACHE, HAL_REG_PROFILE,
+ * HAL_REG_TRACE and HAL_RESET_RECIPE are such features; with AR5513_SIM
+ * the "real" accessors are the host register simulator.  Files
+ * implementing the hooks define HAL_REG_IO_RAW before including hal.h
+ * to see the originals.
+ *
+ * $Id: //depot/sw/branches/AV_dev/src/hal/halRegIo.h#1 $
+ */
+
+#ifndef _HAL_REG_IO_H_
+#define _HAL_REG_IO_H_
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+
+#if defined(HAL_REG_PROFILE) || defined(HAL_REG_TRACE)
+#define HAL_REG_IO_TIMED                /* Accesses are timed and tagged */
+#endif
+
+#if defined(HAL_REG_CACHE) || defined(HAL_REG_IO_TIMED) || defined(HAL_RESET_RECIPE) || \
+    defined(AR5513_SIM)
+#define HAL_REG_IO_HOOKS
+#endif
+
+A_UINT32
+halRegIoCycles(void);
+
+/*
+ * HAL_REG_PROFILE_FN(pDev, fn) - the last declaration of a HAL entry
+ * point; tags the register accesses that follow with fn.
+ * HAL_REG_PROFILE_EXIT(pDev) - before every return of that function;
+ * gives the caller's tag back, so accesses made after it are not
+ * charged to fn.  Accesses outside any tagged function are "-".
+ */
+#ifdef HAL_REG_IO_TIMED
+const char *
+halRegIoEnter(WLAN_DEV_INFO *pDev, const char *pFn);
+
+void
+halRegIoExit(WLAN_DEV_INFO *pDev, const char *pCallerFn);
+
+#define HAL_REG_PROFILE_FN(pDev, fn)    const char *halRegIoCallerFn = halRegIoEnter((pDev), #fn)
+#define HAL_REG_PROFILE_EXIT(pDev)      halRegIoExit((pDev), halRegIoCallerFn)
+#else
+#define HAL_REG_PROFILE_FN(pDev, fn)
+#define HAL_REG_PROFILE_EXIT(pDev)
+#endif
+
+#ifdef HAL_REG_IO_HOOKS
+
+A_UINT32
+halRegIoRead(WLAN_DEV_INFO *pDev, A_UINT32 reg);
+
+void
+halRegIoWrite(WLAN_DEV_INFO *pDev, A_UINT32 reg, A_UINT32 val);
+
+A_UINT32
+halRegIoReadRaw(WLAN_DEV_INFO *pDev, A_UINT32 reg);
+
+void
+halRegIoWriteRaw(WLAN_DEV_INFO *pDev, A_UINT32 reg, A_UINT32 val);
+
+#ifndef HAL_REG_IO_RAW
+#undef readPlatformReg
+#undef writePlatformReg
+#define readPlatformReg(pDev, reg)          halRegIoRead((pDev), (reg))
+#define writePlatformReg(pDev, reg, val)    halRegIoWrite((pDev), (reg), (val))
+#endif /* HAL_REG_IO_RAW */
+
+#endif /* HAL_REG_IO_HOOKS */
+
+#ifdef _cplusplus
+}
+#endif
+
+#endif /* _HAL_REG_IO_H_ */
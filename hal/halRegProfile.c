@@ -0,0 +1,272 @@
+/*
+ *  Copyright (c) 2004 Atheros Communications, Inc., All Rights Reserved
+ *
+ *  Register access profiler.  Every register access made through the
+ *  HAL is charged to the {register, tagged function} pair it came from
+ *  along with the cycles it took.  Functions tag themselves with
+ *  HAL_REG_PROFILE_FN() and give their caller's tag back with
+ *  HAL_REG_PROFILE_EXIT(); accesses are charged to the innermost
+ *  tagged function running (pHalInfo->pRegIoFn), or to "-".
+ */
+
+#ident "$Id: //depot/sw/branches/AV_dev/src/hal/halRegProfile.c#1 $"
+
+#ifdef HAL_REG_PROFILE
+
+#include "wlantype.h"
+#include "wlandrv.h"
+#include "halApi.h"
+#include "hal.h"
+#include "ui.h"
+#include "halRegProfile.h"
+
+#define REG_PROF_EMPTY          0xffffffff
+
+typedef struct halRegProfEntry {
+    A_UINT32    addr;
+    const char  *pFn;
+    A_UINT32    reads;
+    A_UINT32    writes;
+    A_UINT32    cyclesLo;
+    A_UINT32    cyclesHi;
+} HAL_REG_PROF_ENTRY;
+
+struct halRegProfile {
+    A_UINT32            dropped;                        /* Accesses lost - table full */
+    A_UINT32            readHist[HAL_REG_PROF_BUCKETS];
+    A_UINT32            writeHist[HAL_REG_PROF_BUCKETS];
+    HAL_REG_PROF_ENTRY  entry[HAL_REG_PROF_ENTRIES];
+};
+
+/**************************************************************
+ * halRegProfileClearAll
+ */
+static void
+halRegProfileClearAll(struct halRegProfile *pProf)
+{
+    int i;
+
+    A_MEM_ZERO(pProf, sizeof(*pProf));
+    for (i = 0; i < HAL_REG_PROF_ENTRIES; i++) {
+        pProf->entry[i].addr = REG_PROF_EMPTY;
+    }
+}
+
+/**************************************************************
+ * halRegProfileAttach
+ */
+A_STATUS
+halRegProfileAttach(WLAN_DEV_INFO *pDev)
+{
+    struct halRegProfile *pProf;
+
+    ASSERT(pDev && pDev->pHalInfo);
+
+    pProf = (struct halRegProfile *)A_DRIVER_MALLOC(sizeof(struct halRegProfile));
+    if (pProf == NULL) {
+        uiPrintf("halRegProfileAttach: Could not allocate register profile\n");
+        return A_NO_MEMORY;
+    }
+    halRegProfileClearAll(pProf);
+
+    pDev->pHalInfo->pRegProfile = pProf;
+    return A_OK;
+}
+
+/**************************************************************
+ * halRegProfileDetach
+ */
+void
+halRegProfileDetach(WLAN_DEV_INFO *pDev)
+{
+    ASSERT(pDev && pDev->pHalInfo);
+
+    if (pDev->pHalInfo->pRegProfile) {
+        A_DRIVER_FREE(pDev->pHalInfo->pRegProfile, sizeof(struct halRegProfile));
+        pDev->pHalInfo->pRegProfile = NULL;
+    }
+}
+
+/**************************************************************
+ * halRegProfileRecord
+ */
+void
+halRegProfileRecord(WLAN_DEV_INFO *pDev, A_UINT32 reg, A_BOOL isWrite, A_UINT32 cycles)
+{
+    struct halRegProfile *pProf;
+    HAL_REG_PROF_ENTRY   *pEnt;
+    const char           *pFn = pDev->pHalInfo->pRegIoFn;
+    A_UINT32             idx, probe, bucket;
+
+    if ((pProf = pDev->pHalInfo->pRegProfile) == NULL) {
+        return;
+    }
+
+    for (bucket = 0; (cycles >> bucket) > 1 && bucket < HAL_REG_PROF_BUCKETS - 1; bucket++) {
+        ;
+    }
+    if (isWrite) {
+        pProf->writeHist[bucket]++;
+    } else {
+        pProf->readHist[bucket]++;
+    }
+
+    /* Open addressed on {register, function} */
+    idx = (A_UINT32)(((unsigned long)reg >> 2) ^ ((unsigned long)pFn >> 2)) & (HAL_REG_PROF_ENTRIES - 1);
+    for (probe = 0; probe < HAL_REG_PROF_ENTRIES; probe++) {
+        pEnt = &pProf->entry[idx];
+        if (pEnt->addr == REG_PROF_EMPTY) {
+            pEnt->addr = reg;
+            pEnt->pFn  = pFn;
+            break;
+        }
+        if (pEnt->addr == reg && pEnt->pFn == pFn) {
+            break;
+        }
+        idx = (idx + 1) & (HAL_REG_PROF_ENTRIES - 1);
+    }
+    if (probe == HAL_REG_PROF_ENTRIES) {
+        pProf->dropped++;
+        return;
+    }
+
+    if (isWrite) {
+        pEnt->writes++;
+    } else {
+        pEnt->reads++;
+    }
+    pEnt->cyclesLo += cycles;
+    if (pEnt->cyclesLo < cycles) {
+        pEnt->cyclesHi++;
+    }
+}
+
+/**************************************************************
+ * halRegProfileDiv64
+ *
+ * Divides the 64 bit *pHi:*pLo by divisor in place and returns the
+ * remainder - the HAL has no 64 bit type to do it with.
+ */
+static A_UINT32
+halRegProfileDiv64(A_UINT32 *pHi, A_UINT32 *pLo, A_UINT32 divisor)
+{
+    A_UINT32 rem = 0, qHi = 0, qLo = 0, top;
+    int      i;
+
+    for (i = 63; i >= 0; i--) {
+        top = rem >> 31;
+        rem = (rem << 1) | (((i >= 32) ? (*pHi >> (i - 32)) : (*pLo >> i)) & 1);
+        if (top || rem >= divisor) {
+            rem -= divisor;
+            if (i >= 32) {
+                qHi |= (A_UINT32)1 << (i - 32);
+            } else {
+                qLo |= (A_UINT32)1 << i;
+            }
+        }
+    }
+    *pHi = qHi;
+    *pLo = qLo;
+    return rem;
+}
+
+/**************************************************************
+ * halRegProfileFormat64
+ *
+ * hi:lo in decimal
+ */
+static const char *
+halRegProfileFormat64(A_UINT32 hi, A_UINT32 lo, char *pBuf, int bufLen)
+{
+    char *p = pBuf + bufLen - 1;
+
+    *p = '\0';
+    do {
+        *--p = (char)('0' + halRegProfileDiv64(&hi, &lo, 10));
+    } while ((hi || lo) && p > pBuf);
+    return p;
+}
+
+/**************************************************************
+ * halRegProfileDump
+ *
+ * Print the maxEntries most expensive {register, function} pairs
+ * followed by the read and write cycle histograms.
+ */
+void
+halRegProfileDump(WLAN_DEV_INFO *pDev, A_UINT32 maxEntries)
+{
+    struct halRegProfile *pProf;
+    HAL_REG_PROF_ENTRY   *pEnt, *pBest;
+    A_UINT8              *pShown;
+    A_UINT32             n, i, best, avgHi, avgLo;
+    char                 cycles[24], avg[24];
+
+    ASSERT(pDev && pDev->pHalInfo);
+
+    pProf = pDev->pHalInfo->pRegProfile;
+    if (pProf == NULL) {
+        return;
+    }
+
+    pShown = (A_UINT8 *)A_DRIVER_MALLOC(HAL_REG_PROF_ENTRIES);
+    if (pShown == NULL) {
+        return;
+    }
+    A_MEM_ZERO(pShown, HAL_REG_PROF_ENTRIES);
+
+    uiPrintf("  reg   %-28s %10s %10s %10s %8s\n", "function", "reads", "writes", "cycles", "avg");
+    for (n = 0; n < maxEntries; n++) {
+        pBest = NULL;
+        best  = 0;
+        for (i = 0; i < HAL_REG_PROF_ENTRIES; i++) {
+            pEnt = &pProf->entry[i];
+            if (pEnt->addr == REG_PROF_EMPTY || pShown[i]) {
+                continue;
+            }
+            if (pBest == NULL || pEnt->cyclesHi > pBest->cyclesHi ||
+                (pEnt->cyclesHi == pBest->cyclesHi && pEnt->cyclesLo > pBest->cyclesLo))
+            {
+                pBest = pEnt;
+                best  = i;
+            }
+        }
+        if (pBest == NULL) {
+            break;
+        }
+        pShown[best] = 1;
+        avgHi = pBest->cyclesHi;
+        avgLo = pBest->cyclesLo;
+        (void)halRegProfileDiv64(&avgHi, &avgLo, pBest->reads + pBest->writes);
+        uiPrintf("0x%04x  %-28s %10u %10u %10s %8s\n", pBest->addr,
+                 pBest->pFn ? pBest->pFn : "-", pBest->reads, pBest->writes,
+                 halRegProfileFormat64(pBest->cyclesHi, pBest->cyclesLo, cycles, sizeof(cycles)),
+                 halRegProfileFormat64(avgHi, avgLo, avg, sizeof(avg)));
+    }
+    A_DRIVER_FREE(pShown, HAL_REG_PROF_ENTRIES);
+
+    uiPrintf("cycles      reads     writes\n");
+    for (i = 0; i < HAL_REG_PROF_BUCKETS; i++) {
+        if (pProf->readHist[i] || pProf->writeHist[i]) {
+            uiPrintf("<%-8u %8u %10u\n", 2 << i, pProf->readHist[i], pProf->writeHist[i]);
+        }
+    }
+    if (pProf->dropped) {
+        uiPrintf("%u accesses not recorded - profile table full\n", pProf->dropped);
+    }
+}
+
+/**************************************************************
+ * halRegProfileClear
+ */
+void
+halRegProfileClear(WLAN_DEV_INFO *pDev)
+{
+    ASSERT(pDev && pDev->pHalInfo);
+
+    if (pDev->pHalInfo->pRegProfile) {
+        halRegProfileClearAll(pDev->pHalInfo->pRegProfile);
+    }
+}
+
+#endif /* HAL_REG_PROFILE */
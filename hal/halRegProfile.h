@@ -0,0 +1,33 @@
+/*
+ * Copyright  2004 Atheros Communications, Inc.,  All Rights Reserved.
+ *
+ * Register access profiler.  Built only with HAL_REG_PROFILE; counts
+ * reads, writes and cycles per register and per tagged HAL function.
+ *
+ * $Id: //depot/sw/branches/AV_dev/src/hal/halRegProfile.h#1 $
+ */
+
+#ifndef _HAL_REG_PROFILE_H_
+#define _HAL_REG_PROFILE_H_
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+
+#define HAL_REG_PROF_ENTRIES    512     /* {register, function} pairs tracked - power of 2 */
+#define HAL_REG_PROF_BUCKETS    16      /* log2 cycle cost histogram buckets */
+
+A_STATUS
+halRegProfileAttach(WLAN_DEV_INFO *pDev);
+
+void
+halRegProfileDetach(WLAN_DEV_INFO *pDev);
+
+void
+halRegProfileRecord(WLAN_DEV_INFO *pDev, A_UINT32 reg, A_BOOL isWrite, A_UINT32 cycles);
+
+#ifdef _cplusplus
+}
+#endif
+
+#endif /* _HAL_REG_PROFILE_H_ */
@@ -0,0 +1,354 @@
+/*
+ *  Copyright (c) 2004 Atheros Communications, Inc., All Rights Reserved
+ *
+ *  Binary register access trace and replay.  Each chip access costs a
+ *  16 byte store into a ring; nothing is formatted on the fly, so the
+ *  trace does not disturb the timing it records.  The ring lives in a
+ *  self describing image (halRegTrace.h) the platform can map or write
+ *  out, and which halRegTraceReplay can drive back into the chip or the
+ *  host simulator.
+ */
+
+#ident "$Id: //depot/sw/branches/AV_dev/src/hal/halRegTrace.c#1 $"
+
+#ifdef HAL_REG_TRACE
+
+#include "wlantype.h"
+#include "wlandrv.h"
+#include "halApi.h"
+#include "hal.h"
+#include "ui.h"
+#include "halRegTrace.h"
+#ifdef HAL_REG_CACHE
+#include "halRegCache.h"
+#endif
+
+/* Orders the stores of a record before the seq store publishing it */
+#if defined(__GNUC__) && defined(__mips__)
+#define REG_TRACE_WMB()     __asm__ __volatile__("sync" : : : "memory")
+#elif defined(__GNUC__)
+#define REG_TRACE_WMB()     __sync_synchronize()
+#else
+#define REG_TRACE_WMB()
+#endif
+
+/* Takes the next record number - atomic against interrupt context */
+#if defined(__GNUC__)
+#define REG_TRACE_RESERVE(pHead)    __sync_fetch_and_add((pHead), 1)
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#define REG_TRACE_RESERVE(pHead)    ((A_UINT32)_InterlockedExchangeAdd((volatile long *)(pHead), 1))
+#else
+#define REG_TRACE_RESERVE(pHead)    ((*(pHead))++)     /* Trace from one context only */
+#endif
+
+struct halRegTrace {
+    A_BOOL              enabled;
+    A_UINT32            lastCaller;                     /* Likely caller of the next access */
+    const char          *pFn[HAL_REG_TRACE_CALLERS];    /* Tags interned so far */
+    HAL_REG_TRACE_HDR   *pHdr;                          /* Image follows this struct */
+    A_CHAR              *pNames;
+    HAL_REG_TRACE_REC   *pRing;
+};
+
+#define REG_TRACE_ALLOC_SIZE    (sizeof(struct halRegTrace) + HAL_REG_TRACE_IMAGE_SIZE)
+
+/**************************************************************
+ * halRegTraceReset
+ *
+ * Empty the ring and forget the interned callers
+ */
+static void
+halRegTraceReset(struct halRegTrace *pTrace)
+{
+    HAL_REG_TRACE_HDR *pHdr = pTrace->pHdr;
+
+    A_MEM_ZERO(pHdr, HAL_REG_TRACE_IMAGE_SIZE);
+    pHdr->magic      = HAL_REG_TRACE_MAGIC;
+    pHdr->version    = HAL_REG_TRACE_VERSION;
+    pHdr->nameOffset = sizeof(HAL_REG_TRACE_HDR);
+    pHdr->nameLen    = HAL_REG_TRACE_NAME_LEN;
+    pHdr->numCallers = 1;                               /* Untagged */
+    pHdr->ringOffset = pHdr->nameOffset + HAL_REG_TRACE_CALLERS * HAL_REG_TRACE_NAME_LEN;
+    pHdr->numRecords = HAL_REG_TRACE_RECORDS;
+
+    A_MEM_ZERO(pTrace->pFn, sizeof(pTrace->pFn));
+    pTrace->lastCaller = 0;
+}
+
+/**************************************************************
+ * halRegTraceAttach
+ *
+ * Tracing starts out disabled; see halRegTraceEnable.
+ */
+A_STATUS
+halRegTraceAttach(WLAN_DEV_INFO *pDev)
+{
+    struct halRegTrace *pTrace;
+
+    ASSERT(pDev && pDev->pHalInfo);
+
+    pTrace = (struct halRegTrace *)A_DRIVER_MALLOC(REG_TRACE_ALLOC_SIZE);
+    if (pTrace == NULL) {
+        uiPrintf("halRegTraceAttach: Could not allocate register trace\n");
+        return A_NO_MEMORY;
+    }
+    A_MEM_ZERO(pTrace, sizeof(*pTrace));
+    pTrace->pHdr   = (HAL_REG_TRACE_HDR *)(pTrace + 1);
+    pTrace->pNames = (A_CHAR *)(pTrace->pHdr + 1);
+    pTrace->pRing  = (HAL_REG_TRACE_REC *)(pTrace->pNames +
+                                           HAL_REG_TRACE_CALLERS * HAL_REG_TRACE_NAME_LEN);
+    halRegTraceReset(pTrace);
+
+    pDev->pHalInfo->pRegTrace = pTrace;
+    return A_OK;
+}
+
+/**************************************************************
+ * halRegTraceDetach
+ */
+void
+halRegTraceDetach(WLAN_DEV_INFO *pDev)
+{
+    ASSERT(pDev && pDev->pHalInfo);
+
+    if (pDev->pHalInfo->pRegTrace) {
+        A_DRIVER_FREE(pDev->pHalInfo->pRegTrace, REG_TRACE_ALLOC_SIZE);
+        pDev->pHalInfo->pRegTrace = NULL;
+    }
+}
+
+/**************************************************************
+ * halRegTraceCaller
+ *
+ * Returns the image's index for the tag pFn, adding it if new.
+ * Tags that do not fit are logged as untagged.
+ */
+static A_UINT32
+halRegTraceCaller(struct halRegTrace *pTrace, const char *pFn)
+{
+    HAL_REG_TRACE_HDR *pHdr = pTrace->pHdr;
+    A_CHAR            *pName;
+    A_UINT32          i;
+
+    if (pFn == NULL) {
+        return 0;
+    }
+    for (i = 1; i < pHdr->numCallers; i++) {
+        if (pTrace->pFn[i] == pFn) {
+            return i;
+        }
+    }
+    if (pHdr->numCallers == HAL_REG_TRACE_CALLERS) {
+        return 0;
+    }
+
+    pTrace->pFn[i] = pFn;
+    pName = pTrace->pNames + i * HAL_REG_TRACE_NAME_LEN;
+    for (i = 0; i < HAL_REG_TRACE_NAME_LEN - 1 && pFn[i]; i++) {
+        pName[i] = pFn[i];
+    }
+    return pHdr->numCallers++;
+}
+
+/**************************************************************
+ * halRegTraceRecord
+ */
+void
+halRegTraceRecord(WLAN_DEV_INFO *pDev, A_UINT32 reg, A_UINT32 val, A_BOOL isWrite, A_UINT32 timestamp)
+{
+    struct halRegTrace         *pTrace = pDev->pHalInfo->pRegTrace;
+    volatile HAL_REG_TRACE_REC *pRec;
+    const char                 *pFn;
+    A_UINT32                   n, caller;
+
+    if (pTrace == NULL || !pTrace->enabled) {
+        return;
+    }
+
+    /* pFn[] entries never change once set, so the check holds under an interrupt */
+    pFn    = pDev->pHalInfo->pRegIoFn;
+    caller = pTrace->lastCaller;
+    if (pTrace->pFn[caller] != pFn) {
+        caller = halRegTraceCaller(pTrace, pFn);
+        pTrace->lastCaller = caller;
+    }
+
+    /* The slot is ours before anything is written to it */
+    n    = REG_TRACE_RESERVE(&pTrace->pHdr->head);
+    pRec = &pTrace->pRing[n & (HAL_REG_TRACE_RECORDS - 1)];
+    pRec->seq       = 0;
+    pRec->timestamp = timestamp;
+    pRec->info      = (reg & HAL_REG_TRACE_ADDR_M) |
+                      (caller << HAL_REG_TRACE_CALLER_S) |
+                      (isWrite ? HAL_REG_TRACE_WRITE : 0);
+    pRec->value     = val;
+
+    /* Publish the record only once it is whole */
+    REG_TRACE_WMB();
+    pRec->seq = n + 1;
+}
+
+/**************************************************************
+ * halRegTraceEnable
+ *
+ * Enabling the trace restarts it with an empty ring.
+ */
+void
+halRegTraceEnable(WLAN_DEV_INFO *pDev, A_BOOL enable)
+{
+    struct halRegTrace *pTrace;
+
+    ASSERT(pDev && pDev->pHalInfo);
+
+    pTrace = pDev->pHalInfo->pRegTrace;
+    if (pTrace == NULL) {
+        return;
+    }
+    if (enable && !pTrace->enabled) {
+        halRegTraceReset(pTrace);
+    }
+    pTrace->enabled = enable;
+}
+
+/**************************************************************
+ * halRegTraceGetImage
+ *
+ * Returns the live trace image.  It keeps changing while the
+ * trace is enabled; a record is complete once its seq matches.
+ */
+A_STATUS
+halRegTraceGetImage(WLAN_DEV_INFO *pDev, const void **ppImage, A_UINT32 *pSize)
+{
+    ASSERT(pDev && pDev->pHalInfo && ppImage && pSize);
+
+    if (pDev->pHalInfo->pRegTrace == NULL) {
+        return A_ENOTSUP;
+    }
+    *ppImage = pDev->pHalInfo->pRegTrace->pHdr;
+    *pSize   = HAL_REG_TRACE_IMAGE_SIZE;
+    return A_OK;
+}
+
+/**************************************************************
+ * halRegTraceFindCaller
+ *
+ * Returns the index of the caller named pFn in the image, or
+ * numCallers if there is none.
+ */
+static A_UINT32
+halRegTraceFindCaller(const HAL_REG_TRACE_HDR *pHdr, const char *pFn)
+{
+    const A_CHAR *pName;
+    A_UINT32     i, j;
+
+    for (i = 1; i < pHdr->numCallers; i++) {
+        pName = (const A_CHAR *)pHdr + pHdr->nameOffset + i * pHdr->nameLen;
+        for (j = 0; j < pHdr->nameLen && pName[j] == pFn[j] && pFn[j]; j++) {
+            ;
+        }
+        if (j == pHdr->nameLen || pName[j] == pFn[j]) {
+            return i;
+        }
+    }
+    return pHdr->numCallers;
+}
+
+/**************************************************************
+ * halRegTraceReplay
+ *
+ * Drives the accesses captured in a trace image back to the chip,
+ * or to the simulator in an AR5513_SIM build, oldest first.  The
+ * raw accessors are used so the register cache can neither drop a
+ * write nor answer a read; it is invalidated afterwards.  With pFn set only the accesses
+ * tagged with that function (e.g. "ar5513Reset") are replayed.
+ * Reads are checked against the captured values, and the replay
+ * is timed so it can be compared with the capture.
+ */
+A_STATUS
+halRegTraceReplay(WLAN_DEV_INFO *pDev, const void *pImage, A_UINT32 size, const char *pFn,
+                  HAL_REG_TRACE_REPLAY_STATS *pStats)
+{
+    const HAL_REG_TRACE_HDR *pHdr = (const HAL_REG_TRACE_HDR *)pImage;
+    const HAL_REG_TRACE_REC *pRing, *pRec;
+    struct halRegTrace      *pTrace;
+    A_BOOL                  wasEnabled = FALSE;
+    A_UINT32                caller = 0, i, first, head, reg;
+    A_UINT32                traceStart = 0, traceEnd = 0;
+    A_UINT32                replayStart = 0, replayEnd = 0;
+
+    HAL_REG_PROFILE_FN(pDev, halRegTraceReplay);
+
+    ASSERT(pDev && pDev->pHalInfo && pStats);
+
+    if (pImage == NULL || size < sizeof(HAL_REG_TRACE_HDR) ||
+        pHdr->magic != HAL_REG_TRACE_MAGIC || pHdr->version != HAL_REG_TRACE_VERSION ||
+        pHdr->numRecords == 0 || (pHdr->numRecords & (pHdr->numRecords - 1)) ||
+        pHdr->nameOffset + pHdr->numCallers * pHdr->nameLen > pHdr->ringOffset ||
+        pHdr->ringOffset + pHdr->numRecords * sizeof(HAL_REG_TRACE_REC) > size)
+    {
+        HAL_REG_PROFILE_EXIT(pDev);
+        return A_EINVAL;
+    }
+    pRing = (const HAL_REG_TRACE_REC *)((const A_UINT8 *)pImage + pHdr->ringOffset);
+
+    if (pFn) {
+        caller = halRegTraceFindCaller(pHdr, pFn);
+        if (caller == pHdr->numCallers) {
+            HAL_REG_PROFILE_EXIT(pDev);
+            return A_EINVAL;
+        }
+    }
+
+    /* Don't trace the replay - the image may be our own ring */
+    pTrace = pDev->pHalInfo->pRegTrace;
+    if (pTrace) {
+        wasEnabled      = pTrace->enabled;
+        pTrace->enabled = FALSE;
+    }
+
+    A_MEM_ZERO(pStats, sizeof(*pStats));
+    head  = pHdr->head;
+    first = (head > pHdr->numRecords) ? head - pHdr->numRecords : 0;
+    for (i = first; i != head; i++) {
+        pRec = &pRing[i & (pHdr->numRecords - 1)];
+        if (pRec->seq != i + 1) {
+            /* Still being written, or already overwritten */
+            pStats->incomplete++;
+            continue;
+        }
+        if (pFn &&
+            ((pRec->info & HAL_REG_TRACE_CALLER_M) >> HAL_REG_TRACE_CALLER_S) != caller)
+        {
+            continue;
+        }
+        /* Time access starts, as the capture did */
+        replayEnd = halRegIoCycles();
+        traceEnd  = pRec->timestamp;
+        if (pStats->records++ == 0) {
+            replayStart = replayEnd;
+            traceStart  = traceEnd;
+        }
+
+        reg = pRec->info & HAL_REG_TRACE_ADDR_M;
+        if (pRec->info & HAL_REG_TRACE_WRITE) {
+            halRegIoWriteRaw(pDev, reg, pRec->value);
+        } else if (halRegIoReadRaw(pDev, reg) != pRec->value) {
+            pStats->readMismatches++;
+        }
+    }
+    pStats->replayCycles = replayEnd - replayStart;
+    pStats->tracedCycles = traceEnd - traceStart;
+
+#ifdef HAL_REG_CACHE
+    halRegCacheInvalidate(pDev);
+#endif
+
+    if (pTrace) {
+        pTrace->enabled = wasEnabled;
+    }
+    HAL_REG_PROFILE_EXIT(pDev);
+    return A_OK;
+}
+
+#endif /* HAL_REG_TRACE */
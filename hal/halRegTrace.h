@@ -0,0 +1,73 @@
+/*
+ * Copyright  2004 Atheros Communications, Inc.,  All Rights Reserved.
+ *
+ * Binary register access trace.  Built with HAL_REG_TRACE, every chip
+ * access is appended to a ring inside a self describing image that
+ * can be written out or mapped as is, and replayed later.
+ *
+ * $Id: //depot/sw/branches/AV_dev/src/hal/halRegTrace.h#1 $
+ */
+
+#ifndef _HAL_REG_TRACE_H_
+#define _HAL_REG_TRACE_H_
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+
+#define HAL_REG_TRACE_MAGIC         0x52545241  /* "ARTR" */
+#define HAL_REG_TRACE_VERSION       2
+#define HAL_REG_TRACE_RECORDS       16384       /* ring size - power of 2 */
+#define HAL_REG_TRACE_CALLERS       128         /* tagged functions, slot 0 is untagged */
+#define HAL_REG_TRACE_NAME_LEN      32
+
+/* HAL_REG_TRACE_REC info word */
+#define HAL_REG_TRACE_ADDR_M        0x00ffffff
+#define HAL_REG_TRACE_CALLER_M      0x7f000000
+#define HAL_REG_TRACE_CALLER_S      24
+#define HAL_REG_TRACE_WRITE         0x80000000
+
+typedef struct halRegTraceRec {
+    A_UINT32    timestamp;              /* halRegIoCycles() at the start of the access */
+    A_UINT32    info;                   /* address, caller and direction */
+    A_UINT32    value;
+    A_UINT32    seq;                    /* n + 1 once record n is complete */
+} HAL_REG_TRACE_REC;
+
+/*
+ * Image layout: this header, numCallers NUL padded names of nameLen
+ * bytes at nameOffset, then numRecords records at ringOffset.  head
+ * counts every record reserved; record n is at n modulo numRecords.
+ * A record is reserved before it is written, so an access from
+ * interrupt context gets a slot of its own; only records whose seq
+ * is n + 1 are complete.
+ */
+typedef struct halRegTraceHdr {
+    A_UINT32    magic;
+    A_UINT32    version;
+    A_UINT32    nameOffset;
+    A_UINT32    nameLen;
+    A_UINT32    numCallers;
+    A_UINT32    ringOffset;
+    A_UINT32    numRecords;
+    A_UINT32    head;
+} HAL_REG_TRACE_HDR;
+
+#define HAL_REG_TRACE_IMAGE_SIZE    (sizeof(HAL_REG_TRACE_HDR) +                        \
+                                     HAL_REG_TRACE_CALLERS * HAL_REG_TRACE_NAME_LEN +   \
+                                     HAL_REG_TRACE_RECORDS * sizeof(HAL_REG_TRACE_REC))
+
+A_STATUS
+halRegTraceAttach(WLAN_DEV_INFO *pDev);
+
+void
+halRegTraceDetach(WLAN_DEV_INFO *pDev);
+
+void
+halRegTraceRecord(WLAN_DEV_INFO *pDev, A_UINT32 reg, A_UINT32 val, A_BOOL isWrite, A_UINT32 timestamp);
+
+#ifdef _cplusplus
+}
+#endif
+
+#endif /* _HAL_REG_TRACE_H_ */
@@ -9,6 +9,7 @@
 #include "halApi.h"
 #include "hal.h"
 #include "ui.h"
+#include "halResetProfile.h"
 
 /**************************************************************
  * halPeriodicCal
@@ -26,6 +27,42 @@ halPerCalibration(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval)
     return pDev->pHwFunc->hwPerCalibration(pDev, pChval);
 }
 
+/**************************************************************
+ * halStartCalibration
+ *
+ * Starts the HAL_CAL_* calibrations in calMask and returns
+ * without waiting for them.  halCalibrationStatus collects and
+ * applies the results.
+ */
+A_STATUS
+halStartCalibration(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval, A_UINT32 calMask)
+{
+    ASSERT(pDev);
+    ASSERT(pDev->pHwFunc);
+    if (pDev->pHwFunc->hwStartCalibration == NULL) {
+        return A_ENOTSUP;
+    }
+    return pDev->pHwFunc->hwStartCalibration(pDev, pChval, calMask);
+}
+
+/**************************************************************
+ * halCalibrationStatus
+ *
+ * Applies the results of any calibrations that have completed
+ * and returns the HAL_CAL_* mask of those still in progress.
+ * Never waits on the hardware, so may be polled from a timer.
+ */
+A_UINT32
+halCalibrationStatus(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval)
+{
+    ASSERT(pDev);
+    ASSERT(pDev->pHwFunc);
+    if (pDev->pHwFunc->hwCalibrationStatus == NULL) {
+        return 0;
+    }
+    return pDev->pHwFunc->hwCalibrationStatus(pDev, pChval);
+}
+
 /**************************************************************
  * halReset
  *
@@ -40,7 +77,20 @@ halReset(WLAN_DEV_INFO *pDev, WLAN_SERVICE serviceType, CHAN_VALUES *pChval, A_B
     ASSERT(pDev);
     ASSERT(pDev->pHwFunc);
     ASSERT(pDev->pHwFunc->hwReset);
+#ifdef HAL_RESET_PROFILE
+    {
+        A_STATUS status;
+
+        HAL_RESET_PHASE_START(pDev, HAL_RESET_PHASE_TOTAL);
+        status = pDev->pHwFunc->hwReset(pDev, serviceType, pChval, bChannelChange);
+        if (status == A_OK) {
+            HAL_RESET_PHASE_END(pDev, HAL_RESET_PHASE_TOTAL);
+        }
+        return status;
+    }
+#else
     return pDev->pHwFunc->hwReset(pDev, serviceType, pChval, bChannelChange);
+#endif
 }
 
 /**************************************************************
@@ -0,0 +1,219 @@
+/*
+ *  Copyright (c) 2004 Atheros Communications, Inc., All Rights Reserved
+ *
+ *  Reset latency profile.  Each phase keeps its count, extremes, a
+ *  64 bit running sum and a log histogram with four buckets per power
+ *  of two, from which the 99th percentile is read to within 25%.
+ */
+
+#ident "$Id: //depot/sw/branches/AV_dev/src/hal/halResetProfile.c#1 $"
+
+#ifdef HAL_RESET_PROFILE
+
+#include "wlantype.h"
+#include "wlandrv.h"
+#include "halApi.h"
+#include "hal.h"
+#include "ui.h"
+#include "halResetProfile.h"
+
+typedef struct halResetPhaseHist {
+    A_UINT32    count;
+    A_UINT32    minCycles;
+    A_UINT32    maxCycles;
+    A_UINT32    sumLo;
+    A_UINT32    sumHi;
+    A_UINT32    hist[HAL_RESET_PROF_BUCKETS];
+} HAL_RESET_PHASE_HIST;
+
+struct halResetProfile {
+    A_UINT32                openMask;                       /* Phases started, not ended */
+    A_UINT32                start[HAL_RESET_PHASE_COUNT];
+    HAL_RESET_PHASE_HIST    phase[HAL_RESET_PHASE_COUNT];
+};
+
+/**************************************************************
+ * halResetProfBucket
+ *
+ * Values below 4 have a bucket each; above that the top bit
+ * picks the octave and the two bits below it the quarter.
+ */
+static A_UINT32
+halResetProfBucket(A_UINT32 cycles)
+{
+    A_UINT32 msb;
+
+    if (cycles < (1 << HAL_RESET_PROF_SUB_BITS)) {
+        return cycles;
+    }
+    for (msb = 31; (cycles >> msb) == 0; msb--) {
+        ;
+    }
+    return ((msb - HAL_RESET_PROF_SUB_BITS + 1) << HAL_RESET_PROF_SUB_BITS) |
+           ((cycles >> (msb - HAL_RESET_PROF_SUB_BITS)) & ((1 << HAL_RESET_PROF_SUB_BITS) - 1));
+}
+
+/**************************************************************
+ * halResetProfBucketTop
+ *
+ * Largest value counted in the given bucket
+ */
+static A_UINT32
+halResetProfBucketTop(A_UINT32 bucket)
+{
+    A_UINT32 shift, low;
+
+    if (bucket < (1 << HAL_RESET_PROF_SUB_BITS)) {
+        return bucket;
+    }
+    shift = (bucket >> HAL_RESET_PROF_SUB_BITS) - 1;
+    low   = ((1 << HAL_RESET_PROF_SUB_BITS) | (bucket & ((1 << HAL_RESET_PROF_SUB_BITS) - 1))) << shift;
+    return low + ((1 << shift) - 1);
+}
+
+/**************************************************************
+ * halResetProfDiv
+ *
+ * (hi:lo) / div for a quotient known to fit in 32 bits
+ */
+static A_UINT32
+halResetProfDiv(A_UINT32 hi, A_UINT32 lo, A_UINT32 div)
+{
+    A_UINT32 rem = hi, quot = 0, carry;
+    int      i;
+
+    for (i = 31; i >= 0; i--) {
+        carry = rem >> 31;
+        rem   = (rem << 1) | ((lo >> i) & 1);
+        quot <<= 1;
+        if (carry || rem >= div) {
+            rem -= div;
+            quot |= 1;
+        }
+    }
+    return quot;
+}
+
+/**************************************************************
+ * halResetProfileAttach
+ */
+A_STATUS
+halResetProfileAttach(WLAN_DEV_INFO *pDev)
+{
+    struct halResetProfile *pProf;
+
+    ASSERT(pDev && pDev->pHalInfo);
+
+    pProf = (struct halResetProfile *)A_DRIVER_MALLOC(sizeof(struct halResetProfile));
+    if (pProf == NULL) {
+        uiPrintf("halResetProfileAttach: Could not allocate reset profile\n");
+        return A_NO_MEMORY;
+    }
+    A_MEM_ZERO(pProf, sizeof(struct halResetProfile));
+
+    pDev->pHalInfo->pResetProfile = pProf;
+    return A_OK;
+}
+
+/**************************************************************
+ * halResetProfileDetach
+ */
+void
+halResetProfileDetach(WLAN_DEV_INFO *pDev)
+{
+    ASSERT(pDev && pDev->pHalInfo);
+
+    if (pDev->pHalInfo->pResetProfile) {
+        A_DRIVER_FREE(pDev->pHalInfo->pResetProfile, sizeof(struct halResetProfile));
+        pDev->pHalInfo->pResetProfile = NULL;
+    }
+}
+
+/**************************************************************
+ * halResetPhaseStart
+ */
+void
+halResetPhaseStart(WLAN_DEV_INFO *pDev, HAL_RESET_PHASE phase)
+{
+    struct halResetProfile *pProf = pDev->pHalInfo->pResetProfile;
+
+    ASSERT(phase < HAL_RESET_PHASE_COUNT);
+
+    if (pProf) {
+        pProf->openMask     |= 1 << phase;
+        pProf->start[phase]  = halRegIoCycles();
+    }
+}
+
+/**************************************************************
+ * halResetPhaseEnd
+ *
+ * Phases left open by an error return are started over by the
+ * next halResetPhaseStart and never recorded.
+ */
+void
+halResetPhaseEnd(WLAN_DEV_INFO *pDev, HAL_RESET_PHASE phase)
+{
+    struct halResetProfile *pProf = pDev->pHalInfo->pResetProfile;
+    HAL_RESET_PHASE_HIST   *pHist;
+    A_UINT32               cycles;
+
+    ASSERT(phase < HAL_RESET_PHASE_COUNT);
+
+    if (pProf == NULL || !(pProf->openMask & (1 << phase))) {
+        return;
+    }
+    cycles = halRegIoCycles() - pProf->start[phase];
+    pProf->openMask &= ~(1 << phase);
+
+    pHist = &pProf->phase[phase];
+    if (pHist->count++ == 0 || cycles < pHist->minCycles) {
+        pHist->minCycles = cycles;
+    }
+    if (cycles > pHist->maxCycles) {
+        pHist->maxCycles = cycles;
+    }
+    pHist->sumLo += cycles;
+    if (pHist->sumLo < cycles) {
+        pHist->sumHi++;
+    }
+    pHist->hist[halResetProfBucket(cycles)]++;
+}
+
+/**************************************************************
+ * halResetProfileGet
+ */
+void
+halResetProfileGet(struct halResetProfile *pProf, HAL_RESET_PHASE_STATS *pStats, A_BOOL clear)
+{
+    HAL_RESET_PHASE_HIST *pHist;
+    A_UINT32             p, b, seen, target;
+
+    for (p = 0; p < HAL_RESET_PHASE_COUNT; p++) {
+        pHist = &pProf->phase[p];
+        A_MEM_ZERO(&pStats[p], sizeof(pStats[p]));
+        if (pHist->count == 0) {
+            continue;
+        }
+        pStats[p].count     = pHist->count;
+        pStats[p].minCycles = pHist->minCycles;
+        pStats[p].maxCycles = pHist->maxCycles;
+        pStats[p].avgCycles = halResetProfDiv(pHist->sumHi, pHist->sumLo, pHist->count);
+
+        /* Smallest bucket with at least 99% of the samples at or below it */
+        target = pHist->count - pHist->count / 100;
+        for (b = 0, seen = 0; b < HAL_RESET_PROF_BUCKETS; b++) {
+            seen += pHist->hist[b];
+            if (seen >= target) {
+                break;
+            }
+        }
+        pStats[p].p99Cycles = A_MIN(halResetProfBucketTop(b), pHist->maxCycles);
+    }
+
+    if (clear) {
+        A_MEM_ZERO(pProf->phase, sizeof(pProf->phase));
+    }
+}
+
+#endif /* HAL_RESET_PROFILE */
@@ -0,0 +1,56 @@
+/*
+ * Copyright  2004 Atheros Communications, Inc.,  All Rights Reserved.
+ *
+ * Reset latency profile.  The reset paths of every chip family mark
+ * the same phases (HAL_RESET_PHASE) with HAL_RESET_PHASE_START/END;
+ * each completed phase adds its duration in halRegIoCycles() ticks to
+ * a per-device histogram.  Without HAL_RESET_PROFILE the markers
+ * compile away.
+ *
+ * $Id: //depot/sw/branches/AV_dev/src/hal/halResetProfile.h#1 $
+ */
+
+#ifndef _HAL_RESET_PROFILE_H_
+#define _HAL_RESET_PROFILE_H_
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+
+#ifdef HAL_RESET_PROFILE
+
+#define HAL_RESET_PROF_SUB_BITS     2       /* 4 histogram buckets per power of two */
+#define HAL_RESET_PROF_BUCKETS      (32 << HAL_RESET_PROF_SUB_BITS)
+
+struct halResetProfile;
+
+A_STATUS
+halResetProfileAttach(WLAN_DEV_INFO *pDev);
+
+void
+halResetProfileDetach(WLAN_DEV_INFO *pDev);
+
+void
+halResetPhaseStart(WLAN_DEV_INFO *pDev, HAL_RESET_PHASE phase);
+
+void
+halResetPhaseEnd(WLAN_DEV_INFO *pDev, HAL_RESET_PHASE phase);
+
+void
+halResetProfileGet(struct halResetProfile *pProf, HAL_RESET_PHASE_STATS *pStats, A_BOOL clear);
+
+#define HAL_RESET_PHASE_START(pDev, phase)  halResetPhaseStart((pDev), (phase))
+#define HAL_RESET_PHASE_END(pDev, phase)    halResetPhaseEnd((pDev), (phase))
+
+#else
+
+#define HAL_RESET_PHASE_START(pDev, phase)
+#define HAL_RESET_PHASE_END(pDev, phase)
+
+#endif /* HAL_RESET_PROFILE */
+
+#ifdef _cplusplus
+}
+#endif
+
+#endif /* _HAL_RESET_PROFILE_H_ */
@@ -0,0 +1,347 @@
+/*
+ *  Copyright (c) 2004 Atheros Communications, Inc., All Rights Reserved
+ *
+ *  Reset recipe cache.  While a capture is open every register write
+ *  the HAL makes is appended to a scratch list; closing the capture
+ *  stores the list with the device's state block under the given key.
+ *  Replaying a recipe writes the list back in the order captured.
+ *
+ *  A read-modify-write is captured as the value written, which holds
+ *  the bits outside its mask as they were read.  Those bits belong to
+ *  whatever else programs the register (the init tables, the EAR,
+ *  runtime settings) and may differ at the next reset.  So every
+ *  register the capture reads before writing it is kept with the value
+ *  read, and a recipe is only replayed while they all still match.
+ */
+
+#ident "$Id: //depot/sw/branches/AV_dev/src/hal/halResetRecipe.c#1 $"
+
+#ifdef HAL_RESET_RECIPE
+
+#include "wlantype.h"
+#include "wlandrv.h"
+#include "halApi.h"
+#include "hal.h"
+#include "ui.h"
+#include "halWriteList.h"
+#include "halResetRecipe.h"
+
+typedef struct halResetRecipeEntry {
+    HAL_RESET_RECIPE_KEY key;
+    HAL_WRITE_LIST      *pList;             /* Writes, then the reads, then the state block */
+    A_UINT32            numReads;
+    A_UINT32            lastUse;
+} HAL_RESET_RECIPE_ENTRY;
+
+struct halResetRecipeCache {
+    A_UINT32                stateSize;
+    A_BOOL                  capturing;
+    A_BOOL                  overflow;
+    A_UINT32                numCaptured;
+    A_UINT32                numReads;
+    A_UINT32                useCount;       /* LRU clock */
+    HAL_RESET_RECIPE_STATS  stats;
+    HAL_RESET_RECIPE_ENTRY  entry[HAL_RECIPE_ENTRIES];
+    HAL_REG_WRITE           capture[HAL_RECIPE_MAX_WRITES];
+    HAL_REG_WRITE           reads[HAL_RECIPE_MAX_READS];
+};
+
+#define RECIPE_READS(pList)         ((pList)->pWrites + (pList)->numWrites)
+#define RECIPE_STATE(pList, nReads) ((A_UINT8 *)(RECIPE_READS(pList) + (nReads)))
+
+/**************************************************************
+ * halResetRecipeKeyMatch
+ */
+static A_BOOL
+halResetRecipeKeyMatch(const HAL_RESET_RECIPE_KEY *pA, const HAL_RESET_RECIPE_KEY *pB)
+{
+    int i;
+
+    if (pA->channelFlags != pB->channelFlags || pA->channel != pB->channel ||
+        pA->powerLimit != pB->powerLimit || pA->txChainCtrl != pB->txChainCtrl ||
+        pA->rxChainCtrl != pB->rxChainCtrl)
+    {
+        return FALSE;
+    }
+    for (i = 0; i < HAL_RECIPE_CONFIG_WORDS; i++) {
+        if (pA->config[i] != pB->config[i]) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/**************************************************************
+ * halResetRecipeAttach
+ *
+ * stateSize is the size of the block the device saves with each
+ * recipe for the software state the captured code sets.
+ */
+A_STATUS
+halResetRecipeAttach(WLAN_DEV_INFO *pDev, A_UINT32 stateSize)
+{
+    struct halResetRecipeCache *pCache;
+
+    ASSERT(pDev && pDev->pHalInfo);
+
+    pCache = (struct halResetRecipeCache *)A_DRIVER_MALLOC(sizeof(struct halResetRecipeCache));
+    if (pCache == NULL) {
+        uiPrintf("halResetRecipeAttach: Could not allocate reset recipe cache\n");
+        return A_NO_MEMORY;
+    }
+    A_MEM_ZERO(pCache, sizeof(struct halResetRecipeCache));
+    pCache->stateSize = stateSize;
+
+    pDev->pHalInfo->pResetRecipes = pCache;
+    return A_OK;
+}
+
+/**************************************************************
+ * halResetRecipeDetach
+ */
+void
+halResetRecipeDetach(WLAN_DEV_INFO *pDev)
+{
+    ASSERT(pDev && pDev->pHalInfo);
+
+    if (pDev->pHalInfo->pResetRecipes) {
+        halResetRecipeFlush(pDev);
+        A_DRIVER_FREE(pDev->pHalInfo->pResetRecipes, sizeof(struct halResetRecipeCache));
+        pDev->pHalInfo->pResetRecipes = NULL;
+    }
+}
+
+/**************************************************************
+ * halResetRecipeReadsMatch
+ *
+ * Whether the registers the capture read still hold the values
+ * its read-modify-writes were computed from
+ */
+static A_BOOL
+halResetRecipeReadsMatch(WLAN_DEV_INFO *pDev, const HAL_RESET_RECIPE_ENTRY *pEnt)
+{
+    const HAL_REG_WRITE *pRead = RECIPE_READS(pEnt->pList);
+    A_UINT32            i;
+
+    for (i = 0; i < pEnt->numReads; i++) {
+        if (A_REG_RD(pDev, pRead[i].addr) != pRead[i].value) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/**************************************************************
+ * halResetRecipeReplay
+ *
+ * Writes out the recipe stored under pKey and returns its state
+ * block.  Returns NULL, having touched nothing, if there is no
+ * such recipe or a register it read has changed since; the
+ * latter recipe is dropped.
+ */
+const void *
+halResetRecipeReplay(WLAN_DEV_INFO *pDev, const HAL_RESET_RECIPE_KEY *pKey)
+{
+    struct halResetRecipeCache *pCache = pDev->pHalInfo->pResetRecipes;
+    HAL_RESET_RECIPE_ENTRY     *pEnt;
+    int                        i;
+
+    if (pCache == NULL) {
+        return NULL;
+    }
+    ASSERT(!pCache->capturing);
+
+    for (i = 0; i < HAL_RECIPE_ENTRIES; i++) {
+        pEnt = &pCache->entry[i];
+        if (pEnt->pList && halResetRecipeKeyMatch(&pEnt->key, pKey)) {
+            if (!halResetRecipeReadsMatch(pDev, pEnt)) {
+                halWriteListFree(&pEnt->pList);
+                pCache->stats.stale++;
+                break;
+            }
+            pEnt->lastUse = ++pCache->useCount;
+            pCache->stats.hits++;
+            halWriteListApply(pDev, pEnt->pList, FALSE);
+            return RECIPE_STATE(pEnt->pList, pEnt->numReads);
+        }
+    }
+    pCache->stats.misses++;
+    return NULL;
+}
+
+/**************************************************************
+ * halResetRecipeCaptureStart
+ */
+void
+halResetRecipeCaptureStart(WLAN_DEV_INFO *pDev)
+{
+    struct halResetRecipeCache *pCache = pDev->pHalInfo->pResetRecipes;
+
+    if (pCache) {
+        pCache->capturing   = TRUE;
+        pCache->overflow    = FALSE;
+        pCache->numCaptured = 0;
+        pCache->numReads    = 0;
+    }
+}
+
+/**************************************************************
+ * halResetRecipeRecord
+ *
+ * Called for every register write while hooked
+ */
+void
+halResetRecipeRecord(struct halResetRecipeCache *pCache, A_UINT32 reg, A_UINT32 val)
+{
+    if (!pCache->capturing) {
+        return;
+    }
+    if (pCache->numCaptured == HAL_RECIPE_MAX_WRITES) {
+        pCache->overflow = TRUE;
+        return;
+    }
+    pCache->capture[pCache->numCaptured].addr  = reg;
+    pCache->capture[pCache->numCaptured].value = val;
+    pCache->numCaptured++;
+}
+
+/**************************************************************
+ * halResetRecipeRecordRead
+ *
+ * Called for every register read while hooked.  Only the first
+ * read of a register the capture has not yet written is kept.
+ */
+void
+halResetRecipeRecordRead(struct halResetRecipeCache *pCache, A_UINT32 reg, A_UINT32 val)
+{
+    A_UINT32 i;
+
+    if (!pCache->capturing || pCache->overflow) {
+        return;
+    }
+    for (i = 0; i < pCache->numCaptured; i++) {
+        if (pCache->capture[i].addr == reg) {
+            return;
+        }
+    }
+    for (i = 0; i < pCache->numReads; i++) {
+        if (pCache->reads[i].addr == reg) {
+            return;
+        }
+    }
+    if (pCache->numReads == HAL_RECIPE_MAX_READS) {
+        pCache->overflow = TRUE;
+        return;
+    }
+    pCache->reads[pCache->numReads].addr  = reg;
+    pCache->reads[pCache->numReads].value = val;
+    pCache->numReads++;
+}
+
+/**************************************************************
+ * halResetRecipeCaptureEnd
+ *
+ * Closes the capture and stores it under pKey, replacing the
+ * least recently used recipe if the cache is full.  Returns the
+ * new recipe's state block for the caller to fill in, or NULL if
+ * the capture was discarded: pKey NULL, too many writes or reads,
+ * or no memory.
+ */
+void *
+halResetRecipeCaptureEnd(WLAN_DEV_INFO *pDev, const HAL_RESET_RECIPE_KEY *pKey)
+{
+    struct halResetRecipeCache *pCache = pDev->pHalInfo->pResetRecipes;
+    HAL_RESET_RECIPE_ENTRY     *pEnt;
+    HAL_WRITE_LIST             *pList;
+    A_UINT32                   size;
+    int                        i;
+
+    if (pCache == NULL || !pCache->capturing) {
+        return NULL;
+    }
+    pCache->capturing = FALSE;
+
+    if (pKey == NULL) {
+        return NULL;
+    }
+    if (pCache->overflow) {
+        pCache->stats.overflows++;
+        return NULL;
+    }
+
+    size  = sizeof(HAL_WRITE_LIST) +
+            (pCache->numCaptured + pCache->numReads) * sizeof(HAL_REG_WRITE) + pCache->stateSize;
+    pList = (HAL_WRITE_LIST *)A_DRIVER_MALLOC(size);
+    if (pList == NULL) {
+        return NULL;
+    }
+    pList->numWrites = pCache->numCaptured;
+    pList->allocSize = size;
+    pList->pWrites   = (HAL_REG_WRITE *)(pList + 1);
+    A_BCOPY(pCache->capture, pList->pWrites, pCache->numCaptured * sizeof(HAL_REG_WRITE));
+    A_BCOPY(pCache->reads, RECIPE_READS(pList), pCache->numReads * sizeof(HAL_REG_WRITE));
+
+    /* Same key (a replay was not possible), else a free slot, else the LRU one */
+    pEnt = &pCache->entry[0];
+    for (i = 0; i < HAL_RECIPE_ENTRIES; i++) {
+        if (pCache->entry[i].pList && halResetRecipeKeyMatch(&pCache->entry[i].key, pKey)) {
+            pEnt = &pCache->entry[i];
+            break;
+        }
+        if (pEnt->pList &&
+            (pCache->entry[i].pList == NULL || pCache->entry[i].lastUse < pEnt->lastUse))
+        {
+            pEnt = &pCache->entry[i];
+        }
+    }
+    if (pEnt->pList) {
+        if (i == HAL_RECIPE_ENTRIES) {
+            pCache->stats.evictions++;
+        }
+        halWriteListFree(&pEnt->pList);
+    }
+
+    pEnt->key     = *pKey;
+    pEnt->pList    = pList;
+    pEnt->numReads = pCache->numReads;
+    pEnt->lastUse  = ++pCache->useCount;
+    pCache->stats.captures++;
+    return RECIPE_STATE(pList, pEnt->numReads);
+}
+
+/**************************************************************
+ * halResetRecipeFlush
+ *
+ * Drops every recipe - for when an input not in the key, such
+ * as the EEPROM contents, changes.
+ */
+void
+halResetRecipeFlush(WLAN_DEV_INFO *pDev)
+{
+    struct halResetRecipeCache *pCache = pDev->pHalInfo->pResetRecipes;
+    int                        i;
+
+    if (pCache == NULL) {
+        return;
+    }
+    for (i = 0; i < HAL_RECIPE_ENTRIES; i++) {
+        halWriteListFree(&pCache->entry[i].pList);
+    }
+    pCache->capturing = FALSE;
+    pCache->stats.flushes++;
+}
+
+/**************************************************************
+ * halResetRecipeGetStats
+ */
+void
+halResetRecipeGetStats(struct halResetRecipeCache *pCache, HAL_RESET_RECIPE_STATS *pStats,
+                       A_BOOL clear)
+{
+    *pStats = pCache->stats;
+    if (clear) {
+        A_MEM_ZERO(&pCache->stats, sizeof(pCache->stats));
+    }
+}
+
+#endif /* HAL_RESET_RECIPE */
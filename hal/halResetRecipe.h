@@ -0,0 +1,71 @@
+/*
+ * Copyright  2004 Atheros Communications, Inc.,  All Rights Reserved.
+ *
+ * Reset recipe cache.  The channel dependent part of a reset (transmit
+ * power, analog banks, board values) is recorded as the register writes
+ * it made plus a small device defined state block, keyed by the inputs
+ * it was computed from.  A later reset with the same inputs replays the
+ * writes instead of recomputing them.  The registers the capture read
+ * before writing are kept with their values and checked first, as a
+ * read-modify-write is replayed as the value it wrote.  The few most
+ * recently used recipes are kept.
+ *
+ * $Id: //depot/sw/branches/AV_dev/src/hal/halResetRecipe.h#1 $
+ */
+
+#ifndef _HAL_RESET_RECIPE_H_
+#define _HAL_RESET_RECIPE_H_
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+
+#define HAL_RECIPE_ENTRIES          8       /* Recipes kept, least recently used goes first */
+#define HAL_RECIPE_MAX_WRITES       512     /* Longer captures are not kept */
+#define HAL_RECIPE_MAX_READS        64      /* Nor those reading more registers */
+#define HAL_RECIPE_CONFIG_WORDS     8
+
+typedef struct halResetRecipeKey {
+    A_UINT32    channelFlags;
+    A_UINT16    channel;
+    A_INT16     powerLimit;
+    A_UINT32    txChainCtrl;
+    A_UINT32    rxChainCtrl;
+    A_UINT32    config[HAL_RECIPE_CONFIG_WORDS];   /* Other inputs - device defined */
+} HAL_RESET_RECIPE_KEY;
+
+struct halResetRecipeCache;
+
+A_STATUS
+halResetRecipeAttach(WLAN_DEV_INFO *pDev, A_UINT32 stateSize);
+
+void
+halResetRecipeDetach(WLAN_DEV_INFO *pDev);
+
+const void *
+halResetRecipeReplay(WLAN_DEV_INFO *pDev, const HAL_RESET_RECIPE_KEY *pKey);
+
+void
+halResetRecipeCaptureStart(WLAN_DEV_INFO *pDev);
+
+void *
+halResetRecipeCaptureEnd(WLAN_DEV_INFO *pDev, const HAL_RESET_RECIPE_KEY *pKey);
+
+void
+halResetRecipeRecord(struct halResetRecipeCache *pCache, A_UINT32 reg, A_UINT32 val);
+
+void
+halResetRecipeRecordRead(struct halResetRecipeCache *pCache, A_UINT32 reg, A_UINT32 val);
+
+void
+halResetRecipeFlush(WLAN_DEV_INFO *pDev);
+
+void
+halResetRecipeGetStats(struct halResetRecipeCache *pCache, HAL_RESET_RECIPE_STATS *pStats,
+                       A_BOOL clear);
+
+#ifdef _cplusplus
+}
+#endif
+
+#endif /* _HAL_RESET_RECIPE_H_ */
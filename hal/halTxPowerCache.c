@@ -0,0 +1,197 @@
+/*
+ *  Copyright (c) 2004 Atheros Communications, Inc., All Rights Reserved
+ *
+ *  Transmit power table cache.  One allocation holds the cache, its
+ *  keys and the device's blocks back to back; nothing is allocated
+ *  once attached.
+ */
+
+#ident "$Id: //depot/sw/branches/AV_dev/src/hal/halTxPowerCache.c#1 $"
+
+#ifdef HAL_TXPOWER_CACHE
+
+#include "wlantype.h"
+#include "wlandrv.h"
+#include "halApi.h"
+#include "hal.h"
+#include "ui.h"
+#include "halTxPowerCache.h"
+
+typedef struct halTxPowerEntry {
+    HAL_TXPOWER_KEY key;
+    A_UINT32        lastUse;                /* 0 if the entry is free */
+} HAL_TXPOWER_ENTRY;
+
+struct halTxPowerCache {
+    A_UINT32                entrySize;      /* Device block size, rounded to words */
+    A_UINT32                useCount;       /* LRU clock */
+    HAL_TXPOWER_CACHE_STATS stats;
+    HAL_TXPOWER_ENTRY       entry[HAL_TXPOWER_ENTRIES];
+    /* HAL_TXPOWER_ENTRIES device blocks follow */
+};
+
+#define TXPOWER_ALLOC_SIZE(entrySize)   \
+    (sizeof(struct halTxPowerCache) + HAL_TXPOWER_ENTRIES * (entrySize))
+
+#define TXPOWER_BLOCK(pCache, i)        \
+    ((A_UINT8 *)((pCache) + 1) + (i) * (pCache)->entrySize)
+
+/**************************************************************
+ * halTxPowerKeyMatch
+ */
+static A_BOOL
+halTxPowerKeyMatch(const HAL_TXPOWER_KEY *pA, const HAL_TXPOWER_KEY *pB)
+{
+    int i;
+
+    if (pA->channel != pB->channel || pA->chnIdx != pB->chnIdx ||
+        pA->powerLimit != pB->powerLimit || pA->channelFlags != pB->channelFlags)
+    {
+        return FALSE;
+    }
+    for (i = 0; i < HAL_TXPOWER_CONFIG_WORDS; i++) {
+        if (pA->config[i] != pB->config[i]) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/**************************************************************
+ * halTxPowerCacheAttach
+ *
+ * entrySize is the size of the block the device keeps for each
+ * channel and chain.
+ */
+A_STATUS
+halTxPowerCacheAttach(WLAN_DEV_INFO *pDev, A_UINT32 entrySize)
+{
+    struct halTxPowerCache *pCache;
+
+    ASSERT(pDev && pDev->pHalInfo && entrySize);
+
+    entrySize = (entrySize + sizeof(A_UINT32) - 1) & ~(sizeof(A_UINT32) - 1);
+    pCache = (struct halTxPowerCache *)A_DRIVER_MALLOC(TXPOWER_ALLOC_SIZE(entrySize));
+    if (pCache == NULL) {
+        uiPrintf("halTxPowerCacheAttach: Could not allocate transmit power cache\n");
+        return A_NO_MEMORY;
+    }
+    A_MEM_ZERO(pCache, sizeof(struct halTxPowerCache));
+    pCache->entrySize = entrySize;
+
+    pDev->pHalInfo->pTxPowerCache = pCache;
+    return A_OK;
+}
+
+/**************************************************************
+ * halTxPowerCacheDetach
+ */
+void
+halTxPowerCacheDetach(WLAN_DEV_INFO *pDev)
+{
+    struct halTxPowerCache *pCache;
+
+    ASSERT(pDev && pDev->pHalInfo);
+
+    pCache = pDev->pHalInfo->pTxPowerCache;
+    if (pCache) {
+        A_DRIVER_FREE(pCache, TXPOWER_ALLOC_SIZE(pCache->entrySize));
+        pDev->pHalInfo->pTxPowerCache = NULL;
+    }
+}
+
+/**************************************************************
+ * halTxPowerCacheFind
+ *
+ * Returns the block stored under pKey, or NULL if there is none.
+ */
+const void *
+halTxPowerCacheFind(WLAN_DEV_INFO *pDev, const HAL_TXPOWER_KEY *pKey)
+{
+    struct halTxPowerCache *pCache = pDev->pHalInfo->pTxPowerCache;
+    HAL_TXPOWER_ENTRY      *pEnt;
+    int                    i;
+
+    if (pCache == NULL) {
+        return NULL;
+    }
+    for (i = 0; i < HAL_TXPOWER_ENTRIES; i++) {
+        pEnt = &pCache->entry[i];
+        if (pEnt->lastUse && halTxPowerKeyMatch(&pEnt->key, pKey)) {
+            pEnt->lastUse = ++pCache->useCount;
+            pCache->stats.hits++;
+            return TXPOWER_BLOCK(pCache, i);
+        }
+    }
+    pCache->stats.misses++;
+    return NULL;
+}
+
+/**************************************************************
+ * halTxPowerCacheAdd
+ *
+ * Returns a block for the caller to fill in for pKey, taking a
+ * free entry or the least recently used one.  NULL if there is
+ * no cache.
+ */
+void *
+halTxPowerCacheAdd(WLAN_DEV_INFO *pDev, const HAL_TXPOWER_KEY *pKey)
+{
+    struct halTxPowerCache *pCache = pDev->pHalInfo->pTxPowerCache;
+    int                    i, lru = 0;
+
+    if (pCache == NULL) {
+        return NULL;
+    }
+    for (i = 0; i < HAL_TXPOWER_ENTRIES; i++) {
+        if (pCache->entry[i].lastUse < pCache->entry[lru].lastUse) {
+            lru = i;
+        }
+        if (pCache->entry[lru].lastUse == 0) {
+            break;
+        }
+    }
+    if (pCache->entry[lru].lastUse) {
+        pCache->stats.evictions++;
+    }
+    pCache->entry[lru].key     = *pKey;
+    pCache->entry[lru].lastUse = ++pCache->useCount;
+    return TXPOWER_BLOCK(pCache, lru);
+}
+
+/**************************************************************
+ * halTxPowerCacheFlush
+ *
+ * Drops every table - for when an input not in the key, such
+ * as the EEPROM contents, changes.
+ */
+void
+halTxPowerCacheFlush(WLAN_DEV_INFO *pDev)
+{
+    struct halTxPowerCache *pCache = pDev->pHalInfo->pTxPowerCache;
+    int                    i;
+
+    if (pCache == NULL) {
+        return;
+    }
+    for (i = 0; i < HAL_TXPOWER_ENTRIES; i++) {
+        pCache->entry[i].lastUse = 0;
+    }
+    pCache->useCount = 0;
+    pCache->stats.flushes++;
+}
+
+/**************************************************************
+ * halTxPowerCacheGetStats
+ */
+void
+halTxPowerCacheGetStats(struct halTxPowerCache *pCache, HAL_TXPOWER_CACHE_STATS *pStats,
+                        A_BOOL clear)
+{
+    *pStats = pCache->stats;
+    if (clear) {
+        A_MEM_ZERO(&pCache->stats, sizeof(pCache->stats));
+    }
+}
+
+#endif /* HAL_TXPOWER_CACHE */
@@ -0,0 +1,56 @@
+/*
+ * Copyright  2004 Atheros Communications, Inc.,  All Rights Reserved.
+ *
+ * Transmit power table cache.  The PCDAC table and per rate powers a
+ * device computes for a channel and chain from the EEPROM calibration
+ * are kept, in a device defined block, keyed by the inputs they were
+ * computed from.  All blocks live in one arena allocated at attach;
+ * the least recently used one is reused when it is full.
+ *
+ * $Id: //depot/sw/branches/AV_dev/src/hal/halTxPowerCache.h#1 $
+ */
+
+#ifndef _HAL_TXPOWER_CACHE_H_
+#define _HAL_TXPOWER_CACHE_H_
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+
+#define HAL_TXPOWER_ENTRIES         32      /* Channel and chain tables kept */
+#define HAL_TXPOWER_CONFIG_WORDS    4
+
+typedef struct halTxPowerKey {
+    A_UINT32    channelFlags;
+    A_UINT16    channel;
+    A_INT16     powerLimit;
+    A_UINT32    chnIdx;
+    A_UINT32    config[HAL_TXPOWER_CONFIG_WORDS];  /* Other inputs - device defined */
+} HAL_TXPOWER_KEY;
+
+struct halTxPowerCache;
+
+A_STATUS
+halTxPowerCacheAttach(WLAN_DEV_INFO *pDev, A_UINT32 entrySize);
+
+void
+halTxPowerCacheDetach(WLAN_DEV_INFO *pDev);
+
+const void *
+halTxPowerCacheFind(WLAN_DEV_INFO *pDev, const HAL_TXPOWER_KEY *pKey);
+
+void *
+halTxPowerCacheAdd(WLAN_DEV_INFO *pDev, const HAL_TXPOWER_KEY *pKey);
+
+void
+halTxPowerCacheFlush(WLAN_DEV_INFO *pDev);
+
+void
+halTxPowerCacheGetStats(struct halTxPowerCache *pCache, HAL_TXPOWER_CACHE_STATS *pStats,
+                        A_BOOL clear);
+
+#ifdef _cplusplus
+}
+#endif
+
+#endif /* _HAL_TXPOWER_CACHE_H_ */
@@ -17,6 +17,52 @@ extern "C" {
 A_UINT32
 reverseBits(A_UINT32 val, A_UINT32 bitCount);
 
+/*
+ * Read-modify-write batch.  Field updates to the same register are
+ * merged so each register is read once and written once at commit,
+ * in the order the registers were last touched - each register's
+ * final write keeps its place relative to the other registers.
+ * Only use it where the earlier writes a merge drops do not matter.
+ *
+ *     HAL_RMW_BATCH batch;
+ *
+ *     HAL_RMW_INIT(&batch, pDev);
+ *     HAL_RMW_FIELD(&batch, PHY_AGC_CTL1, COARSE_HIGH, high);
+ *     HAL_RMW_FIELD(&batch, PHY_AGC_CTL1, COARSE_LOW, low);
+ *     halRmwCommit(&batch);
+ */
+#define HAL_RMW_MAX_REGS    8
+
+typedef struct halRmwBatch {
+    WLAN_DEV_INFO   *pDev;
+    A_UINT32        numRegs;
+    struct {
+        A_UINT32    reg;
+        A_UINT32    mask;                   /* bits being replaced */
+        A_UINT32    val;
+    } regs[HAL_RMW_MAX_REGS];
+} HAL_RMW_BATCH;
+
+#define HAL_RMW_INIT(_pB, _pDev)                do {    \
+    (_pB)->pDev    = (_pDev);                           \
+    (_pB)->numRegs = 0;                                 \
+} while (0)
+
+#define HAL_RMW_FIELD(_pB, _reg, _field, _val)  \
+    halRmwAdd((_pB), (_reg), _reg##_##_field##_M, A_FIELD_VALUE(_reg, _field, _val))
+
+#define HAL_RMW_SET_BIT(_pB, _reg, _bit)        \
+    halRmwAdd((_pB), (_reg), _reg##_##_bit, _reg##_##_bit)
+
+#define HAL_RMW_CLR_BIT(_pB, _reg, _bit)        \
+    halRmwAdd((_pB), (_reg), _reg##_##_bit, 0)
+
+void
+halRmwAdd(HAL_RMW_BATCH *pBatch, A_UINT32 reg, A_UINT32 mask, A_UINT32 val);
+
+void
+halRmwCommit(HAL_RMW_BATCH *pBatch);
+
 #ifdef _cplusplus
 }
 #endif
@@ -0,0 +1,315 @@
+/*
+ *  Copyright (c) 2004 Atheros Communications, Inc., All Rights Reserved
+ *
+ *  Register write-list engine.  Compiles the 2-D reset init tables into
+ *  flat per-mode {addr, value} streams and writes them out with the
+ *  device's pacing policy.
+ */
+
+#ident "$Id: //depot/sw/branches/AV_dev/src/hal/halWriteList.c#1 $"
+
+#include "wlantype.h"
+#include "wlandrv.h"
+#include "halApi.h"
+#include "hal.h"
+#include "ui.h"
+#include "halWriteList.h"
+
+#define HAL_WL_IS_PCU(addr)     (((addr) & ~HAL_WL_FLAG_MASK) >= 0x8000 && \
+                                 ((addr) & ~HAL_WL_FLAG_MASK) < 0x9000)
+
+/**************************************************************
+ * halWriteListInitPacing
+ *
+ * Default pacing: a 1 us delay every writeBlockSize writes
+ * (bug 10685).  flushReg is a side effect free register the
+ * HAL_WRITE_PACE_FLUSH policy may read (bug 6773).
+ */
+void
+halWriteListInitPacing(WLAN_DEV_INFO *pDev, A_UINT32 flushReg)
+{
+    HAL_INFO *pInfo = pDev->pHalInfo;
+
+    pInfo->writePacing.policy    = HAL_WRITE_PACE_DELAY;
+    pInfo->writePacing.delayUs   = 1;
+    pInfo->writePacing.flushReg  = flushReg;
+#ifdef BUILD_AP
+    pInfo->writePacing.blockSize = MAX_WRITEBLOCKSIZE;
+#else
+    pInfo->writePacing.blockSize = pDev->staConfig.writeBlockSize;
+#endif
+    pInfo->writePaceCount = 0;
+}
+
+/**************************************************************
+ * halWriteStall
+ */
+static INLINE void
+halWriteStall(WLAN_DEV_INFO *pDev, HAL_INFO *pInfo)
+{
+    HAL_WRITE_PACING *pPacing = &pInfo->writePacing;
+
+    pInfo->writePaceCount = 0;
+    pInfo->writeStats.stalls++;
+
+    if (pPacing->policy == HAL_WRITE_PACE_FLUSH) {
+        /* A PIO read lets other cards' DMA reads complete */
+        (void)A_REG_RD(pDev, pPacing->flushReg);
+    } else {
+        udelay(pPacing->delayUs);
+    }
+}
+
+/**************************************************************
+ * halWritePace
+ *
+ * Accounts for one register write and stalls if the pacing
+ * policy calls for it.
+ */
+static INLINE void
+halWritePace(WLAN_DEV_INFO *pDev, HAL_INFO *pInfo)
+{
+    HAL_WRITE_PACING *pPacing = &pInfo->writePacing;
+
+    pInfo->writeStats.writes++;
+
+    if (pPacing->policy == HAL_WRITE_PACE_NONE || pPacing->blockSize == 0) {
+        return;
+    }
+    if (++pInfo->writePaceCount >= pPacing->blockSize) {
+        halWriteStall(pDev, pInfo);
+    }
+}
+
+/**************************************************************
+ * halWriteListCompile
+ *
+ * Concatenates the given init table columns in order, sorts the
+ * result by address and folds repeated registers so that the
+ * last value written wins - the same end state as writing the
+ * tables one after the other.
+ */
+A_STATUS
+halWriteListCompile(HAL_WRITE_LIST **ppList, const HAL_WL_SOURCE *pSrc, A_UINT32 numSrc,
+                    A_UINT32 modesIndex, A_UINT32 freqIndex)
+{
+    HAL_WRITE_LIST  *pList;
+    HAL_REG_WRITE   *pTmp, entry;
+    A_UINT32        total = 0, num = 0, size;
+    A_UINT32        s, r, col;
+    A_INT32         i, j;
+
+    ASSERT(ppList && *ppList == NULL);
+
+    for (s = 0; s < numSrc; s++) {
+        total += pSrc[s].rows;
+    }
+    if (total == 0) {
+        return A_EINVAL;
+    }
+
+    pTmp = (HAL_REG_WRITE *)A_DRIVER_MALLOC(total * sizeof(HAL_REG_WRITE));
+    if (pTmp == NULL) {
+        return A_NO_MEMORY;
+    }
+
+    for (s = 0; s < numSrc; s++) {
+        switch (pSrc[s].colType) {
+        case HAL_WL_COL_MODE:
+            col = modesIndex;
+            break;
+        case HAL_WL_COL_FREQ:
+            col = freqIndex;
+            break;
+        default:
+            col = 1;
+            break;
+        }
+        ASSERT(col > 0 && col < pSrc[s].cols);
+
+        for (r = 0; r < pSrc[s].rows; r++) {
+            pTmp[num].addr  = pSrc[s].pTable[r * pSrc[s].cols];
+            pTmp[num].value = pSrc[s].pTable[r * pSrc[s].cols + col];
+            ASSERT((pTmp[num].addr & HAL_WL_FLAG_MASK) == 0);
+            if ((pSrc[s].flags & HAL_WL_KEEP_PCU) && HAL_WL_IS_PCU(pTmp[num].addr)) {
+                pTmp[num].addr |= HAL_WL_KEEP_PCU;
+            }
+            num++;
+        }
+    }
+
+    /*
+     * Stable insertion sort - the ini tables are already close to
+     * address order so this is nearly linear.
+     */
+    for (i = 1; i < (A_INT32)num; i++) {
+        entry = pTmp[i];
+        for (j = i - 1;
+             j >= 0 && (pTmp[j].addr & ~HAL_WL_FLAG_MASK) > (entry.addr & ~HAL_WL_FLAG_MASK);
+             j--)
+        {
+            pTmp[j + 1] = pTmp[j];
+        }
+        pTmp[j + 1] = entry;
+    }
+
+    /* Fold duplicates, keeping the later write */
+    for (i = 0, j = 0; i < (A_INT32)num; i++) {
+        if (j > 0 &&
+            (pTmp[j - 1].addr & ~HAL_WL_FLAG_MASK) == (pTmp[i].addr & ~HAL_WL_FLAG_MASK))
+        {
+            pTmp[j - 1] = pTmp[i];
+        } else {
+            pTmp[j++] = pTmp[i];
+        }
+    }
+
+    size  = sizeof(HAL_WRITE_LIST) + j * sizeof(HAL_REG_WRITE);
+    pList = (HAL_WRITE_LIST *)A_DRIVER_MALLOC(size);
+    if (pList == NULL) {
+        A_DRIVER_FREE(pTmp, total * sizeof(HAL_REG_WRITE));
+        return A_NO_MEMORY;
+    }
+    pList->numWrites = j;
+    pList->allocSize = size;
+    pList->pWrites   = (HAL_REG_WRITE *)(pList + 1);
+    A_BCOPY(pTmp, pList->pWrites, j * sizeof(HAL_REG_WRITE));
+
+    A_DRIVER_FREE(pTmp, total * sizeof(HAL_REG_WRITE));
+
+    *ppList = pList;
+    return A_OK;
+}
+
+/**************************************************************
+ * halWriteListInDelta
+ *
+ * TRUE if the entry of pTo at pWr must be written when the chip
+ * already holds pFrom.  *pIdx walks pFrom alongside pTo; both
+ * lists are address sorted.
+ */
+static A_BOOL
+halWriteListInDelta(const HAL_WRITE_LIST *pFrom, A_UINT32 *pIdx, const HAL_REG_WRITE *pWr,
+                    const A_UINT32 *pVolatile, A_UINT32 numVolatile)
+{
+    A_UINT32 addr = pWr->addr & ~HAL_WL_FLAG_MASK;
+    A_UINT32 i;
+
+    for (i = 0; i < numVolatile; i++) {
+        if (pVolatile[i] == addr) {
+            return TRUE;
+        }
+    }
+
+    while (*pIdx < pFrom->numWrites &&
+           (pFrom->pWrites[*pIdx].addr & ~HAL_WL_FLAG_MASK) < addr)
+    {
+        (*pIdx)++;
+    }
+    return (*pIdx == pFrom->numWrites ||
+            (pFrom->pWrites[*pIdx].addr & ~HAL_WL_FLAG_MASK) != addr ||
+            pFrom->pWrites[*pIdx].value != pWr->value);
+}
+
+/**************************************************************
+ * halWriteListDiff
+ *
+ * Builds the list that takes the chip from compiled list pFrom
+ * to pTo: the entries of pTo whose value differs, plus any of
+ * the pVolatile registers, which the driver changes after the
+ * tables are written.  The result may be empty.
+ */
+A_STATUS
+halWriteListDiff(HAL_WRITE_LIST **ppDelta, const HAL_WRITE_LIST *pFrom, const HAL_WRITE_LIST *pTo,
+                 const A_UINT32 *pVolatile, A_UINT32 numVolatile)
+{
+    HAL_WRITE_LIST  *pDelta;
+    A_UINT32        num = 0, size, i, idx;
+
+    ASSERT(ppDelta && *ppDelta == NULL && pFrom && pTo);
+
+    for (i = 0, idx = 0; i < pTo->numWrites; i++) {
+        if (halWriteListInDelta(pFrom, &idx, &pTo->pWrites[i], pVolatile, numVolatile)) {
+            num++;
+        }
+    }
+
+    size   = sizeof(HAL_WRITE_LIST) + num * sizeof(HAL_REG_WRITE);
+    pDelta = (HAL_WRITE_LIST *)A_DRIVER_MALLOC(size);
+    if (pDelta == NULL) {
+        return A_NO_MEMORY;
+    }
+    pDelta->numWrites = num;
+    pDelta->allocSize = size;
+    pDelta->pWrites   = (HAL_REG_WRITE *)(pDelta + 1);
+
+    for (i = 0, idx = 0, num = 0; i < pTo->numWrites; i++) {
+        if (halWriteListInDelta(pFrom, &idx, &pTo->pWrites[i], pVolatile, numVolatile)) {
+            pDelta->pWrites[num++] = pTo->pWrites[i];
+        }
+    }
+
+    *ppDelta = pDelta;
+    return A_OK;
+}
+
+/**************************************************************
+ * halWriteListFree
+ */
+void
+halWriteListFree(HAL_WRITE_LIST **ppList)
+{
+    if (*ppList) {
+        A_DRIVER_FREE(*ppList, (*ppList)->allocSize);
+        *ppList = NULL;
+    }
+}
+
+/**************************************************************
+ * halWriteListApply
+ *
+ * Writes out a compiled list, stalling once up front as the old
+ * array writes did.  On a channel change the PCU registers
+ * flagged HAL_WL_KEEP_PCU are left alone.
+ */
+void
+halWriteListApply(WLAN_DEV_INFO *pDev, const HAL_WRITE_LIST *pList, A_BOOL bChannelChange)
+{
+    HAL_INFO            *pInfo = pDev->pHalInfo;
+    const HAL_REG_WRITE *pWr   = pList->pWrites;
+    const HAL_REG_WRITE *pEnd  = pWr + pList->numWrites;
+    A_UINT32            skipMask = bChannelChange ? HAL_WL_KEEP_PCU : 0;
+
+    if (pInfo->writePacing.policy != HAL_WRITE_PACE_NONE) {
+        halWriteStall(pDev, pInfo);
+    }
+    for (; pWr < pEnd; pWr++) {
+        if (pWr->addr & skipMask) {
+            continue;
+        }
+        A_REG_WR(pDev, pWr->addr & ~HAL_WL_FLAG_MASK, pWr->value);
+        halWritePace(pDev, pInfo);
+    }
+}
+
+/**************************************************************
+ * halWriteRegsPaced
+ *
+ * Writes count registers in the order given, taking addresses
+ * from every addrStride'th word of pAddr.
+ */
+void
+halWriteRegsPaced(WLAN_DEV_INFO *pDev, const A_UINT32 *pAddr, A_UINT32 addrStride,
+                  const A_UINT32 *pData, A_UINT32 count)
+{
+    HAL_INFO *pInfo = pDev->pHalInfo;
+    A_UINT32 r;
+
+    if (pInfo->writePacing.policy != HAL_WRITE_PACE_NONE) {
+        halWriteStall(pDev, pInfo);
+    }
+    for (r = 0; r < count; r++) {
+        A_REG_WR(pDev, pAddr[r * addrStride], pData[r]);
+        halWritePace(pDev, pInfo);
+    }
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright  2004 Atheros Communications, Inc.,  All Rights Reserved.
+ *
+ * Register write lists.  The reset init tables are compiled at attach
+ * time into one address-sorted {addr, value} stream per wireless mode,
+ * which the reset code then writes out under the configured pacing.
+ *
+ * $Id: //depot/sw/branches/AV_dev/src/hal/halWriteList.h#1 $
+ */
+
+#ifndef _HAL_WRITE_LIST_H_
+#define _HAL_WRITE_LIST_H_
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+
+/* Which column of an init table supplies the value */
+#define HAL_WL_COL_COMMON       0       /* [][2] table - column 1 */
+#define HAL_WL_COL_MODE         1       /* [][N] table - column modesIndex */
+#define HAL_WL_COL_FREQ         2       /* [][3] table - column freqIndex */
+
+/* Source flags */
+#define HAL_WL_KEEP_PCU         0x1     /* Skip 0x8000-0x8fff on channel change */
+
+/*
+ * Compiled entries keep their flags in the low address bits,
+ * registers are always 32 bit aligned.
+ */
+#define HAL_WL_FLAG_MASK        0x3
+
+typedef struct halWlSource {
+    const A_UINT32  *pTable;            /* First element of a [rows][cols] table */
+    A_UINT32        rows;
+    A_UINT32        cols;
+    A_UINT32        colType;            /* HAL_WL_COL_xxx */
+    A_UINT32        flags;              /* HAL_WL_xxx */
+} HAL_WL_SOURCE;
+
+#define HAL_WL_SOURCE_INIT(table, colType, flags)                   \
+    { &(table)[0][0], sizeof(table) / sizeof(*(table)),             \
+      sizeof(*(table)) / sizeof(A_UINT32), (colType), (flags) }
+
+typedef struct halRegWrite {
+    A_UINT32    addr;                   /* Register | HAL_WL_xxx flags */
+    A_UINT32    value;
+} HAL_REG_WRITE;
+
+typedef struct halWriteList {
+    A_UINT32        numWrites;
+    A_UINT32        allocSize;
+    HAL_REG_WRITE   *pWrites;           /* Follows the header in the same allocation */
+} HAL_WRITE_LIST;
+
+/* Analog bank writes - order matters, so these are written as given */
+#define HAL_WL_WRITE_RF_ARRAY(pDev, regAddress, regData)                        \
+    halWriteRegsPaced((pDev), &(regAddress)[0][0],                              \
+                      sizeof(*(regAddress)) / sizeof(A_UINT32), (regData),      \
+                      sizeof(regAddress) / sizeof(*(regAddress)))
+
+void
+halWriteListInitPacing(WLAN_DEV_INFO *pDev, A_UINT32 flushReg);
+
+A_STATUS
+halWriteListCompile(HAL_WRITE_LIST **ppList, const HAL_WL_SOURCE *pSrc, A_UINT32 numSrc,
+                    A_UINT32 modesIndex, A_UINT32 freqIndex);
+
+A_STATUS
+halWriteListDiff(HAL_WRITE_LIST **ppDelta, const HAL_WRITE_LIST *pFrom, const HAL_WRITE_LIST *pTo,
+                 const A_UINT32 *pVolatile, A_UINT32 numVolatile);
+
+void
+halWriteListFree(HAL_WRITE_LIST **ppList);
+
+void
+halWriteListApply(WLAN_DEV_INFO *pDev, const HAL_WRITE_LIST *pList, A_BOOL bChannelChange);
+
+void
+halWriteRegsPaced(WLAN_DEV_INFO *pDev, const A_UINT32 *pAddr, A_UINT32 addrStride,
+                  const A_UINT32 *pData, A_UINT32 count);
+
+#ifdef _cplusplus
+}
+#endif
+
+#endif /* _HAL_WRITE_LIST_H_ */
@@ -0,0 +1,455 @@
+/*
+ *  Copyright (c) 2004 Atheros Communications, Inc., All Rights Reserved
+ *
+ *  Host test of the AR5513 HAL against the register simulator.  A
+ *  calibrated single chain 11a EEPROM image is loaded into the
+ *  simulator, then the HAL is attached, reset onto a 5GHz channel
+ *  and a transmit and a receive descriptor are each set up, completed
+ *  as the DMA engine would and processed.  The simulator has no DMA:
+ *  the test writes the status words itself.
+ *
+ *  Build and run from hal/:
+ *
+ *      cc -DBUILD_AR5513 -DAR5513 -DAR5513_SIM -DPCI_INTERFACE \
+ *          -DCB63_NDIS -DNDIS_HW -Itest/stub -I. -Iar5513 \
+ *          test/ar5513SimTest.c ar5513/ar5513*.c halAttach.c halBeacon.c \
+ *          halCalInterp.c halInterrupts.c halKeyCache.c halMisc.c \
+ *          halPower.c halReceive.c halRegIo.c halReset.c halTransmit.c \
+ *          halUtil.c halWriteList.c -o ar5513SimTest
+ *      ./ar5513SimTest
+ */
+
+#include "wlantype.h"
+#include "wlandrv.h"
+#include "wlanchannel.h"
+#include "halApi.h"
+#include "hal.h"
+#include "ui.h"
+#include "vport.h"
+#include "halDevId.h"
+
+/* Headers for HW private items */
+#include "ar5513MacReg.h"
+#include "ar5513Mac.h"
+#include "ar5513Sim.h"
+
+#include <stdarg.h>
+
+#define SIM_EEPROM_WORDS    ATHEROS_EEPROM_END_DEFAULT
+#define SIM_CHANNEL         5200
+#define SIM_HW_TX_RETRIES   4
+#define SIM_FRAME_LENGTH    (sizeof(WLAN_DATA_MAC_HEADER) + 100 + FCS_FIELD_SIZE)
+#define SIM_RX_BUFFER_SIZE  1600
+#define SIM_ACK_RSSI        30
+#define SIM_RX_RSSI         40
+
+typedef struct simTestState {
+    WLAN_DEV_INFO           dev;
+    OS_DEV_INFO             osDev;
+    CHAN_VALUES             chan;
+    SIB_ENTRY               localSta;
+    WLAN_DATA_MAC_HEADER    txHdr;
+    WLAN_DATA_MAC_HEADER    rxHdr;
+    ATHEROS_DESC            txDesc;
+    ATHEROS_DESC            rxDesc[2];
+    A_UINT16                eeprom[SIM_EEPROM_WORDS];
+} SIM_TEST_STATE;
+
+static SIM_TEST_STATE   simTest;
+
+int             gSlotTime;
+WLAN_MACADDR    broadcastMacAddr = {{0xff, 0xff, 0xff, 0xff, 0xff, 0xff}};
+
+int
+uiPrintf(const char *format, ...)
+{
+    va_list args;
+    int     n;
+
+    va_start(args, format);
+    n = vprintf(format, args);
+    va_end(args);
+    return n;
+}
+
+int
+sysCountGet(void)
+{
+    return 0;
+}
+
+void
+apPanic(const char *msg)
+{
+    printf("FAIL: panic %s\n", msg);
+    exit(1);
+}
+
+DURATION
+phyComputeTxTime(const RATE_TABLE *pRateTable, A_UINT32 frameLength,
+                 A_UINT16 rateIndex, A_BOOL shortPreamble)
+{
+    /* OFDM: 20us preamble and signal, then 4us symbols */
+    A_UINT32 bitsPerSymbol = pRateTable->info[rateIndex].rateKbps * 4 / 1000;
+
+    if (bitsPerSymbol == 0) {
+        bitsPerSymbol = 24;
+    }
+    return (DURATION)(20 + 4 * ((16 + 8 * frameLength + 6 + bitsPerSymbol - 1) / bitsPerSymbol));
+}
+
+A_UINT16
+rcRateFind(WLAN_DEV_INFO *pDev, ATHEROS_DESC *pDesc)
+{
+    return 0;
+}
+
+A_UINT16
+rcGetBestCckRate(ATHEROS_DESC *pDesc, A_UINT16 rateIndex)
+{
+    return rateIndex;
+}
+
+void
+rcUpdate(WLAN_DEV_INFO *pDev, SIB_ENTRY *pSib, A_UINT8 rateIndex, A_UINT32 frameLength,
+         A_BOOL xRetry, A_UINT16 retries, A_RSSI rssiAck, A_UINT8 antenna)
+{
+}
+
+void
+swretryStateReset(WLAN_DEV_INFO *pDev, SIB_ENTRY *pSib, A_BOOL clearDest,
+                  A_BOOL clearFiltered)
+{
+}
+
+void
+setXrBssIdMask(WLAN_MACADDR *pMask)
+{
+}
+
+SIB_ENTRY *
+sibEntryFind(WLAN_DEV_INFO *pDev, WLAN_MACADDR *pAddr)
+{
+    return NULL;
+}
+
+A_STATUS
+wlanKeyCacheFault(WLAN_DEV_INFO *pDev, SIB_ENTRY *pSib, A_BOOL *pFaulted)
+{
+    *pFaulted = FALSE;
+    return A_OK;
+}
+
+A_BOOL
+isXrBssRxFrame(WLAN_DEV_INFO *pDev, WLAN_FRAME_HEADER *pHdr)
+{
+    return FALSE;
+}
+
+A_BOOL
+wlanIsNfCheckRequired(WLAN_DEV_INFO *pDev)
+{
+    return FALSE;
+}
+
+A_BOOL
+wlanIsRegCcValid(WLAN_DEV_INFO *pDev)
+{
+    return TRUE;
+}
+
+WIRELESS_MODE
+wlanCFlagsToWirelessMode(WLAN_DEV_INFO *pDev, A_UINT16 cflags)
+{
+    if (IS_CHAN_5GHZ(cflags)) {
+        return IS_CHAN_TURBO(cflags) ? WIRELESS_MODE_TURBO : WIRELESS_MODE_11a;
+    }
+    return IS_CHAN_CCK(cflags) ? WIRELESS_MODE_11b : WIRELESS_MODE_11g;
+}
+
+WIRELESS_MODE
+wlanFindModeFromRateTable(WLAN_DEV_INFO *pDev, VPORT_BSS *pVportBss)
+{
+    return WIRELESS_MODE_11a;
+}
+
+A_UINT16
+wlanConvertGHztoCh(A_UINT16 freq, A_UINT32 channelFlags)
+{
+    return (A_UINT16)((freq - 5000) / 5);
+}
+
+A_UINT16
+wlanGetCtl(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval)
+{
+    return NO_CTL;
+}
+
+A_INT16
+wlanGetChannelPower(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval)
+{
+    return 2 * 17;
+}
+
+A_UINT16
+wlanGetAntennaReduction(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval, A_UINT16 twiceGain)
+{
+    return 0;
+}
+
+static void
+simTestFail(const char *what, A_STATUS status)
+{
+    printf("FAIL: %s (status %d)\n", what, status);
+    exit(1);
+}
+
+/**************************************************************
+ * simTestBuildEeprom
+ *
+ * A 4.9 EEPROM for one 5112 chain calibrating 11a only: two
+ * frequency piers with one xpd gain, a target power entry and
+ * no CTLs or EAR.  The checksum word makes the calibration area
+ * XOR to 0xffff.
+ */
+static void
+simTestBuildEeprom(A_UINT16 *pEep)
+{
+    A_UINT16 pier, chkSum = 0;
+    A_UINT32 i;
+
+    for (i = 0; i < SIM_EEPROM_WORDS; i++) {
+        pEep[i] = 0;
+    }
+
+    /* 00:03:7f:00:55:13 */
+    pEep[EEPROM_MAC_MSW_OFFSET] = 0x0003;
+    pEep[EEPROM_MAC_MID_OFFSET] = 0x7f00;
+    pEep[EEPROM_MAC_LSW_OFFSET] = 0x5513;
+    pEep[REGULATORY_DOMAIN_OFFSET] = 0x0010;      /* FCC */
+
+    pEep[ATHEROS_EEPROM_OFFSET + 1] = EEPROM_VER4_9;
+    pEep[ATHEROS_EEPROM_OFFSET + 7] = 40 << 10;   /* ART build */
+
+    /* 11a only, both turbo modes disabled */
+    pEep[0x00C2] = 0x8000 | 0x0008 | 0x0001;
+    /* EEP_MAP 1 (5112 power), no EAR */
+    pEep[0x00C4] = 1 << 14;
+    pEep[0x00C5] = EEPROM_GROUPS_OFFSET3_3 + 0x20;
+
+    /* 11a modal section: noise floor threshold -54, xpd gain 0 with xpd on */
+    pEep[0x00D4 + 9]  = 0x00ca;
+    pEep[0x00D4 + 10] = (1 << 1) | 1;
+
+    /* Group 2: two 11a piers (5180 and 5320) then five words each */
+    pEep[EEPROM_GROUPS_OFFSET3_3] = (A_UINT16)(((5320 - 4800) / 5) << 8 | ((5180 - 4800) / 5));
+    for (pier = 0; pier < 2; pier++) {
+        i = EEPROM_GROUPS_OFFSET3_3 + NUM_11A_EEPROM_CHANNELS / 2 + pier * 5;
+        pEep[i]     = (A_UINT16)((40 << 8) | 20);        /* pwr2, pwr1 in quarter dBm */
+        pEep[i + 1] = (A_UINT16)((70 << 8) | 58);        /* pwr4, pwr3 */
+        pEep[i + 2] = (A_UINT16)((10 << 10) | (10 << 5) | 10);  /* pcdac deltas */
+        pEep[i + 3] = 0;
+        pEep[i + 4] = (A_UINT16)(20 << 8);               /* pcd1 */
+    }
+
+    /* Group 5: one 11a target power test channel at 5200, 17dBm at every rate */
+    i = EEPROM_GROUPS_OFFSET3_3 + 0x20;
+    pEep[i]     = (A_UINT16)(((5200 - 4800) / 5) << 8 | (34 << 2) | (34 >> 4));
+    pEep[i + 1] = (A_UINT16)(((34 & 0xf) << 12) | (34 << 6) | 34);
+
+    for (i = ATHEROS_EEPROM_OFFSET + 1; i < SIM_EEPROM_WORDS; i++) {
+        chkSum ^= pEep[i];
+    }
+    pEep[ATHEROS_EEPROM_OFFSET] = chkSum ^ 0xffff;
+}
+
+/**************************************************************
+ * simTestTxDesc
+ *
+ * A single descriptor unicast data frame at the lowest 11a rate:
+ * set up, checked as still pending, completed with an ack by
+ * writing its status words, then processed.
+ */
+static void
+simTestTxDesc(SIM_TEST_STATE *pT)
+{
+    WLAN_DEV_INFO     *pDev = &pT->dev;
+    ATHEROS_DESC      *pDesc = &pT->txDesc;
+    AR5513_TX_CONTROL *pTxControl = TX_CONTROL(pDesc);
+    AR5513_TX_STATUS  *pTxStatus = TX_STATUS(pDesc);
+    const RATE_TABLE  *pRateTable = pDev->baseBss.bss.pRateTable;
+    A_STATUS          status;
+
+    pT->txHdr.frameControl.fType = FRAME_DATA;
+    pT->txHdr.address1.octets[0] = 0x00;
+    pT->txHdr.address1.octets[5] = 0x01;
+    A_MACADDR_COPY(&pDev->staConfig.macPermAddr, &pT->txHdr.address2);
+
+    pDesc->pTxFirstDesc          = pDesc;
+    pDesc->pTxLastDesc           = pDesc;
+    pDesc->pNextVirtPtr          = pDesc;
+    pDesc->pVportBss             = GET_BASE_BSS(pDev);
+    pDesc->pBufferVirtPtr.header = &pT->txHdr;
+    pTxControl->frameLength      = SIM_FRAME_LENGTH;
+
+    halSetupTxDesc(pDev, pDesc, HWINDEX_INVALID);
+    if (pTxControl->TXRate0 != pRateTable->info[0].rateCode ||
+        pTxControl->TXDataTries0 != 1 + SIM_HW_TX_RETRIES ||
+        pTxControl->noAck || pTxControl->destIdxValid)
+    {
+        simTestFail("transmit control words", A_ERROR);
+    }
+
+    status = halProcessTxDesc(pDev, pDesc);
+    if (status != A_EBUSY || pDesc->status.tx.status != NOT_DONE) {
+        simTestFail("transmit descriptor done before completion", status);
+    }
+
+    /* What the DMA engine writes back: sent once, acked on antenna 0 */
+    pTxStatus->ackRssiAnt0Chain0 = SIM_ACK_RSSI;
+    pTxStatus->ackRssiAnt1Chain0 = SIM_ACK_RSSI;
+    pTxStatus->sendTimestamp     = 0x1234;
+    pTxStatus->txSeqNum          = 7;
+    pTxStatus->pktTransmitOK     = 1;
+    pTxStatus->done              = 1;
+
+    status = halProcessTxDesc(pDev, pDesc);
+    if (status != A_OK || pDesc->status.tx.status != TRANSMIT_OK ||
+        pDesc->status.tx.seqNum != 7 || pDesc->status.tx.retryCount != 0 ||
+        pDesc->status.tx.rate != pRateTable->info[0].rateCode)
+    {
+        simTestFail("transmit descriptor status", status);
+    }
+}
+
+/**************************************************************
+ * simTestRxDesc
+ *
+ * Two descriptors linked in a ring with RXDP on the first.  The
+ * first is checked as pending, then completed with a frame at
+ * 6Mbps with RXDP moved on to the second, and processed.
+ */
+static void
+simTestRxDesc(SIM_TEST_STATE *pT)
+{
+    WLAN_DEV_INFO     *pDev = &pT->dev;
+    ATHEROS_DESC      *pDesc = &pT->rxDesc[0];
+    AR5513_RX_STATUS  *pRxStatus = RX_STATUS(pDesc);
+    const RATE_TABLE  *pRateTable = pDev->baseBss.bss.pRateTable;
+    A_STATUS          status;
+    int               i;
+
+    for (i = 0; i < 2; i++) {
+        pT->rxDesc[i].thisPhysPtr           = 0x1000 + i * sizeof(ATHEROS_DESC);
+        pT->rxDesc[i].pNextVirtPtr          = &pT->rxDesc[(i + 1) % 2];
+        pT->rxDesc[i].nextPhysPtr           = pT->rxDesc[(i + 1) % 2].thisPhysPtr;
+        pT->rxDesc[i].pBufferVirtPtr.header = &pT->rxHdr;
+        halSetupRxDesc(pDev, &pT->rxDesc[i], SIM_RX_BUFFER_SIZE);
+        if (RX_CONTROL(&pT->rxDesc[i])->bufferLength != SIM_RX_BUFFER_SIZE) {
+            simTestFail("receive control words", A_ERROR);
+        }
+    }
+    halSetRxDP(pDev, pDesc->thisPhysPtr);
+    if (halGetRxDP(pDev) != pDesc->thisPhysPtr) {
+        simTestFail("receive descriptor pointer", A_ERROR);
+    }
+
+    status = halProcessRxDesc(pDev, pDesc);
+    if (status != A_EBUSY) {
+        simTestFail("receive descriptor done before completion", status);
+    }
+
+    /* The frame lands in the first descriptor and the DMA engine moves on */
+    pT->rxHdr.frameControl.fType = FRAME_DATA;
+    A_MACADDR_COPY(&pDev->staConfig.macPermAddr, &pT->rxHdr.address1);
+    pRxStatus->rssiAnt0Chain0 = SIM_RX_RSSI;
+    pRxStatus->dataLength     = SIM_FRAME_LENGTH;
+    pRxStatus->rxRate         = pRateTable->info[0].rateCode;
+    pRxStatus->rxTimestamp    = 0x2345;
+    pRxStatus->pktReceivedOK  = 1;
+    pRxStatus->done           = 1;
+    ar5513SimPoke(MAC_RXDP, pT->rxDesc[1].thisPhysPtr);
+
+    status = halProcessRxDesc(pDev, pDesc);
+    if (status != A_OK || pDesc->status.rx.dataLength != SIM_FRAME_LENGTH ||
+        pDesc->status.rx.rssi != SIM_RX_RSSI || pDesc->status.rx.rate != 0 ||
+        pDesc->status.rx.timestamp != 0x2345 || pDesc->pVportBss != GET_BASE_BSS(pDev))
+    {
+        simTestFail("receive descriptor status", status);
+    }
+
+    /* The second is still the hardware's */
+    status = halProcessRxDesc(pDev, &pT->rxDesc[1]);
+    if (status != A_EBUSY) {
+        simTestFail("receive descriptor owned by the hardware", status);
+    }
+}
+
+int
+main(int argc, char *argv[])
+{
+    SIM_TEST_STATE *pT = &simTest;
+    WLAN_DEV_INFO  *pDev = &pT->dev;
+    EEP_MAP        *pMap;
+    A_STATUS       status;
+
+    simTestBuildEeprom(pT->eeprom);
+    status = ar5513SimAttach(pT->eeprom, SIM_EEPROM_WORDS);
+    if (status != A_OK) {
+        simTestFail("simulator attach", status);
+    }
+
+    pDev->pOSHandle            = &pT->osDev;
+    pDev->pciInfo.DeviceID     = AR5513_DEVID;
+    pDev->staConfig.txChainCtrl = CHAIN_FIXED_A;
+    pDev->staConfig.rxChainCtrl = CHAIN_FIXED_A;
+    pDev->staConfig.bssType     = INFRASTRUCTURE_BSS;
+    pDev->staConfig.hwTxRetries = SIM_HW_TX_RETRIES;
+    pDev->defaultStaConfig      = pDev->staConfig;
+
+    status = halAttach(pDev);
+    if (status != A_OK) {
+        simTestFail("halAttach", status);
+    }
+    if (!IS_5112(pDev)) {
+        simTestFail("radio revision", A_ERROR);
+    }
+
+    /* The calibration stays in the EEPROM cache until a reset needs it */
+    pMap = pDev->pHalInfo->pEepData;
+    if (pMap->pRawEeprom == NULL || pMap->chain[0].expanded || pMap->chain[0].expnModes) {
+        simTestFail("calibration parsed at attach", A_ERROR);
+    }
+
+    pT->chan.channel      = SIM_CHANNEL;
+    pT->chan.channelFlags = CHANNEL_A;
+    status = halReset(pDev, WLAN_STA_SERVICE, &pT->chan, FALSE);
+    if (status != A_OK) {
+        simTestFail("halReset", status);
+    }
+    if (!(ar5513SimRead(pDev, PHY_ACTIVE) & PHY_ACTIVE_EN)) {
+        simTestFail("PHY not activated by reset", A_ERROR);
+    }
+
+    /* The only calibrated mode is now parsed and the cache dropped */
+    if (!pMap->chain[0].expanded || pMap->chain[0].expnModes != (1 << headerInfo11A) ||
+        pMap->pRawEeprom != NULL)
+    {
+        simTestFail("calibration not parsed by reset", A_ERROR);
+    }
+
+    /* What the driver sets up for the BSS before queueing frames */
+    pDev->localSta                 = &pT->localSta;
+    pDev->staConfig.pChannel       = &pT->chan;
+    pDev->baseBss.bss.pRateTable   = pDev->hwRateTable[WIRELESS_MODE_11a];
+    pDev->rxFilterReg              = HAL_RX_UCAST;
+
+    simTestTxDesc(pT);
+    simTestRxDesc(pT);
+
+    halDetach(pDev);
+    ar5513SimDetach();
+
+    printf("PASS\n");
+    return 0;
+}
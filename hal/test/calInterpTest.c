@@ -0,0 +1,408 @@
+/*
+ *  Copyright (c) 2004 Atheros Communications, Inc., All Rights Reserved
+ *
+ *  Host test of the calibration pier search and interpolation.  The
+ *  bisecting halCalInterp routines and ar5211FindValueInList are
+ *  compared, over random ascending lists, with the linear scans the
+ *  chip files carried before them (copied below as they were).  Any
+ *  difference in a result fails the test.
+ *
+ *  ar5211Reset.c is included so its static ar5211FindValueInList can
+ *  be called; --gc-sections drops the rest of it.  Build and run from
+ *  hal/:
+ *
+ *      cc -DBUILD_AR5211 -DBUILD_AP -DPCI_INTERFACE -Itest/stub -I. \
+ *          -Iar5211 -ffunction-sections -Wl,--gc-sections \
+ *          test/calInterpTest.c halCalInterp.c -o calInterpTest
+ *      ./calInterpTest [seed]
+ */
+
+#include "ar5211/ar5211Reset.c"
+
+#include <stdarg.h>
+
+#define NUM_ITERATIONS      500000
+
+static A_UINT32 numErrors;
+
+A_UINT32
+readPlatformReg(void *pDev, A_UINT32 reg)
+{
+    return 0;
+}
+
+void
+writePlatformReg(void *pDev, A_UINT32 reg, A_UINT32 value)
+{
+}
+
+int
+uiPrintf(const char *format, ...)
+{
+    va_list args;
+    int     n;
+
+    va_start(args, format);
+    n = vprintf(format, args);
+    va_end(args);
+    return n;
+}
+
+/**************************************************************
+ * The routines halCalInterp replaced, as ar5211/ar5212/ar5513
+ * had them.
+ */
+static A_BOOL
+oldFindValueInList(A_UINT16 channel, A_UINT16 pcdacValue, PCDACS_EEPROM *pSrcStruct, A_UINT16 *powerValue)
+{
+    DATA_PER_CHANNEL    *pChannelData;
+    A_UINT16            *pPcdac;
+    A_UINT16            i, j;
+
+    pChannelData = pSrcStruct->pDataPerChannel;
+
+    for (i = 0; i < pSrcStruct->numChannels; i++ ) {
+        if (pChannelData->channelValue == channel) {
+            pPcdac = pChannelData->PcdacValues;
+
+            for (j = 0; j < pChannelData->numPcdacValues; j++ ) {
+                if (*pPcdac == pcdacValue) {
+                    *powerValue = pChannelData->PwrValues[j];
+                    return TRUE;
+                }
+                pPcdac++;
+            }
+        }
+        pChannelData++;
+    }
+
+    return FALSE;
+}
+
+static A_UINT16
+oldGetInterpolatedValue(A_UINT16 target, A_UINT16 srcLeft, A_UINT16 srcRight,
+                        A_UINT16 targetLeft, A_UINT16 targetRight, A_BOOL scaleUp)
+{
+    A_UINT16 returnValue;
+    A_INT16 lRatio;
+    A_UINT16 scaleValue = EEP_SCALE;
+
+    if ((targetLeft * targetRight) == 0) {
+        return 0;
+    }
+
+    if (scaleUp) {
+        scaleValue = 1;
+    }
+
+    if (srcRight != srcLeft) {
+        lRatio = ((target - srcLeft) * EEP_SCALE / (srcRight - srcLeft));
+        if (lRatio < 0) {
+            returnValue = targetLeft * (scaleUp ? EEP_SCALE : 1);
+        } else if (lRatio > EEP_SCALE) {
+            returnValue = targetRight * (scaleUp ? EEP_SCALE : 1);
+        } else {
+            returnValue = ((lRatio * targetRight + (EEP_SCALE - lRatio) *
+                                  targetLeft) / scaleValue);
+        }
+    } else {
+        returnValue = targetLeft * (scaleUp ? EEP_SCALE : 1);
+    }
+
+    return returnValue;
+}
+
+static void
+oldGetLowerUpperValues(A_UINT16 value, A_UINT16 *pList, A_UINT16 listSize,
+                       A_UINT16 *pLowerValue, A_UINT16 *pUpperValue)
+{
+    A_UINT16    i;
+    A_UINT16    listEndValue = *(pList + listSize - 1);
+    A_UINT32    target       = value * EEP_SCALE;
+
+    if (target < (A_UINT32)(*pList * EEP_SCALE - EEP_DELTA)) {
+        *pLowerValue = *pList;
+        *pUpperValue = *pList;
+        return;
+    }
+
+    if (target > (A_UINT32)(listEndValue * EEP_SCALE + EEP_DELTA)) {
+        *pLowerValue = listEndValue;
+        *pUpperValue = listEndValue;
+        return;
+    }
+
+    for (i = 0; i < listSize; i++) {
+        if (A_ABS(pList[i] * EEP_SCALE - (A_INT32)target) < EEP_DELTA) {
+            *pLowerValue = pList[i];
+            *pUpperValue = pList[i];
+            return;
+        }
+
+        if (target < (A_UINT32)(pList[i + 1] * EEP_SCALE - EEP_DELTA)) {
+            *pLowerValue = pList[i];
+            *pUpperValue = pList[i + 1];
+            return;
+        }
+    }
+}
+
+/* ar5513 - unsigned lists */
+static void
+oldGetLowerUpperIndex(A_UINT16 value, A_UINT16 *pList, A_UINT16 listSize, A_UINT32 *pLowerValue,
+                      A_UINT32 *pUpperValue)
+{
+    A_UINT16    i;
+    A_UINT16    listEndValue = *(pList + listSize - 1);
+    A_UINT16    target = value ;
+
+    if (target <= (*pList)) {
+        *pLowerValue = 0;
+        *pUpperValue = 0;
+        return;
+    }
+
+    if (target >= listEndValue) {
+        *pLowerValue = listSize - 1;
+        *pUpperValue = listSize - 1;
+        return;
+    }
+
+    for(i = 0; i < listSize; i++) {
+        if (pList[i] == target) {
+            *pLowerValue = i;
+            *pUpperValue = i;
+            return;
+        }
+
+        if (target < pList[i + 1]) {
+            *pLowerValue = i;
+            *pUpperValue = i + 1;
+            return;
+        }
+    }
+}
+
+/* ar5212 - the 2413 power lists are signed */
+static void
+oldGetLowerUpperIndexSigned(A_INT16 value, A_UINT16 *pList, A_UINT16 listSize, A_UINT32 *pLowerValue,
+                            A_UINT32 *pUpperValue)
+{
+    A_UINT16    i;
+    A_INT16     listEndValue = *(pList + listSize - 1);
+    A_INT16     target = value ;
+
+    if (target <= (*pList)) {
+        *pLowerValue = 0;
+        *pUpperValue = 0;
+        return;
+    }
+
+    if (target >= listEndValue) {
+        *pLowerValue = listSize - 1;
+        *pUpperValue = listSize - 1;
+        return;
+    }
+
+    for(i = 0; i < listSize; i++) {
+        if (pList[i] == target) {
+            *pLowerValue = i;
+            *pUpperValue = i;
+            return;
+        }
+
+        if (target < pList[i + 1]) {
+            *pLowerValue = i;
+            *pUpperValue = i + 1;
+            return;
+        }
+    }
+}
+
+static A_INT16
+oldGetInterpolatedValue_Signed16(A_UINT16 target, A_UINT16 srcLeft, A_UINT16 srcRight,
+                                 A_INT16 targetLeft, A_INT16 targetRight)
+{
+    A_INT16 returnValue;
+
+    if (srcRight != srcLeft) {
+        returnValue = (A_INT16)( ( (target - srcLeft)*targetRight + (srcRight - target)*targetLeft)/(srcRight - srcLeft));
+    } else {
+        returnValue = targetLeft;
+    }
+    return (returnValue);
+}
+
+/**************************************************************
+ * calTestList
+ *
+ * Fills pList with n ascending values from about base, with
+ * repeats if dupOk.
+ */
+static void
+calTestList(A_UINT16 *pList, int n, int base, int step, A_BOOL dupOk)
+{
+    int i, v = base + rand() % (step + 1);
+
+    for (i = 0; i < n; i++) {
+        pList[i] = (A_UINT16)v;
+        v += dupOk ? rand() % (step + 1) : 1 + rand() % step;
+    }
+}
+
+static void
+calTestCheck(A_BOOL same, const char *what, long iter)
+{
+    if (!same) {
+        if (numErrors++ < 10) {
+            printf("FAIL: %s differs at iteration %ld\n", what, iter);
+        }
+    }
+}
+
+/**************************************************************
+ * calTestSearch
+ *
+ * The pier searches on one random list of n entries.
+ */
+static void
+calTestSearch(long iter)
+{
+    A_UINT16 list[64], lo1, hi1, lo2, hi2, value;
+    A_INT16  sList[64], sValue;
+    A_UINT32 a, b, c, d;
+    int      n, base, step, v, k;
+
+    n    = 1 + rand() % 64;
+    base = (rand() % 4 == 0) ? 0 : rand() % 6000;
+    step = 1 + rand() % 40;
+    calTestList(list, n, base, step, rand() & 1);
+    value = (rand() % 3 == 0) ? list[rand() % n] :
+            (A_UINT16)(base - 50 + rand() % (n * step + 100));
+
+    oldGetLowerUpperValues(value, list, (A_UINT16)n, &lo1, &hi1);
+    halCalGetLowerUpperValues(value, list, (A_UINT16)n, &lo2, &hi2);
+    calTestCheck(lo1 == lo2 && hi1 == hi2, "halCalGetLowerUpperValues", iter);
+
+    oldGetLowerUpperIndex(value, list, (A_UINT16)n, &a, &b);
+    halCalGetLowerUpperIndex(value, list, (A_UINT16)n, &c, &d);
+    calTestCheck(a == c && b == d, "halCalGetLowerUpperIndex", iter);
+
+    /* Signed, as the 2413 power lists */
+    v = -200 + rand() % 400;
+    for (k = 0; k < n; k++) {
+        sList[k] = (A_INT16)v;
+        v += rand() % 9;
+    }
+    sValue = (A_INT16)(-250 + rand() % (500 + n * 8));
+    oldGetLowerUpperIndexSigned(sValue, (A_UINT16 *)sList, (A_UINT16)n, &a, &b);
+    halCalGetLowerUpperIndex(sValue, (A_UINT16 *)sList, (A_UINT16)n, &c, &d);
+    calTestCheck(a == c && b == d, "halCalGetLowerUpperIndex (signed)", iter);
+}
+
+/**************************************************************
+ * calTestFindValue
+ *
+ * ar5211FindValueInList on a random set of calibrated channels,
+ * filled as the EEPROM reader does: pDataPerChannel[i] for
+ * pChannelList[i].
+ */
+static void
+calTestFindValue(long iter)
+{
+    static A_UINT16         channels[NUM_11A_EEPROM_CHANNELS];
+    static DATA_PER_CHANNEL data[NUM_11A_EEPROM_CHANNELS];
+    PCDACS_EEPROM           src;
+    A_UINT16                channel, pcdac, pwr1 = 0, pwr2 = 0;
+    A_BOOL                  found1, found2;
+    int                     n, i, k;
+
+    n = 1 + rand() % NUM_11A_EEPROM_CHANNELS;
+    calTestList(channels, n, 4900 + rand() % 100, 40, rand() % 4 == 0);
+    for (i = 0; i < n; i++) {
+        data[i].channelValue   = channels[i];
+        data[i].numPcdacValues = (A_UINT16)(rand() % (NUM_PCDAC_VALUES + 1));
+        calTestList(data[i].PcdacValues, data[i].numPcdacValues, 1 + rand() % 8, 6,
+                    rand() % 4 == 0);
+        for (k = 0; k < data[i].numPcdacValues; k++) {
+            data[i].PwrValues[k] = (A_INT16)(rand() % 200);
+        }
+    }
+    src.pChannelList    = channels;
+    src.numChannels     = (A_UINT16)n;
+    src.pDataPerChannel = data;
+
+    channel = (rand() % 4) ? channels[rand() % n] : (A_UINT16)(4880 + rand() % 500);
+    pcdac   = (A_UINT16)(rand() % 70);
+    found1  = oldFindValueInList(channel, pcdac, &src, &pwr1);
+    found2  = ar5211FindValueInList(channel, pcdac, &src, &pwr2);
+    calTestCheck(found1 == found2 && pwr1 == pwr2, "ar5211FindValueInList", iter);
+}
+
+/**************************************************************
+ * calTestInterpolate
+ *
+ * halCalInterpolate, halCalInterpolateSigned16 and, now and then,
+ * halCalInterpolateVector on a whole 64 entry table.
+ */
+static void
+calTestInterpolate(long iter)
+{
+    A_INT16  left[64], right[64], out[64];
+    A_UINT16 srcLeft, srcRight, target, tLeft, tRight;
+    A_INT16  sLeft, sRight;
+    A_BOOL   scaleUp;
+    int      k;
+
+    srcLeft  = (A_UINT16)(rand() % 6000);
+    srcRight = (A_UINT16)(srcLeft + rand() % 40);
+    target   = (A_UINT16)(srcLeft - 20 + rand() % 80);
+    tLeft    = (A_UINT16)(rand() % 8 ? rand() % 400 : 0);
+    tRight   = (A_UINT16)(rand() % 400);
+    scaleUp  = rand() & 1;
+    calTestCheck(oldGetInterpolatedValue(target, srcLeft, srcRight, tLeft, tRight, scaleUp) ==
+                 halCalInterpolate(target, srcLeft, srcRight, tLeft, tRight, scaleUp),
+                 "halCalInterpolate", iter);
+
+    sLeft  = (A_INT16)(rand() % 400 - 100);
+    sRight = (A_INT16)(rand() % 400 - 100);
+    calTestCheck(oldGetInterpolatedValue_Signed16(target, srcLeft, srcRight, sLeft, sRight) ==
+                 halCalInterpolateSigned16(target, srcLeft, srcRight, sLeft, sRight),
+                 "halCalInterpolateSigned16", iter);
+
+    if (iter % 16 == 0) {
+        for (k = 0; k < 64; k++) {
+            left[k]  = (A_INT16)(rand() % 600 - 200);
+            right[k] = (A_INT16)(rand() % 600 - 200);
+        }
+        halCalInterpolateVector(target, srcLeft, srcRight, left, right, out, 64);
+        for (k = 0; k < 64; k++) {
+            calTestCheck(out[k] == oldGetInterpolatedValue_Signed16(target, srcLeft, srcRight,
+                                                                    left[k], right[k]),
+                         "halCalInterpolateVector", iter);
+        }
+    }
+}
+
+int
+main(int argc, char *argv[])
+{
+    int  seed;
+    long iter;
+
+    seed = (argc > 1) ? atoi(argv[1]) : 1;
+    srand(seed);
+
+    for (iter = 0; iter < NUM_ITERATIONS; iter++) {
+        calTestSearch(iter);
+        calTestFindValue(iter);
+        calTestInterpolate(iter);
+    }
+
+    if (numErrors) {
+        printf("FAIL: seed %d, %u differences\n", seed, numErrors);
+        return 1;
+    }
+    printf("PASS: seed %d, %d iterations\n", seed, NUM_ITERATIONS);
+    return 0;
+}
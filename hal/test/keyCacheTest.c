@@ -0,0 +1,440 @@
+/*
+ *  Copyright (c) 2004 Atheros Communications, Inc., All Rights Reserved
+ *
+ *  Host test of the AR5513 key cache allocator.  Random stations are
+ *  keyed, rekeyed and freed, and after every call the key cache
+ *  owners, the TKIP groups, the free slot maps and the LRU lists are
+ *  checked.  With TKIP in use every key must stay below the group
+ *  limit, so that a station rekeyed to TKIP at the index it holds
+ *  gets a hardware group whenever the upper entries can be cleared.
+ *  A single entry key that has to steal must take the entry a scan
+ *  of the key cache would have picked.
+ *
+ *  Build and run from hal/:
+ *
+ *      cc -DBUILD_AR5513 -DAR5513_QOS -Itest/stub -I. -Iar5513 \
+ *          test/keyCacheTest.c halKeyCache.c ar5513/ar5513KeyCache.c \
+ *          -o keyCacheTest
+ *      ./keyCacheTest [seed]
+ */
+
+#include "wlantype.h"
+#include "wlandrv.h"
+#include "halApi.h"
+#include "hal.h"
+#include "ui.h"
+#include "halUtil.h"
+
+/* Headers for HW private items */
+#include "ar5513MacReg.h"
+#include "ar5513Misc.h"
+
+#include <stdarg.h>
+
+A_UINT16
+ar5513KeyCacheAlloc(WLAN_DEV_INFO *pdevInfo, A_UINT16 hwIndex,
+                    SIB_ENTRY *pSib, A_UINT16 keyType, A_BOOL *pHwEncrypt);
+
+void
+ar5513KeyCacheFree(WLAN_DEV_INFO *pdevInfo, A_UINT16 hwIndex);
+
+#define NUM_STA             80
+#define NUM_TRIALS          400
+#define NUM_STEPS           1500
+#define TKIP_GROUP_LIMIT    (MAC_KEY_CACHE_SIZE / 4 - 1)
+#define KEY_TEST_ASSOC(_pSib)   (((_pSib)->staState & (STATE_AUTH|STATE_ASSOC)) ? 1 : 0)
+
+typedef struct keyTestState {
+    WLAN_DEV_INFO       dev;
+    HAL_INFO            halInfo;
+    SIB_ENTRY           *keyCacheSib[MAC_KEY_CACHE_SIZE];
+    WLAN_PRIV_RECORD    *keyCache[MAC_KEY_CACHE_SIZE];
+    SIB_ENTRY           sib[NUM_STA + 1];   /* the last is localSta */
+    A_BOOL              tkip[NUM_STA];
+    A_BOOL              hwEncrypt[NUM_STA];
+} KEY_TEST_STATE;
+
+static KEY_TEST_STATE   keyTest;
+static A_UINT32         numAllocs, numSwFallbacks, numRekeys, numSteals;
+
+A_UINT32
+readPlatformReg(void *pDev, A_UINT32 reg)
+{
+    return 0;
+}
+
+void
+writePlatformReg(void *pDev, A_UINT32 reg, A_UINT32 value)
+{
+}
+
+A_UINT32
+halRegIoCycles(void)
+{
+    return 0;
+}
+
+A_UINT32
+halGetCapability(WLAN_DEV_INFO *pDev, HAL_CAPABILITY_TYPE requestType, A_UINT32 param)
+{
+    return 0;
+}
+
+void
+ar5513SetDefAntenna(WLAN_DEV_INFO *pDev, A_UINT32 antenna)
+{
+}
+
+int
+uiPrintf(const char *format, ...)
+{
+    va_list args;
+    int     n;
+
+    va_start(args, format);
+    n = vprintf(format, args);
+    va_end(args);
+    return n;
+}
+
+void
+swretryStateReset(WLAN_DEV_INFO *pDev, SIB_ENTRY *pSib, A_BOOL clearDest,
+                  A_BOOL clearFiltered)
+{
+}
+
+static void
+keyTestFail(const char *what, int sta, A_UINT16 hwIndex)
+{
+    printf("FAIL: %s (station %d, index %d)\n", what, sta, hwIndex);
+    exit(1);
+}
+
+/**************************************************************
+ * keyTestCheckLru
+ *
+ * Each LRU list is properly linked, holds stations of its own
+ * state at their own entries, oldest first, and every keyed
+ * station other than localSta is on one.
+ */
+static void
+keyTestCheckLru(KEY_TEST_STATE *pT, int numSta)
+{
+    HAL_KEY_SLOTS *pSlots = &pT->halInfo.keySlots;
+    SIB_ENTRY     *pSib, *pPrevSib;
+    A_UINT32      list, idx, prev;
+    int           s, numLinked = 0, numKeyed = 0;
+
+    for (list = 0; list < 2; list++) {
+        prev = HAL_KEY_SLOT_NONE;
+        for (idx = pSlots->lruHead[list]; idx != HAL_KEY_SLOT_NONE;
+             idx = pSlots->lruNext[idx])
+        {
+            pSib = pT->keyCacheSib[idx];
+            if (idx >= MAC_KEY_CACHE_SIZE || ++numLinked > MAC_KEY_CACHE_SIZE ||
+                pSlots->lruList[idx] != list || pSlots->lruPrev[idx] != prev)
+            {
+                keyTestFail("LRU list broken", -1, (A_UINT16)idx);
+            }
+            if (pSib == NULL || pSib == pT->dev.localSta ||
+                pSib->hwIndex != idx || KEY_TEST_ASSOC(pSib) != (int)list)
+            {
+                keyTestFail("LRU entry not a station's own", -1, (A_UINT16)idx);
+            }
+            if (prev != HAL_KEY_SLOT_NONE) {
+                pPrevSib = pT->keyCacheSib[prev];
+                if (pPrevSib->staLastActivityTime > pSib->staLastActivityTime ||
+                    (pPrevSib->staLastActivityTime == pSib->staLastActivityTime &&
+                     prev > idx))
+                {
+                    keyTestFail("LRU list out of order", -1, (A_UINT16)idx);
+                }
+            }
+            prev = idx;
+        }
+        if (pSlots->lruTail[list] != prev) {
+            keyTestFail("LRU tail wrong", -1, (A_UINT16)prev);
+        }
+    }
+
+    for (s = 0; s < numSta; s++) {
+        if (pT->sib[s].hwIndex != HWINDEX_INVALID) {
+            numKeyed++;
+        }
+    }
+    if (numKeyed != numLinked) {
+        keyTestFail("keyed station missing from the LRU lists", -1, HWINDEX_INVALID);
+    }
+}
+
+/**************************************************************
+ * keyTestCheck
+ *
+ * Every keyed station owns its entry, a hardware TKIP key owns its
+ * whole group, the free slot maps and LRU lists match keyCacheSib[]
+ * and, with TKIP in use, no key sits above the group limit.
+ */
+static void
+keyTestCheck(KEY_TEST_STATE *pT, int numSta)
+{
+    HAL_KEY_SLOTS *pSlots = &pT->halInfo.keySlots;
+    A_BOOL        tkipInUse;
+    SIB_ENTRY     *pSib;
+    int           s, k, i;
+
+    tkipInUse = pT->dev.staConfig.encryptionAlg == ENCRYPTION_TKIP ||
+                pT->dev.staConfig.encryptionAlg == ENCRYPTION_AUTO;
+
+    for (s = 0; s < numSta; s++) {
+        pSib = &pT->sib[s];
+        if (pSib->hwIndex == HWINDEX_INVALID) {
+            continue;
+        }
+        if (pT->keyCacheSib[pSib->hwIndex] != pSib) {
+            keyTestFail("entry not owned by its station", s, pSib->hwIndex);
+        }
+        if (tkipInUse && pSib->hwIndex >= TKIP_GROUP_LIMIT) {
+            keyTestFail("key above the TKIP group limit", s, pSib->hwIndex);
+        }
+        if (pT->tkip[s] && pT->hwEncrypt[s]) {
+            for (k = 1; k < 4; k++) {
+                if (pT->keyCacheSib[pSib->hwIndex + 32 * k] != pSib) {
+                    keyTestFail("TKIP group broken", s, pSib->hwIndex);
+                }
+            }
+        }
+    }
+
+    if (pSlots->valid) {
+        for (i = 0; i < MAC_KEY_CACHE_SIZE; i++) {
+            if ((A_BOOL)((pSlots->freeMap[i >> 5] >> (i & 31)) & 1) !=
+                (pT->keyCacheSib[i] == NULL))
+            {
+                keyTestFail("free slot map out of date", -1, (A_UINT16)i);
+            }
+        }
+        keyTestCheckLru(pT, numSta);
+    }
+}
+
+/**************************************************************
+ * keyTestVictim
+ *
+ * The station a single entry key for pSib must steal from, as
+ * the scan over keyCacheSib[] picked it: the least recently
+ * active idle station below the index limit, preferring those
+ * neither authenticated nor associated, lowest index first on a
+ * tie.  NULL if there is a free entry to take instead, or no
+ * station can give one up.
+ */
+static SIB_ENTRY *
+keyTestVictim(KEY_TEST_STATE *pT, int numSta)
+{
+    SIB_ENTRY *pSib, *pBest = NULL;
+    A_BOOL    skipShared;
+    int       s, i, indexLimit;
+
+    if (pT->dev.staConfig.encryptionAlg == ENCRYPTION_TKIP ||
+        pT->dev.staConfig.encryptionAlg == ENCRYPTION_AUTO)
+    {
+        indexLimit = TKIP_GROUP_LIMIT;
+    } else {
+        indexLimit = MAC_KEY_CACHE_SIZE -
+                     ((pT->dev.staConfig.txChainCtrl == DUAL_CHAIN) ? 4 : 2);
+    }
+    skipShared = pT->dev.localSta->serviceType == WLAN_STA_SERVICE;
+
+    for (i = MAX_SHARED_KEYS; i < indexLimit; i++) {
+        if (!(skipShared && (i & 0x1F) < MAX_SHARED_KEYS) &&
+            pT->keyCacheSib[i] == NULL)
+        {
+            return NULL;
+        }
+    }
+    for (s = 0; s < numSta; s++) {
+        pSib = &pT->sib[s];
+        i    = pSib->hwIndex;
+        if (i == HWINDEX_INVALID || i < MAX_SHARED_KEYS || i >= indexLimit ||
+            (skipShared && (i & 0x1F) < MAX_SHARED_KEYS) ||
+            pSib->totalTxPending > 0)
+        {
+            continue;
+        }
+        if (pBest == NULL ||
+            KEY_TEST_ASSOC(pSib) < KEY_TEST_ASSOC(pBest) ||
+            (KEY_TEST_ASSOC(pSib) == KEY_TEST_ASSOC(pBest) &&
+             (pSib->staLastActivityTime < pBest->staLastActivityTime ||
+              (pSib->staLastActivityTime == pBest->staLastActivityTime &&
+               pSib->hwIndex < pBest->hwIndex))))
+        {
+            pBest = pSib;
+        }
+    }
+    return pBest;
+}
+
+/**************************************************************
+ * keyTestGroupClearable
+ *
+ * TRUE if the allocator can hand TKIP group hwIndex to pSib:
+ * each upper entry is free, already pSib's, or the only entry of
+ * an idle station other than localSta.
+ */
+static A_BOOL
+keyTestGroupClearable(KEY_TEST_STATE *pT, A_UINT16 hwIndex, SIB_ENTRY *pSib)
+{
+    SIB_ENTRY *pOther;
+    int       k;
+
+    if (hwIndex >= MAC_KEY_CACHE_SIZE / 4) {
+        return FALSE;
+    }
+    for (k = 1; k < 4; k++) {
+        pOther = pT->keyCacheSib[hwIndex + 32 * k];
+        if (pOther != NULL && pOther != pSib &&
+            (pOther == pT->dev.localSta ||
+             pOther->hwIndex != hwIndex + 32 * k ||
+             pOther->totalTxPending > 0))
+        {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/**************************************************************
+ * keyTestSetup
+ *
+ * A fresh device with the beacon antenna control entries at the
+ * top of the key cache held by localSta, as ar5513 attach leaves
+ * them.
+ */
+static void
+keyTestSetup(KEY_TEST_STATE *pT, int service, int encryptionAlg, int chainCtrl)
+{
+    int i, numAntEntries;
+
+    A_MEM_ZERO(pT, sizeof(*pT));
+    pT->dev.pHalInfo                = &pT->halInfo;
+    pT->dev.keyCacheSib             = pT->keyCacheSib;
+    pT->dev.keyCache                = pT->keyCache;
+    pT->dev.keyCacheSize            = MAC_KEY_CACHE_SIZE;
+    pT->dev.localSta                = &pT->sib[NUM_STA];
+    pT->dev.staConfig.encryptionAlg = encryptionAlg;
+    pT->dev.staConfig.txChainCtrl   = chainCtrl;
+    pT->dev.staConfig.rxChainCtrl   = chainCtrl;
+    pT->sib[NUM_STA].serviceType    = service;
+    for (i = 0; i <= NUM_STA; i++) {
+        pT->sib[i].hwIndex = HWINDEX_INVALID;
+    }
+
+    numAntEntries = (chainCtrl == DUAL_CHAIN) ? 4 : 2;
+    for (i = MAC_KEY_CACHE_SIZE - numAntEntries; i < MAC_KEY_CACHE_SIZE; i++) {
+        ar5513KeyCacheAlloc(&pT->dev, (A_UINT16)i, pT->dev.localSta,
+                            PRIV_KEY_TYPE_WEP, NULL);
+    }
+}
+
+/**************************************************************
+ * keyTestStep
+ *
+ * Keys, rekeys or frees station s.  A rekey may change the key
+ * type, as a station moving from WEP to TKIP does.
+ */
+static void
+keyTestStep(KEY_TEST_STATE *pT, int numSta, int s, A_UINT32 now)
+{
+    SIB_ENTRY *pSib = &pT->sib[s];
+    SIB_ENTRY *pVictim;
+    A_UINT16  keyType, hwIndex, victimIndex = HWINDEX_INVALID;
+    A_BOOL    hwEncrypt, expected;
+    int       o, op = rand() % 10;
+
+    for (o = 0; o < numSta; o++) {
+        pT->sib[o].numTxPending = pT->sib[o].totalTxPending = 0;
+    }
+    pSib->staLastActivityTime = now;
+    pSib->staState            = rand() % 4;
+    if (rand() % 8 == 0) {
+        pSib->numTxPending = pSib->totalTxPending = 1;
+    }
+    halKeyCacheTouch(&pT->dev, pSib);
+
+    if (pSib->hwIndex == HWINDEX_INVALID) {
+        keyType   = pT->tkip[s] ? PRIV_KEY_TYPE_TKIP : PRIV_KEY_TYPE_WEP;
+        pVictim   = NULL;
+        if (keyType == PRIV_KEY_TYPE_WEP) {
+            pVictim = keyTestVictim(pT, numSta);
+            if (pVictim) {
+                victimIndex = pVictim->hwIndex;
+            }
+        }
+        hwEncrypt = TRUE;
+        hwIndex   = ar5513KeyCacheAlloc(&pT->dev, HWINDEX_INVALID, pSib,
+                                        keyType, &hwEncrypt);
+        numAllocs++;
+        if (pVictim) {
+            numSteals++;
+            if (hwIndex != victimIndex || pVictim->hwIndex != HWINDEX_INVALID) {
+                keyTestFail("stole from the wrong station", s, hwIndex);
+            }
+        }
+        if (hwIndex != HWINDEX_INVALID) {
+            pSib->hwIndex    = hwIndex;
+            pT->hwEncrypt[s] = hwEncrypt;
+        }
+    } else if (op < 3) {
+        pSib->numTxPending = pSib->totalTxPending = 0;
+        ar5513KeyCacheFree(&pT->dev, pSib->hwIndex);
+        pSib->hwIndex = HWINDEX_INVALID;
+    } else if (op < 5) {
+        pSib->numTxPending = pSib->totalTxPending = 0;
+        if (rand() % 4 == 0) {
+            pT->tkip[s] = !pT->tkip[s];
+        }
+        keyType   = pT->tkip[s] ? PRIV_KEY_TYPE_TKIP : PRIV_KEY_TYPE_WEP;
+        expected  = !pT->tkip[s] ||
+                    keyTestGroupClearable(pT, pSib->hwIndex, pSib);
+        hwEncrypt = TRUE;
+        ar5513KeyCacheAlloc(&pT->dev, pSib->hwIndex, pSib, keyType,
+                            &hwEncrypt);
+        numRekeys++;
+        if (hwEncrypt != expected) {
+            keyTestFail("rekey in place lost its hardware key", s,
+                        pSib->hwIndex);
+        }
+        pT->hwEncrypt[s] = hwEncrypt;
+        if (pT->tkip[s] && !hwEncrypt) {
+            numSwFallbacks++;
+        }
+    }
+    keyTestCheck(pT, numSta);
+}
+
+int
+main(int argc, char *argv[])
+{
+    KEY_TEST_STATE *pT = &keyTest;
+    int            seed, trial, step, s, numSta, pctTkip;
+
+    seed = (argc > 1) ? atoi(argv[1]) : 1;
+    srand(seed);
+
+    for (trial = 0; trial < NUM_TRIALS; trial++) {
+        keyTestSetup(pT, (rand() % 2) ? WLAN_STA_SERVICE : WLAN_AP_SERVICE,
+                     ENCRYPTION_WEP + rand() % 3,
+                     (rand() % 2) ? DUAL_CHAIN : SINGLE_CHAIN);
+        numSta  = 20 + rand() % (NUM_STA - 20);
+        pctTkip = 20 + rand() % 60;
+        for (s = 0; s < NUM_STA; s++) {
+            pT->tkip[s] = (rand() % 100) < pctTkip;
+        }
+        for (step = 0; step < NUM_STEPS; step++) {
+            keyTestStep(pT, numSta, rand() % numSta, (A_UINT32)step);
+        }
+    }
+
+    printf("PASS: seed %d, %u allocations, %u rekeys, %u steals, %u TKIP software fallbacks\n",
+           seed, numAllocs, numRekeys, numSteals, numSwFallbacks);
+    return 0;
+}
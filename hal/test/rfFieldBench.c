@@ -0,0 +1,415 @@
+/*
+ *  Copyright (c) 2004 Atheros Communications, Inc., All Rights Reserved
+ *
+ *  Host check and timing of the analog bank field edits.
+ *
+ *  reverseBits is compared with the bit at a time loop it replaced
+ *  for every width, and the two are timed.
+ *
+ *  The batched HAL_RF_FIELD edits that were tried for the 5112 bank 6
+ *  and 7 writes are kept below as they were, and compared with the
+ *  per field ModifyRfBuffer/GetRfField calls ar5513Reset.c makes.
+ *  Both give the same bank contents; the edits ar5513SetRfRegs5112
+ *  makes on a 5 GHz reset are then timed both ways.  reverseBits is
+ *  linked from halUtil.c in both, as in the driver, so neither side
+ *  can fold the reversal of a constant.
+ *
+ *  The best of several runs is reported for each.  Build and run from
+ *  hal/, at the optimisation the driver uses:
+ *
+ *      cc -O2 -Itest/stub -I. test/rfFieldBench.c halUtil.c \
+ *          -o rfFieldBench
+ *      ./rfFieldBench
+ */
+
+#include "wlantype.h"
+#include "wlandrv.h"
+#include "halApi.h"
+#include "hal.h"
+#include "ui.h"
+#include "halUtil.h"
+
+#include <stdarg.h>
+#include <time.h>
+
+#define NUM_CHECKS          200000
+#define NUM_RUNS            7
+#define NUM_RESETS          200000
+#define NUM_REVERSES        2000000
+#define BANK6_WORDS         40
+#define BANK7_WORDS         8
+
+A_UINT32
+readPlatformReg(void *pDev, A_UINT32 reg)
+{
+    return 0;
+}
+
+void
+writePlatformReg(void *pDev, A_UINT32 reg, A_UINT32 value)
+{
+}
+
+int
+uiPrintf(const char *format, ...)
+{
+    va_list args;
+    int     n;
+
+    va_start(args, format);
+    n = vprintf(format, args);
+    va_end(args);
+    return n;
+}
+
+/**************************************************************
+ * loopReverseBits - reverseBits as it was, a bit at a time
+ */
+static A_UINT32
+loopReverseBits(A_UINT32 val, A_UINT32 bitCount)
+{
+    A_UINT32 retval = 0;
+    A_UINT32 i;
+
+    for (i = 0; i < bitCount; i++) {
+        retval = (retval << 1) | ((val >> i) & 1);
+    }
+    return retval;
+}
+
+/**************************************************************
+ * The per field routines, as ar5513Reset.c has them
+ */
+static void
+fieldModifyRfBuffer(A_UINT32 *rfBuf, A_UINT32 reg32, A_UINT32 numBits,
+                    A_UINT32 firstBit, A_UINT32 column)
+{
+    A_UINT32 tmp32, mask, arrayEntry, lastBit;
+    A_INT32  bitPosition, bitsLeft;
+
+    tmp32 = reverseBits(reg32, numBits);
+    arrayEntry = (firstBit - 1) / 8;
+    bitPosition = (firstBit - 1) % 8;
+    bitsLeft = numBits;
+    while (bitsLeft > 0) {
+        lastBit = (bitPosition + bitsLeft > 8) ? (8) : (bitPosition + bitsLeft);
+        mask = (((1 << lastBit) - 1) ^ ((1 << bitPosition) - 1)) << (column * 8);
+        rfBuf[arrayEntry] &= ~mask;
+        rfBuf[arrayEntry] |= ((tmp32 << bitPosition) << (column * 8)) & mask;
+        bitsLeft -= (8 - bitPosition);
+        tmp32 = tmp32 >> (8 - bitPosition);
+        bitPosition = 0;
+        arrayEntry++;
+    }
+}
+
+static A_UINT32
+fieldGetRfField(A_UINT32 *rfBuf, A_UINT32 numBits, A_UINT32 firstBit, A_UINT32 column)
+{
+    A_UINT32 reg32 = 0, mask, arrayEntry, lastBit;
+    A_INT32  bitPosition, bitsLeft, bitsShifted;
+
+    arrayEntry = (firstBit - 1) / 8;
+    bitPosition = (firstBit - 1) % 8;
+    bitsLeft = numBits;
+    bitsShifted = 0;
+    while (bitsLeft > 0) {
+        lastBit = (bitPosition + bitsLeft > 8) ? (8) : (bitPosition + bitsLeft);
+        mask = (((1 << lastBit) - 1) ^ ((1 << bitPosition) - 1)) << (column * 8);
+        reg32 |= (((rfBuf[arrayEntry] & mask) >> (column * 8)) >> bitPosition) << bitsShifted;
+        bitsShifted += lastBit - bitPosition;
+        bitsLeft -= (8 - bitPosition);
+        bitPosition = 0;
+        arrayEntry++;
+    }
+    return reverseBits(reg32, numBits);
+}
+
+/**************************************************************
+ * The batched field edits, as they were tried.  A HAL_RF_FIELD is
+ * a field's position worked out once, so that setting it is a
+ * masked update of each word it spans.
+ */
+typedef struct halRfField {
+    A_UINT16    entry;                      /* word holding the first bit */
+    A_UINT8     shift;                      /* first bit's position in its byte */
+    A_UINT8     column;                     /* byte lane */
+    A_UINT8     numBits;
+    A_UINT8     numEntries;                 /* words spanned */
+    A_UINT8     firstMask;                  /* lane bits used in the first word */
+    A_UINT8     lastMask;                   /* lane bits used in the last word */
+} HAL_RF_FIELD;
+
+#define HAL_RF_ENTRY(_firstBit)                 (((_firstBit) - 1) / 8)
+#define HAL_RF_SHIFT(_firstBit)                 (((_firstBit) - 1) % 8)
+#define HAL_RF_NUM_ENTRIES(_numBits, _firstBit) ((HAL_RF_SHIFT(_firstBit) + (_numBits) + 7) / 8)
+#define HAL_RF_FIRST_MASK(_firstBit)            ((0xff << HAL_RF_SHIFT(_firstBit)) & 0xff)
+#define HAL_RF_LAST_MASK(_numBits, _firstBit)   \
+    (0xff >> ((8 - (HAL_RF_SHIFT(_firstBit) + (_numBits)) % 8) % 8))
+
+#define HAL_RF_FIELD_INIT(_numBits, _firstBit, _column) {                       \
+    HAL_RF_ENTRY(_firstBit), HAL_RF_SHIFT(_firstBit), (_column), (_numBits),    \
+    HAL_RF_NUM_ENTRIES(_numBits, _firstBit), HAL_RF_FIRST_MASK(_firstBit),      \
+    HAL_RF_LAST_MASK(_numBits, _firstBit)                                       \
+}
+
+typedef struct halRfEdit {
+    const HAL_RF_FIELD  *pField;
+    A_UINT32            value;
+} HAL_RF_EDIT;
+
+#define HAL_RF_EDIT_ADD(_pEdits, _n, _pField, _val)     do {    \
+    (_pEdits)[_n].pField  = (_pField);                          \
+    (_pEdits)[(_n)++].value = (_val);                           \
+} while (0)
+
+static void
+halRfFieldCompile(HAL_RF_FIELD *pField, A_UINT32 numBits, A_UINT32 firstBit, A_UINT32 column)
+{
+    pField->entry      = (A_UINT16)HAL_RF_ENTRY(firstBit);
+    pField->shift      = (A_UINT8)HAL_RF_SHIFT(firstBit);
+    pField->column     = (A_UINT8)column;
+    pField->numBits    = (A_UINT8)numBits;
+    pField->numEntries = (A_UINT8)HAL_RF_NUM_ENTRIES(numBits, firstBit);
+    pField->firstMask  = (A_UINT8)HAL_RF_FIRST_MASK(firstBit);
+    pField->lastMask   = (A_UINT8)HAL_RF_LAST_MASK(numBits, firstBit);
+}
+
+static void
+halRfFieldSet(A_UINT32 *rfBuf, const HAL_RF_FIELD *pField, A_UINT32 value)
+{
+    A_UINT32 *pWord = &rfBuf[pField->entry];
+    A_UINT32 bits, lane, mask, i;
+    A_UINT32 laneShift = pField->column * 8;
+
+    bits = reverseBits(value, pField->numBits);
+    if (pField->numEntries == 1) {
+        mask   = (A_UINT32)(pField->firstMask & pField->lastMask) << laneShift;
+        *pWord = (*pWord & ~mask) | ((bits << (pField->shift + laneShift)) & mask);
+        return;
+    }
+    for (i = 0; i < pField->numEntries; i++, pWord++) {
+        mask = 0xff;
+        if (i == 0) {
+            mask &= pField->firstMask;
+            lane  = bits << pField->shift;
+            bits >>= 8 - pField->shift;
+        } else {
+            lane  = bits;
+            bits >>= 8;
+        }
+        if (i == pField->numEntries - 1U) {
+            mask &= pField->lastMask;
+        }
+        mask <<= laneShift;
+        *pWord = (*pWord & ~mask) | ((lane << laneShift) & mask);
+    }
+}
+
+static A_UINT32
+halRfFieldGet(const A_UINT32 *rfBuf, const HAL_RF_FIELD *pField)
+{
+    const A_UINT32 *pWord = &rfBuf[pField->entry];
+    A_UINT32       bits = 0, byte, i, shifted = 0;
+
+    for (i = 0; i < pField->numEntries; i++, pWord++) {
+        byte = (*pWord >> (pField->column * 8)) & 0xff;
+        if (i == 0) {
+            byte = (byte & pField->firstMask) >> pField->shift;
+        }
+        bits    |= byte << shifted;
+        shifted += (i == 0) ? 8 - pField->shift : 8;
+    }
+    if (pField->numBits < 32) {
+        bits &= (1 << pField->numBits) - 1;
+    }
+    return reverseBits(bits, pField->numBits);
+}
+
+static void
+halRfFieldsApply(A_UINT32 *rfBuf, const HAL_RF_EDIT *pEdits, A_UINT32 numEdits)
+{
+    A_UINT32 i;
+
+    for (i = 0; i < numEdits; i++) {
+        halRfFieldSet(rfBuf, pEdits[i].pField, pEdits[i].value);
+    }
+}
+
+/* The 5112 bank 6 and 7 fields ar5513SetRfRegs5112 writes */
+static const HAL_RF_FIELD rf5112XpdSel      = HAL_RF_FIELD_INIT(1, 302, 0);
+static const HAL_RF_FIELD rf5112XpdGain0    = HAL_RF_FIELD_INIT(2, 270, 0);
+static const HAL_RF_FIELD rf5112XpdGain1    = HAL_RF_FIELD_INIT(2, 257, 0);
+static const HAL_RF_FIELD rf5112Pwd[]       = {
+    HAL_RF_FIELD_INIT(1, 168, 3), HAL_RF_FIELD_INIT(1, 169, 3), HAL_RF_FIELD_INIT(1, 170, 3),
+    HAL_RF_FIELD_INIT(1, 174, 3), HAL_RF_FIELD_INIT(1, 175, 3), HAL_RF_FIELD_INIT(1, 176, 3)
+};
+static const HAL_RF_FIELD rf5112Ob5GHz      = HAL_RF_FIELD_INIT(3, 279, 0);
+static const HAL_RF_FIELD rf5112Db5GHz      = HAL_RF_FIELD_INIT(3, 282, 0);
+static const HAL_RF_FIELD rf5112LowPower[]  = {
+    HAL_RF_FIELD_INIT(1, 281, 1), HAL_RF_FIELD_INIT(2, 1, 3), HAL_RF_FIELD_INIT(2, 3, 3),
+    HAL_RF_FIELD_INIT(1, 139, 3), HAL_RF_FIELD_INIT(1, 140, 3)
+};
+static const HAL_RF_FIELD rf5112MixgainOvr  = HAL_RF_FIELD_INIT(2, 37, 0);
+static const HAL_RF_FIELD rf5112GainI       = HAL_RF_FIELD_INIT(6, 14, 0);
+
+static A_UINT32 bank6[BANK6_WORDS], bank7[BANK7_WORDS];
+
+/**************************************************************
+ * benchField / benchBatch
+ *
+ * One reset's worth of bank 6 and 7 edits, v standing in for the
+ * gain and power values.
+ */
+static void
+benchField(A_UINT32 v, const A_UINT32 *pwd)
+{
+    fieldModifyRfBuffer(bank6, v & 1, 1, 302, 0);
+    fieldModifyRfBuffer(bank6, v & 3, 2, 270, 0);
+    fieldModifyRfBuffer(bank6, (v >> 2) & 3, 2, 257, 0);
+    fieldModifyRfBuffer(bank6, pwd[0], 1, 168, 3);
+    fieldModifyRfBuffer(bank6, pwd[1], 1, 169, 3);
+    fieldModifyRfBuffer(bank6, pwd[2], 1, 170, 3);
+    fieldModifyRfBuffer(bank6, pwd[3], 1, 174, 3);
+    fieldModifyRfBuffer(bank6, pwd[4], 1, 175, 3);
+    fieldModifyRfBuffer(bank6, pwd[5], 1, 176, 3);
+    fieldModifyRfBuffer(bank6, v & 7, 3, 279, 0);
+    fieldModifyRfBuffer(bank6, (v >> 3) & 7, 3, 282, 0);
+    fieldModifyRfBuffer(bank6, 1, 1, 281, 1);
+    fieldModifyRfBuffer(bank6, 1, 2, 1, 3);
+    fieldModifyRfBuffer(bank6, 1, 2, 3, 3);
+    fieldModifyRfBuffer(bank6, 1, 1, 139, 3);
+    fieldModifyRfBuffer(bank6, 1, 1, 140, 3);
+
+    fieldModifyRfBuffer(bank7, pwd[6], 2, 37, 0);
+    fieldModifyRfBuffer(bank7, v & 0x3f, 6, 14, 0);
+}
+
+static void
+benchBatch(A_UINT32 v, const A_UINT32 *pwd)
+{
+    HAL_RF_EDIT edits[16];
+    A_UINT32    numEdits = 0;
+    int         i;
+
+    HAL_RF_EDIT_ADD(edits, numEdits, &rf5112XpdSel, v & 1);
+    HAL_RF_EDIT_ADD(edits, numEdits, &rf5112XpdGain0, v & 3);
+    HAL_RF_EDIT_ADD(edits, numEdits, &rf5112XpdGain1, (v >> 2) & 3);
+    for (i = 0; i < 6; i++) {
+        HAL_RF_EDIT_ADD(edits, numEdits, &rf5112Pwd[i], pwd[i]);
+    }
+    HAL_RF_EDIT_ADD(edits, numEdits, &rf5112Ob5GHz, v & 7);
+    HAL_RF_EDIT_ADD(edits, numEdits, &rf5112Db5GHz, (v >> 3) & 7);
+    for (i = 0; i < 5; i++) {
+        HAL_RF_EDIT_ADD(edits, numEdits, &rf5112LowPower[i], 1);
+    }
+    halRfFieldsApply(bank6, edits, numEdits);
+
+    numEdits = 0;
+    HAL_RF_EDIT_ADD(edits, numEdits, &rf5112MixgainOvr, pwd[6]);
+    HAL_RF_EDIT_ADD(edits, numEdits, &rf5112GainI, v & 0x3f);
+    halRfFieldsApply(bank7, edits, numEdits);
+}
+
+static double
+elapsedNs(const struct timespec *pT0, const struct timespec *pT1, A_UINT32 count)
+{
+    return ((pT1->tv_sec - pT0->tv_sec) * 1e9 + (pT1->tv_nsec - pT0->tv_nsec)) / count;
+}
+
+static double
+benchResetNs(void (*pFunc)(A_UINT32, const A_UINT32 *))
+{
+    static A_UINT32 pwd[7];
+    struct timespec t0, t1;
+    double          ns, best = 0;
+    A_UINT32        i;
+    int             run;
+
+    for (run = 0; run < NUM_RUNS; run++) {
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        for (i = 0; i < NUM_RESETS; i++) {
+            pwd[i % 7] = i & 1;
+            pFunc(i, pwd);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        ns = elapsedNs(&t0, &t1, NUM_RESETS);
+        if (run == 0 || ns < best) {
+            best = ns;
+        }
+    }
+    return best;
+}
+
+volatile A_UINT32 reverseSink;
+
+static double
+benchReverseNs(A_UINT32 (*pFunc)(A_UINT32, A_UINT32))
+{
+    struct timespec t0, t1;
+    double          ns, best = 0;
+    A_UINT32        i, sum;
+    int             run;
+
+    for (run = 0; run < NUM_RUNS; run++) {
+        sum = 0;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        for (i = 0; i < NUM_REVERSES; i++) {
+            /* The widths the bank fields use */
+            sum += pFunc(i * 0x9e3779b9, 1 + (i & 7));
+        }
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        reverseSink = sum;
+        ns = elapsedNs(&t0, &t1, NUM_REVERSES);
+        if (run == 0 || ns < best) {
+            best = ns;
+        }
+    }
+    return best;
+}
+
+int
+main(int argc, char *argv[])
+{
+    A_UINT32     a[48], b[48], i, n, firstBit, column, value, numErrors = 0;
+    HAL_RF_FIELD field;
+    double       loopNs, lutNs, fieldNs, batchNs;
+    int          t;
+
+    srand(1);
+    for (n = 0; n <= 32; n++) {
+        for (t = 0; t < 1000; t++) {
+            value = rand() ^ (rand() << 16);
+            numErrors += loopReverseBits(value, n) != reverseBits(value, n);
+        }
+    }
+    for (t = 0; t < NUM_CHECKS; t++) {
+        n        = 1 + rand() % 24;
+        firstBit = 1 + rand() % (300 - n);
+        column   = rand() % 4;
+        value    = (rand() ^ (rand() << 16)) & ((1u << n) - 1);
+        for (i = 0; i < 48; i++) {
+            a[i] = b[i] = rand() ^ (rand() << 16);
+        }
+        fieldModifyRfBuffer(a, value, n, firstBit, column);
+        halRfFieldCompile(&field, n, firstBit, column);
+        halRfFieldSet(b, &field, value);
+        numErrors += memcmp(a, b, sizeof(a)) != 0;
+        numErrors += fieldGetRfField(a, n, firstBit, column) != halRfFieldGet(b, &field);
+        numErrors += fieldGetRfField(a, n, firstBit, column) != value;
+    }
+    if (numErrors) {
+        printf("FAIL: %u differences between the field routines\n", numErrors);
+        return 1;
+    }
+
+    loopNs  = benchReverseNs(loopReverseBits);
+    lutNs   = benchReverseNs(reverseBits);
+    fieldNs = benchResetNs(benchField);
+    batchNs = benchResetNs(benchBatch);
+    printf("reverseBits: loop %.2f ns, table %.2f ns\n", loopNs, lutNs);
+    printf("5112 bank 6+7 edits per reset: per field %.1f ns, batched %.1f ns\n",
+           fieldNs, batchNs);
+    printf("PASS: fields match\n");
+    return 0;
+}
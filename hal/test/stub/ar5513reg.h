@@ -0,0 +1,10 @@
+/*
+ *  Copyright (c) 2004 Atheros Communications, Inc., All Rights Reserved
+ *
+ *  Host test stand-in for the AR5513 system (non WMAC) registers.
+ */
+
+#ifndef _AR5513REG_H_
+#define _AR5513REG_H_
+
+#endif /* _AR5513REG_H_ */
@@ -0,0 +1,11 @@
+/*
+ *  Copyright (c) 2004 Atheros Communications, Inc., All Rights Reserved
+ *
+ *  Host test stand-in for the driver's debug displays.  The HAL
+ *  sources under test need nothing from it.
+ */
+
+#ifndef _DISPLAY_H_
+#define _DISPLAY_H_
+
+#endif /* _DISPLAY_H_ */
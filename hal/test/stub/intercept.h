@@ -0,0 +1,19 @@
+/*
+ *  Copyright (c) 2004 Atheros Communications, Inc., All Rights Reserved
+ *
+ *  Host test stand-in for the driver's call intercepts.  Intercepted
+ *  entry points are plain functions here.
+ */
+
+#ifndef _INTERCEPT_H_
+#define _INTERCEPT_H_
+
+typedef enum {
+    ICEPT_MACSTOP,
+    ICEPT_MAX
+} ICEPT_ID;
+
+#define ENTRY_FN(_ret, _name, _args, _argNames, _id)    \
+    _ret _name _args
+
+#endif /* _INTERCEPT_H_ */
@@ -0,0 +1,14 @@
+/*
+ *  Copyright (c) 2004 Atheros Communications, Inc., All Rights Reserved
+ *
+ *  Host test stand-in for the driver's packet log.  Nothing is logged.
+ */
+
+#ifndef _PKTLOG_H_
+#define _PKTLOG_H_
+
+#define PKTLOG_TX_PKT(_pDev, ...)           do { } while (0)
+#define PKTLOG_RX_PKT(_pDev, ...)           do { } while (0)
+#define PKTLOG_CHANGE_SLOT_TIME(_pDev, _t)  do { } while (0)
+
+#endif /* _PKTLOG_H_ */
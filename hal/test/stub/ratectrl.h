@@ -0,0 +1,22 @@
+/*
+ *  Copyright (c) 2004 Atheros Communications, Inc., All Rights Reserved
+ *
+ *  Host test stand-in for the driver's rate control.  Each test that
+ *  links the transmit path supplies these.
+ */
+
+#ifndef _RATECTRL_H_
+#define _RATECTRL_H_
+
+A_UINT16
+rcRateFind(WLAN_DEV_INFO *pDev, ATHEROS_DESC *pTxDesc);
+
+A_UINT16
+rcGetBestCckRate(ATHEROS_DESC *pTxDesc, A_UINT16 rateIndex);
+
+void
+rcUpdate(WLAN_DEV_INFO *pDev, SIB_ENTRY *pSib, A_UINT8 rateIndex,
+         A_UINT32 frameLength, A_BOOL xRetry, A_UINT16 retries,
+         A_RSSI rssiAck, A_UINT8 antenna);
+
+#endif /* _RATECTRL_H_ */
@@ -0,0 +1,26 @@
+/*
+ *  Copyright (c) 2004 Atheros Communications, Inc., All Rights Reserved
+ *
+ *  Host test stand-in for the driver's console output.
+ */
+
+#ifndef _UI_H_
+#define _UI_H_
+
+#include <stdio.h>
+
+int
+uiPrintf(const char *format, ...);
+
+#define isrPrintf               uiPrintf
+
+/* Register dump entry point wrapping _name##Helper */
+#define DEFINE_DEBUG_DUMP_FN(_name, _title)             \
+void                                                    \
+_name(WLAN_DEV_INFO *pDev)                              \
+{                                                       \
+    uiPrintf("%s dump\n", _title);                      \
+    _name##Helper(pDev);                                \
+}
+
+#endif /* _UI_H_ */
@@ -0,0 +1,14 @@
+/*
+ *  Copyright (c) 2004 Atheros Communications, Inc., All Rights Reserved
+ *
+ *  Host test stand-in for the driver's virtual port state.  The BSS
+ *  state itself lives in wlandrv.h.
+ */
+
+#ifndef _VPORT_H_
+#define _VPORT_H_
+
+#define GET_BASE_BSS(_pDev)     (&(_pDev)->baseBss)
+#define GET_XR_BSS(_pDev)       ((_pDev)->pXrBss)
+
+#endif /* _VPORT_H_ */
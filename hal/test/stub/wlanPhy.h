@@ -0,0 +1,78 @@
+/*
+ *  Copyright (c) 2004 Atheros Communications, Inc., All Rights Reserved
+ *
+ *  Host test stand-in for the driver's PHY rate tables.  The frame
+ *  time calculations are left to the test, which defines
+ *  phyComputeTxTime.
+ */
+
+#ifndef _WLANPHY_H_
+#define _WLANPHY_H_
+
+typedef enum {
+    WLAN_PHY_OFDM,
+    WLAN_PHY_TURBO,
+    WLAN_PHY_CCK,
+    WLAN_PHY_XR,
+    WLAN_PHY_MAX
+} WLAN_PHY;
+
+typedef enum {
+    WIRELESS_MODE_11a,
+    WIRELESS_MODE_TURBO,
+    WIRELESS_MODE_11b,
+    WIRELESS_MODE_11g,
+    WIRELESS_MODE_108g,
+    WIRELESS_MODE_XR,
+    WIRELESS_MODE_MAX
+} WIRELESS_MODE;
+
+#define MODE_SELECT_11A     0x01
+#define MODE_SELECT_TURBO   0x02
+#define MODE_SELECT_11B     0x04
+#define MODE_SELECT_11G     0x08
+#define MODE_SELECT_108G    0x20
+
+#define RATE_TABLE_SIZE     32
+
+typedef A_UINT16    DURATION;
+
+typedef struct RateTable {
+    int         rateCount;
+    A_UINT8     rateCodeToIndex[RATE_TABLE_SIZE];
+    struct {
+        int         valid;
+        WLAN_PHY    phy;
+        A_UINT16    rateKbps;
+        A_UINT16    userRateKbps;
+        A_UINT8     rateCode;
+        A_UINT8     shortPreamble;
+        A_UINT8     dot11Rate;
+        A_UINT8     controlRate;
+        A_RSSI      rssiAckValidMin;
+        A_RSSI      rssiAckDeltaMin;
+        A_UINT16    lpAckDuration;
+        A_UINT16    spAckDuration;
+    } info[RATE_TABLE_SIZE];
+    A_UINT32    probeInterval;
+    A_UINT32    rssiReduceInterval;
+    A_UINT8     regularToTurboThresh;
+    A_UINT8     turboToRegularThresh;
+    A_UINT8     pktCountThresh;
+    A_UINT8     initialRateMax;
+    A_UINT8     numTurboRates;
+    A_UINT8     xrToRegularThresh;
+    A_UINT8     regularToXrThresh;
+    A_UINT8     xrPktCountThresh;
+} RATE_TABLE;
+
+DURATION
+phyComputeTxTime(const RATE_TABLE *pRateTable, A_UINT32 frameLength,
+                 A_UINT16 rateIndex, A_BOOL shortPreamble);
+
+#define PHY_COMPUTE_TX_TIME(_pRt, _len, _idx, _sp) \
+    phyComputeTxTime((_pRt), (_len), (_idx), (_sp))
+#define PHY_COMPUTE_PKT_TX_TIME(_pRt, _len, _idx, _sp) \
+    phyComputeTxTime((_pRt), (_len), (_idx), (_sp))
+
+#endif /* _WLANPHY_H_ */
@@ -0,0 +1,10 @@
+/*
+ *  Copyright (c) 2004 Atheros Communications, Inc., All Rights Reserved
+ *
+ *  Host test stand-in.
+ */
+
+#ifndef _WLANSEND_H_
+#define _WLANSEND_H_
+
+#endif /* _WLANSEND_H_ */
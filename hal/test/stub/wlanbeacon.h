@@ -0,0 +1,10 @@
+/*
+ *  Copyright (c) 2004 Atheros Communications, Inc., All Rights Reserved
+ *
+ *  Host test stand-in.
+ */
+
+#ifndef _WLANBEACON_H_
+#define _WLANBEACON_H_
+
+#endif /* _WLANBEACON_H_ */
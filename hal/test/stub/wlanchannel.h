@@ -0,0 +1,69 @@
+/*
+ *  Copyright (c) 2004 Atheros Communications, Inc., All Rights Reserved
+ *
+ *  Host test stand-in for the driver's channel flags.
+ */
+
+#ifndef _WLANCHANNEL_H_
+#define _WLANCHANNEL_H_
+
+#define CHANNEL_CW_INT      0x0002
+#define CHANNEL_TURBO       0x0010
+#define CHANNEL_CCK         0x0020
+#define CHANNEL_OFDM        0x0040
+#define CHANNEL_2GHZ        0x0080
+#define CHANNEL_5GHZ        0x0100
+#define CHANNEL_XR          0x0400
+#define CHANNEL_DONT_SCAN   0x1000
+
+#define CHANNEL_A           (CHANNEL_5GHZ | CHANNEL_OFDM)
+#define CHANNEL_B           (CHANNEL_2GHZ | CHANNEL_CCK)
+#define CHANNEL_G           (CHANNEL_2GHZ | CHANNEL_OFDM)
+#define CHANNEL_PUREG       (CHANNEL_2GHZ | CHANNEL_OFDM)
+#define CHANNEL_T           (CHANNEL_5GHZ | CHANNEL_OFDM | CHANNEL_TURBO)
+#define CHANNEL_108G        (CHANNEL_2GHZ | CHANNEL_OFDM | CHANNEL_TURBO)
+#define CHANNEL_XR_A        (CHANNEL_A | CHANNEL_XR)
+#define CHANNEL_XR_G        (CHANNEL_G | CHANNEL_XR)
+#define CHANNEL_XR_T        (CHANNEL_T | CHANNEL_XR)
+#define CHANNEL_ALL         (CHANNEL_OFDM | CHANNEL_CCK | CHANNEL_5GHZ | \
+                             CHANNEL_2GHZ | CHANNEL_TURBO | CHANNEL_XR)
+
+typedef A_UINT16    WLAN_CFLAGS;
+
+#define IS_CHAN_TURBO(_flags)   (((_flags) & CHANNEL_TURBO) != 0)
+#define IS_CHAN_CCK(_flags)     (((_flags) & CHANNEL_CCK) != 0)
+#define IS_CHAN_OFDM(_flags)    (((_flags) & CHANNEL_OFDM) != 0)
+#define IS_CHAN_2GHZ(_flags)    (((_flags) & CHANNEL_2GHZ) != 0)
+#define IS_CHAN_5GHZ(_flags)    (((_flags) & CHANNEL_5GHZ) != 0)
+#define IS_CHAN_XR(_flags)      (((_flags) & CHANNEL_XR) != 0)
+#define IS_CHAN_B(_flags)       (((_flags) & CHANNEL_B) == CHANNEL_B)
+#define IS_CHAN_G(_flags)       (((_flags) & CHANNEL_ALL) == CHANNEL_G)
+#define IS_CHAN_T(_flags)       (((_flags) & CHANNEL_ALL) == CHANNEL_T)
+#define IS_CHAN_108G(_flags)    (((_flags) & CHANNEL_ALL) == CHANNEL_108G)
+#define IS_CHAN_XR_A(_flags)    (((_flags) & CHANNEL_ALL) == CHANNEL_XR_A)
+#define IS_CHAN_XR_G(_flags)    (((_flags) & CHANNEL_ALL) == CHANNEL_XR_G)
+#define IS_CHAN_XR_T(_flags)    (((_flags) & CHANNEL_ALL) == CHANNEL_XR_T)
+
+/* Conformance test limit groups */
+#define CTL_MODE_M          0x0f
+#define CTL_11A             0
+#define CTL_11B             1
+#define CTL_11G             2
+#define CTL_TURBO           3
+#define CTL_108G            4
+#define SD_NO_CTL           0xe0
+#define NO_CTL              0xff
+
+A_UINT16
+wlanConvertGHztoCh(A_UINT16 freq, A_UINT32 channelFlags);
+
+A_UINT16
+wlanGetCtl(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval);
+
+A_INT16
+wlanGetChannelPower(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval);
+
+A_UINT16
+wlanGetAntennaReduction(WLAN_DEV_INFO *pDev, CHAN_VALUES *pChval, A_UINT16 twiceGain);
+
+#endif /* _WLANCHANNEL_H_ */
@@ -0,0 +1,435 @@
+/*
+ *  Copyright (c) 2004 Atheros Communications, Inc., All Rights Reserved
+ *
+ *  Host test stand-in for the driver's device and station state.
+ *  The structures carry only the fields the HAL sources under test
+ *  use; their layout does not match the driver's.
+ */
+
+#ifndef _WLANDRV_H_
+#define _WLANDRV_H_
+
+#include "wlantype.h"
+#include "wlanos.h"
+
+#define FIELD_OFFSET(type, field)   ((A_UINT32)offsetof(type, field))
+
+#define HWINDEX_INVALID         0xffff
+#define DECOMPINDEX_INVALID     0xffff
+#define MAX_SHARED_KEYS         4
+#define KEY_XOR                 0xaa
+#define QUEUE_INDEX_MAX         4
+
+#define STATE_AUTH              0x1
+#define STATE_ASSOC             0x2
+
+#define MAX_REG_ADD_COUNT       32
+
+enum {
+    PRIV_KEY_TYPE_NULL,
+    PRIV_KEY_TYPE_WEP,
+    PRIV_KEY_TYPE_TKIP,
+    PRIV_KEY_TYPE_TKIP_SW,
+    PRIV_KEY_TYPE_AES_OCB,
+    PRIV_KEY_TYPE_AES_CCM,
+    PRIV_KEY_TYPE_CKIP
+};
+
+enum { ENCRYPTION_WEP = 1, ENCRYPTION_TKIP, ENCRYPTION_AUTO };
+enum { WLAN_STA_SERVICE = 1, WLAN_AP_SERVICE };
+enum { SINGLE_CHAIN = 1, DUAL_CHAIN, CHAIN_FIXED_A, CHAIN_FIXED_B };
+enum { INFRASTRUCTURE_BSS = 1, INDEPENDENT_BSS };
+enum { ANTENNA_CONTROLLABLE, ANTENNA_FIXED_A, ANTENNA_FIXED_B };
+enum { STA_MODE_A = 1, STA_MODE_B, STA_MODE_G };
+enum { PROT_MODE_NONE, PROT_MODE_ALWAYS, PROT_MODE_AUTO };
+enum { PROT_TYPE_CTSONLY, PROT_TYPE_RTSCTS };
+enum { POWERMGT_CAM, POWERMGT_PERF, POWERMGT_SLEEP };
+enum { D0_STATE, D1_STATE, D2_STATE, D3_STATE };
+enum { NOT_DONE, TRANSMIT_OK, EXCESSIVE_RETRIES, FILTERED, FIFO_UNDERRUN };
+
+/* Atheros superG features */
+#define ABOLT_TURBO_G           0x01
+#define ABOLT_TURBO_PRIME       0x02
+#define ABOLT_COMPRESSION       0x04
+#define ABOLT_FAST_FRAME        0x08
+#define ABOLT_BURST             0x10
+#define ABOLT_XR                0x20
+#define USE_ABOLT               0
+
+#define DECRYPTERROR_CRC        0x01
+#define DECRYPTERROR_MIC        0x02
+
+#define PSPOLL_RATE_INDEX       0
+#define XR_PSPOLL_RATE_INDEX    0
+#define POWER_UP_TIME           2000            /* us */
+#define DMA_BEACON_RESPONSE_TIME    (2 * 1024)  /* us */
+#define SW_BEACON_RESPONSE_TIME     (10 * 1024)
+#define PCI_STATUS_REGISTER     0x06
+
+#define XR_AIFS                 0
+#define XR_LOG_CWMIN            3
+#define XR_SLOT_DELAY           20
+#define XR_CHIRP_DUR            24
+#define XR_DATA_DETECT_DELAY    50
+
+#define DRV_DEBUG_INT           0x0001
+#define DRV_LOG(_level, _args)  do { } while (0)
+
+enum { ACI_BE, ACI_BK, ACI_Vi, ACI_Vo };
+
+#define LOG_TO_CW(_x)           ((1 << (_x)) - 1)
+#define TXOP_TO_US(_txop)       ((_txop) << 5)
+#define TSF_TO_TU(_tsf)         (((_tsf).high << 22) | ((_tsf).low >> 10))
+#define RTS_THRESHOLD(_pDev)    2346
+#define USE_SHORT_PREAMBLE(_pDev, _pSib, _pHdr)     FALSE
+#define isXrAp(_pDev)           FALSE
+#define XR_CTS_RATE(_pDev)      0x0b
+#define XR_UPLINK_TRANSACTION_TIME(_pDev)           0
+
+typedef int     WLAN_SERVICE;
+typedef A_INT8  A_RSSI;
+typedef A_INT32 A_RSSI32;
+typedef int     ANTENNA_CONTROL;
+
+#include "wlanframe.h"
+#include "wlanPhy.h"
+
+typedef struct { A_UINT32 low, high; } WLAN_TIMESTAMP;
+typedef struct { A_UINT8 length, rates[32]; } WLAN_RATE_SET;
+
+#define NF_CAL_HIST_MAX         5
+
+typedef struct {
+    A_INT16     nfCalBuffer[NF_CAL_HIST_MAX];
+    A_UINT8     currIndex;
+    A_BOOL      isBufferFull;
+} NFCAL_HIST;
+
+typedef struct {
+    A_UINT16    channelFlags;
+    A_UINT16    channel;
+    A_BOOL      iqCalValid;
+    A_INT32     iCoff;
+    A_INT32     qCoff;
+    A_INT16     rawNoiseFloor;
+    A_INT16     finalNoiseFloor;
+    NFCAL_HIST  nfCalHist[2];
+} CHAN_VALUES;
+typedef struct {
+    int         listSize;
+    CHAN_VALUES *chanArray;
+} WLAN_CHANNEL_LIST;
+typedef struct { A_UINT32 Offset, Value; } REGISTER_VAL;
+
+#include "halDesc.h"
+#include "halTxQID.h"
+
+typedef struct {
+    A_UINT16    keyType;
+    A_UINT16    keyLength;
+    A_UINT16    aesKeyLength;
+    A_UINT8     keyVal[32];
+    A_UINT8     micTxKeyVal[8];
+    A_UINT8     micRxKeyVal[8];
+    A_UINT8     aesKeyVal[16];
+} WLAN_PRIV_RECORD;
+
+typedef struct {
+    A_UINT32    TxExcessiveRetries;
+    A_UINT32    TxFiltered;
+    A_UINT32    TxDmaUnderrun;
+    A_UINT32    TransmitErrors;
+    A_UINT32    TotalRetries;
+    A_UINT32    TxUnicastBeamFormed;
+    A_UINT32    RetryBins[16];
+    A_UINT32    shortFrameRetryBins[16];
+    A_UINT32    ReceiveErrors;
+    A_UINT32    RcvCrcErrors;
+    A_UINT32    RcvPhyErrors;
+    A_UINT32    RcvKeyCacheMisses;
+    A_UINT32    RcvDecryptCrcErrors;
+    A_UINT32    AckRcvFailures;
+    A_UINT32    RtsFailCnt;
+    A_UINT32    FcsFailCnt;
+    A_UINT32    RtsSuccessCnt;
+    A_UINT32    RxBeacons;
+    A_RSSI32    ackRssi;
+    A_UINT32    txRateKb;
+} WLAN_STATS;
+
+struct atherosDesc;
+
+typedef struct {
+    struct atherosDesc  *pDescQueueHead;
+    struct atherosDesc  *pDescQueueTail;
+    struct atherosDesc  *pBurstHeadDesc;
+    struct atherosDesc  *pBurstTailDesc;
+    A_UINT32            qFrameCount;
+    A_UINT32            qBurstCount;
+    A_UINT32            pendBFrameCount;
+    A_UINT32            burstCTSDur;
+    A_BOOL              queuingBurst;
+    int                 qSem;
+} QUEUE_DETAILS;
+
+typedef struct {
+    A_UINT16    frameLen;
+} BEACON_INFO;
+
+typedef struct {
+    WLAN_MACADDR        bssId;
+    const RATE_TABLE    *pRateTable;
+    A_UINT16            defaultRateIndex;
+    BEACON_INFO         *pBeaconInfo;
+    QUEUE_DETAILS       burstQueue;
+    QUEUE_DETAILS       wmequeues[QUEUE_INDEX_MAX + 2];
+    struct {
+        struct {
+            A_UINT16    txOpLimit;
+        } ac[4];
+    } phyChAPs;
+} OP_BSS;
+
+typedef struct vportBss {
+    OP_BSS      bss;
+} VPORT_BSS;
+
+typedef struct {
+    struct {
+        A_BOOL      shortSlotTime;
+    } capabilityInfo;
+    struct {
+        A_UINT8     elementID;
+        A_INT8      pwrLimit;
+    } tpcIe;
+    struct {
+        struct {
+            A_UINT8 boost;
+        } info;
+    } athAdvCapElement;
+    A_UINT16    beaconInterval;
+    A_UINT16    timOffset;
+} BSSDESCR;
+
+#define IS_ELEMENT_USED(_pIe)   ((_pIe)->elementID != 0)
+
+typedef struct atherosDesc {
+    A_UINT32                    nextPhysPtr;
+    A_UINT32                    bufferPhysPtr;
+    union {
+        HW_TX_CONTROL_ACCESS    txControl;
+        A_UINT32                word[HAL_MAX_DESC_WORDS];
+    } hw;
+    A_UINT32                    thisPhysPtr;
+    struct atherosDesc          *pNextVirtPtr;
+    struct atherosDesc          *pTxFirstDesc;
+    struct atherosDesc          *pTxLastDesc;
+    struct sibEntry             *pDestSibEntry;
+    VPORT_BSS                   *pVportBss;
+    struct {
+        WLAN_FRAME_HEADER       *header;
+    } pBufferVirtPtr;
+    A_BOOL                      isSyncFrame;
+    A_BOOL                      ffFlag;
+    A_BOOL                      jfFlag;
+    union {
+        struct {
+            A_UINT8     status;
+            A_UINT8     rate;
+            A_UINT16    retryCount;
+            A_UINT16    seqNum;
+            A_UINT16    timestamp;
+        } tx;
+        struct {
+            A_UINT16    dataLength;
+            A_UINT16    timestamp;
+            A_UINT8     hwIndex;
+            A_UINT8     rate;
+            A_RSSI      rssi;
+            A_UINT8     antenna;
+            A_UINT8     phyError;
+            A_UINT8     decryptError;
+        } rx;
+    } status;
+} ATHEROS_DESC;
+
+typedef struct sibEntry {
+    A_UINT16    hwIndex;
+    A_UINT16    decompMaskIndex;
+    A_UINT16    assocId;
+    int         staState;
+    int         serviceType;
+    int         wlanMode;
+    A_UINT32    staLastActivityTime;
+    A_INT32     numTxPending;
+    A_INT32     totalTxPending;
+    A_INT32     numFilteredPending;
+    A_INT32     totalFilteredPending;
+    A_BOOL      needClearDest;
+    struct {
+        A_BOOL  needClearDest;
+    } swRetryInfo[QUEUE_INDEX_MAX];
+    struct {
+        A_UINT8 antChain;
+        A_UINT8 divSxChn;
+    } quadAnt;
+    struct {
+        A_BOOL  shortSlotTime;
+    } capInfo;
+    struct {
+        A_RSSI  rssiLast;
+    } txRateCtrl;
+    WLAN_STATS  stats;
+} SIB_ENTRY;
+
+typedef struct {
+    WLAN_MACADDR    macAddr;
+    WLAN_MACADDR    macPermAddr;
+    int             bssType;
+    int             encryptionAlg;
+    int             txChainCtrl;
+    int             rxChainCtrl;
+    int             quadAnt;
+    int             diversityControl;
+    A_UINT32        overRideTxPower;
+    A_UINT32        tpScale;
+    A_UINT32        calibrationTime;
+    A_BOOL          iqOverride;
+    A_INT32         iCoff;
+    A_INT32         qCoff;
+    A_UINT32        iqLogCountMax;
+    A_UINT32        abolt;
+    A_UINT32        disableTurboG;
+    A_BOOL          removeNoGSubId;
+    A_UINT16        atimWindow;
+    A_UINT16        gBeaconRate;
+    A_UINT32        hwTxRetries;
+    A_BOOL          swretryEnabled;
+    A_BOOL          rateCtrlEnable;
+    A_BOOL          shortSlotTime;
+    int             modeCTS;
+    int             protectionType;
+    A_UINT32        burstSeqThreshold;
+    A_UINT16        quietDuration;
+    A_UINT16        quietOffset;
+    A_BOOL          quietAckCtsAllow;
+    A_UINT32        writeBlockSize;
+    A_BOOL          nfCalHistEnable;
+    A_UINT8         nfCalHistSize;
+    A_INT16         tpcHalfDbm5;
+    A_INT16         tpcHalfDbm2;
+    A_BOOL          enable32KHzClock;
+    A_BOOL          eirpLtdMode;
+    int             sleepMode;
+    CHAN_VALUES     *pChannel;
+    CHAN_VALUES     *phwChannel;
+} WLAN_STA_CONFIG;
+
+typedef struct {
+    A_UINT32    PciSlotNumber;
+    void        *NicAdapterHandle;
+} OS_DEV_INFO;
+
+typedef struct wlanDevInfo {
+    struct HalInfo          *pHalInfo;
+    const struct HwFuncs    *pHwFunc;
+    OS_DEV_INFO             *pOSHandle;
+    WLAN_STA_CONFIG         staConfig;
+    WLAN_STA_CONFIG         defaultStaConfig;
+    SIB_ENTRY               *localSta;
+    SIB_ENTRY               **keyCacheSib;
+    WLAN_PRIV_RECORD        **keyCache;
+    A_UINT32                keyCacheSize;
+    int                     devno;
+    A_UINT32                macVersion;
+    A_UINT32                macRev;
+    A_UINT16                phyRev;
+    A_UINT16                analog5GhzRev;
+    struct {
+        A_UINT16    DeviceID;
+        A_UINT16    SubVendorID;
+        A_UINT32    SubVendorDeviceID;
+    } pciInfo;
+    REGISTER_VAL            *pInitRegs;
+    A_UINT32                MaskReg;
+    A_UINT32                globISRReg;
+    A_UINT32                rxFilterReg;
+    A_UINT16                maxTxPowerAvail;
+    A_UINT16                tx6PowerInHalfDbm;
+    const RATE_TABLE        *hwRateTable[WIRELESS_MODE_MAX];
+    VPORT_BSS               baseBss;
+    VPORT_BSS               *pXrBss;
+    BSSDESCR                *bssDescr;
+    QUEUE_DETAILS           rxQueue;
+    A_BOOL                  invalidTxChannel;
+    A_BOOL                  partialRxDesc;
+    A_BOOL                  useShortSlotTime;
+    A_BOOL                  nonErpPreamble;
+    A_BOOL                  protectOn;
+    A_UINT16                protectRateIdx;
+    A_BOOL                  useFastDiversity;
+    A_UINT8                 cachedDefAnt;
+    A_UINT32                countOtherRxAnt;
+    A_UINT32                cycleCount;
+    A_UINT32                txFrameCount;
+    A_UINT32                rxFrameCount;
+    struct {
+        A_UINT32    hungCount;
+        A_UINT32    dmaUnderrunCount;
+    } txPrefetchStats;
+    struct {
+        int         powerState;
+    } powerMgmt;
+    struct {
+        A_UINT8     gpioSelect;
+        A_UINT8     polarity;
+        A_BOOL      eepEnabled;
+        A_BOOL      hwRadioDisable;
+        A_BOOL      swRadioDisable;
+    } rfSilent;
+    struct {
+        A_UINT8 chain;
+        A_UINT8 chainStrong;
+        A_UINT8 divSxChn;
+        A_UINT8 divSxChnStrong;
+        A_UINT8 divSxChn0;
+        A_UINT8 divSxChn1;
+        A_UINT8 chain0Ant;
+        A_UINT8 chain1Ant;
+    } quadAnt;
+} WLAN_DEV_INFO;
+
+extern int gSlotTime;
+
+A_BOOL
+wlanIsNfCheckRequired(WLAN_DEV_INFO *pDev);
+
+A_BOOL
+wlanIsRegCcValid(WLAN_DEV_INFO *pDev);
+
+WIRELESS_MODE
+wlanCFlagsToWirelessMode(WLAN_DEV_INFO *pDev, A_UINT16 cflags);
+
+WIRELESS_MODE
+wlanFindModeFromRateTable(WLAN_DEV_INFO *pDev, VPORT_BSS *pVportBss);
+
+SIB_ENTRY *
+sibEntryFind(WLAN_DEV_INFO *pDev, WLAN_MACADDR *pAddr);
+
+A_STATUS
+wlanKeyCacheFault(WLAN_DEV_INFO *pDev, SIB_ENTRY *pSib, A_BOOL *pFaulted);
+
+A_BOOL
+isXrBssRxFrame(WLAN_DEV_INFO *pDev, WLAN_FRAME_HEADER *pHdr);
+
+void
+setXrBssIdMask(WLAN_MACADDR *pMask);
+
+void
+apPanic(const char *msg);
+
+void
+swretryStateReset(WLAN_DEV_INFO *pDev, SIB_ENTRY *pSib, A_BOOL clearDest,
+                  A_BOOL clearFiltered);
+
+#endif /* _WLANDRV_H_ */
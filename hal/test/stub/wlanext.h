@@ -0,0 +1,11 @@
+/*
+ *  Copyright (c) 2004 Atheros Communications, Inc., All Rights Reserved
+ *
+ *  Host test stand-in for the driver's external declarations.  The
+ *  HAL sources under test need nothing from it.
+ */
+
+#ifndef _WLANEXT_H_
+#define _WLANEXT_H_
+
+#endif /* _WLANEXT_H_ */
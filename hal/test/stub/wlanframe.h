@@ -0,0 +1,61 @@
+/*
+ *  Copyright (c) 2004 Atheros Communications, Inc., All Rights Reserved
+ *
+ *  Host test stand-in for the driver's 802.11 frame definitions.
+ */
+
+#ifndef _WLANFRAME_H_
+#define _WLANFRAME_H_
+
+#define FRAME_MGT               0
+#define FRAME_CTRL              1
+#define FRAME_DATA              2
+
+#define SUBT_PROBE_RESP         5
+#define SUBT_BEACON             8
+#define SUBT_NODATA_CFPOLL      6
+
+#define FCS_FIELD_SIZE          4
+#define WLAN_CTRL_FRAME_SIZE    (2 + 2 + 6 + FCS_FIELD_SIZE)
+#define MAX_WLAN_BODY_SIZE      2312
+
+typedef union {
+    A_UINT8         octets[6];
+    struct {
+        A_UINT32    word;
+        A_UINT16    half;
+    } st;
+} WLAN_MACADDR;
+
+typedef struct {
+    A_UINT16    protoVer:2,
+                fType:2,
+                fSubtype:4,
+                ToDS:1,
+                FromDS:1,
+                moreFrag:1,
+                retry:1,
+                pwrMgt:1,
+                moreData:1,
+                wep:1,
+                order:1;
+} FRAME_CONTROL;
+
+typedef struct {
+    FRAME_CONTROL   frameControl;
+    A_UINT16        durationNav;
+    WLAN_MACADDR    address1;
+    WLAN_MACADDR    address2;
+    WLAN_MACADDR    address3;
+    A_UINT16        seqControl;
+} WLAN_FRAME_HEADER;
+
+typedef WLAN_FRAME_HEADER   WLAN_DATA_MAC_HEADER;
+
+#define isGrp(_pAddr)                       (((_pAddr)->octets[0] & 0x01) != 0)
+#define WLAN_GET_FRAGNUM(_seqControl)       ((_seqControl) & 0xf)
+#define WLAN_SET_DURATION_NAV(_nav, _val)   ((_nav) = (A_UINT16)(_val))
+
+extern WLAN_MACADDR broadcastMacAddr;
+
+#endif /* _WLANFRAME_H_ */
@@ -0,0 +1,105 @@
+/*
+ *  Copyright (c) 2004 Atheros Communications, Inc., All Rights Reserved
+ *
+ *  Host test stand-in for the OS abstraction.  Register accesses go
+ *  to readPlatformReg/writePlatformReg, which each test provides.
+ *  A failed ASSERT ends the test.
+ */
+
+#ifndef _WLANOS_H_
+#define _WLANOS_H_
+
+#include <stdio.h>
+
+#define INLINE                  __inline__ __attribute__((gnu_inline))
+#define LOCAL                   static
+
+#define A_MIN(a, b)             ((a) < (b) ? (a) : (b))
+#define A_MAX(a, b)             ((a) > (b) ? (a) : (b))
+#define A_ABS(x)                ((x) < 0 ? -(x) : (x))
+#define A_MEM_ZERO(p, n)        memset((p), 0, (n))
+#define A_BCOPY(s, d, n)        memcpy((d), (s), (n))
+#define A_DRIVER_BCOPY(s, d, n) memcpy((d), (s), (n))
+#define A_MACADDR_COPY(s, d)    memcpy((d), (s), sizeof(WLAN_MACADDR))
+#define A_ROUNDUP(x, y)         ((((x) + (y) - 1) / (y)) * (y))
+#define A_DRIVER_MALLOC(n)      malloc(n)
+#define A_DRIVER_FREE(p, n)     free(p)
+
+/* NDIS types the PCI paths use */
+typedef void                VOID;
+typedef unsigned char       BOOLEAN;
+typedef void                *PVOID;
+typedef unsigned int        UINT32;
+typedef void                *NDIS_HANDLE;
+
+#define udelay(us)              ((void)(us))
+#define logMsg                  printf
+#define A_MS_TICKGET()          0
+
+/* No caches or address translation between the host and the simulator */
+#define A_DATA_V2P(p)           ((A_UINT32)(unsigned long)(p))
+#define A_DATA_P2V(a)           ((void *)(unsigned long)(a))
+#define A_DESC_CACHE_FLUSH(p)   do { } while (0)
+#define A_TX_DESC_CACHE_INVAL(p) do { } while (0)
+#define A_RX_DESC_CACHE_INVAL(p) do { } while (0)
+#define A_PIPEFLUSH()           do { } while (0)
+#define A_SEM_VALID(s)          0
+
+#define A_RSSI_LPF(x, y)        (((x) * 7 + (y)) / 8)
+#define A_RATE_LPF(x, y)        (((x) * 7 + (y)) / 8)
+
+#define A_SIB_ENTRY_LOCK(p)     do { } while (0)
+#define A_SIB_ENTRY_UNLOCK(p)   do { } while (0)
+
+/* Single threaded - interrupt locks and synchronised calls run inline */
+#define INIT_WLAN_INTR_LOCK(_key)           int _key = 0
+#define LOCK_WLAN_INTR(_key)                ((void)(_key))
+#define UNLOCK_WLAN_INTR(_key)              ((void)(_key))
+#define ATH_OSSYNCINTR(_pDev, _fn, _ctx)    ((void)(_fn)(_ctx))
+
+/* PCI config space reads back as zero */
+#define NdisReadPciSlotInformation(_h, _slot, _off, _pBuf, _len) \
+    (memset((_pBuf), 0, (_len)), (_len))
+
+#define ASSERT(x)                                                       \
+    do {                                                                \
+        if (!(x)) {                                                     \
+            printf("ASSERT(%s) failed at %s:%d\n", #x, __FILE__, __LINE__); \
+            exit(1);                                                    \
+        }                                                               \
+    } while (0)
+
+A_UINT32
+readPlatformReg(void *pDev, A_UINT32 reg);
+
+void
+writePlatformReg(void *pDev, A_UINT32 reg, A_UINT32 value);
+
+#define A_REG_RD(pDev, reg)         readPlatformReg((pDev), (reg))
+#define A_REG_WR(pDev, reg, value)  writePlatformReg((pDev), (reg), (value))
+
+#define A_FIELD_VALUE(_reg, _field, _val)                               \
+    (((A_UINT32)(_val) << _reg##_##_field##_S) & _reg##_##_field##_M)
+#define A_REG_RMW_FIELD(_pDev, _reg, _field, _val)                      \
+    A_REG_WR((_pDev), (_reg), (A_REG_RD((_pDev), (_reg)) &              \
+             ~_reg##_##_field##_M) | A_FIELD_VALUE(_reg, _field, _val))
+#define A_REG_SET_BIT(_pDev, _reg, _field)                              \
+    A_REG_WR((_pDev), (_reg), A_REG_RD((_pDev), (_reg)) | _reg##_##_field)
+#define A_REG_CLR_BIT(_pDev, _reg, _field)                              \
+    A_REG_WR((_pDev), (_reg), A_REG_RD((_pDev), (_reg)) & ~_reg##_##_field)
+#define A_REG_SET_BIT2(_pDev, _reg, _f1, _f2)                           \
+    A_REG_WR((_pDev), (_reg), A_REG_RD((_pDev), (_reg)) |               \
+             _reg##_##_f1 | _reg##_##_f2)
+#define A_REG_SET_BIT3(_pDev, _reg, _f1, _f2, _f3)                      \
+    A_REG_WR((_pDev), (_reg), A_REG_RD((_pDev), (_reg)) |               \
+             _reg##_##_f1 | _reg##_##_f2 | _reg##_##_f3)
+#define A_REG_IS_BIT_SET(_pDev, _reg, _field)                           \
+    ((A_REG_RD((_pDev), (_reg)) & _reg##_##_field) != 0)
+#define A_REG_RD_FIELD(_pDev, _reg, _field)                             \
+    ((A_REG_RD((_pDev), (_reg)) & _reg##_##_field##_M) >> _reg##_##_field##_S)
+#define A_REG_WR_FIELD(_pDev, _reg, _field, _val)                       \
+    A_REG_WR((_pDev), (_reg), A_FIELD_VALUE(_reg, _field, _val))
+#define A_REG_RMW(_pDev, _reg, _set, _clr)                              \
+    A_REG_WR((_pDev), (_reg), (A_REG_RD((_pDev), (_reg)) & ~(_clr)) | (_set))
+
+#endif /* _WLANOS_H_ */
@@ -0,0 +1,46 @@
+/*
+ *  Copyright (c) 2004 Atheros Communications, Inc., All Rights Reserved
+ *
+ *  Host test stand-in for the driver's basic types.  Only what the
+ *  HAL sources under test need is defined here.
+ */
+
+#ifndef _WLANTYPE_H_
+#define _WLANTYPE_H_
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef unsigned char       A_UINT8;
+typedef signed char         A_INT8;
+typedef unsigned short      A_UINT16;
+typedef short               A_INT16;
+typedef unsigned int        A_UINT32;
+typedef unsigned int        A_UINT;
+typedef int                 A_INT32;
+typedef unsigned long long  A_UINT64;
+typedef long long           A_INT64;
+typedef int                 A_BOOL;
+typedef char                A_CHAR;
+typedef unsigned char       A_UCHAR;
+typedef int                 A_STATUS;
+
+#define TRUE                1
+#define FALSE               0
+
+#define A_OK                0
+#define A_ERROR             1
+#define A_NO_MEMORY         2
+#define A_EINVAL            3
+#define A_HARDWARE          4
+#define A_EBADCHANNEL       5
+#define A_ENOTSUP           6
+#define A_EBUSY             7
+#define A_PHY_ERROR         8
+#define A_DEVICE_NOT_FOUND  9
+
+#define cpu2le16(x)         ((A_UINT16)(x))
+#define cpu2le32(x)         ((A_UINT32)(x))
+
+#endif /* _WLANTYPE_H_ */